@@ -0,0 +1,387 @@
+#include "capture.h"
+
+#include "video.h"
+
+#include <stdio.h>
+#include <string.h>
+#if !PLATFORM_HOST
+#include <malloc.h>
+#endif
+
+#define CAP_W VIDEO_WIDTH
+#define CAP_H VIDEO_HEIGHT
+#define CAP_FRAME_BYTES ((unsigned int)CAP_W * CAP_H)
+
+#define FLI_MAGIC 0xAF11
+#define FLI_FRAME_MAGIC 0xF1FA
+#define FLI_COLOR64 11
+#define FLI_LC 12
+#define FLI_BRUN 15
+#define FLI_HEADER_SIZE 128
+#define FLI_MAX_FRAMES 0xFFFFU
+
+#define CAP_MAX_PACKET 127
+#define CAP_GAP_MERGE 2   // Huecos iguales de hasta 2 bytes van dentro del paquete (la cabecera cuesta 2)
+#define CAP_BRUN_ROWS (CAP_H * 3 / 4)
+
+static FILE *g_cap = NULL;
+static unsigned char far *g_prev = NULL;
+static unsigned char g_prev_dac[256 * 3];
+static int g_have_prev = 0;
+static unsigned int g_frames = 0;
+// Peor caso de una línea: paquetes de 1 byte separados por 1 byte igual
+static unsigned char g_line[CAP_W * 2 + 16];
+
+static void cap_put8(int v)
+{
+    putc(v & 0xFF, g_cap);
+}
+
+static void cap_put16(unsigned int v)
+{
+    putc(v & 0xFF, g_cap);
+    putc((v >> 8) & 0xFF, g_cap);
+}
+
+static void cap_put32(unsigned long v)
+{
+    cap_put16((unsigned int)(v & 0xFFFFUL));
+    cap_put16((unsigned int)(v >> 16));
+}
+
+static long cap_chunk_begin(unsigned int type)
+{
+    long pos = ftell(g_cap);
+
+    cap_put32(0);
+    cap_put16(type);
+    return pos;
+}
+
+static void cap_chunk_end(long pos)
+{
+    long end = ftell(g_cap);
+
+    // Los chunks van alineados a par
+    if ((end - pos) & 1) {
+        cap_put8(0);
+        ++end;
+    }
+    fseek(g_cap, pos, SEEK_SET);
+    cap_put32((unsigned long)(end - pos));
+    fseek(g_cap, end, SEEK_SET);
+}
+
+// Paquetes de repetición/copia para n bytes de src. En LC cada paquete lleva
+// delante el salto (sólo el primero salta de verdad) y el signo va al revés que en BRUN.
+static unsigned int cap_pack(unsigned char *out, const unsigned char far *src, int n, int brun, int skip,
+                             int *packets)
+{
+    unsigned int len = 0;
+    int i = 0;
+
+    while (i < n) {
+        int run = 1;
+
+        while (i + run < n && run < CAP_MAX_PACKET && src[i + run] == src[i]) {
+            ++run;
+        }
+
+        if (!brun) {
+            out[len++] = (unsigned char)skip;
+            skip = 0;
+        }
+
+        if (run >= 3) {
+            out[len++] = (unsigned char)(brun ? run : -run);
+            out[len++] = src[i];
+            i += run;
+        } else {
+            int j = i;
+
+            while (j < n && j - i < CAP_MAX_PACKET) {
+                if (j + 2 < n && src[j] == src[j + 1] && src[j] == src[j + 2]) {
+                    break;
+                }
+                ++j;
+            }
+            out[len++] = (unsigned char)(brun ? -(j - i) : (j - i));
+            _fmemcpy((unsigned char far *)(out + len), src + i, (unsigned int)(j - i));
+            len += (unsigned int)(j - i);
+            i = j;
+        }
+        ++(*packets);
+    }
+
+    return len;
+}
+
+static void cap_write_brun(const unsigned char far *frame)
+{
+    long pos = cap_chunk_begin(FLI_BRUN);
+    int y;
+
+    for (y = 0; y < CAP_H; ++y) {
+        int packets = 0;
+        unsigned int len = cap_pack(g_line + 1, frame + (unsigned int)y * CAP_W, CAP_W, 1, 0, &packets);
+
+        // El contador de BRUN no lo usa nadie, pero mejor que sea correcto
+        g_line[0] = (unsigned char)(packets > 255 ? 0 : packets);
+        fwrite(g_line, 1, len + 1, g_cap);
+    }
+
+    cap_chunk_end(pos);
+}
+
+static unsigned int cap_lc_line(const unsigned char far *cur, const unsigned char far *prev)
+{
+    unsigned int len = 1;
+    int packets = 0;
+    int x = 0;
+    int last = 0;
+
+    while (x < CAP_W) {
+        int start;
+        int end;
+        int skip;
+
+        if (cur[x] == prev[x]) {
+            ++x;
+            continue;
+        }
+
+        start = x;
+        end = x + 1;
+        while (end < CAP_W) {
+            int gap = 0;
+
+            while (end + gap < CAP_W && cur[end + gap] == prev[end + gap]) {
+                ++gap;
+            }
+            if (gap == 0) {
+                ++end;
+            } else if (gap <= CAP_GAP_MERGE && end + gap < CAP_W) {
+                end += gap;
+            } else {
+                break;
+            }
+        }
+
+        skip = start - last;
+        while (skip > 255) {
+            // Salto largo: paquete de copia vacío
+            g_line[len++] = 255;
+            g_line[len++] = 0;
+            ++packets;
+            skip -= 255;
+        }
+
+        len += cap_pack(g_line + len, cur + start, end - start, 0, skip, &packets);
+        last = end;
+        x = end;
+    }
+
+    g_line[0] = (unsigned char)packets;
+    return len;
+}
+
+static void cap_write_lc(const unsigned char far *frame, int first, int last)
+{
+    long pos = cap_chunk_begin(FLI_LC);
+    int y;
+
+    cap_put16((unsigned int)first);
+    cap_put16((unsigned int)(last - first + 1));
+
+    for (y = first; y <= last; ++y) {
+        unsigned int offset = (unsigned int)y * CAP_W;
+        unsigned int len = cap_lc_line(frame + offset, g_prev + offset);
+
+        fwrite(g_line, 1, len, g_cap);
+    }
+
+    cap_chunk_end(pos);
+}
+
+static int cap_write_palette(const unsigned char *dac)
+{
+    long pos;
+    long count_pos;
+    unsigned int packets = 0;
+    int last = 0;
+    int i = 0;
+
+    if (g_have_prev && memcmp(g_prev_dac, dac, sizeof(g_prev_dac)) == 0) {
+        return 0;
+    }
+
+    pos = cap_chunk_begin(FLI_COLOR64);
+    count_pos = ftell(g_cap);
+    cap_put16(0);
+
+    while (i < 256) {
+        int first;
+
+        if (g_have_prev && memcmp(g_prev_dac + i * 3, dac + i * 3, 3) == 0) {
+            ++i;
+            continue;
+        }
+
+        first = i;
+        while (i < 256 && (!g_have_prev || memcmp(g_prev_dac + i * 3, dac + i * 3, 3) != 0)) {
+            ++i;
+        }
+
+        cap_put8(first - last);
+        cap_put8(i - first); // 256 se escribe como 0
+        fwrite(dac + first * 3, 1, (i - first) * 3, g_cap);
+        last = i;
+        ++packets;
+    }
+
+    {
+        long end = ftell(g_cap);
+
+        fseek(g_cap, count_pos, SEEK_SET);
+        cap_put16(packets);
+        fseek(g_cap, end, SEEK_SET);
+    }
+    cap_chunk_end(pos);
+
+    memcpy(g_prev_dac, dac, sizeof(g_prev_dac));
+    return 1;
+}
+
+int cap_open(const char *path)
+{
+    int i;
+
+    cap_close();
+    if (!path || !path[0]) return 0;
+
+    g_prev = (unsigned char far *)_fmalloc(CAP_FRAME_BYTES);
+    if (!g_prev) return 0;
+
+    g_cap = fopen(path, "wb");
+    if (!g_cap) {
+        _ffree(g_prev);
+        g_prev = NULL;
+        return 0;
+    }
+
+    // Cabecera FLI; tamaño y número de frames se rellenan al cerrar
+    cap_put32(0);
+    cap_put16(FLI_MAGIC);
+    cap_put16(0);
+    cap_put16(CAP_W);
+    cap_put16(CAP_H);
+    cap_put16(8);
+    cap_put16(0);
+    cap_put16(1); // Velocidad en 1/70 s
+    for (i = 18; i < FLI_HEADER_SIZE; ++i) {
+        cap_put8(0);
+    }
+
+    g_have_prev = 0;
+    g_frames = 0;
+    return 1;
+}
+
+void cap_close(void)
+{
+    if (g_cap) {
+        long end = ftell(g_cap);
+
+        fseek(g_cap, 0, SEEK_SET);
+        cap_put32((unsigned long)end);
+        cap_put16(FLI_MAGIC);
+        cap_put16(g_frames);
+        fclose(g_cap);
+        g_cap = NULL;
+    }
+
+    if (g_prev) {
+        _ffree(g_prev);
+        g_prev = NULL;
+    }
+    g_have_prev = 0;
+}
+
+int cap_active(void)
+{
+    return g_cap != NULL;
+}
+
+void cap_frame(const unsigned char far *frame, const unsigned char *dac, int y0, int y1)
+{
+    long pos;
+    unsigned int chunks = 0;
+    int first = -1;
+    int last = -1;
+    int y;
+
+    if (!g_cap || !frame || !dac || g_frames >= FLI_MAX_FRAMES) {
+        return;
+    }
+
+    if (y0 < 0) y0 = 0;
+    if (y1 > CAP_H) y1 = CAP_H;
+
+    pos = ftell(g_cap);
+    cap_put32(0);
+    cap_put16(FLI_FRAME_MAGIC);
+    cap_put16(0);
+    for (y = 0; y < 8; ++y) {
+        cap_put8(0);
+    }
+
+    if (cap_write_palette(dac)) {
+        ++chunks;
+    }
+
+    if (!g_have_prev) {
+        cap_write_brun(frame);
+        _fmemcpy(g_prev, frame, CAP_FRAME_BYTES);
+        ++chunks;
+    } else {
+        int changed = 0;
+
+        // Fuera de [y0, y1) el frame no se ha tocado desde el anterior
+        for (y = y0; y < y1; ++y) {
+            unsigned int offset = (unsigned int)y * CAP_W;
+
+            if (_fmemcmp(frame + offset, g_prev + offset, CAP_W) != 0) {
+                if (first < 0) first = y;
+                last = y;
+                ++changed;
+            }
+        }
+
+        if (changed >= CAP_BRUN_ROWS) {
+            cap_write_brun(frame);
+            ++chunks;
+        } else if (changed > 0) {
+            cap_write_lc(frame, first, last);
+            ++chunks;
+        }
+
+        if (changed > 0) {
+            unsigned int offset = (unsigned int)first * CAP_W;
+            _fmemcpy(g_prev + offset, frame + offset, (unsigned int)(last - first + 1) * CAP_W);
+        }
+    }
+
+    g_have_prev = 1;
+
+    {
+        long end = ftell(g_cap);
+
+        fseek(g_cap, pos, SEEK_SET);
+        cap_put32((unsigned long)(end - pos));
+        cap_put16(FLI_FRAME_MAGIC);
+        cap_put16(chunks);
+        fseek(g_cap, end, SEEK_SET);
+    }
+
+    ++g_frames;
+}
@@ -0,0 +1,17 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "platform.h"
+
+// Captura de partida en formato FLI (320x200): paleta y después sólo las
+// diferencias con el frame anterior. La alimenta v_present().
+// TOOLS/captura_a_ppm.py la vuelve a expandir a PPM.
+
+int cap_open(const char *path);
+void cap_close(void);
+int cap_active(void);
+
+// Llamada desde video.c: frame presentado, DAC (6 bits) y filas que pueden haber cambiado
+void cap_frame(const unsigned char far *frame, const unsigned char *dac, int y0, int y1);
+
+#endif
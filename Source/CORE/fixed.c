@@ -0,0 +1,60 @@
+#include "fixed.h"
+
+// sin(0..90 grados) en 16.16
+static const fix_t g_sin_q1[91] = {
+         0L,   1144L,   2287L,   3430L,   4572L,   5712L,   6850L,   7987L,
+      9121L,  10252L,  11380L,  12505L,  13626L,  14742L,  15855L,  16962L,
+     18064L,  19161L,  20252L,  21336L,  22415L,  23486L,  24550L,  25607L,
+     26656L,  27697L,  28729L,  29753L,  30767L,  31772L,  32768L,  33754L,
+     34729L,  35693L,  36647L,  37590L,  38521L,  39441L,  40348L,  41243L,
+     42126L,  42995L,  43852L,  44695L,  45525L,  46341L,  47143L,  47930L,
+     48703L,  49461L,  50203L,  50931L,  51643L,  52339L,  53020L,  53684L,
+     54332L,  54963L,  55578L,  56175L,  56756L,  57319L,  57865L,  58393L,
+     58903L,  59396L,  59870L,  60326L,  60764L,  61183L,  61584L,  61966L,
+     62328L,  62672L,  62997L,  63303L,  63589L,  63856L,  64104L,  64332L,
+     64540L,  64729L,  64898L,  65048L,  65177L,  65287L,  65376L,  65446L,
+     65496L,  65526L,  65536L,
+};
+
+fix_t fix_sin_deg(int degrees)
+{
+    degrees %= 360;
+    if (degrees < 0) {
+        degrees += 360;
+    }
+
+    if (degrees <= 90) return g_sin_q1[degrees];
+    if (degrees <= 180) return g_sin_q1[180 - degrees];
+    if (degrees <= 270) return -g_sin_q1[degrees - 180];
+    return -g_sin_q1[360 - degrees];
+}
+
+fix_t fix_cos_deg(int degrees)
+{
+    return fix_sin_deg(degrees + 90);
+}
+
+fix_t fix_sqrt(fix_t v)
+{
+    // Raíz entera de v << 16, bit a bit: sqrt(v/65536) * 65536
+    uint32_t rem = 0;
+    uint32_t root = 0;
+    uint32_t num;
+    int i;
+
+    if (v <= 0) {
+        return 0;
+    }
+
+    num = (uint32_t)v;
+    for (i = 0; i < 24; ++i) {
+        root <<= 1;
+        rem = (rem << 2) | (num >> 30);
+        num <<= 2;
+        if (root < rem) {
+            rem -= root + 1;
+            root += 2;
+        }
+    }
+    return (fix_t)(root >> 1);
+}
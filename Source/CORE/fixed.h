@@ -0,0 +1,75 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+
+// Coma fija 16.16: en un 386/486SX sin FPU cada operación con float se emula.
+// Sumas, restas y comparaciones son las de int32_t; mul/div pasan por 64 bits.
+
+typedef int32_t fix_t;
+
+#define FIX_SHIFT 16
+#define FIX_ONE ((fix_t)65536L)
+#define FIX_HALF ((fix_t)32768L)
+
+#define FIX_FROM_INT(i) ((fix_t)(i) * FIX_ONE)
+// Trunca hacia cero como (int) de un float
+#define FIX_TO_INT(f) ((f) >= 0 ? (int)((f) >> FIX_SHIFT) : -(int)((-(f)) >> FIX_SHIFT))
+// Para constantes: el compilador lo resuelve, no queda float en el código
+#define FIX_CONST(x) ((fix_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define FIX_FROM_FLOAT(x) FIX_CONST(x)
+#define FIX_TO_FLOAT(f) ((float)(f) / 65536.0f)
+// n/d exacto sin pasar por float
+#define FIX_RATIO(n, d) ((fix_t)(((int64_t)(n) * FIX_ONE) / (d)))
+
+#define fix_mul(a, b) ((fix_t)(((int64_t)(a) * (int64_t)(b) + FIX_HALF) >> FIX_SHIFT))
+#define fix_div(a, b) ((fix_t)(((int64_t)(a) * FIX_ONE) / (b)))
+#define fix_lerp(a, b, t) ((a) + fix_mul((b) - (a), (t)))
+#define fix_clamp(v, lo, hi) ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+#define fix_abs(v) ((v) < 0 ? -(v) : (v))
+
+// Ángulos en grados enteros, por tabla (91 valores de un cuadrante)
+fix_t fix_sin_deg(int degrees);
+fix_t fix_cos_deg(int degrees);
+fix_t fix_sqrt(fix_t v);
+
+// Física de los minijuegos: phys_t es fix_t o float según USE_FIXED_PHYSICS.
+// El camino float queda como referencia (mismos resultados que antes del cambio).
+// ./build_host.sh fisica compara los dos caminos con las mismas partidas.
+#ifndef USE_FIXED_PHYSICS
+#define USE_FIXED_PHYSICS 1
+#endif
+
+#if USE_FIXED_PHYSICS
+typedef fix_t phys_t;
+#define PHYS_C(x) FIX_CONST(x)
+#define PHYS_I(i) FIX_FROM_INT(i)
+#define PHYS_INT(p) FIX_TO_INT(p)
+#define PHYS_F(f) FIX_FROM_FLOAT(f)
+#define PHYS_TO_F(p) FIX_TO_FLOAT(p)
+#define PHYS_RATIO(n, d) FIX_RATIO(n, d)
+#define PHYS_MUL(a, b) fix_mul(a, b)
+#define PHYS_DIV(a, b) fix_div(a, b)
+#define PHYS_LERP(a, b, t) fix_lerp(a, b, t)
+#define PHYS_SIN_DEG(d) fix_sin_deg(d)
+#define PHYS_COS_DEG(d) fix_cos_deg(d)
+#define PHYS_SQRT(p) fix_sqrt(p)
+#else
+#include <math.h>
+
+typedef float phys_t;
+#define PHYS_C(x) ((float)(x))
+#define PHYS_I(i) ((float)(i))
+#define PHYS_INT(p) ((int)(p))
+#define PHYS_F(f) ((float)(f))
+#define PHYS_TO_F(p) ((float)(p))
+#define PHYS_RATIO(n, d) ((float)(n) / (float)(d))
+#define PHYS_MUL(a, b) ((a) * (b))
+#define PHYS_DIV(a, b) ((a) / (b))
+#define PHYS_LERP(a, b, t) ((a) + ((b) - (a)) * (t))
+#define PHYS_SIN_DEG(d) ((float)sin((float)(d) * 3.1415926f / 180.0f))
+#define PHYS_COS_DEG(d) ((float)cos((float)(d) * 3.1415926f / 180.0f))
+#define PHYS_SQRT(p) ((float)sqrt(p))
+#endif
+
+#endif
@@ -0,0 +1,157 @@
+#include "frame.h"
+
+#include "keyboard.h"
+#include "timer.h"
+
+static uint32_t g_period_us = FRAME_PERIOD_US;
+static uint32_t g_deadline_us = 0;
+static uint32_t g_last_start_us = 0;
+static uint32_t g_last_us = 0;
+static int g_started = 0;
+
+#define USE_FRAME_SKIP 1
+// Margen del paso que puede ocupar el trabajo: para subir de nivel y, más estricto, para bajar
+#define FRAME_SKIP_BUDGET_PCT 90UL
+#define FRAME_SKIP_RELAX_PCT 70UL
+// Frames pintados seguidos con holgura antes de bajar un nivel
+#define FRAME_SKIP_HOLD 30
+
+static int g_skip_level = 1;
+static int g_skip_steps = 0;
+static int g_skip_calm = 0;
+// Medias móviles (1/8) en microsegundos
+static uint32_t g_skip_update_us = 0;
+static uint32_t g_skip_draw_us = 0;
+
+void frame_set_period(uint32_t period_us)
+{
+    g_period_us = period_us ? period_us : FRAME_PERIOD_US;
+    g_started = 0;
+}
+
+uint32_t frame_period(void)
+{
+    return g_period_us;
+}
+
+int frame_sleep_until(uint32_t deadline_us, int wake_on_input)
+{
+    // OJO: resta con signo para que el salto de 32 bits (cada 71 min) no cuelgue
+    while ((int32_t)(deadline_us - timer_now_us()) > 0) {
+        if (wake_on_input && kb_keyhit()) {
+            return 1;
+        }
+        t_idle();
+    }
+    return 0;
+}
+
+static int frame_next(int wake_on_input)
+{
+    uint32_t now = timer_now_us();
+    int woke = 0;
+
+    if (!g_started) {
+        g_started = 1;
+        g_last_start_us = now;
+        g_deadline_us = now + g_period_us;
+    }
+
+    woke = frame_sleep_until(g_deadline_us, wake_on_input);
+    now = timer_now_us();
+
+    if (!woke) {
+        g_deadline_us += g_period_us;
+        // Si vamos más de un frame tarde no se intenta recuperar
+        if ((int32_t)(now - g_deadline_us) > 0) {
+            g_deadline_us = now + g_period_us;
+        }
+    }
+
+    g_last_us = now - g_last_start_us;
+    g_last_start_us = now;
+    return woke;
+}
+
+int frame_wait_input(void)
+{
+    return frame_next(1);
+}
+
+void frame_wait(void)
+{
+    frame_next(0);
+}
+
+uint32_t frame_last_us(void)
+{
+    return g_last_us;
+}
+
+void frame_skip_reset(void)
+{
+    g_skip_level = 1;
+    g_skip_steps = 0;
+    g_skip_calm = 0;
+    g_skip_update_us = 0;
+    g_skip_draw_us = 0;
+}
+
+int frame_skip_due(int updates)
+{
+    g_skip_steps += updates;
+    // Sin pasos nuevos también se pinta (interpolación) mientras no haya que recortar
+    if (g_skip_level <= 1 || g_skip_steps >= g_skip_level) {
+        g_skip_steps = 0;
+        return 1;
+    }
+    return 0;
+}
+
+static uint32_t frame_skip_avg(uint32_t avg, uint32_t sample)
+{
+    if (avg == 0) {
+        return sample;
+    }
+    return avg - (avg >> 3) + (sample >> 3);
+}
+
+// Cabe si N pasos de update más un pintado entran en N pasos de reloj
+static int frame_skip_fits(int level, unsigned long pct)
+{
+    uint32_t budget = (uint32_t)((g_period_us * pct) / 100UL) * (uint32_t)level;
+
+    return (g_skip_update_us * (uint32_t)level + g_skip_draw_us) <= budget;
+}
+
+void frame_skip_cost(uint32_t update_us, uint32_t draw_us)
+{
+#if USE_FRAME_SKIP
+    if (update_us) {
+        g_skip_update_us = frame_skip_avg(g_skip_update_us, update_us);
+    }
+    g_skip_draw_us = frame_skip_avg(g_skip_draw_us, draw_us);
+
+    // Subir en cuanto no cabe; bajar sólo tras un rato con holgura
+    while (g_skip_level < FRAME_SKIP_MAX && !frame_skip_fits(g_skip_level, FRAME_SKIP_BUDGET_PCT)) {
+        g_skip_level++;
+        g_skip_calm = 0;
+    }
+    if (g_skip_level > 1 && frame_skip_fits(g_skip_level - 1, FRAME_SKIP_RELAX_PCT)) {
+        if (++g_skip_calm >= FRAME_SKIP_HOLD) {
+            g_skip_level--;
+            g_skip_calm = 0;
+        }
+    } else {
+        g_skip_calm = 0;
+    }
+#else
+    (void)update_us;
+    (void)draw_us;
+#endif
+}
+
+int frame_skip_level(void)
+{
+    return g_skip_level;
+}
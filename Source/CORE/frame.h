@@ -0,0 +1,39 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+
+// Ritmo de frames: entre frame y frame la CPU duerme (HLT) en vez de dar vueltas.
+// Los menús esperan con frame_wait_input() y sólo presentan si algo cambió.
+
+#define FRAME_PERIOD_US 16667UL
+
+void frame_set_period(uint32_t period_us);
+uint32_t frame_period(void);
+
+// Duerme hasta deadline_us; con wake_on_input vuelve antes si llega una tecla.
+// Devuelve 1 si despertó por entrada
+int frame_sleep_until(uint32_t deadline_us, int wake_on_input);
+
+// Espera al siguiente frame del periodo actual o a una tecla (menús)
+int frame_wait_input(void);
+// Igual pero sin despertar por entrada (bucles de juego)
+void frame_wait(void);
+
+// Tiempo real del último frame, espera incluida
+uint32_t frame_last_us(void);
+
+// Pintado adaptativo: si update + pintar no caben en el paso, se pinta uno de
+// cada 2 o 3 pasos y la simulación sigue a 60 Hz de reloj. Vuelve a pintarlo
+// todo cuando sobra tiempo.
+#define FRAME_SKIP_MAX 3
+
+void frame_skip_reset(void);
+// Pasos simulados desde la última vuelta; devuelve 1 si esta vuelta toca pintar
+int frame_skip_due(int updates);
+// Coste medido: update de un paso y pintado (sin la espera del retrace)
+void frame_skip_cost(uint32_t update_us, uint32_t draw_us);
+// 1 = pinta todos los pasos, N = uno de cada N
+int frame_skip_level(void);
+
+#endif
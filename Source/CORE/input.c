@@ -10,6 +10,13 @@ static int g_joy_last_dy = 0;
 static unsigned char g_joy_last_buttons = 0;
 static unsigned char g_prev_keys[128];
 
+// Joystick congelado por tick (grabar/reproducir): ya resuelto a dirección y botones
+static int g_joy_frozen = 0;
+static int g_joy_tick_available = 0;
+static int g_joy_tick_dx = 0;
+static int g_joy_tick_dy = 0;
+static unsigned char g_joy_tick_buttons = 0;
+
 static int input_joystick_enabled(void)
 {
     const GameOptions *options = options_get();
@@ -18,19 +25,15 @@ static int input_joystick_enabled(void)
 
 static int input_joystick_event(void)
 {
-    JoystickState state;
     int dx = 0;
     int dy = 0;
     int event = IN_KEY_NONE;
-    unsigned char buttons;
+    unsigned char buttons = 0;
 
-    if (!in_joystick_state(&state)) {
+    if (!in_joystick_direction(&dx, &dy, &buttons)) {
         return IN_KEY_NONE;
     }
 
-    joy_get_direction(&state, &dx, &dy);
-    buttons = state.buttons;
-
     if (dy != 0 && dy != g_joy_last_dy) {
         event = (dy < 0) ? IN_KEY_UP : IN_KEY_DOWN;
     } else if (dx != 0 && dx != g_joy_last_dx) {
@@ -92,13 +95,12 @@ int in_any_down(void)
     }
 
     if (input_joystick_enabled()) {
-        JoystickState state;
         int dx = 0;
         int dy = 0;
+        unsigned char buttons = 0;
 
-        if (in_joystick_state(&state)) {
-            joy_get_direction(&state, &dx, &dy);
-            if (dx != 0 || dy != 0 || state.buttons != 0) {
+        if (in_joystick_direction(&dx, &dy, &buttons)) {
+            if (dx != 0 || dy != 0 || buttons != 0) {
                 return 1;
             }
         }
@@ -109,14 +111,36 @@ int in_any_down(void)
 
 int in_joystick_available(void)
 {
+    if (g_joy_frozen) {
+        return g_joy_tick_available;
+    }
     return joy_available();
 }
 
 int in_joystick_state(JoystickState *state)
 {
+    if (g_joy_frozen) {
+        // OJO: congelado sólo valen los botones; los ejes no se guardan
+        if (!state || !g_joy_tick_available) {
+            return 0;
+        }
+        state->x = 0;
+        state->y = 0;
+        state->buttons = g_joy_tick_buttons;
+        return 1;
+    }
     return joy_read(state);
 }
 
+void in_joystick_freeze(int on, int available, int dir_x, int dir_y, unsigned char buttons)
+{
+    g_joy_frozen = on;
+    g_joy_tick_available = available;
+    g_joy_tick_dx = dir_x;
+    g_joy_tick_dy = dir_y;
+    g_joy_tick_buttons = buttons;
+}
+
 int in_joystick_direction(int *dir_x, int *dir_y, unsigned char *buttons)
 {
     JoystickState state;
@@ -125,6 +149,18 @@ int in_joystick_direction(int *dir_x, int *dir_y, unsigned char *buttons)
         return 0;
     }
 
+    if (g_joy_frozen) {
+        if (!g_joy_tick_available) {
+            return 0;
+        }
+        *dir_x = g_joy_tick_dx;
+        *dir_y = g_joy_tick_dy;
+        if (buttons) {
+            *buttons = g_joy_tick_buttons;
+        }
+        return 1;
+    }
+
     if (!in_joystick_state(&state)) {
         return 0;
     }
@@ -26,6 +26,8 @@ int in_any_down(void);
 int in_joystick_available(void);
 int in_joystick_state(JoystickState *state);
 int in_joystick_direction(int *dir_x, int *dir_y, unsigned char *buttons);
+// Grabar/reproducir: con on, las consultas de joystick devuelven estos valores
+void in_joystick_freeze(int on, int available, int dir_x, int dir_y, unsigned char buttons);
 int Input_Pressed(int key);
 
 #endif
@@ -1,7 +1,11 @@
 #include "joystick.h"
 
+#include "platform.h"
+
+#if !PLATFORM_HOST
 #include <dos.h>
 #include <conio.h>
+#endif
 
 #define JOY_PORT 0x201
 #define JOY_TIMEOUT 8000
@@ -46,6 +50,16 @@ int joy_read(JoystickState *state)
         return 0;
     }
 
+#if PLATFORM_HOST
+    // En host no hay puerto de juegos: ejes a tope, como sin joystick
+    (void)x;
+    (void)y;
+    (void)port;
+    state->x = JOY_TIMEOUT;
+    state->y = JOY_TIMEOUT;
+    state->buttons = 0;
+    return 1;
+#else
     outp(JOY_PORT, 0xFF);
 
     while (1) {
@@ -80,6 +94,7 @@ int joy_read(JoystickState *state)
 
     joy_calibrate_center(state);
     return 1;
+#endif
 }
 
 int joy_available(void)
@@ -1,5 +1,9 @@
+#include "platform.h"
+
+#if !PLATFORM_HOST
 #include <dos.h>
 #include <conio.h>
+#endif
 #include "input.h"
 #include "keyboard.h"
 
@@ -15,8 +19,17 @@ static volatile unsigned char g_qtail = 0;
 // Prefijo E0 pendiente
 static volatile unsigned char g_e0 = 0;
 
+// Foto por tick (grabar/reproducir): con g_frozen las consultas no ven el teclado vivo
+static int g_frozen = 0;
+static unsigned char g_fkeys[KB_SNAPSHOT_BYTES];
+static int g_fq[KB_QSIZE];
+static int g_fq_len = 0;
+static int g_fq_pos = 0;
+
+#if !PLATFORM_HOST
 // Vector anterior de INT 9
 static void (interrupt far *old_int9)();
+#endif
 
 static void kb_qpush(int k)
 {
@@ -27,23 +40,41 @@ static void kb_qpush(int k)
     }
 }
 
+static int kb_live_poll(void)
+{
+    int k;
+    if (g_qhead == g_qtail) return IN_KEY_NONE;
+    k = g_q[g_qtail];
+    g_qtail = (unsigned char)((g_qtail + 1) & (KB_QSIZE - 1));
+    return k;
+}
+
 int kb_keyhit(void)
 {
+    if (g_frozen) return g_fq_pos < g_fq_len;
     return g_qhead != g_qtail;
 }
 
 int kb_poll(void)
 {
-    int k;
-    if (g_qhead == g_qtail) return IN_KEY_NONE;
-    k = g_q[g_qtail];
-    g_qtail = (unsigned char)((g_qtail + 1) & (KB_QSIZE - 1));
-    return k;
+    if (g_frozen) {
+        if (g_fq_pos >= g_fq_len) return IN_KEY_NONE;
+        return g_fq[g_fq_pos++];
+    }
+    return kb_live_poll();
 }
 
 int kb_any_down(void)
 {
     int i;
+    if (g_frozen) {
+        for (i = 0; i < KB_SNAPSHOT_BYTES; ++i) {
+            if (g_fkeys[i]) {
+                return 1;
+            }
+        }
+        return 0;
+    }
     for (i = 0; i < 128; ++i) {
         if (g_keys[i]) {
             return 1;
@@ -55,9 +86,70 @@ int kb_any_down(void)
 int kb_down(unsigned char sc)
 {
     if (sc >= 128) return 0;
+    if (g_frozen) return (g_fkeys[sc >> 3] >> (sc & 7)) & 1;
     return g_keys[sc] != 0;
 }
 
+void kb_freeze(int on)
+{
+    g_frozen = on;
+}
+
+int kb_snapshot_take(unsigned char *keys, int *events, int max_events)
+{
+    int i;
+    int n = 0;
+    int k;
+
+    for (i = 0; i < KB_SNAPSHOT_BYTES; ++i) {
+        g_fkeys[i] = 0;
+    }
+    for (i = 0; i < 128; ++i) {
+        if (g_keys[i]) {
+            g_fkeys[i >> 3] |= (unsigned char)(1 << (i & 7));
+        }
+    }
+
+    // La cola viva pasa entera a la foto; lo que no quepa se pierde igual al reproducir
+    g_fq_len = 0;
+    g_fq_pos = 0;
+    while ((k = kb_live_poll()) != IN_KEY_NONE) {
+        if (g_fq_len < KB_QSIZE && n < max_events) {
+            g_fq[g_fq_len++] = k;
+            if (events) events[n] = k;
+            ++n;
+        }
+    }
+
+    if (keys) {
+        for (i = 0; i < KB_SNAPSHOT_BYTES; ++i) {
+            keys[i] = g_fkeys[i];
+        }
+    }
+    return n;
+}
+
+void kb_snapshot_set(const unsigned char *keys, const int *events, int count)
+{
+    int i;
+
+    for (i = 0; i < KB_SNAPSHOT_BYTES; ++i) {
+        g_fkeys[i] = keys ? keys[i] : 0;
+    }
+    g_fq_len = 0;
+    g_fq_pos = 0;
+    for (i = 0; i < count && i < KB_QSIZE; ++i) {
+        g_fq[g_fq_len++] = events[i];
+    }
+}
+
+void kb_snapshot_press(unsigned char *keys, unsigned char sc)
+{
+    if (keys && sc < 128) {
+        keys[sc >> 3] |= (unsigned char)(1 << (sc & 7));
+    }
+}
+
 // Traduce scancode a tecla lógica para menús
 static int kb_translate_make(unsigned char sc, unsigned char e0)
 {
@@ -83,20 +175,12 @@ static int kb_translate_make(unsigned char sc, unsigned char e0)
     return IN_KEY_NONE;
 }
 
-static void interrupt far kb_int9()
+// Un byte del controlador de teclado: prefijo E0, make o break
+static void kb_feed(unsigned char sc)
 {
-    unsigned char sc = inp(0x60);
-
     // Prefijo E0
     if (sc == 0xE0) {
         g_e0 = 1;
-        // OJO: ACK + EOI siempre para no bloquear el teclado
-        {
-            unsigned char a = inp(0x61);
-            outp(0x61, (unsigned char)(a | 0x80));
-            outp(0x61, a);
-        }
-        outp(0x20, 0x20);
         return;
     }
 
@@ -113,18 +197,34 @@ static void interrupt far kb_int9()
             int k = kb_translate_make(code, e0);
             if (k != IN_KEY_NONE) kb_qpush(k);
         }
+    }
+}
 
-        // ACK teclado
-        {
-            unsigned char a = inp(0x61);
-            outp(0x61, (unsigned char)(a | 0x80));
-            outp(0x61, a);
-        }
+void kb_inject(unsigned char sc, int down)
+{
+    // Las flechas llegan como extendidas, igual que desde el teclado
+    if (sc == SC_UP || sc == SC_DOWN || sc == SC_LEFT || sc == SC_RIGHT) {
+        kb_feed(0xE0);
+    }
+    kb_feed((unsigned char)(down ? (sc & 0x7F) : (sc | 0x80)));
+}
 
-        // EOI PIC
-        outp(0x20, 0x20);
+#if !PLATFORM_HOST
+static void interrupt far kb_int9()
+{
+    kb_feed(inp(0x60));
+
+    // OJO: ACK + EOI siempre para no bloquear el teclado
+    {
+        unsigned char a = inp(0x61);
+        outp(0x61, (unsigned char)(a | 0x80));
+        outp(0x61, a);
     }
+
+    // EOI PIC
+    outp(0x20, 0x20);
 }
+#endif
 
 void kb_init(void)
 {
@@ -132,12 +232,17 @@ void kb_init(void)
     for (i = 0; i < 128; ++i) g_keys[i] = 0;
     g_qhead = g_qtail = 0;
     g_e0 = 0;
+    g_frozen = 0;
 
+#if !PLATFORM_HOST
     old_int9 = _dos_getvect(0x09);
     _dos_setvect(0x09, kb_int9);
+#endif
 }
 
 void kb_shutdown(void)
 {
+#if !PLATFORM_HOST
     if (old_int9) _dos_setvect(0x09, old_int9);
+#endif
 }
@@ -15,6 +15,19 @@ int kb_keyhit(void);
 int kb_poll(void);
 int kb_any_down(void);
 
+// Mete una pulsación como si viniera del teclado (runner, repeticiones)
+void kb_inject(unsigned char sc, int down);
+
+// Foto por tick para grabar y reproducir: teclas como bitset de 128 bits + eventos de la cola.
+// Con kb_freeze(1), kb_down/kb_poll/kb_keyhit sólo ven la última foto.
+#define KB_SNAPSHOT_BYTES 16
+void kb_freeze(int on);
+// Vivo -> foto (vacía la cola viva); devuelve cuántos eventos copia en events
+int kb_snapshot_take(unsigned char *keys, int *events, int max_events);
+void kb_snapshot_set(const unsigned char *keys, const int *events, int count);
+// Marca una tecla en una foto (la demo arma así las teclas de la IA)
+void kb_snapshot_press(unsigned char *keys, unsigned char sc);
+
 /* -------------------------------------------------------------------------
    SCANCODES SET 1
    ------------------------------------------------------------------------- */
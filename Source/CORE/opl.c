@@ -0,0 +1,199 @@
+#include "opl.h"
+
+#include "platform.h"
+
+#include <stdio.h>
+
+#if !PLATFORM_HOST
+#include <conio.h>
+#endif
+
+#define OPL_PORT_ADDR 0x388
+#define OPL_PORT_DATA 0x389
+#define OPL_FREQ 49716UL
+
+// Modulador de cada canal; la portadora está 3 más allá
+static const unsigned char g_op_offset[OPL_CHANNELS] = {0x00, 0x01, 0x02, 0x08, 0x09, 0x0A, 0x10, 0x11, 0x12};
+
+static FILE *g_log = NULL;
+static int g_log_pending = 0;
+static unsigned char g_log_reg = 0;
+static unsigned char g_log_value = 0;
+static unsigned long g_log_wait = 0;
+
+static void opl_log_flush(void)
+{
+    unsigned long wait = g_log_wait;
+
+    if (!g_log_pending) {
+        return;
+    }
+    // Esperas más largas que 16 bits: registros de relleno sobre 0x00, que no hace nada
+    while (wait > 0xFFFFUL) {
+        fputc(g_log_reg, g_log);
+        fputc(g_log_value, g_log);
+        fputc(0xFF, g_log);
+        fputc(0xFF, g_log);
+        wait -= 0xFFFFUL;
+        g_log_reg = 0x00;
+        g_log_value = 0x00;
+    }
+    fputc(g_log_reg, g_log);
+    fputc(g_log_value, g_log);
+    fputc((int)(wait & 0xFF), g_log);
+    fputc((int)((wait >> 8) & 0xFF), g_log);
+    g_log_pending = 0;
+}
+
+int opl_log_open(const char *path)
+{
+#if PLATFORM_HOST
+    opl_log_close();
+    if (!path || !path[0]) {
+        return 0;
+    }
+    g_log = fopen(path, "wb");
+    g_log_pending = 0;
+    g_log_wait = 0;
+    return g_log != NULL;
+#else
+    (void)path;
+    return 0;
+#endif
+}
+
+void opl_log_close(void)
+{
+    if (!g_log) {
+        return;
+    }
+    g_log_wait = 0;
+    opl_log_flush();
+    fclose(g_log);
+    g_log = NULL;
+}
+
+void opl_log_tick(void)
+{
+    if (g_log && g_log_pending) {
+        g_log_wait++;
+    }
+}
+
+void opl_write(unsigned char reg, unsigned char value)
+{
+#if !PLATFORM_HOST
+    int i;
+
+    // OJO: la tarjeta pide 3.3 us tras el registro y 23 us tras el dato;
+    // cada lectura del puerto de estado tarda ~0.84 us en el bus ISA
+    outp(OPL_PORT_ADDR, reg);
+    for (i = 0; i < 6; ++i) {
+        inp(OPL_PORT_ADDR);
+    }
+    outp(OPL_PORT_DATA, value);
+    for (i = 0; i < 35; ++i) {
+        inp(OPL_PORT_ADDR);
+    }
+#endif
+    if (g_log) {
+        opl_log_flush();
+        g_log_pending = 1;
+        g_log_reg = reg;
+        g_log_value = value;
+        g_log_wait = 0;
+    }
+}
+
+// Detección clásica con el timer 1 de la tarjeta
+int opl_detect(void)
+{
+#if PLATFORM_HOST
+    return 0;
+#else
+    unsigned char status1;
+    unsigned char status2;
+    int i;
+
+    opl_write(0x04, 0x60);
+    opl_write(0x04, 0x80);
+    status1 = (unsigned char)inp(OPL_PORT_ADDR);
+    opl_write(0x02, 0xFF);
+    opl_write(0x04, 0x21);
+    // >80 us para que el timer desborde
+    for (i = 0; i < 200; ++i) {
+        inp(OPL_PORT_ADDR);
+    }
+    status2 = (unsigned char)inp(OPL_PORT_ADDR);
+    opl_write(0x04, 0x60);
+    opl_write(0x04, 0x80);
+    return (status1 & 0xE0) == 0x00 && (status2 & 0xE0) == 0xC0;
+#endif
+}
+
+void opl_reset(void)
+{
+    int reg;
+
+    for (reg = 0x01; reg <= 0xF5; ++reg) {
+        opl_write((unsigned char)reg, 0);
+    }
+    opl_write(0x01, 0x20); // Formas de onda
+}
+
+void opl_set_patch(int channel, const OplPatch *patch)
+{
+    unsigned char op = g_op_offset[channel];
+
+    opl_write((unsigned char)(0x20 + op), patch->mod_char);
+    opl_write((unsigned char)(0x23 + op), patch->car_char);
+    opl_write((unsigned char)(0x40 + op), patch->mod_level);
+    opl_write((unsigned char)(0x43 + op), patch->car_level);
+    opl_write((unsigned char)(0x60 + op), patch->mod_ad);
+    opl_write((unsigned char)(0x63 + op), patch->car_ad);
+    opl_write((unsigned char)(0x80 + op), patch->mod_sr);
+    opl_write((unsigned char)(0x83 + op), patch->car_sr);
+    opl_write((unsigned char)(0xE0 + op), patch->mod_wave);
+    opl_write((unsigned char)(0xE3 + op), patch->car_wave);
+    opl_write((unsigned char)(0xC0 + channel), patch->fb_conn);
+}
+
+void opl_note_on(int channel, unsigned int fnum_block)
+{
+    opl_write((unsigned char)(0xA0 + channel), (unsigned char)(fnum_block & 0xFF));
+    opl_write((unsigned char)(0xB0 + channel), (unsigned char)(0x20 | ((fnum_block >> 8) & 0x1F)));
+}
+
+// Con el mismo fnum/bloque para que la cola de la nota no cambie de tono
+void opl_note_off(int channel, unsigned int fnum_block)
+{
+    opl_write((unsigned char)(0xB0 + channel), (unsigned char)((fnum_block >> 8) & 0x1F));
+}
+
+// freq = fnum * 49716 / 2^(20 - bloque): el bloque más bajo en el que cabe
+unsigned int opl_fnum_block(unsigned int freq)
+{
+    unsigned long fnum;
+    unsigned int block;
+
+    if (freq == 0) {
+        return 0;
+    }
+    // OJO: freq << (20 - bloque) tiene que caber en 32 bits
+    for (block = 0; block < 7; ++block) {
+        if ((unsigned long)freq < (1UL << (12 + block))) {
+            fnum = (((unsigned long)freq << (20 - block)) + OPL_FREQ / 2) / OPL_FREQ;
+            if (fnum < 1024UL) {
+                break;
+            }
+        }
+    }
+    fnum = (((unsigned long)freq << (20 - block)) + OPL_FREQ / 2) / OPL_FREQ;
+    if (fnum > 1023UL) {
+        fnum = 1023UL;
+    }
+    if (fnum == 0) {
+        fnum = 1;
+    }
+    return (unsigned int)(fnum | ((unsigned long)block << 10));
+}
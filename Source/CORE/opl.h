@@ -0,0 +1,41 @@
+#ifndef OPL_H
+#define OPL_H
+
+// OPL2 (AdLib) en 0x388: registros y detección. La música y los efectos los
+// lleva CORE/sound.c con SOUND_BACKEND_OPL2.
+#define OPL_CHANNELS 9
+
+// Instrumento: registros de modulador y portadora, como en un .SBI
+typedef struct {
+    unsigned char mod_char; // 0x20: AM/VIB/EG/KSR/MULT
+    unsigned char car_char;
+    unsigned char mod_level; // 0x40: KSL/TL
+    unsigned char car_level;
+    unsigned char mod_ad; // 0x60
+    unsigned char car_ad;
+    unsigned char mod_sr; // 0x80
+    unsigned char car_sr;
+    unsigned char mod_wave; // 0xE0
+    unsigned char car_wave;
+    unsigned char fb_conn; // 0xC0
+} OplPatch;
+
+int opl_detect(void);
+// Todo a cero, forma de onda habilitada y canales en silencio
+void opl_reset(void);
+void opl_write(unsigned char reg, unsigned char value);
+void opl_set_patch(int channel, const OplPatch *patch);
+// fnum_block: fnum en los 10 bits bajos y bloque en los 3 siguientes (0 = silencio)
+void opl_note_on(int channel, unsigned int fnum_block);
+void opl_note_off(int channel, unsigned int fnum_block);
+unsigned int opl_fnum_block(unsigned int freq);
+
+// Registro de escrituras en formato IMF (tipo 0): registro, valor y espera en
+// ms hasta la siguiente, 16 bits little endian. Sólo en host: en DOS las
+// escrituras salen de la ISR.
+int opl_log_open(const char *path);
+void opl_log_close(void);
+// Un ms más para la espera de la última escritura
+void opl_log_tick(void);
+
+#endif
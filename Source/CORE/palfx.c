@@ -0,0 +1,375 @@
+#include "palfx.h"
+
+#include "timer.h"
+#include "video.h"
+
+#include <string.h>
+
+#define PAL_FX_LEVEL_FULL 256
+#define PAL_FX_DAC_PER_VBLANK 96 // OJO: en tarjetas ISA lentas 256 entradas no caben en un retrace
+
+typedef enum {
+    PAL_FADE_NONE = 0,
+    PAL_FADE_OUT,
+    PAL_FADE_IN,
+    PAL_FADE_CROSS
+} PalFadeKind;
+
+typedef struct {
+    int active;
+    int first;
+    int count;
+    int direction;
+    int offset;
+    unsigned int step_ms;
+    unsigned long next_ms;
+} PalCycle;
+
+typedef struct {
+    int active;
+    int index;
+    unsigned char rgb[3];
+    unsigned long end_ms;
+} PalFlash;
+
+static unsigned char g_shown[256 * 3];   // Lo que tiene el DAC ahora mismo
+static unsigned char g_want[256 * 3];    // Lo que debería tener
+static unsigned char g_cross_from[256 * 3];
+static unsigned char g_cross_to[256 * 3];
+static int g_shown_valid = 0;
+static int g_pending = 0;
+static int g_force = 0;
+static int g_cursor = 0;
+
+static PalFadeKind g_fade = PAL_FADE_NONE;
+static unsigned long g_fade_start = 0;
+static unsigned long g_fade_ms = 0;
+static int g_level = PAL_FX_LEVEL_FULL; // Se mantiene tras un fundido a negro
+
+static PalCycle g_cycles[PAL_FX_MAX_CYCLES];
+static PalFlash g_flashes[PAL_FX_MAX_FLASHES];
+
+static void pal_fx_sync_shown(void)
+{
+    if (!g_shown_valid) {
+        memcpy(g_shown, v_palette_ptr(), sizeof(g_shown));
+        g_shown_valid = 1;
+    }
+}
+
+static int pal_fx_any_active(void)
+{
+    int i;
+
+    if (g_fade != PAL_FADE_NONE || g_level != PAL_FX_LEVEL_FULL || g_pending || g_force) {
+        return 1;
+    }
+    for (i = 0; i < PAL_FX_MAX_CYCLES; ++i) {
+        if (g_cycles[i].active) {
+            return 1;
+        }
+    }
+    for (i = 0; i < PAL_FX_MAX_FLASHES; ++i) {
+        if (g_flashes[i].active) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void pal_fx_start_fade(PalFadeKind kind, unsigned int duration_ms)
+{
+    pal_fx_sync_shown();
+    g_fade = kind;
+    g_fade_start = t_now_ms();
+    g_fade_ms = duration_ms ? duration_ms : 1;
+    g_force = 1;
+}
+
+void pal_fx_fade_to_black(unsigned int duration_ms)
+{
+    pal_fx_start_fade(PAL_FADE_OUT, duration_ms);
+}
+
+void pal_fx_fade_from_black(unsigned int duration_ms)
+{
+    g_level = 0;
+    pal_fx_start_fade(PAL_FADE_IN, duration_ms);
+}
+
+void pal_fx_crossfade(const unsigned char *to_rgb, unsigned int duration_ms)
+{
+    if (!to_rgb) {
+        return;
+    }
+
+    pal_fx_sync_shown();
+    // Parte de lo que se ve, así enlaza con un fundido a medias
+    memcpy(g_cross_from, g_shown, sizeof(g_cross_from));
+    memcpy(g_cross_to, to_rgb, sizeof(g_cross_to));
+    g_level = PAL_FX_LEVEL_FULL;
+    pal_fx_start_fade(PAL_FADE_CROSS, duration_ms);
+}
+
+int pal_fx_cycle_add(int first, int count, unsigned int step_ms, int direction)
+{
+    int i;
+
+    if (first < 0 || count < 2 || first + count > 256) {
+        return -1;
+    }
+
+    for (i = 0; i < PAL_FX_MAX_CYCLES; ++i) {
+        if (!g_cycles[i].active) {
+            pal_fx_sync_shown();
+            g_cycles[i].active = 1;
+            g_cycles[i].first = first;
+            g_cycles[i].count = count;
+            g_cycles[i].direction = direction < 0 ? -1 : 1;
+            g_cycles[i].offset = 0;
+            g_cycles[i].step_ms = step_ms ? step_ms : 1;
+            g_cycles[i].next_ms = t_now_ms() + g_cycles[i].step_ms;
+            g_force = 1;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void pal_fx_cycle_clear(void)
+{
+    int i;
+
+    for (i = 0; i < PAL_FX_MAX_CYCLES; ++i) {
+        g_cycles[i].active = 0;
+    }
+    g_force = 1;
+}
+
+void pal_fx_flash(int index, unsigned char r, unsigned char g, unsigned char b, unsigned int duration_ms)
+{
+    int i;
+    int slot = 0;
+    unsigned long now;
+
+    if (index < 0 || index > 255) {
+        return;
+    }
+
+    // Reutiliza el hueco del mismo índice o el que antes acabe
+    for (i = 0; i < PAL_FX_MAX_FLASHES; ++i) {
+        if (g_flashes[i].active && g_flashes[i].index == index) {
+            slot = i;
+            break;
+        }
+        if (!g_flashes[i].active) {
+            slot = i;
+        } else if (g_flashes[slot].active && g_flashes[i].end_ms < g_flashes[slot].end_ms) {
+            slot = i;
+        }
+    }
+
+    pal_fx_sync_shown();
+    now = t_now_ms();
+    g_flashes[slot].active = 1;
+    g_flashes[slot].index = index;
+    g_flashes[slot].rgb[0] = r;
+    g_flashes[slot].rgb[1] = g;
+    g_flashes[slot].rgb[2] = b;
+    g_flashes[slot].end_ms = now + duration_ms;
+    g_force = 1;
+}
+
+int pal_fx_busy(void)
+{
+    return g_fade != PAL_FADE_NONE;
+}
+
+void pal_fx_stop(void)
+{
+    int i;
+
+    g_fade = PAL_FADE_NONE;
+    g_level = PAL_FX_LEVEL_FULL;
+    for (i = 0; i < PAL_FX_MAX_CYCLES; ++i) {
+        g_cycles[i].active = 0;
+    }
+    for (i = 0; i < PAL_FX_MAX_FLASHES; ++i) {
+        g_flashes[i].active = 0;
+    }
+    g_force = 1;
+}
+
+static int pal_fx_step_time(unsigned long now)
+{
+    int changed = 0;
+    int i;
+
+    if (g_fade != PAL_FADE_NONE) {
+        unsigned long elapsed = now - g_fade_start;
+        int p = (elapsed >= g_fade_ms) ? PAL_FX_LEVEL_FULL
+                                       : (int)((elapsed * PAL_FX_LEVEL_FULL) / g_fade_ms);
+
+        switch (g_fade) {
+        case PAL_FADE_OUT:
+            g_level = PAL_FX_LEVEL_FULL - p;
+            break;
+        case PAL_FADE_IN:
+            g_level = p;
+            break;
+        case PAL_FADE_CROSS:
+        default:
+            g_level = p;
+            break;
+        }
+        if (p >= PAL_FX_LEVEL_FULL) {
+            if (g_fade == PAL_FADE_CROSS) {
+                g_fade = PAL_FADE_NONE;
+                g_level = PAL_FX_LEVEL_FULL;
+                // La paleta destino pasa a ser la lógica
+                v_set_palette_raw(g_cross_to, 256);
+            } else {
+                g_fade = PAL_FADE_NONE;
+            }
+        }
+        changed = 1;
+    }
+
+    for (i = 0; i < PAL_FX_MAX_CYCLES; ++i) {
+        PalCycle *c = &g_cycles[i];
+        while (c->active && (long)(now - c->next_ms) >= 0) {
+            c->offset += c->direction;
+            if (c->offset < 0) {
+                c->offset += c->count;
+            } else if (c->offset >= c->count) {
+                c->offset -= c->count;
+            }
+            c->next_ms += c->step_ms;
+            changed = 1;
+        }
+    }
+
+    for (i = 0; i < PAL_FX_MAX_FLASHES; ++i) {
+        if (g_flashes[i].active && (long)(now - g_flashes[i].end_ms) >= 0) {
+            g_flashes[i].active = 0;
+            changed = 1;
+        }
+    }
+
+    return changed;
+}
+
+static void pal_fx_compute(void)
+{
+    static unsigned char src[256 * 3];
+    const unsigned char *logical = v_palette_ptr();
+    int i;
+
+    if (g_fade == PAL_FADE_CROSS) {
+        for (i = 0; i < 256 * 3; ++i) {
+            int from = g_cross_from[i];
+            src[i] = (unsigned char)(from + (((int)g_cross_to[i] - from) * g_level) / PAL_FX_LEVEL_FULL);
+        }
+    } else if (g_level >= PAL_FX_LEVEL_FULL) {
+        memcpy(src, logical, sizeof(src));
+    } else {
+        for (i = 0; i < 256 * 3; ++i) {
+            src[i] = (unsigned char)(((unsigned int)logical[i] * (unsigned int)g_level) >> 8);
+        }
+    }
+
+    memcpy(g_want, src, sizeof(g_want));
+
+    for (i = 0; i < PAL_FX_MAX_CYCLES; ++i) {
+        const PalCycle *c = &g_cycles[i];
+        int k;
+
+        if (!c->active || c->offset == 0) {
+            continue;
+        }
+        for (k = 0; k < c->count; ++k) {
+            int from = c->first + ((k + c->offset) % c->count);
+            memcpy(g_want + (c->first + k) * 3, src + from * 3, 3);
+        }
+    }
+
+    for (i = 0; i < PAL_FX_MAX_FLASHES; ++i) {
+        if (g_flashes[i].active) {
+            memcpy(g_want + g_flashes[i].index * 3, g_flashes[i].rgb, 3);
+        }
+    }
+}
+
+// Vuelca al DAC como mucho PAL_FX_DAC_PER_VBLANK entradas, el resto en el siguiente retrace
+static void pal_fx_flush(void)
+{
+    int budget = PAL_FX_DAC_PER_VBLANK;
+    int scanned = 0;
+    int idx = g_cursor;
+
+    g_pending = 0;
+    while (scanned < 256) {
+        int first;
+        int n = 0;
+
+        if (memcmp(g_shown + idx * 3, g_want + idx * 3, 3) == 0) {
+            idx = (idx + 1) & 0xFF;
+            ++scanned;
+            continue;
+        }
+
+        if (budget == 0) {
+            g_pending = 1;
+            break;
+        }
+
+        first = idx;
+        while (scanned < 256 && idx >= first && n < budget &&
+               memcmp(g_shown + idx * 3, g_want + idx * 3, 3) != 0) {
+            ++n;
+            ++idx;
+            ++scanned;
+            if (idx == 256) {
+                break;
+            }
+        }
+        idx &= 0xFF;
+
+        v_dac_write(first, n, g_want + first * 3);
+        memcpy(g_shown + first * 3, g_want + first * 3, n * 3);
+        budget -= n;
+    }
+
+    g_cursor = idx;
+}
+
+void pal_fx_update(void)
+{
+    unsigned long now;
+
+    if (!pal_fx_any_active()) {
+        return;
+    }
+
+    pal_fx_sync_shown();
+    now = t_now_ms();
+    if (pal_fx_step_time(now) || g_force) {
+        g_force = 0;
+        pal_fx_compute();
+    }
+    pal_fx_flush();
+}
+
+int pal_fx_palette_changed(void)
+{
+    if (!pal_fx_any_active()) {
+        // Sin efectos el DAC quedará igual que la paleta lógica
+        g_shown_valid = 0;
+        return 0;
+    }
+
+    // Con efectos activos el DAC lo escribe pal_fx_update
+    g_force = 1;
+    return 1;
+}
@@ -0,0 +1,24 @@
+#ifndef PALFX_H
+#define PALFX_H
+
+// Efectos de paleta: todo se hace tocando el DAC, sin repintar píxeles.
+// Se calculan sobre la paleta lógica de video.c y se aplican en v_present().
+
+#define PAL_FX_MAX_CYCLES 4
+#define PAL_FX_MAX_FLASHES 4
+
+void pal_fx_fade_to_black(unsigned int duration_ms);
+void pal_fx_fade_from_black(unsigned int duration_ms);
+void pal_fx_crossfade(const unsigned char *to_rgb, unsigned int duration_ms);
+int pal_fx_cycle_add(int first, int count, unsigned int step_ms, int direction);
+void pal_fx_cycle_clear(void);
+void pal_fx_flash(int index, unsigned char r, unsigned char g, unsigned char b, unsigned int duration_ms);
+int pal_fx_busy(void);
+void pal_fx_stop(void);
+
+// Llamadas desde video.c
+void pal_fx_update(void);
+// Devuelve 1 si el motor se encarga del DAC (hay efectos activos)
+int pal_fx_palette_changed(void);
+
+#endif
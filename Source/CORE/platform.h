@@ -0,0 +1,27 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// Build DOS (Open Watcom) o build de host para probar sin hardware.
+// En host no hay memoria segmentada: far desaparece y las _f* son las normales.
+#ifndef PLATFORM_HOST
+#if defined(__WATCOMC__) || defined(__TURBOC__)
+#define PLATFORM_HOST 0
+#else
+#define PLATFORM_HOST 1
+#endif
+#endif
+
+#if PLATFORM_HOST
+#include <stdlib.h>
+#include <string.h>
+
+#define far
+#define _fmalloc malloc
+#define _ffree free
+#define _fmemcpy memcpy
+#define _fmemset memset
+#define _fmemmove memmove
+#define _fmemcmp memcmp
+#endif
+
+#endif
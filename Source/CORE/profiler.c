@@ -0,0 +1,350 @@
+#include "profiler.h"
+
+#if USE_PROFILER
+
+#include "frame.h"
+#include "timer.h"
+#include "video.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define PROF_MAX_SESSIONS 12
+#define PROF_NAME_MAX 12
+#define PROF_STACK 4
+// Frames que resume cada refresco del overlay
+#define PROF_WINDOW 32
+// Histograma de tiempo de frame en ms; el último cubo es "eso o más"
+#define PROF_HIST_BUCKETS 41
+#define PROF_BAR_MAX 40
+
+// Estadísticas de frame completo van detrás de las fases
+#define PROF_FRAME PROF_PHASES
+#define PROF_STATS (PROF_PHASES + 1)
+
+#define PROF_OVERLAY_X 2
+#define PROF_OVERLAY_Y 2
+#define PROF_OVERLAY_COLS 16
+#define PROF_OVERLAY_W (PROF_OVERLAY_COLS * 8 + 4)
+// Cabecera, una línea por fase y el nivel de pintado adaptativo
+#define PROF_OVERLAY_H ((PROF_STATS + 2) * 8 + 4)
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} ProfStat;
+
+typedef struct {
+    char name[PROF_NAME_MAX];
+    unsigned long frames;
+    ProfStat stat[PROF_STATS];
+    unsigned long hist[PROF_HIST_BUCKETS];
+} ProfSession;
+
+static const char *g_phase_names[PROF_STATS] = {"ENT", "UPD", "PIN", "PRE", "SON", "DOR", "FRM"};
+static const char *g_phase_long[PROF_STATS] = {"entrada", "update", "pintar", "presentar",
+                                               "sonido", "dormir", "frame"};
+
+static ProfSession g_sessions[PROF_MAX_SESSIONS];
+static int g_session_count = 0;
+static ProfSession *g_cur = NULL;
+
+// Pila de fases abiertas: la de arriba es la que se está cobrando el tiempo
+static int g_stack[PROF_STACK];
+static int g_depth = 0;
+static uint32_t g_mark = 0;
+static uint32_t g_acc[PROF_PHASES];
+
+static int g_frame_open = 0;
+static uint32_t g_frame_t0 = 0;
+
+// Ventana en curso y la última completa (la que enseña el overlay)
+static ProfStat g_win[PROF_STATS];
+static int g_win_frames = 0;
+static ProfStat g_shown[PROF_STATS];
+static int g_shown_frames = 0;
+
+static int g_overlay = 0;
+static int g_overlay_drawn = 0;
+static Surface g_under;
+
+static void prof_stat_reset(ProfStat *s, int count)
+{
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        s[i].min = 0xFFFFFFFFUL;
+        s[i].max = 0;
+        s[i].sum = 0;
+    }
+}
+
+static void prof_stat_add(ProfStat *s, uint32_t us)
+{
+    if (us < s->min) s->min = us;
+    if (us > s->max) s->max = us;
+    s->sum += us;
+}
+
+static void prof_charge(uint32_t now)
+{
+    if (g_depth > 0) {
+        g_acc[g_stack[g_depth - 1]] += now - g_mark;
+    }
+    g_mark = now;
+}
+
+static void prof_frame_reset(void)
+{
+    memset(g_acc, 0, sizeof(g_acc));
+    g_depth = 0;
+}
+
+static void prof_frame_close(uint32_t now)
+{
+    uint32_t frame_us = now - g_frame_t0;
+    unsigned long bucket = frame_us / 1000UL;
+    int i;
+
+    prof_charge(now);
+
+    for (i = 0; i < PROF_PHASES; ++i) {
+        prof_stat_add(&g_cur->stat[i], g_acc[i]);
+        prof_stat_add(&g_win[i], g_acc[i]);
+    }
+    prof_stat_add(&g_cur->stat[PROF_FRAME], frame_us);
+    prof_stat_add(&g_win[PROF_FRAME], frame_us);
+
+    if (bucket >= PROF_HIST_BUCKETS) bucket = PROF_HIST_BUCKETS - 1;
+    g_cur->hist[bucket]++;
+    g_cur->frames++;
+
+    if (++g_win_frames >= PROF_WINDOW) {
+        memcpy(g_shown, g_win, sizeof(g_shown));
+        g_shown_frames = g_win_frames;
+        prof_stat_reset(g_win, PROF_STATS);
+        g_win_frames = 0;
+    }
+
+    memset(g_acc, 0, sizeof(g_acc));
+}
+
+void prof_session_begin(const char *name)
+{
+    int i;
+
+    prof_session_end();
+    if (!name) name = "?";
+
+    for (i = 0; i < g_session_count; ++i) {
+        if (strncmp(g_sessions[i].name, name, PROF_NAME_MAX - 1) == 0) {
+            g_cur = &g_sessions[i];
+            break;
+        }
+    }
+    if (!g_cur) {
+        if (g_session_count >= PROF_MAX_SESSIONS) {
+            return;
+        }
+        g_cur = &g_sessions[g_session_count++];
+        memset(g_cur, 0, sizeof(*g_cur));
+        strncpy(g_cur->name, name, PROF_NAME_MAX - 1);
+        prof_stat_reset(g_cur->stat, PROF_STATS);
+    }
+
+    prof_frame_reset();
+    prof_stat_reset(g_win, PROF_STATS);
+    g_win_frames = 0;
+    g_shown_frames = 0;
+    g_frame_open = 0;
+}
+
+void prof_session_end(void)
+{
+    // El frame a medias se tira: incluye el *_End y la pantalla de después
+    g_cur = NULL;
+    g_frame_open = 0;
+    prof_frame_reset();
+}
+
+void prof_frame_begin(void)
+{
+    uint32_t now;
+
+    if (!g_cur) {
+        return;
+    }
+
+    now = timer_now_us();
+    if (g_frame_open) {
+        prof_frame_close(now);
+    }
+    prof_frame_reset();
+    g_frame_t0 = now;
+    g_mark = now;
+    g_frame_open = 1;
+}
+
+void prof_frame_discard(void)
+{
+    g_frame_open = 0;
+    prof_frame_reset();
+}
+
+void prof_begin(int phase)
+{
+    if (!g_frame_open || phase < 0 || phase >= PROF_PHASES) {
+        return;
+    }
+
+    prof_charge(timer_now_us());
+    if (g_depth < PROF_STACK) {
+        g_stack[g_depth] = phase;
+    }
+    g_depth++;
+}
+
+void prof_end(int phase)
+{
+    (void)phase;
+    if (!g_frame_open || g_depth <= 0) {
+        return;
+    }
+
+    if (g_depth <= PROF_STACK) {
+        prof_charge(timer_now_us());
+    }
+    g_depth--;
+}
+
+void prof_overlay_toggle(void)
+{
+    g_overlay = !g_overlay;
+}
+
+// Número a la derecha en width columnas (sin printf en cada frame)
+static void prof_put_num(char *dst, int width, unsigned long v)
+{
+    int i;
+
+    for (i = width - 1; i >= 0; --i) {
+        dst[i] = (i == width - 1 || v) ? (char)('0' + (v % 10)) : ' ';
+        v /= 10;
+    }
+}
+
+void prof_overlay_draw(void)
+{
+    Surface *screen = v_surface_screen();
+    char line[PROF_OVERLAY_COLS + 1];
+    int i;
+
+    if (!g_overlay || !g_cur) {
+        return;
+    }
+    if (!g_under.pixels && !v_surface_alloc(&g_under, PROF_OVERLAY_W, PROF_OVERLAY_H)) {
+        g_overlay = 0;
+        return;
+    }
+
+    v_surf_blit(&g_under, 0, 0, screen, PROF_OVERLAY_X, PROF_OVERLAY_Y, PROF_OVERLAY_W, PROF_OVERLAY_H);
+    v_surf_fill_rect(screen, PROF_OVERLAY_X, PROF_OVERLAY_Y, PROF_OVERLAY_W, PROF_OVERLAY_H, 0);
+    v_surf_puts(screen, PROF_OVERLAY_X + 2, PROF_OVERLAY_Y + 2, "us  MEDIA   MAX", 14);
+
+    for (i = 0; i < PROF_STATS; ++i) {
+        unsigned long avg = 0;
+        unsigned long max = 0;
+
+        if (g_shown_frames) {
+            avg = (unsigned long)(g_shown[i].sum / (uint64_t)g_shown_frames);
+            max = (unsigned long)g_shown[i].max;
+        }
+        memset(line, ' ', PROF_OVERLAY_COLS);
+        memcpy(line, g_phase_names[i], 3);
+        prof_put_num(line + 4, 6, avg);
+        prof_put_num(line + 10, 6, max);
+        line[PROF_OVERLAY_COLS] = '\0';
+        v_surf_puts(screen, PROF_OVERLAY_X + 2, PROF_OVERLAY_Y + 2 + (i + 1) * 8, line,
+                    (unsigned char)(i == PROF_FRAME ? 15 : 7));
+    }
+
+    memset(line, ' ', PROF_OVERLAY_COLS);
+    memcpy(line, "PINTA 1/", 8);
+    line[8] = (char)('0' + frame_skip_level());
+    line[PROF_OVERLAY_COLS] = '\0';
+    v_surf_puts(screen, PROF_OVERLAY_X + 2, PROF_OVERLAY_Y + 2 + (PROF_STATS + 1) * 8, line,
+                (unsigned char)(frame_skip_level() > 1 ? 12 : 7));
+    g_overlay_drawn = 1;
+}
+
+void prof_overlay_restore(void)
+{
+    // Lo de debajo vuelve al backbuffer: el juego sigue pintando sobre lo suyo
+    if (!g_overlay_drawn) {
+        return;
+    }
+    v_surf_blit(v_surface_screen(), PROF_OVERLAY_X, PROF_OVERLAY_Y, &g_under, 0, 0, PROF_OVERLAY_W,
+                PROF_OVERLAY_H);
+    g_overlay_drawn = 0;
+}
+
+static void prof_write_session(FILE *f, const ProfSession *s)
+{
+    unsigned long peak = 0;
+    int last = 0;
+    int i;
+
+    fprintf(f, "== %s: %lu frames\n", s->name, s->frames);
+    fprintf(f, "%-10s %8s %8s %8s\n", "fase (us)", "min", "media", "max");
+    for (i = 0; i < PROF_STATS; ++i) {
+        fprintf(f, "%-10s %8lu %8lu %8lu\n", g_phase_long[i], (unsigned long)s->stat[i].min,
+                (unsigned long)(s->stat[i].sum / (uint64_t)s->frames), (unsigned long)s->stat[i].max);
+    }
+
+    for (i = 0; i < PROF_HIST_BUCKETS; ++i) {
+        if (s->hist[i] > peak) peak = s->hist[i];
+        if (s->hist[i]) last = i;
+    }
+    fprintf(f, "frame (ms)\n");
+    for (i = 0; i <= last; ++i) {
+        int bar = (int)((s->hist[i] * PROF_BAR_MAX + peak - 1) / peak);
+
+        if (i == PROF_HIST_BUCKETS - 1) {
+            fprintf(f, "%3d+   %7lu ", i, s->hist[i]);
+        } else {
+            fprintf(f, "%3d-%-2d %7lu ", i, i + 1, s->hist[i]);
+        }
+        while (bar-- > 0) {
+            putc('#', f);
+        }
+        putc('\n', f);
+    }
+    putc('\n', f);
+}
+
+int prof_write_summary(const char *path)
+{
+    FILE *f;
+    int i;
+
+    if (!path || !path[0] || g_session_count == 0) {
+        return 0;
+    }
+
+    f = fopen(path, "w");
+    if (!f) {
+        return 0;
+    }
+
+    for (i = 0; i < g_session_count; ++i) {
+        if (g_sessions[i].frames) {
+            prof_write_session(f, &g_sessions[i]);
+        }
+    }
+
+    fclose(f);
+    return 1;
+}
+
+#endif
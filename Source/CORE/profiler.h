@@ -0,0 +1,54 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Perfil por fases del bucle de juego: cuánto se va en entrada, update, pintar,
+// presentar (vsync y copia a VGA), sonido y en dormir. Cada fase cuenta sólo su
+// tiempo propio: lo de sound_update dentro de un update va a PROF_SOUND.
+// F11 en partida enseña el resumen en pantalla; SET TBPROFILE=PERFIL.TXT deja
+// al salir min/media/max e histograma de tiempo de frame por minijuego.
+
+#ifndef USE_PROFILER
+#define USE_PROFILER 1
+#endif
+
+#define PROF_INPUT 0
+#define PROF_UPDATE 1
+#define PROF_DRAW 2
+#define PROF_PRESENT 3
+#define PROF_SOUND 4
+#define PROF_IDLE 5
+#define PROF_PHASES 6
+
+#if USE_PROFILER
+// Sesión = partida de un minijuego; las de mismo nombre se acumulan
+void prof_session_begin(const char *name);
+void prof_session_end(void);
+
+// Al principio de cada vuelta del bucle; discard tira el frame abierto (menús a mitad de partida)
+void prof_frame_begin(void);
+void prof_frame_discard(void);
+void prof_begin(int phase);
+void prof_end(int phase);
+
+void prof_overlay_toggle(void);
+// Llamadas desde v_present: pinta el resumen encima del frame y después deja lo de debajo
+void prof_overlay_draw(void);
+void prof_overlay_restore(void);
+
+int prof_write_summary(const char *path);
+#else
+#define prof_session_begin(name) ((void)0)
+#define prof_session_end() ((void)0)
+#define prof_frame_begin() ((void)0)
+#define prof_frame_discard() ((void)0)
+#define prof_begin(phase) ((void)0)
+#define prof_end(phase) ((void)0)
+#define prof_overlay_toggle() ((void)0)
+#define prof_overlay_draw() ((void)0)
+#define prof_overlay_restore() ((void)0)
+#define prof_write_summary(path) ((void)(path))
+#endif
+
+#endif
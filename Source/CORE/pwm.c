@@ -0,0 +1,306 @@
+#include "pwm.h"
+
+#include "platform.h"
+#include "timer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PLATFORM_HOST
+#include <conio.h>
+#endif
+
+// 512 muestras: 64 ms a 8 kHz, cuatro ticks del juego de margen por trozo
+#define PWM_CHUNK 512
+#define PWM_SILENCE (PWM_LEVELS / 2)
+// Por debajo el periodo no cabe en la cuenta de un byte: se repiten muestras
+#define PWM_MIN_PER_MS 5
+#define PWM_PIT_FREQ 1193182UL
+
+// Dos trozos: la ISR toca uno mientras el juego llena el otro. g_chunk_len lo
+// escribe el juego al dejar un trozo lleno y la ISR lo pone a 0 al acabarlo.
+static unsigned char g_chunk[2][PWM_CHUNK];
+static volatile unsigned int g_chunk_len[2];
+// Los dos primeros trozos, leídos al cargar: así empezar a sonar no toca el disco
+static unsigned char g_head[2][PWM_CHUNK];
+static unsigned int g_head_len[2];
+static volatile unsigned char g_eof = 0;
+static volatile unsigned char g_playing = 0;
+
+// Sólo de la ISR (o de pwm_tick_ms)
+static volatile unsigned char g_cur = 0;
+static unsigned int g_pos = 0;
+static unsigned int g_frac = 0;
+
+// Sólo del juego
+static FILE *g_file = NULL;
+static unsigned long g_left = 0;
+// Lo que queda detrás de g_head y dónde empieza en el fichero
+static unsigned long g_rest_left = 0;
+static long g_rest_pos = 0;
+static int g_seek = 0;
+static int g_started = 0;
+static unsigned int g_step = 256; // Muestras del WAV por muestra sonada, 8.8
+static unsigned int g_per_ms = 0;
+static int g_hardware = 0;
+// Cuenta del PIT para cada nivel
+static unsigned char g_count[PWM_LEVELS];
+
+static unsigned long pwm_le(const unsigned char *p, int bytes)
+{
+    unsigned long v = 0;
+
+    while (bytes-- > 0) {
+        v = (v << 8) | p[bytes];
+    }
+    return v;
+}
+
+// RIFF/WAVE con fmt PCM, mono y 8 bits; deja el fichero al principio de los datos
+static int pwm_read_header(unsigned long *rate)
+{
+    unsigned char head[16];
+    int have_fmt = 0;
+
+    if (fread(head, 1, 12, g_file) != 12 || memcmp(head, "RIFF", 4) != 0 || memcmp(head + 8, "WAVE", 4) != 0) {
+        return 0;
+    }
+    while (fread(head, 1, 8, g_file) == 8) {
+        unsigned long size = pwm_le(head + 4, 4);
+
+        if (memcmp(head, "fmt ", 4) == 0) {
+            if (size < 16 || fread(head, 1, 16, g_file) != 16) {
+                return 0;
+            }
+            if (pwm_le(head, 2) != 1 || pwm_le(head + 2, 2) != 1 || pwm_le(head + 14, 2) != 8) {
+                return 0;
+            }
+            *rate = pwm_le(head + 4, 4);
+            have_fmt = 1;
+            size -= 16;
+        } else if (memcmp(head, "data", 4) == 0) {
+            g_left = size;
+            return have_fmt && *rate > 0;
+        }
+        // Los trozos van alineados a 2
+        if (fseek(g_file, (long)(size + (size & 1)), SEEK_CUR) != 0) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+static void pwm_fill(int index)
+{
+    unsigned int want = g_left < PWM_CHUNK ? (unsigned int)g_left : PWM_CHUNK;
+    unsigned int got = want ? (unsigned int)fread(g_chunk[index], 1, want, g_file) : 0;
+    unsigned int i;
+
+    for (i = 0; i < got; ++i) {
+        g_chunk[index][i] >>= 2;
+    }
+    g_left = got < want ? 0 : g_left - got;
+    if (got) {
+        g_chunk_len[index] = got;
+    }
+    if (g_left == 0) {
+        g_eof = 1;
+    }
+}
+
+// Siguiente nivel; si el trozo no ha llegado a tiempo suena el centro
+static unsigned char pwm_next_level(void)
+{
+    unsigned char level;
+
+    if (!g_playing) {
+        return PWM_SILENCE;
+    }
+    while (g_pos >= g_chunk_len[g_cur]) {
+        if (g_chunk_len[g_cur] == 0) {
+            if (g_eof) {
+                g_playing = 0;
+            }
+            return PWM_SILENCE;
+        }
+        g_pos -= g_chunk_len[g_cur];
+        g_chunk_len[g_cur] = 0;
+        g_cur ^= 1;
+    }
+    level = g_chunk[g_cur][g_pos];
+    g_frac += g_step;
+    g_pos += g_frac >> 8;
+    g_frac &= 0xFF;
+    return level;
+}
+
+// Modo 0 del canal 2: la salida baja al escribir la cuenta y sube al acabarla,
+// así que cuanto más corta la cuenta más rato arriba
+static void pwm_isr(void)
+{
+#if !PLATFORM_HOST
+    outp(0x42, g_count[pwm_next_level()]);
+#endif
+}
+
+static void pwm_speaker_begin(unsigned int divisor)
+{
+    int i;
+
+    for (i = 0; i < PWM_LEVELS; ++i) {
+        unsigned int count = (unsigned int)(((unsigned long)(PWM_LEVELS - i) * divisor) / PWM_LEVELS);
+
+        g_count[i] = (unsigned char)(count ? count : 1);
+    }
+#if !PLATFORM_HOST
+    outp(0x61, (unsigned char)(inp(0x61) | 0x03));
+    outp(0x43, 0x90); // Canal 2, sólo LSB, modo 0
+    outp(0x42, g_count[PWM_SILENCE]);
+#endif
+}
+
+static void pwm_speaker_end(void)
+{
+#if !PLATFORM_HOST
+    outp(0x43, 0xB6); // Canal 2 como lo deja sound.c: LSB+MSB, modo 3
+    outp(0x61, (unsigned char)(inp(0x61) & ~0x03));
+#endif
+}
+
+int pwm_load(const char *path)
+{
+    unsigned long rate = 0;
+
+    pwm_unload();
+    if (!path || !path[0]) {
+        return 0;
+    }
+    g_file = fopen(path, "rb");
+    if (!g_file) {
+        return 0;
+    }
+    if (!pwm_read_header(&rate)) {
+        fclose(g_file);
+        g_file = NULL;
+        return 0;
+    }
+
+    // Un WAV más rápido que el tope se salta muestras en vez de subir la IRQ0
+    g_per_ms = (unsigned int)((rate + 500UL) / 1000UL);
+    if (g_per_ms < PWM_MIN_PER_MS) {
+        g_per_ms = PWM_MIN_PER_MS;
+    } else if (g_per_ms > PWM_MAX_PER_MS) {
+        g_per_ms = PWM_MAX_PER_MS;
+    }
+    g_step = (unsigned int)((rate * 256UL) / ((unsigned long)g_per_ms * 1000UL));
+
+    g_chunk_len[0] = 0;
+    g_chunk_len[1] = 0;
+    g_eof = 0;
+    pwm_fill(0);
+    if (!g_eof) {
+        pwm_fill(1);
+    }
+    memcpy(g_head, g_chunk, sizeof(g_head));
+    g_head_len[0] = g_chunk_len[0];
+    g_head_len[1] = g_chunk_len[1];
+    g_rest_left = g_left;
+    g_rest_pos = ftell(g_file);
+    return 1;
+}
+
+void pwm_unload(void)
+{
+    pwm_stop();
+    if (g_file) {
+        fclose(g_file);
+        g_file = NULL;
+    }
+}
+
+int pwm_play(int hardware)
+{
+    if (!g_file) {
+        return 0;
+    }
+    pwm_stop();
+
+    memcpy(g_chunk, g_head, sizeof(g_chunk));
+    g_chunk_len[0] = g_head_len[0];
+    g_chunk_len[1] = g_head_len[1];
+    g_left = g_rest_left;
+    g_eof = g_left == 0;
+    // El resto se busca en el fichero en el primer pwm_refill()
+    g_seek = !g_eof;
+    g_cur = 0;
+    g_pos = 0;
+    g_frac = 0;
+    g_playing = 1;
+    g_started = 1;
+
+    g_hardware = 0;
+    if (hardware) {
+        pwm_speaker_begin((unsigned int)(PWM_PIT_FREQ / 1000UL) / g_per_ms);
+        g_hardware = timer_fast_begin(pwm_isr, g_per_ms);
+        if (!g_hardware) {
+            pwm_speaker_end();
+        }
+    }
+    return 1;
+}
+
+void pwm_stop(void)
+{
+    g_playing = 0;
+    g_started = 0;
+    if (g_hardware) {
+        timer_fast_end();
+        pwm_speaker_end();
+        g_hardware = 0;
+    }
+}
+
+int pwm_active(void)
+{
+    return g_started;
+}
+
+void pwm_refill(void)
+{
+    if (!g_started) {
+        return;
+    }
+    if (!g_playing) {
+        pwm_stop();
+        return;
+    }
+    if (g_eof) {
+        return;
+    }
+    if (g_seek) {
+        g_seek = 0;
+        if (fseek(g_file, g_rest_pos, SEEK_SET) != 0) {
+            g_eof = 1;
+            return;
+        }
+    }
+    // Primero el que espera la ISR (si se ha quedado sin nada), luego el otro
+    if (g_chunk_len[g_cur] == 0) {
+        pwm_fill(g_cur);
+    } else if (g_chunk_len[g_cur ^ 1] == 0) {
+        pwm_fill(g_cur ^ 1);
+    }
+}
+
+int pwm_tick_ms(unsigned char *levels)
+{
+    unsigned int i;
+
+    if (!g_started || g_hardware || !g_playing) {
+        return 0;
+    }
+    for (i = 0; i < g_per_ms; ++i) {
+        levels[i] = pwm_next_level();
+    }
+    return (int)g_per_ms;
+}
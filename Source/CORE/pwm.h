@@ -0,0 +1,25 @@
+#ifndef PWM_H
+#define PWM_H
+
+// Muestras digitalizadas por el altavoz: PWM de 6 bits con el canal 2 del PIT.
+// El WAV (PCM mono de 8 bits) se abre al cargarlo y se lee del disco a trozos
+// mientras suena. Lo usa CORE/sound.c (sound_load_sample, sound_play_sample).
+#define PWM_LEVELS 64
+// Tope de muestras por ms: una IRQ0 por muestra
+#define PWM_MAX_PER_MS 8
+
+// Abre el WAV y lee sus dos primeros trozos; el fichero queda abierto hasta pwm_unload()
+int pwm_load(const char *path);
+void pwm_unload(void);
+// La cargada desde el principio, sin tocar el disco. hardware: 1 lo saca una IRQ0
+// rápida por el altavoz; 0 avanza con pwm_tick_ms()
+int pwm_play(int hardware);
+void pwm_stop(void);
+int pwm_active(void);
+// Desde el juego, nunca desde la ISR: lee el siguiente trozo (uno como mucho)
+// y recoge la muestra cuando ha acabado
+void pwm_refill(void);
+// Sin hardware: los niveles (0..PWM_LEVELS-1) de 1 ms; devuelve cuántos (0 = nada)
+int pwm_tick_ms(unsigned char *levels);
+
+#endif
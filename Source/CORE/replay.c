@@ -0,0 +1,422 @@
+#include "replay.h"
+
+#include "input.h"
+#include "keyboard.h"
+#include "options.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define REC_MAGIC "TBRP"
+#define REC_VERSION 3 // 3: lo elegido en el menú de continuar va en la grabación
+
+// Cada tick empieza con un byte: 0x80|n son n+1 ticks sin cambios;
+// si no, banderas de lo que viene detrás
+#define REC_IDLE 0x80
+#define REC_IDLE_MAX 128
+#define REC_SESSION 0x40 // id de juego (16 bits) + semilla (32 bits)
+#define REC_MENU 0x20    // menú de continuar antes del tick: REC_MENU_*
+#define REC_KEYS 0x01    // n + scancodes que cambian de estado
+#define REC_EVENTS 0x02  // n + eventos de la cola
+#define REC_JOY 0x04     // byte con disponible, dirección y botones
+
+#define REC_MAX_EVENTS 32
+
+#define REC_MENU_CONTINUE 0
+#define REC_MENU_QUIT 1
+
+static FILE *g_rec = NULL;
+static int g_mode = REC_OFF;
+static int g_in_session = 0;
+static unsigned char g_keys[KB_SNAPSHOT_BYTES];
+static unsigned char g_joy = 0;
+static unsigned int g_idle = 0;
+static int g_end = REC_TICK_OK;
+// Cabecera de la siguiente partida ya leída por rec_session_peek()
+static int g_next_ready = 0;
+static unsigned int g_next_id = 0;
+static uint32_t g_next_seed = 0;
+
+static void rec_put16(unsigned int v)
+{
+    putc(v & 0xFF, g_rec);
+    putc((v >> 8) & 0xFF, g_rec);
+}
+
+static void rec_put32(uint32_t v)
+{
+    rec_put16((unsigned int)(v & 0xFFFFUL));
+    rec_put16((unsigned int)(v >> 16));
+}
+
+static int rec_get16(unsigned int *v)
+{
+    int lo = getc(g_rec);
+    int hi = getc(g_rec);
+
+    if (lo == EOF || hi == EOF) return 0;
+    *v = (unsigned int)lo | ((unsigned int)hi << 8);
+    return 1;
+}
+
+static int rec_get32(uint32_t *v)
+{
+    unsigned int lo;
+    unsigned int hi;
+
+    if (!rec_get16(&lo) || !rec_get16(&hi)) return 0;
+    *v = (uint32_t)lo | ((uint32_t)hi << 16);
+    return 1;
+}
+
+// Joystick en un byte: bit 0 disponible, 1-2 dx+1, 3-4 dy+1, 5-6 botones
+static unsigned char rec_joy_pack(int available, int dx, int dy, unsigned char buttons)
+{
+    if (!available) return 0;
+    return (unsigned char)(1 | ((dx + 1) << 1) | ((dy + 1) << 3) | ((buttons & 3) << 5));
+}
+
+static void rec_joy_apply(unsigned char joy)
+{
+    if (!(joy & 1)) {
+        in_joystick_freeze(1, 0, 0, 0, 0);
+        return;
+    }
+    in_joystick_freeze(1, 1, ((joy >> 1) & 3) - 1, ((joy >> 3) & 3) - 1, (unsigned char)((joy >> 5) & 3));
+}
+
+static void rec_unfreeze(void)
+{
+    kb_freeze(0);
+    in_joystick_freeze(0, 0, 0, 0, 0);
+}
+
+static void rec_flush_idle(void)
+{
+    if (g_idle) {
+        putc(REC_IDLE | (g_idle - 1), g_rec);
+        g_idle = 0;
+    }
+}
+
+static unsigned char rec_joy_live(void)
+{
+    const GameOptions *options = options_get();
+    int available = 0;
+    int dx = 0;
+    int dy = 0;
+    unsigned char buttons = 0;
+
+    // El joystick sólo se lee si el juego lo va a usar: cada lectura es un bucle de puerto
+    in_joystick_freeze(0, 0, 0, 0, 0);
+    if (options && options->input_mode == INPUT_JOYSTICK && in_joystick_available()) {
+        available = in_joystick_direction(&dx, &dy, &buttons);
+    }
+    return rec_joy_pack(available, dx, dy, buttons);
+}
+
+static void rec_tick_record(void)
+{
+    unsigned char keys[KB_SNAPSHOT_BYTES];
+    unsigned char changed[128];
+    int events[REC_MAX_EVENTS];
+    int changed_count = 0;
+    int event_count;
+    unsigned char joy;
+    unsigned char flags = 0;
+    int i;
+
+    event_count = kb_snapshot_take(keys, events, REC_MAX_EVENTS);
+    joy = rec_joy_live();
+    rec_joy_apply(joy);
+
+    for (i = 0; i < 128; ++i) {
+        if (((keys[i >> 3] ^ g_keys[i >> 3]) >> (i & 7)) & 1) {
+            changed[changed_count++] = (unsigned char)i;
+        }
+    }
+
+    if (changed_count) flags |= REC_KEYS;
+    if (event_count) flags |= REC_EVENTS;
+    if (joy != g_joy) flags |= REC_JOY;
+
+    if (!flags) {
+        if (++g_idle == REC_IDLE_MAX) {
+            rec_flush_idle();
+        }
+        return;
+    }
+
+    rec_flush_idle();
+    putc(flags, g_rec);
+    if (flags & REC_KEYS) {
+        putc(changed_count, g_rec);
+        fwrite(changed, 1, (size_t)changed_count, g_rec);
+    }
+    if (flags & REC_EVENTS) {
+        putc(event_count, g_rec);
+        for (i = 0; i < event_count; ++i) {
+            putc(events[i], g_rec);
+        }
+    }
+    if (flags & REC_JOY) {
+        putc(joy, g_rec);
+    }
+
+    memcpy(g_keys, keys, sizeof(g_keys));
+    g_joy = joy;
+}
+
+// Lee un tick; con apply lo mete en el teclado/joystick. Devuelve 0 al acabar la partida
+// grabada y -1 si en ella se salió desde el menú
+static int rec_read_tick(int apply)
+{
+    int events[REC_MAX_EVENTS];
+    int event_count = 0;
+    int flags;
+    int i;
+
+    if (g_idle) {
+        --g_idle;
+        if (apply) kb_snapshot_set(g_keys, NULL, 0);
+        return 1;
+    }
+
+    flags = getc(g_rec);
+    while (flags == REC_MENU) {
+        if (getc(g_rec) != REC_MENU_CONTINUE) {
+            return -1;
+        }
+        // Al volver a la partida el menú deja la entrada limpia
+        if (apply) in_clear();
+        flags = getc(g_rec);
+    }
+    if (flags == EOF) {
+        return 0;
+    }
+    if (flags == REC_SESSION) {
+        ungetc(flags, g_rec);
+        return 0;
+    }
+
+    if (flags & REC_IDLE) {
+        g_idle = (unsigned int)(flags & 0x7F);
+        if (apply) kb_snapshot_set(g_keys, NULL, 0);
+        return 1;
+    }
+
+    if (flags & REC_KEYS) {
+        int count = getc(g_rec);
+
+        for (i = 0; i < count; ++i) {
+            int sc = getc(g_rec);
+            if (sc == EOF) return 0;
+            g_keys[(sc & 0x7F) >> 3] ^= (unsigned char)(1 << (sc & 7));
+        }
+    }
+    if (flags & REC_EVENTS) {
+        int count = getc(g_rec);
+
+        for (i = 0; i < count; ++i) {
+            int k = getc(g_rec);
+            if (k == EOF) return 0;
+            if (event_count < REC_MAX_EVENTS) events[event_count++] = k;
+        }
+    }
+    if (flags & REC_JOY) {
+        int joy = getc(g_rec);
+        if (joy == EOF) return 0;
+        g_joy = (unsigned char)joy;
+    }
+
+    if (apply) {
+        kb_snapshot_set(g_keys, events, event_count);
+        rec_joy_apply(g_joy);
+    }
+    return 1;
+}
+
+int rec_record(const char *path)
+{
+    rec_close();
+    if (!path || !path[0]) return 0;
+
+    g_rec = fopen(path, "wb");
+    if (!g_rec) return 0;
+
+    fwrite(REC_MAGIC, 1, 4, g_rec);
+    putc(REC_VERSION, g_rec);
+    g_mode = REC_RECORDING;
+    g_idle = 0;
+    g_next_ready = 0;
+    return 1;
+}
+
+int rec_replay(const char *path)
+{
+    char magic[4];
+
+    rec_close();
+    if (!path || !path[0]) return 0;
+
+    g_rec = fopen(path, "rb");
+    if (!g_rec) return 0;
+
+    if (fread(magic, 1, 4, g_rec) != 4 || memcmp(magic, REC_MAGIC, 4) != 0 || getc(g_rec) != REC_VERSION) {
+        fclose(g_rec);
+        g_rec = NULL;
+        return 0;
+    }
+
+    g_mode = REC_REPLAYING;
+    g_idle = 0;
+    g_next_ready = 0;
+    return 1;
+}
+
+void rec_close(void)
+{
+    if (g_in_session) {
+        rec_session_end();
+    }
+    if (g_rec) {
+        fclose(g_rec);
+        g_rec = NULL;
+    }
+    g_mode = REC_OFF;
+    g_end = REC_TICK_OK;
+    g_next_ready = 0;
+}
+
+int rec_active(void)
+{
+    return g_mode;
+}
+
+// Salta lo que quede de la partida en curso y lee la cabecera de la siguiente
+static int rec_read_session(void)
+{
+    if (g_next_ready) {
+        return 1;
+    }
+    while (rec_read_tick(0) > 0) {
+    }
+    g_idle = 0;
+    if (getc(g_rec) != REC_SESSION || !rec_get16(&g_next_id) || !rec_get32(&g_next_seed)) {
+        return 0;
+    }
+    g_next_ready = 1;
+    return 1;
+}
+
+int rec_session_peek(unsigned int *game_id)
+{
+    if (g_mode != REC_REPLAYING) {
+        return 0;
+    }
+    if (g_in_session) {
+        rec_session_end();
+    }
+    if (!rec_read_session()) {
+        return 0;
+    }
+    *game_id = g_next_id;
+    return 1;
+}
+
+uint32_t rec_session_begin(unsigned int game_id, uint32_t seed)
+{
+    g_end = REC_TICK_OK;
+    if (g_mode == REC_OFF) {
+        return seed;
+    }
+    if (g_in_session) {
+        rec_session_end();
+    }
+
+    memset(g_keys, 0, sizeof(g_keys));
+    g_joy = 0;
+
+    if (g_mode == REC_RECORDING) {
+        putc(REC_SESSION, g_rec);
+        rec_put16(game_id);
+        rec_put32(seed);
+    } else {
+        // Lo que quede de la partida anterior se salta
+        if (!rec_read_session() || g_next_id != game_id) {
+            // Otro juego o fin del fichero: se acaba la repetición
+            rec_close();
+            return seed;
+        }
+        g_next_ready = 0;
+        memset(g_keys, 0, sizeof(g_keys));
+        g_joy = 0;
+        seed = g_next_seed;
+    }
+
+    g_in_session = 1;
+    kb_freeze(1);
+    // El primer tick ya cuenta para lo que vea *_Init
+    rec_tick();
+    return seed;
+}
+
+void rec_session_end(void)
+{
+    if (!g_in_session) {
+        return;
+    }
+    if (g_mode == REC_RECORDING) {
+        rec_flush_idle();
+        fflush(g_rec);
+    }
+    g_in_session = 0;
+    rec_unfreeze();
+}
+
+int rec_tick(void)
+{
+    int read;
+
+    if (!g_in_session) {
+        return g_end;
+    }
+
+    if (g_mode == REC_RECORDING) {
+        rec_tick_record();
+        return REC_TICK_OK;
+    }
+
+    read = rec_read_tick(1);
+    if (read <= 0) {
+        // Fin de lo grabado: el jugador sigue en vivo, o se sale como al grabar
+        g_end = read < 0 ? REC_TICK_QUIT : REC_TICK_EARLY;
+        g_in_session = 0;
+        rec_unfreeze();
+    }
+    return g_end;
+}
+
+void rec_menu(int wants_continue)
+{
+    if (!g_in_session || g_mode != REC_RECORDING) {
+        return;
+    }
+    rec_flush_idle();
+    putc(REC_MENU, g_rec);
+    putc(wants_continue ? REC_MENU_CONTINUE : REC_MENU_QUIT, g_rec);
+}
+
+void rec_pause(int on)
+{
+    if (!g_in_session) {
+        return;
+    }
+
+    if (on) {
+        rec_unfreeze();
+    } else {
+        kb_freeze(1);
+        rec_joy_apply(g_joy);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+
+// Grabación de la entrada por tick de juego: teclas, cola de eventos y joystick,
+// más la semilla de cada partida. Al reproducir, la misma secuencia vuelve a
+// entrar por keyboard.c/input.c y la partida sale idéntica.
+// SET TBRECORD=PARTIDA.REC para grabar, SET TBREPLAY=PARTIDA.REC para reproducir.
+
+#define REC_OFF 0
+#define REC_RECORDING 1
+#define REC_REPLAYING 2
+
+int rec_record(const char *path);
+int rec_replay(const char *path);
+void rec_close(void);
+int rec_active(void);
+
+// Antes del *_Init de cada partida, con el año del juego como id: devuelve la
+// semilla que hay que usar (la propuesta al grabar, la grabada al reproducir)
+uint32_t rec_session_begin(unsigned int game_id, uint32_t seed);
+void rec_session_end(void);
+// Reproduciendo: id de la siguiente partida grabada; 0 si no quedan
+int rec_session_peek(unsigned int *game_id);
+
+// Una vez por tick, antes del update. Reproduciendo avisa de que se acabó lo grabado:
+#define REC_TICK_OK 0
+#define REC_TICK_QUIT 1  // aquí se salió de la partida desde el menú de continuar
+#define REC_TICK_EARLY 2 // antes de que acabe la partida; sigue en vivo
+int rec_tick(void);
+
+// Grabando, menús y pausa en mitad de la partida: la entrada vuelve a ser la del teclado
+void rec_pause(int on);
+// Grabando: lo elegido en el menú de continuar. Reproduciendo no hay pausa ni
+// menú; lo elegido vuelve por rec_tick()
+void rec_menu(int wants_continue);
+
+#endif
@@ -0,0 +1,45 @@
+#include "rng.h"
+
+void rng_seed(Rng *rng, uint32_t seed)
+{
+    // Mezcla de murmur3: con xorshift32 sin mezclar, 1 y 2 arrancarían casi iguales
+    uint32_t h = seed + 0x9E3779B9UL;
+
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    // OJO: xorshift32 se queda en 0 para siempre
+    rng->state = h ? h : 0x9E3779B9UL;
+}
+
+uint32_t rng_next(Rng *rng)
+{
+    uint32_t x = rng->state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng->state = x;
+    return x;
+}
+
+int rng_below(Rng *rng, int n)
+{
+    // Los 16 bits altos son los mejores de xorshift32 y el módulo queda en 16 bits
+    unsigned int hi = (unsigned int)(rng_next(rng) >> 16);
+
+    if (n <= 0) {
+        return 0;
+    }
+    return (int)(hi % (unsigned int)n);
+}
+
+int rng_range(Rng *rng, int min_value, int max_value)
+{
+    if (max_value <= min_value) {
+        return min_value;
+    }
+    return min_value + rng_below(rng, max_value - min_value + 1);
+}
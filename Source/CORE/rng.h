@@ -0,0 +1,22 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Generador xorshift32 con estado explícito: cada minijuego lleva el suyo,
+// sembrado desde GameSettings.seed. A diferencia de rand() sale igual en DOS y
+// en host, y dos juegos (o dos simulaciones del runner) no comparten estado.
+
+typedef struct {
+    uint32_t state;
+} Rng;
+
+// Cualquier semilla vale, 0 incluida; semillas seguidas dan series distintas
+void rng_seed(Rng *rng, uint32_t seed);
+uint32_t rng_next(Rng *rng);
+// 0..n-1 con n hasta 65535; n <= 0 devuelve 0
+int rng_below(Rng *rng, int n);
+// min..max, ambos incluidos
+int rng_range(Rng *rng, int min_value, int max_value);
+
+#endif
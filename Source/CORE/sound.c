@@ -1,43 +1,165 @@
 #include "sound.h"
 
+#include "opl.h"
+#include "platform.h"
+#include "profiler.h"
+#include "pwm.h"
 #include "timer.h"
 
+#if !PLATFORM_HOST
 #include <conio.h>
 #include <dos.h>
+#endif
 
 #define PIT_FREQ 1193182UL
+// Notas por efecto
 #define SOUND_QUEUE_MAX 32
 
-static SoundNote g_queue[SOUND_QUEUE_MAX];
-static int g_queue_len = 0;
-static int g_queue_pos = 0;
-static unsigned long g_note_end_ms = 0;
-static int g_playing = 0;
+// Las voces avanzan en un hook de la ISR de IRQ0 (1 ms), no al ritmo de in_poll()
+#define USE_SOUND_ISR 1
+
+// Voces lógicas sobre el único canal del altavoz: con varias sonando a la vez
+// se turnan cada SOUND_SLICE_MS (arpegio); sus notas duran lo mismo igualmente.
+// Con la OPL2 cada voz tiene su canal.
+#define SOUND_VOICES OPL_CHANNELS
+#define SOUND_SPEAKER_VOICES 4
+#define SOUND_SLICE_MS 5
+// Canales de abajo que se queda un stream de registros mientras suena
+#define SOUND_STREAM_CHANNELS 6
+#define SOUND_VOICE_CHANNEL(v) (OPL_CHANNELS - 1 - (v))
+#define SOUND_PATCH_UNKNOWN 0xFF
+// Sin ISR (host) como mucho se recupera este tiempo de golpe
+#define SOUND_CATCHUP_MS 250U
+
+// Órdenes del juego a la ISR en una cola circular de un productor y un consumidor,
+// sin cli/sti: el juego sólo escribe g_tail y las órdenes, la ISR sólo g_head.
+// Los índices son de 8 bits (se escriben de una vez) y dan la vuelta solos.
+// Un efecto entero (START y sus NOTE) se publica de una vez al mover g_tail.
+#define SOUND_RING 64
+#define SOUND_RING_MASK (SOUND_RING - 1)
+
+enum {
+    SOUND_CMD_START = 0, // Voz nueva con la primera nota; count = notas del efecto
+    SOUND_CMD_NOTE,      // Siguiente nota del último START
+    SOUND_CMD_STOP,      // Para la voz del handle
+    SOUND_CMD_STOP_ALL
+};
+
+typedef struct {
+    unsigned int divisor; // Ya dividido para el PIT; 0 = silencio
+    unsigned int fnum_block; // Lo mismo para la OPL2
+    unsigned int duration_ms;
+} SoundStep;
+
+typedef struct {
+    unsigned char op;
+    unsigned char priority;
+    unsigned char patch;
+    unsigned char count;
+    SoundHandle handle;
+    SoundStep step;
+} SoundCmd;
+
+// Todo lo de la voz es de la ISR; el juego sólo lee g_voice_handle
+typedef struct {
+    unsigned char priority;
+    unsigned char patch;
+    unsigned char count;
+    unsigned char pos;
+    unsigned char serial; // Cambia con cada nota: la OPL2 vuelve a pulsar la tecla
+    unsigned int left_ms;
+    unsigned int started; // g_mix_ms al empezar: para robar la más vieja
+    SoundStep steps[SOUND_QUEUE_MAX];
+} SoundVoice;
+
+static volatile SoundCmd g_ring[SOUND_RING];
+static volatile unsigned char g_head = 0;
+static volatile unsigned char g_tail = 0;
+// Último START atendido por la ISR: los handles posteriores aún están en cola
+static volatile SoundHandle g_taken = 0;
+static volatile SoundHandle g_voice_handle[SOUND_VOICES];
+
+// Sólo de la ISR
+static SoundVoice g_voices[SOUND_VOICES];
+static int g_fill_voice = -1;
+static int g_out_voice = 0;
+static unsigned int g_out_divisor = 0;
+static unsigned int g_slice_ms = 0;
+static unsigned int g_mix_ms = 0;
+static SoundBackend g_out_backend = SOUND_BACKEND_PC_SPEAKER;
+
+// OPL2: lo último escrito en el canal de cada voz
+static unsigned int g_opl_key[SOUND_VOICES];
+static unsigned char g_opl_serial[SOUND_VOICES];
+static unsigned char g_opl_patch[SOUND_VOICES];
+
+// Stream de registros: el juego deja el siguiente y sube g_stream_req
+static const unsigned char *volatile g_stream_next = NULL;
+static volatile unsigned long g_stream_next_len = 0;
+static volatile unsigned char g_stream_req = 0;
+static volatile unsigned char g_stream_seen = 0;
+static volatile unsigned char g_stream_on = 0;
+static const unsigned char *g_stream_data = NULL;
+static unsigned long g_stream_len = 0;
+static unsigned long g_stream_pos = 0;
+static unsigned int g_stream_wait = 0;
+
+static const OplPatch g_patches[SOUND_PATCH_COUNT] = {
+    // BEEP: sostenida y con realimentación, lo más parecido al altavoz
+    {0x22, 0x21, 0x1A, 0x00, 0xF0, 0xF0, 0x0F, 0x0F, 0x00, 0x00, 0x0E},
+    // LEAD: ataque rápido y se apaga sola, tipo piano
+    {0x21, 0x01, 0x1C, 0x00, 0xF3, 0xF2, 0x44, 0x54, 0x00, 0x00, 0x08},
+    // HIT: modulador muy alto, suena a ruido
+    {0x0E, 0x00, 0x00, 0x00, 0xF5, 0xF4, 0x77, 0x47, 0x00, 0x00, 0x0E}
+};
+
+// Sólo del juego
+static SoundHandle g_next_handle = 0;
+static SoundHandle g_music = 0;
+
+// Backend RENDER
+#define SOUND_RENDER_HIGH 0xC0
+#define SOUND_RENDER_LOW 0x40
+#define SOUND_RENDER_SILENCE 0x80
+
+static unsigned char *g_render_buf = NULL;
+static unsigned long g_render_cap = 0;
+static unsigned long g_render_len = 0;
+static unsigned int g_render_frac = 0;
+static unsigned int g_render_divisor = 0;
+static unsigned long g_render_phase = 0;
+
+// Muestra digitalizada sin IRQ0 rápida: niveles del último ms
+static unsigned char g_pwm_levels[PWM_MAX_PER_MS];
+static int g_pwm_count = 0;
+
+static int g_hook = -1;
+static unsigned long g_last_ms = 0;
 static int g_enabled = 1;
 static SoundBackend g_backend = SOUND_BACKEND_PC_SPEAKER;
 
+// En host no hay altavoz: las voces avanzan igual pero no suena
 static void pc_speaker_stop(void)
 {
+#if !PLATFORM_HOST
     unsigned char value = inp(0x61);
     value &= (unsigned char)~0x03;
     outp(0x61, value);
+#endif
 }
 
-static void pc_speaker_start(unsigned int freq)
+static void pc_speaker_start(unsigned int divisor)
 {
-    unsigned long divisor;
     unsigned char value;
 
-    if (freq == 0) {
+    if (divisor == 0) {
         pc_speaker_stop();
         return;
     }
 
-    divisor = PIT_FREQ / (unsigned long)freq;
-    if (divisor == 0) {
-        divisor = 1;
-    }
-
+#if PLATFORM_HOST
+    (void)value;
+#else
     outp(0x43, 0xB6);
     outp(0x42, (unsigned char)(divisor & 0xFF));
     outp(0x42, (unsigned char)((divisor >> 8) & 0xFF));
@@ -45,13 +167,36 @@ static void pc_speaker_start(unsigned int freq)
     value = inp(0x61);
     value |= 0x03;
     outp(0x61, value);
+#endif
 }
 
-static void sound_backend_start(unsigned int freq)
+static unsigned int pc_speaker_divisor(unsigned int freq)
+{
+    unsigned long divisor;
+
+    if (freq == 0) {
+        return 0;
+    }
+    divisor = PIT_FREQ / (unsigned long)freq;
+    if (divisor == 0) {
+        divisor = 1;
+    } else if (divisor > 0xFFFFUL) {
+        divisor = 0xFFFFUL;
+    }
+    return (unsigned int)divisor;
+}
+
+static void sound_backend_start(unsigned int divisor)
 {
     switch (g_backend) {
     case SOUND_BACKEND_PC_SPEAKER:
-        pc_speaker_start(freq);
+        pc_speaker_start(divisor);
+        break;
+    case SOUND_BACKEND_RENDER:
+        // Lo saca sound_render_ms() de g_out_divisor
+        break;
+    case SOUND_BACKEND_OPL2:
+        // Va por sound_opl_output()
         break;
     case SOUND_BACKEND_NONE:
     default:
@@ -66,6 +211,9 @@ static void sound_backend_stop(void)
     case SOUND_BACKEND_PC_SPEAKER:
         pc_speaker_stop();
         break;
+    case SOUND_BACKEND_RENDER:
+    case SOUND_BACKEND_OPL2:
+        break;
     case SOUND_BACKEND_NONE:
     default:
         pc_speaker_stop();
@@ -73,140 +221,693 @@ static void sound_backend_stop(void)
     }
 }
 
+/* -------------------------------------------------------------------------
+   ISR: voces y mezcla. Sin timer_now_us(): en la ISR no se puede.
+   ------------------------------------------------------------------------- */
+
+static void sound_voice_free(int v)
+{
+    g_voice_handle[v] = 0;
+    if (g_fill_voice == v) {
+        g_fill_voice = -1;
+    }
+}
+
+static int sound_voice_limit(void)
+{
+    if (g_backend != SOUND_BACKEND_OPL2) {
+        return SOUND_SPEAKER_VOICES;
+    }
+    return g_stream_on ? OPL_CHANNELS - SOUND_STREAM_CHANNELS : OPL_CHANNELS;
+}
+
+// Misma primera nota y mismo largo que un efecto que ya suena: se reinicia ese.
+// Si no, una voz libre o la de menos prioridad (la más vieja) si no es más importante.
+static int sound_voice_pick(const volatile SoundCmd *cmd)
+{
+    int limit = sound_voice_limit();
+    int best = -1;
+    int v;
+
+    for (v = 0; v < limit; ++v) {
+        const SoundVoice *voice = &g_voices[v];
+
+        if (g_voice_handle[v] && voice->count == cmd->count && voice->priority == cmd->priority &&
+            voice->patch == cmd->patch && voice->steps[0].divisor == cmd->step.divisor &&
+            voice->steps[0].duration_ms == cmd->step.duration_ms) {
+            return v;
+        }
+    }
+    for (v = 0; v < limit; ++v) {
+        if (!g_voice_handle[v]) {
+            return v;
+        }
+    }
+    for (v = 0; v < limit; ++v) {
+        const SoundVoice *voice = &g_voices[v];
+
+        if (voice->priority > cmd->priority) {
+            continue;
+        }
+        if (best < 0 || voice->priority < g_voices[best].priority ||
+            (voice->priority == g_voices[best].priority &&
+             (unsigned int)(g_mix_ms - voice->started) > (unsigned int)(g_mix_ms - g_voices[best].started))) {
+            best = v;
+        }
+    }
+    return best;
+}
+
+static void sound_stream_release(void);
+
+static void sound_take_commands(void)
+{
+    while (g_head != g_tail) {
+        const volatile SoundCmd *cmd = &g_ring[g_head & SOUND_RING_MASK];
+        int v;
+
+        switch (cmd->op) {
+        case SOUND_CMD_START:
+            g_taken = cmd->handle;
+            g_fill_voice = sound_voice_pick(cmd);
+            if (g_fill_voice >= 0) {
+                SoundVoice *voice = &g_voices[g_fill_voice];
+
+                voice->priority = cmd->priority;
+                voice->patch = cmd->patch;
+                voice->count = 1;
+                voice->pos = 0;
+                voice->serial++;
+                voice->steps[0].divisor = cmd->step.divisor;
+                voice->steps[0].fnum_block = cmd->step.fnum_block;
+                voice->steps[0].duration_ms = cmd->step.duration_ms;
+                voice->left_ms = cmd->step.duration_ms ? cmd->step.duration_ms : 1;
+                voice->started = g_mix_ms;
+                g_voice_handle[g_fill_voice] = cmd->handle;
+            }
+            break;
+        case SOUND_CMD_NOTE:
+            if (g_fill_voice >= 0 && g_voice_handle[g_fill_voice] == cmd->handle &&
+                g_voices[g_fill_voice].count < SOUND_QUEUE_MAX) {
+                SoundVoice *voice = &g_voices[g_fill_voice];
+
+                voice->steps[voice->count].divisor = cmd->step.divisor;
+                voice->steps[voice->count].fnum_block = cmd->step.fnum_block;
+                voice->steps[voice->count].duration_ms = cmd->step.duration_ms;
+                voice->count++;
+            }
+            break;
+        case SOUND_CMD_STOP:
+            for (v = 0; v < SOUND_VOICES; ++v) {
+                if (g_voice_handle[v] == cmd->handle) {
+                    sound_voice_free(v);
+                }
+            }
+            break;
+        case SOUND_CMD_STOP_ALL:
+        default:
+            for (v = 0; v < SOUND_VOICES; ++v) {
+                sound_voice_free(v);
+            }
+            sound_stream_release();
+            break;
+        }
+        g_head++;
+    }
+}
+
+static void sound_voices_advance(void)
+{
+    int v;
+
+    for (v = 0; v < SOUND_VOICES; ++v) {
+        SoundVoice *voice = &g_voices[v];
+
+        if (!g_voice_handle[v] || --voice->left_ms > 0) {
+            continue;
+        }
+        voice->pos++;
+        voice->serial++;
+        if (voice->pos >= voice->count) {
+            sound_voice_free(v);
+            continue;
+        }
+        voice->left_ms = voice->steps[voice->pos].duration_ms ? voice->steps[voice->pos].duration_ms : 1;
+    }
+}
+
+static unsigned int sound_voice_divisor(int v)
+{
+    return g_voice_handle[v] ? g_voices[v].steps[g_voices[v].pos].divisor : 0;
+}
+
+/* -------------------------------------------------------------------------
+   ISR: OPL2
+   ------------------------------------------------------------------------- */
+
+static void sound_opl_forget(int first_voice)
+{
+    int v;
+
+    for (v = first_voice; v < SOUND_VOICES; ++v) {
+        g_opl_key[v] = 0;
+        g_opl_patch[v] = SOUND_PATCH_UNKNOWN;
+    }
+}
+
+// Calla los canales del stream y lo suelta
+static void sound_stream_release(void)
+{
+    int channel;
+
+    if (g_stream_on) {
+        for (channel = 0; channel < SOUND_STREAM_CHANNELS; ++channel) {
+            opl_write((unsigned char)(0xB0 + channel), 0);
+        }
+    }
+    g_stream_on = 0;
+    g_stream_data = NULL;
+}
+
+static void sound_stream_start(void)
+{
+    int v;
+
+    sound_stream_release();
+    if (g_backend != SOUND_BACKEND_OPL2 || !g_stream_next) {
+        return;
+    }
+
+    // Las voces de esos canales se cortan
+    for (v = OPL_CHANNELS - SOUND_STREAM_CHANNELS; v < SOUND_VOICES; ++v) {
+        if (g_opl_key[v]) {
+            opl_note_off(SOUND_VOICE_CHANNEL(v), g_opl_key[v]);
+        }
+        sound_voice_free(v);
+    }
+    sound_opl_forget(OPL_CHANNELS - SOUND_STREAM_CHANNELS);
+
+    g_stream_data = g_stream_next;
+    g_stream_len = g_stream_next_len;
+    g_stream_pos = 0;
+    g_stream_wait = 0;
+    g_stream_on = 1;
+}
+
+// Registro, valor y ms de espera hasta el siguiente (IMF tipo 0)
+static void sound_stream_step(void)
+{
+    if (g_stream_seen != g_stream_req) {
+        g_stream_seen = g_stream_req;
+        sound_stream_start();
+    }
+
+    while (g_stream_on && g_stream_wait == 0) {
+        const unsigned char *rec = g_stream_data + g_stream_pos;
+
+        if (g_stream_pos + 4 > g_stream_len) {
+            g_stream_on = 0;
+            g_stream_data = NULL;
+            break;
+        }
+        opl_write(rec[0], rec[1]);
+        g_stream_wait = (unsigned int)rec[2] | ((unsigned int)rec[3] << 8);
+        g_stream_pos += 4;
+    }
+    if (g_stream_wait > 0) {
+        g_stream_wait--;
+    }
+}
+
+// Sólo se escribe en la tarjeta lo que cambia: tecla, nota o instrumento
+static void sound_opl_output(void)
+{
+    int v;
+
+    for (v = 0; v < SOUND_VOICES; ++v) {
+        const SoundVoice *voice = &g_voices[v];
+        int channel = SOUND_VOICE_CHANNEL(v);
+        unsigned int key = g_voice_handle[v] ? voice->steps[voice->pos].fnum_block : 0;
+
+        if (key == g_opl_key[v] && (key == 0 || voice->serial == g_opl_serial[v])) {
+            continue;
+        }
+        if (g_opl_key[v]) {
+            opl_note_off(channel, g_opl_key[v]);
+        }
+        g_opl_key[v] = key;
+        g_opl_serial[v] = voice->serial;
+        if (key == 0) {
+            continue;
+        }
+        if (g_opl_patch[v] != voice->patch) {
+            opl_set_patch(channel, &g_patches[voice->patch]);
+            g_opl_patch[v] = voice->patch;
+        }
+        opl_note_on(channel, key);
+    }
+}
+
+// Lo que dejó sonando el backend anterior se calla desde aquí, igual que se encendió.
+// El reset entero de la OPL2 lo hace sound_set_backend(): en la ISR es muy largo.
+static void sound_backend_switch(void)
+{
+    int channel;
+
+    if (g_out_backend == SOUND_BACKEND_OPL2) {
+        for (channel = 0; channel < OPL_CHANNELS; ++channel) {
+            opl_write((unsigned char)(0xB0 + channel), 0);
+        }
+        g_stream_on = 0;
+        g_stream_data = NULL;
+    } else {
+        pc_speaker_stop();
+        g_out_divisor = 0;
+    }
+    sound_opl_forget(0);
+    g_out_backend = g_backend;
+}
+
+// Turno del altavoz: la voz sigue hasta agotar su rodaja o quedarse en silencio
+static void sound_speaker_output(void)
+{
+    unsigned int divisor;
+
+    // Con una muestra sonando el canal 2 es suyo; los tonos vuelven al acabar
+    if (pwm_active()) {
+        g_out_divisor = 0;
+        return;
+    }
+
+    divisor = sound_voice_divisor(g_out_voice);
+
+    if (++g_slice_ms >= SOUND_SLICE_MS || divisor == 0) {
+        int i;
+
+        g_slice_ms = 0;
+        for (i = 1; i <= SOUND_VOICES; ++i) {
+            int v = (g_out_voice + i) % SOUND_VOICES;
+            unsigned int d = sound_voice_divisor(v);
+
+            if (d) {
+                g_out_voice = v;
+                divisor = d;
+                break;
+            }
+        }
+    }
+
+    // Sólo se toca el PIT si cambia lo que suena
+    if (divisor != g_out_divisor) {
+        g_out_divisor = divisor;
+        if (divisor) {
+            sound_backend_start(divisor);
+        } else {
+            sound_backend_stop();
+        }
+    }
+}
+
+static void sound_mix_output(void)
+{
+    if (g_backend != g_out_backend) {
+        sound_backend_switch();
+    }
+    if (g_backend == SOUND_BACKEND_OPL2) {
+        sound_opl_output();
+    } else {
+        sound_speaker_output();
+    }
+}
+
+// Muestras del ms que acaba de pasar con lo que sonaba en él. La fase cuenta
+// en 1/SOUND_RENDER_RATE de ciclo del PIT y vuelve a 0 al reprogramarlo.
+// Una muestra digitalizada tapa los tonos: sale su nivel de PWM, que es lo
+// que deja el altavoz tras filtrar los pulsos.
+static void sound_render_ms(void)
+{
+    unsigned long period;
+    unsigned int n;
+    unsigned int i;
+
+    if (g_backend != SOUND_BACKEND_RENDER || !g_render_buf) {
+        return;
+    }
+
+    g_render_frac += (unsigned int)SOUND_RENDER_RATE % 1000U;
+    n = (unsigned int)(SOUND_RENDER_RATE / 1000UL) + g_render_frac / 1000U;
+    g_render_frac %= 1000U;
+
+    if (g_pwm_count > 0) {
+        for (i = 0; i < n; ++i) {
+            unsigned char level = g_pwm_levels[(i * (unsigned int)g_pwm_count) / n];
+
+            if (g_render_len < g_render_cap) {
+                g_render_buf[g_render_len++] = (unsigned char)(level << 2);
+            }
+        }
+        return;
+    }
+
+    if (g_out_divisor != g_render_divisor) {
+        g_render_divisor = g_out_divisor;
+        g_render_phase = 0;
+    }
+    period = (unsigned long)g_render_divisor * SOUND_RENDER_RATE;
+
+    while (n-- > 0) {
+        unsigned char sample = SOUND_RENDER_SILENCE;
+
+        if (g_render_divisor) {
+            sample = g_render_phase < period / 2 ? SOUND_RENDER_HIGH : SOUND_RENDER_LOW;
+            g_render_phase += PIT_FREQ;
+            while (g_render_phase >= period) {
+                g_render_phase -= period;
+            }
+        }
+        if (g_render_len < g_render_cap) {
+            g_render_buf[g_render_len++] = sample;
+        }
+    }
+}
+
+static void sound_mix_tick(void)
+{
+    g_pwm_count = pwm_tick_ms(g_pwm_levels);
+    sound_render_ms();
+    opl_log_tick();
+    g_mix_ms++;
+    sound_voices_advance();
+    sound_take_commands();
+    sound_stream_step();
+    sound_mix_output();
+}
+
+/* -------------------------------------------------------------------------
+   Juego: órdenes a la cola
+   ------------------------------------------------------------------------- */
+
+static int sound_ring_free(void)
+{
+    return (SOUND_RING - 1) - (int)(unsigned char)(g_tail - g_head);
+}
+
+static void sound_ring_put(unsigned char *tail, unsigned char op, SoundHandle handle, unsigned char priority,
+                           unsigned char patch, unsigned char count, const SoundNote *note)
+{
+    volatile SoundCmd *cmd = &g_ring[*tail & SOUND_RING_MASK];
+
+    cmd->op = op;
+    cmd->handle = handle;
+    cmd->priority = priority;
+    cmd->patch = patch;
+    cmd->count = count;
+    cmd->step.divisor = note ? pc_speaker_divisor(note->freq) : 0;
+    cmd->step.fnum_block = note ? opl_fnum_block(note->freq) : 0;
+    cmd->step.duration_ms = note ? note->duration_ms : 0;
+    (*tail)++;
+}
+
+// Sin ISR lo pedido tiene que sonar ya, como antes
+static void sound_kick(void)
+{
+    if (g_hook >= 0) {
+        return;
+    }
+    sound_update();
+    sound_take_commands();
+    sound_stream_step();
+    sound_mix_output();
+}
+
 void sound_init(void)
 {
-    g_queue_len = 0;
-    g_queue_pos = 0;
-    g_note_end_ms = 0;
-    g_playing = 0;
+    int v;
+
+    g_head = 0;
+    g_tail = 0;
+    g_taken = 0;
+    g_next_handle = 0;
+    g_music = 0;
+    for (v = 0; v < SOUND_VOICES; ++v) {
+        g_voice_handle[v] = 0;
+    }
+    sound_opl_forget(0);
+    g_fill_voice = -1;
+    g_out_voice = 0;
+    g_out_divisor = 0;
+    g_slice_ms = 0;
+    g_stream_on = 0;
+    g_stream_data = NULL;
+    g_stream_seen = g_stream_req;
     g_enabled = 1;
     g_backend = SOUND_BACKEND_PC_SPEAKER;
+    g_out_backend = g_backend;
     sound_backend_stop();
+    g_last_ms = t_now_ms();
+#if USE_SOUND_ISR
+    // OJO: después de timer_init, que vacía los hooks
+    if (g_hook < 0) {
+        g_hook = timer_hook_add(sound_mix_tick, 1);
+    }
+#endif
 }
 
 void sound_shutdown(void)
 {
-    g_queue_len = 0;
-    g_queue_pos = 0;
-    g_note_end_ms = 0;
-    g_playing = 0;
+    int v;
+
+    if (g_hook >= 0) {
+        timer_hook_remove(g_hook);
+        g_hook = -1;
+    }
+    g_head = g_tail;
+    for (v = 0; v < SOUND_VOICES; ++v) {
+        g_voice_handle[v] = 0;
+    }
+    g_stream_on = 0;
+    g_stream_data = NULL;
+    g_out_divisor = 0;
+    pwm_unload();
+    if (g_backend == SOUND_BACKEND_OPL2 || g_out_backend == SOUND_BACKEND_OPL2) {
+        opl_reset();
+    }
     sound_backend_stop();
 }
 
+static void sound_stop_all(void)
+{
+    unsigned char tail = g_tail;
+
+    if (sound_ring_free() < 1) {
+        return;
+    }
+    sound_ring_put(&tail, SOUND_CMD_STOP_ALL, 0, 0, 0, 0, NULL);
+    g_tail = tail;
+    g_music = 0;
+    sound_kick();
+}
+
 void sound_set_enabled(int enabled)
 {
     g_enabled = enabled ? 1 : 0;
     if (!g_enabled) {
-        g_queue_len = 0;
-        g_queue_pos = 0;
-        g_playing = 0;
-        sound_backend_stop();
+        pwm_stop();
+        sound_stop_all();
     }
 }
 
 void sound_set_backend(SoundBackend backend)
 {
+    // Antes de que la ISR empiece a escribir en ella
+    if (backend == SOUND_BACKEND_OPL2 && g_backend != SOUND_BACKEND_OPL2) {
+        opl_reset();
+    }
+    pwm_stop();
     g_backend = backend;
-    sound_backend_stop();
-    g_playing = 0;
-    g_queue_len = 0;
-    g_queue_pos = 0;
+    sound_stop_all();
 }
 
-static void sound_start_note(const SoundNote *note)
+void sound_update(void)
 {
-    if (!note) {
+    unsigned long now;
+    unsigned long elapsed;
+
+    if (!g_enabled) {
         return;
     }
+    // Con la ISR sólo queda leer la muestra del disco
+    if (g_hook >= 0) {
+        pwm_refill();
+        return;
+    }
+
+    prof_begin(PROF_SOUND);
+    now = t_now_ms();
+    elapsed = now - g_last_ms;
+    g_last_ms = now;
+    // OJO: el render no se salta nada, cuesta lo que dure
+    if (elapsed > SOUND_CATCHUP_MS && g_backend != SOUND_BACKEND_RENDER) {
+        elapsed = SOUND_CATCHUP_MS;
+    }
+    while (elapsed-- > 0) {
+        pwm_refill();
+        sound_mix_tick();
+    }
+    prof_end(PROF_SOUND);
+}
 
-    sound_backend_start(note->freq);
-    g_note_end_ms = t_now_ms() + (unsigned long)note->duration_ms;
-    g_playing = 1;
+SoundHandle sound_play(const SoundNote *notes, int count, int priority)
+{
+    return sound_play_patch(notes, count, priority, SOUND_PATCH_BEEP);
 }
 
-void sound_update(void)
+SoundHandle sound_play_patch(const SoundNote *notes, int count, int priority, int patch)
 {
-    if (!g_enabled) {
-        return;
-    }
+    unsigned char tail;
+    SoundHandle handle;
+    int i;
 
-    if (g_queue_len <= 0) {
-        if (g_playing) {
-            sound_backend_stop();
-            g_playing = 0;
-        }
-        return;
+    if (!g_enabled || !notes || count <= 0 || patch < 0 || patch >= SOUND_PATCH_COUNT) {
+        return 0;
+    }
+    if (count > SOUND_QUEUE_MAX) {
+        count = SOUND_QUEUE_MAX;
+    }
+    // El efecto entra entero o no entra
+    if (sound_ring_free() < count) {
+        return 0;
     }
 
-    if (!g_playing) {
-        g_queue_pos = 0;
-        sound_start_note(&g_queue[g_queue_pos]);
-        return;
+    if (++g_next_handle == 0) {
+        g_next_handle = 1;
     }
+    handle = g_next_handle;
 
-    if (t_now_ms() >= g_note_end_ms) {
-        g_queue_pos++;
-        if (g_queue_pos >= g_queue_len) {
-            g_queue_len = 0;
-            g_queue_pos = 0;
-            g_playing = 0;
-            sound_backend_stop();
-            return;
-        }
-        sound_start_note(&g_queue[g_queue_pos]);
+    tail = g_tail;
+    sound_ring_put(&tail, SOUND_CMD_START, handle, (unsigned char)priority, (unsigned char)patch,
+                   (unsigned char)count, &notes[0]);
+    for (i = 1; i < count; ++i) {
+        sound_ring_put(&tail, SOUND_CMD_NOTE, handle, 0, 0, 0, &notes[i]);
     }
+    g_tail = tail;
+    sound_kick();
+    return handle;
 }
 
-void sound_play_tone(unsigned int freq, unsigned int duration_ms)
+void sound_stop(SoundHandle handle)
 {
-    SoundNote note;
+    unsigned char tail = g_tail;
 
-    if (!g_enabled) {
+    if (!handle || sound_ring_free() < 1) {
         return;
     }
+    sound_ring_put(&tail, SOUND_CMD_STOP, handle, 0, 0, 0, NULL);
+    g_tail = tail;
+    sound_kick();
+}
 
-    if (g_queue_len >= SOUND_QUEUE_MAX) {
-        return;
+int sound_playing(SoundHandle handle)
+{
+    int v;
+
+    if (!handle) {
+        return 0;
+    }
+    // Aún en la cola
+    if ((int)(handle - g_taken) > 0) {
+        return 1;
+    }
+    for (v = 0; v < SOUND_VOICES; ++v) {
+        if (g_voice_handle[v] == handle) {
+            return 1;
+        }
     }
+    return 0;
+}
+
+void sound_play_tone(unsigned int freq, unsigned int duration_ms)
+{
+    SoundNote note;
 
     note.freq = freq;
     note.duration_ms = duration_ms;
+    sound_play(&note, 1, SOUND_PRIO_SFX);
+}
 
-    if (g_queue_len == 0) {
-        g_queue[0] = note;
-        g_queue_len = 1;
-        g_queue_pos = 0;
-        g_playing = 0;
-        sound_update();
-        return;
+void sound_play_melody(const SoundNote *notes, int count)
+{
+    // Una sola música: la nueva sustituye a la anterior, los efectos siguen
+    sound_stop(g_music);
+    g_music = sound_play_patch(notes, count, SOUND_PRIO_MUSIC, SOUND_PATCH_LEAD);
+}
+
+int sound_load_sample(const char *path)
+{
+    if (!g_enabled || g_backend == SOUND_BACKEND_NONE) {
+        pwm_unload();
+        return 0;
     }
+    return pwm_load(path);
+}
 
-    g_queue[g_queue_len++] = note;
+void sound_unload_sample(void)
+{
+    pwm_unload();
 }
 
-void sound_play_melody(const SoundNote *notes, int count)
+int sound_play_sample(void)
 {
-    int i;
+    if (!g_enabled || g_backend == SOUND_BACKEND_NONE) {
+        return 0;
+    }
+    // RENDER o sin ISR: la muestra avanza con el mezclador, sin tocar el altavoz
+    return pwm_play(g_backend != SOUND_BACKEND_RENDER && g_hook >= 0);
+}
 
-    if (!g_enabled || !notes || count <= 0) {
+void sound_stop_sample(void)
+{
+    pwm_stop();
+}
+
+void sound_play_stream(const unsigned char *data, unsigned long bytes)
+{
+    if (data && (!g_enabled || g_backend != SOUND_BACKEND_OPL2)) {
         return;
     }
+    // OJO: primero el stream y luego la petición, que es lo que mira la ISR
+    g_stream_next = data;
+    g_stream_next_len = data ? bytes : 0;
+    g_stream_req++;
+    sound_kick();
+}
 
-    if (count > SOUND_QUEUE_MAX) {
-        count = SOUND_QUEUE_MAX;
-    }
+int sound_is_playing(void)
+{
+    int v;
 
-    for (i = 0; i < count; ++i) {
-        g_queue[i] = notes[i];
+    if (g_head != g_tail || g_stream_on || g_stream_seen != g_stream_req || pwm_active()) {
+        return 1;
+    }
+    for (v = 0; v < SOUND_VOICES; ++v) {
+        if (g_voice_handle[v]) {
+            return 1;
+        }
     }
+    return 0;
+}
 
-    g_queue_len = count;
-    g_queue_pos = 0;
-    g_playing = 0;
-    sound_update();
+void sound_render_start(unsigned char *buffer, unsigned long capacity)
+{
+    g_render_buf = buffer;
+    g_render_cap = buffer ? capacity : 0;
+    g_render_len = 0;
+    g_render_frac = 0;
+    g_render_divisor = 0;
+    g_render_phase = 0;
 }
 
-int sound_is_playing(void)
+unsigned long sound_render_length(void)
 {
-    return g_playing;
+    return g_render_len;
 }
@@ -3,21 +3,71 @@
 
 typedef enum {
     SOUND_BACKEND_NONE = 0,
-    SOUND_BACKEND_PC_SPEAKER = 1
+    SOUND_BACKEND_PC_SPEAKER = 1,
+    SOUND_BACKEND_RENDER = 2, // PCM a memoria (sound_render_start), sin altavoz
+    SOUND_BACKEND_OPL2 = 3    // AdLib: una voz por canal, hasta 9 (CORE/opl.c)
 } SoundBackend;
 
+// PCM del backend RENDER: mono, 8 bits sin signo, onda cuadrada como el altavoz
+#define SOUND_RENDER_RATE 22050UL
+
 typedef struct {
     unsigned int freq;
     unsigned int duration_ms;
 } SoundNote;
 
+// Prioridad de un efecto: uno nuevo sólo quita la voz a otro de igual o menor
+enum {
+    SOUND_PRIO_LOW = 0,
+    SOUND_PRIO_SFX = 1,
+    SOUND_PRIO_MUSIC = 2,
+    SOUND_PRIO_HIGH = 3
+};
+
+// Instrumento de la voz con SOUND_BACKEND_OPL2; el altavoz no tiene
+enum {
+    SOUND_PATCH_BEEP = 0,
+    SOUND_PATCH_LEAD,
+    SOUND_PATCH_HIT,
+    SOUND_PATCH_COUNT
+};
+
+// 0 = ninguno (no había sitio o el sonido está apagado)
+typedef unsigned int SoundHandle;
+
 void sound_init(void);
 void sound_shutdown(void);
 void sound_set_enabled(int enabled);
 void sound_set_backend(SoundBackend backend);
+// Con la ISR del timer las notas avanzan solas y esto no hace nada;
+// sin ella (host) avanza la cola con t_now_ms()
 void sound_update(void);
+// Varias voces comparten el altavoz por turnos. Repetir un efecto que ya
+// suena lo reinicia en vez de ocupar otra voz.
+SoundHandle sound_play(const SoundNote *notes, int count, int priority);
+SoundHandle sound_play_patch(const SoundNote *notes, int count, int priority, int patch);
+void sound_stop(SoundHandle handle);
+int sound_playing(SoundHandle handle);
+// Efecto suelto de prioridad SOUND_PRIO_SFX
 void sound_play_tone(unsigned int freq, unsigned int duration_ms);
+// Música: sustituye a la anterior
 void sound_play_melody(const SoundNote *notes, int count);
+// Escrituras de registros ya hechas para la OPL2 (IMF tipo 0, esperas en ms), p. ej.
+// un registro de opl_log_open(). Se queda los canales 0-5 mientras suena; NULL lo para.
+void sound_play_stream(const unsigned char *data, unsigned long bytes);
+// WAV PCM mono de 8 bits por el altavoz en PWM (CORE/pwm.c). Cargarla abre el
+// fichero y lee su principio: en *_Init, no en el tick. Una cargada cada vez.
+int sound_load_sample(const char *path);
+void sound_unload_sample(void);
+// La cargada desde el principio; el resto se lee a trozos en sound_update().
+// Mientras suena no hay tonos por el altavoz. 0 si no hay ninguna.
+int sound_play_sample(void);
+void sound_stop_sample(void);
 int sound_is_playing(void);
 
+// Cada ms sonado en RENDER añade sus muestras a buffer; lo que no cabe se pierde.
+// Sin ISR el reloj es el de t_now_ms(): con timer_set_virtual el render es exacto.
+void sound_render_start(unsigned char *buffer, unsigned long capacity);
+unsigned long sound_render_length(void);
+
 #endif
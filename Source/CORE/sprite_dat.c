@@ -1,9 +1,41 @@
 #include "sprite_dat.h"
 
 #include <stdio.h>
+#include <string.h>
+#if !PLATFORM_HOST
+#include <malloc.h>
+#endif
 
-int sprite_dat_load_auto(const char *path, unsigned short *out_w, unsigned short *out_h,
-                         unsigned char far *dst, unsigned long max_pixels)
+// Sprites residentes: lo precargado se copia desde memoria en vez de ir a disco
+#define SPRITE_CACHE_MAX 24
+#define SPRITE_CACHE_PATH 32
+#define SPRITE_CACHE_BYTES 96000UL // Tope de RAM para la caché entera
+
+typedef struct {
+    char path[SPRITE_CACHE_PATH];
+    unsigned short w;
+    unsigned short h;
+    unsigned char far *pixels;
+} SpriteCacheEntry;
+
+static SpriteCacheEntry g_cache[SPRITE_CACHE_MAX];
+static int g_cache_count = 0;
+static unsigned long g_cache_bytes = 0;
+
+static const SpriteCacheEntry *sprite_cache_find(const char *path)
+{
+    int i;
+
+    for (i = 0; i < g_cache_count; ++i) {
+        if (strcmp(g_cache[i].path, path) == 0) {
+            return &g_cache[i];
+        }
+    }
+    return NULL;
+}
+
+static int sprite_dat_read(const char *path, unsigned short *out_w, unsigned short *out_h,
+                           unsigned char far *dst, unsigned long max_pixels)
 {
     FILE *file;
     long file_size;
@@ -101,3 +133,88 @@ int sprite_dat_load_auto(const char *path, unsigned short *out_w, unsigned short
     fclose(file);
     return 0;
 }
+
+int sprite_dat_load_auto(const char *path, unsigned short *out_w, unsigned short *out_h,
+                         unsigned char far *dst, unsigned long max_pixels)
+{
+    const SpriteCacheEntry *entry;
+
+    if (!path || !out_w || !out_h || !dst || max_pixels == 0) {
+        return 0;
+    }
+
+    entry = sprite_cache_find(path);
+    if (entry && (unsigned long)entry->w * entry->h <= max_pixels) {
+        _fmemcpy(dst, entry->pixels, (unsigned int)((unsigned long)entry->w * entry->h));
+        *out_w = entry->w;
+        *out_h = entry->h;
+        return 1;
+    }
+
+    return sprite_dat_read(path, out_w, out_h, dst, max_pixels);
+}
+
+int sprite_dat_prefetch(const char *path)
+{
+    SpriteCacheEntry *entry;
+    FILE *file;
+    long file_size;
+    unsigned char far *pixels;
+
+    if (!path || strlen(path) >= SPRITE_CACHE_PATH) {
+        return 0;
+    }
+    if (sprite_cache_find(path)) {
+        return 1;
+    }
+    if (g_cache_count >= SPRITE_CACHE_MAX) {
+        return 0;
+    }
+
+    file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    file_size = ftell(file);
+    fclose(file);
+
+    // El fichero es cabecera + píxeles: su tamaño sobra para el buffer
+    if (file_size <= 2 || file_size > 65000L || g_cache_bytes + (unsigned long)file_size > SPRITE_CACHE_BYTES) {
+        return 0;
+    }
+
+    pixels = (unsigned char far *)_fmalloc((size_t)file_size);
+    if (!pixels) {
+        return 0;
+    }
+
+    entry = &g_cache[g_cache_count];
+    if (!sprite_dat_read(path, &entry->w, &entry->h, pixels, (unsigned long)file_size)) {
+        _ffree(pixels);
+        return 0;
+    }
+
+    strcpy(entry->path, path);
+    entry->pixels = pixels;
+    g_cache_bytes += (unsigned long)file_size;
+    ++g_cache_count;
+    return 1;
+}
+
+int sprite_dat_is_cached(const char *path)
+{
+    return path && sprite_cache_find(path) != NULL;
+}
+
+void sprite_dat_cache_release(void)
+{
+    int i;
+
+    for (i = 0; i < g_cache_count; ++i) {
+        _ffree(g_cache[i].pixels);
+        g_cache[i].pixels = NULL;
+    }
+    g_cache_count = 0;
+    g_cache_bytes = 0;
+}
@@ -1,7 +1,15 @@
 #ifndef SPRITE_DAT_H
 #define SPRITE_DAT_H
 
+#include "platform.h"
+
 int sprite_dat_load_auto(const char *path, unsigned short *out_w, unsigned short *out_h,
                          unsigned char far *dst, unsigned long max_pixels);
 
+// Caché de sprites residentes: lo precargado no vuelve a leerse de disco
+// hasta sprite_dat_cache_release(). Si no cabe, se sigue cargando de disco.
+int sprite_dat_prefetch(const char *path);
+int sprite_dat_is_cached(const char *path);
+void sprite_dat_cache_release(void);
+
 #endif
@@ -1,14 +1,82 @@
 #include "timer.h"
 
+#include "platform.h"
+
+#if PLATFORM_HOST
+#include <time.h>
+#else
 #include <conio.h>
 #include <dos.h>
+#endif
 
 #define PIT_PORT_DATA 0x40
 #define PIT_PORT_CTRL 0x43
 #define PIT_CTRL_LATCH 0x00
+#define PIT_CTRL_CH0_RATE 0x36 // Canal 0, LSB+MSB, modo 3
+#define PIT_CTRL_CH0_RATEGEN 0x34 // Canal 0, LSB+MSB, modo 2: baja de uno en uno
+#define PIC_PORT_CMD 0x20
+#define PIC_OCW3_READ_IRR 0x0A
 #define PIT_BASE_FREQ 1193182UL
 
-uint32_t timer_now_us(void)
+// ISR propia en IRQ0: el PIT va más rápido y el tiempo queda en memoria
+#define USE_TIMER_ISR 1
+#define TIMER_ISR_HZ 1000UL
+#define TIMER_ISR_DIVISOR ((unsigned int)(PIT_BASE_FREQ / TIMER_ISR_HZ))
+// Microsegundos por interrupción en 16.16 (1193 cuentas de PIT = 999.85 us)
+#define TIMER_TICK_US_Q16 ((uint32_t)(((uint64_t)TIMER_ISR_DIVISOR * 1000000ULL * 65536ULL) / PIT_BASE_FREQ))
+
+// En host no hay PIT ni vectores: reloj del sistema
+#if PLATFORM_HOST
+#undef USE_TIMER_ISR
+#define USE_TIMER_ISR 0
+#endif
+
+// Reloj virtual: el tiempo sólo avanza cuando se pide (runner, repeticiones)
+static int g_virtual = 0;
+static uint32_t g_virtual_us = 0;
+
+#if USE_TIMER_ISR
+typedef struct {
+    TimerHookFn fn;
+    unsigned int period;
+    unsigned int count;
+} TimerHook;
+
+static volatile uint32_t g_now_us = 0;
+static volatile uint16_t g_now_frac = 0;
+static volatile uint32_t g_isr_ticks = 0;
+static volatile uint16_t g_chain_acc = 0;
+static volatile TimerHook g_hooks[TIMER_MAX_HOOKS];
+// Modo rápido: cuentas de PIT del periodo en curso (0 = apagado), las que el PIT
+// cargará en la siguiente IRQ0 y las que van del ms. Sin g_fast_fn se está
+// volviendo a 1 ms.
+static volatile unsigned int g_fast_run = 0;
+static volatile unsigned int g_fast_reload = 0;
+static volatile unsigned int g_fast_acc = 0;
+static volatile TimerFastFn g_fast_fn = 0;
+static int g_isr_installed = 0;
+static uint32_t g_last_us = 0;
+
+// Vector anterior de INT 8
+static void (interrupt far *old_int8)();
+#endif
+
+#if defined(__WATCOMC__)
+// STI justo antes de HLT: la interrupción no se puede colar entre las dos
+void timer_cpu_halt(void);
+#pragma aux timer_cpu_halt = "sti" "hlt";
+#endif
+
+#if PLATFORM_HOST
+static uint32_t timer_pit_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)(ts.tv_nsec / 1000L));
+}
+#else
+static uint32_t timer_pit_now_us(void)
 {
     const unsigned long far *bios_ticks = (unsigned long far *)MK_FP(0x40, 0x6C);
     unsigned long tick_before;
@@ -30,6 +98,303 @@ uint32_t timer_now_us(void)
         return (uint32_t)us;
     }
 }
+#endif
+
+#if USE_TIMER_ISR
+static void timer_pit_rate(unsigned char mode, unsigned int divisor)
+{
+    outp(PIT_PORT_CTRL, mode);
+    outp(PIT_PORT_DATA, divisor & 0xFF);
+    outp(PIT_PORT_DATA, (divisor >> 8) & 0xFF);
+}
+
+// Sin palabra de control el modo 2 no se reinicia: la cuenta nueva entra al
+// acabar el periodo en curso
+static void timer_pit_reload(unsigned int divisor)
+{
+    outp(PIT_PORT_DATA, divisor & 0xFF);
+    outp(PIT_PORT_DATA, (divisor >> 8) & 0xFF);
+}
+
+static void interrupt far timer_int8()
+{
+    uint32_t frac;
+    uint16_t chain_before;
+    int i;
+
+    // En modo rápido el ms sólo se cuenta cuando se han juntado sus 1193 cuentas
+    if (g_fast_run) {
+        g_fast_acc += g_fast_run;
+        g_fast_run = g_fast_reload;
+        if (g_fast_fn) {
+            g_fast_fn();
+        } else if (g_fast_reload != TIMER_ISR_DIVISOR) {
+            // De vuelta a 1 ms: detrás del periodo en curso va el que acaba justo en el ms
+            unsigned int left = (g_fast_acc + g_fast_run) % TIMER_ISR_DIVISOR;
+
+            g_fast_reload = left ? TIMER_ISR_DIVISOR - left : TIMER_ISR_DIVISOR;
+            timer_pit_reload(g_fast_reload);
+        }
+        if (g_fast_acc < TIMER_ISR_DIVISOR) {
+            outp(0x20, 0x20);
+            return;
+        }
+        g_fast_acc -= TIMER_ISR_DIVISOR;
+        if (g_fast_run == TIMER_ISR_DIVISOR && g_fast_acc == 0) {
+            g_fast_run = 0;
+        }
+    }
+
+    frac = (uint32_t)g_now_frac + TIMER_TICK_US_Q16;
+    g_now_us += frac >> 16;
+    g_now_frac = (uint16_t)(frac & 0xFFFFUL);
+    g_isr_ticks++;
+
+    for (i = 0; i < TIMER_MAX_HOOKS; ++i) {
+        if (g_hooks[i].fn && ++g_hooks[i].count >= g_hooks[i].period) {
+            g_hooks[i].count = 0;
+            g_hooks[i].fn();
+        }
+    }
+
+    // Al BIOS sólo le llega un tick de cada 65536 cuentas: sigue a 18.2 Hz
+    chain_before = g_chain_acc;
+    g_chain_acc = (uint16_t)(g_chain_acc + TIMER_ISR_DIVISOR);
+    if (g_chain_acc < chain_before) {
+        _chain_intr(old_int8); // El manejador viejo manda el EOI
+    }
+
+    // EOI PIC
+    outp(0x20, 0x20);
+}
+#endif
+
+void timer_init(void)
+{
+#if USE_TIMER_ISR
+    int i;
+
+    if (g_isr_installed) {
+        return;
+    }
+
+    for (i = 0; i < TIMER_MAX_HOOKS; ++i) {
+        g_hooks[i].fn = 0;
+    }
+
+    _disable();
+    // Sigue contando desde donde iba el reloj de la BIOS
+    g_now_us = timer_pit_now_us();
+    g_now_frac = 0;
+    g_isr_ticks = 0;
+    g_chain_acc = 0;
+    old_int8 = _dos_getvect(0x08);
+    _dos_setvect(0x08, timer_int8);
+    g_last_us = g_now_us;
+    // Modo 2 en vez del 3: la cuenta leída dice cuánto falta para la siguiente IRQ0
+    timer_pit_rate(PIT_CTRL_CH0_RATEGEN, TIMER_ISR_DIVISOR);
+    g_isr_installed = 1;
+    _enable();
+#endif
+}
+
+void timer_shutdown(void)
+{
+#if USE_TIMER_ISR
+    if (!g_isr_installed) {
+        return;
+    }
+
+    _disable();
+    g_fast_fn = 0;
+    g_fast_run = 0;
+    timer_pit_rate(PIT_CTRL_CH0_RATE, 0); // 0 = 65536, los 18.2 Hz de siempre
+    _dos_setvect(0x08, old_int8);
+    g_isr_installed = 0;
+    _enable();
+#endif
+}
+
+int timer_hook_add(TimerHookFn fn, unsigned int period_ticks)
+{
+#if USE_TIMER_ISR
+    int i;
+
+    if (!fn) {
+        return -1;
+    }
+
+    for (i = 0; i < TIMER_MAX_HOOKS; ++i) {
+        if (!g_hooks[i].fn) {
+            _disable();
+            g_hooks[i].period = period_ticks ? period_ticks : 1;
+            g_hooks[i].count = 0;
+            g_hooks[i].fn = fn;
+            _enable();
+            return i;
+        }
+    }
+#else
+    (void)fn;
+    (void)period_ticks;
+#endif
+    return -1;
+}
+
+void timer_hook_remove(int slot)
+{
+#if USE_TIMER_ISR
+    if (slot >= 0 && slot < TIMER_MAX_HOOKS) {
+        g_hooks[slot].fn = 0;
+    }
+#else
+    (void)slot;
+#endif
+}
+
+int timer_fast_begin(TimerFastFn fn, unsigned int per_ms)
+{
+#if USE_TIMER_ISR
+    unsigned int divisor;
+
+    if (!g_isr_installed || !fn || per_ms < 2 || g_fast_fn) {
+        return 0;
+    }
+    divisor = TIMER_ISR_DIVISOR / per_ms;
+
+    _disable();
+    // El periodo de 1 ms en curso acaba entero: esa primera interrupción cierra
+    // el ms y el PIT sigue con el divisor nuevo. Si aún se volvía a 1 ms, el
+    // periodo en curso ya está en g_fast_run.
+    if (!g_fast_run) {
+        g_fast_run = TIMER_ISR_DIVISOR;
+        g_fast_acc = 0;
+    }
+    g_fast_reload = divisor;
+    timer_pit_reload(divisor);
+    g_fast_fn = fn;
+    _enable();
+    return 1;
+#else
+    (void)fn;
+    (void)per_ms;
+    return 0;
+#endif
+}
+
+void timer_fast_end(void)
+{
+#if USE_TIMER_ISR
+    // La ISR mete un periodo corto que acaba justo en el ms y vuelve a 1 ms: ni el
+    // reloj ni la BIOS pierden cuentas
+    g_fast_fn = 0;
+#endif
+}
+
+uint32_t timer_isr_ticks(void)
+{
+#if USE_TIMER_ISR
+    uint32_t a;
+    uint32_t b;
+
+    do {
+        a = g_isr_ticks;
+        b = g_isr_ticks;
+    } while (a != b);
+    return a;
+#else
+    return 0;
+#endif
+}
+
+void timer_set_virtual(int on, uint32_t start_us)
+{
+    g_virtual = on;
+    g_virtual_us = start_us;
+}
+
+int timer_is_virtual(void)
+{
+    return g_virtual;
+}
+
+void timer_advance_us(uint32_t us)
+{
+    g_virtual_us += us;
+}
+
+uint32_t timer_now_us(void)
+{
+    if (g_virtual) {
+        return g_virtual_us;
+    }
+#if USE_TIMER_ISR
+    if (g_isr_installed) {
+        uint32_t base;
+        unsigned int count;
+        unsigned int elapsed;
+        unsigned int fast_run;
+        unsigned int fast_reload;
+        unsigned int fast_acc;
+        unsigned char irr;
+        uint32_t us;
+
+        // Entre dos interrupciones se interpola con la cuenta del PIT.
+        // OJO: deja las interrupciones activadas, no llamar desde un hook de la ISR
+        _disable();
+        base = g_now_us;
+        fast_run = g_fast_run;
+        fast_reload = g_fast_reload;
+        fast_acc = g_fast_acc;
+        outp(PIT_PORT_CTRL, PIT_CTRL_LATCH);
+        count = (unsigned int)inp(PIT_PORT_DATA);
+        count |= (unsigned int)inp(PIT_PORT_DATA) << 8;
+        outp(PIC_PORT_CMD, PIC_OCW3_READ_IRR);
+        irr = (unsigned char)inp(PIC_PORT_CMD);
+        _enable();
+
+        if (fast_run) {
+            // Lo juntado del ms más lo que va del periodo en curso
+            if ((irr & 1) && count <= fast_reload && fast_reload - count < fast_reload / 2) {
+                // IRQ0 pendiente: el PIT ya va por el periodo siguiente
+                elapsed = fast_acc + fast_run + (fast_reload - count);
+            } else {
+                elapsed = fast_acc + (count <= fast_run ? fast_run - count : 0);
+            }
+        } else {
+            elapsed = (count <= TIMER_ISR_DIVISOR) ? TIMER_ISR_DIVISOR - count : 0;
+            // IRQ0 pendiente y la cuenta ya recargada: ese tick aún no está en g_now_us
+            if ((irr & 1) && elapsed < TIMER_ISR_DIVISOR / 2) {
+                elapsed += TIMER_ISR_DIVISOR;
+            }
+        }
+        us = base + (uint32_t)(((unsigned long)elapsed * 1000000UL) / PIT_BASE_FREQ);
+
+        // El redondeo de la ISR no puede hacer que el tiempo vaya hacia atrás
+        if ((int32_t)(us - g_last_us) < 0) {
+            us = g_last_us;
+        }
+        g_last_us = us;
+        return us;
+    }
+#endif
+    return timer_pit_now_us();
+}
+
+void t_idle(void)
+{
+    // En virtual dormir es avanzar lo que tardaría la siguiente interrupción
+    if (g_virtual) {
+        g_virtual_us += 1000UL;
+        return;
+    }
+#if USE_TIMER_ISR && defined(__WATCOMC__)
+    // Con el PIT a 18.2 Hz un HLT podría dormir 55 ms: sólo con la ISR puesta
+    if (g_isr_installed) {
+        timer_cpu_halt();
+    }
+#endif
+}
 
 unsigned long t_now_ms(void)
 {
@@ -41,14 +406,31 @@ void t_wait_ms(unsigned long ms)
     unsigned long start = t_now_ms();
 
     while ((t_now_ms() - start) < ms) {
-        // Espera activa en DOS, suficiente aquí
+        t_idle();
     }
 }
 
 void t_wait_us(uint32_t us)
 {
+#if PLATFORM_HOST
+    uint32_t start;
+
+    if (g_virtual) {
+        g_virtual_us += us;
+        return;
+    }
+    start = timer_now_us();
+    while ((uint32_t)(timer_now_us() - start) < us) {
+    }
+#else
     // Espera BIOS: INT 15h, AH=86h, CX:DX en microsegundos
     union REGS r;
+
+    if (g_virtual) {
+        g_virtual_us += us;
+        return;
+    }
+
     r.h.ah = 0x86;
     r.x.cx = (unsigned int)(us >> 16);
     r.x.dx = (unsigned int)(us & 0xFFFF);
@@ -61,4 +443,5 @@ void t_wait_us(uint32_t us)
         while ((uint32_t)(timer_now_us() - start) < us) {
         }
     }
+#endif
 }
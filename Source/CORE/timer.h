@@ -3,9 +3,35 @@
 
 #include <stdint.h>
 
+#define TIMER_MAX_HOOKS 4
+
+// Llamada desde la ISR de IRQ0: corta, sin DOS ni BIOS
+typedef void (*TimerHookFn)(void);
+// Lo mismo, en cada interrupción del modo rápido
+typedef void (*TimerFastFn)(void);
+
+// Instala la ISR de IRQ0 (PIT a 1 kHz, encadena al INT 8 original a 18.2 Hz)
+void timer_init(void);
+void timer_shutdown(void);
+// Devuelve el hueco o -1; period_ticks en interrupciones de 1 ms
+int timer_hook_add(TimerHookFn fn, unsigned int period_ticks);
+void timer_hook_remove(int slot);
+uint32_t timer_isr_ticks(void);
+// IRQ0 per_ms veces por ms con fn en cada una (muestras por el altavoz); el reloj,
+// los hooks y el BIOS siguen a 1 kHz. 0 si no hay ISR o ya está en marcha.
+int timer_fast_begin(TimerFastFn fn, unsigned int per_ms);
+void timer_fast_end(void);
+
+// Reloj virtual: timer_now_us() devuelve start_us y sólo avanza con timer_advance_us()
+void timer_set_virtual(int on, uint32_t start_us);
+int timer_is_virtual(void);
+void timer_advance_us(uint32_t us);
+
 uint32_t timer_now_us(void);
 unsigned long t_now_ms(void);
 void t_wait_ms(unsigned long ms);
 void t_wait_us(uint32_t us);
+// Duerme la CPU hasta la siguiente interrupción (1 ms como mucho con la ISR)
+void t_idle(void);
 
 #endif
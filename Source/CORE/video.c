@@ -1,20 +1,500 @@
 #include "video.h"
+#include "palfx.h"
+#include "capture.h"
+#include "profiler.h"
+#include "timer.h"
 
+#if !VIDEO_HEADLESS
 #include <dos.h>
-#include <stdlib.h>
-#include <string.h>
 #include <memory.h>
 #include <conio.h>
 #include <malloc.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 
 #define USE_BACKBUFFER 1
+#define USE_DIRTY_RECTS 1
+
+#define DIRTY_MAX 32
+#define DIRTY_MERGE_SLACK 256L
+#define DIRTY_FULL_AREA 38400L // OJO: a partir del 60% de pantalla sale más barato copiar todo
+
+#define USE_TEXT_CACHE 1
+#define TEXT_CACHE_SLOTS 12
+#define TEXT_CACHE_MAX_LEN 40
+
+// Captura FLI desde v_present (se activa con cap_open)
+#define USE_CAPTURE 1
 
+// Modo X: VRAM planar con varias páginas, el present sube lo dañado a la
+// página oculta y cambia la dirección de inicio del CRTC
+#define USE_MODEX 1
+#define MODEX_PAGES 2
+
+#if !USE_BACKBUFFER
+#undef USE_MODEX
+#define USE_MODEX 0 // Se compone siempre en el backbuffer lineal
+#endif
+
+// Modo diferido: lo que se pinta en pantalla se apunta y se ejecuta en v_present
+// quitando lo que luego queda tapado (se activa con v_set_deferred)
+#define USE_RENDER_QUEUE 1
+#define RQ_MAX 128
+#define RQ_TEXT_BYTES 512
+#define RQ_OCCLUDERS 16
+#define RQ_OCCLUDER_MIN_AREA 64L
+#define RQ_FRAGS 256
+#define RQ_FRAGS_PER_FILL 32
+
+// Hash de cada frame presentado (en DOS sólo bajo demanda)
+#ifndef VIDEO_FRAME_HASH
+#define VIDEO_FRAME_HASH VIDEO_HEADLESS
+#endif
+
+#if VIDEO_HEADLESS
+static unsigned char g_headless_vram[VIDEO_WIDTH * VIDEO_HEIGHT];
+#define VGA ((unsigned char far *)g_headless_vram)
+#else
 static unsigned char far *const VGA = (unsigned char far *)MK_FP(0xA000, 0x0000);
+#endif
+// Copia de lo escrito en el DAC (el hardware no se relee)
+static unsigned char g_dac_shadow[256 * 3];
+static unsigned long g_frame_count = 0;
+static uint64_t g_frame_hash = 0;
+static FILE *g_hash_log = NULL;
+// Bytes escritos en el backbuffer por las primitivas (por rectángulo)
+static unsigned long g_frame_bytes = 0;
+static unsigned long g_frame_bytes_last = 0;
+// Filas copiadas en el último present
+static int g_present_y0 = 0;
+static int g_present_y1 = VIDEO_HEIGHT;
 static unsigned char far *backbuffer = NULL;
 static unsigned char locked_palette[256 * 3];
 static unsigned char current_palette[256 * 3];
 static int palette_locked = 0;
+static Surface g_screen = { VIDEO_WIDTH, VIDEO_HEIGHT, VIDEO_WIDTH, 0, NULL };
+static Surface *g_target = NULL;
+
+#if USE_MODEX
+static int g_modex = 0;
+static int g_modex_top = 0;           // En 320x240 la imagen va centrada
+static unsigned int g_modex_page_size = 0;
+static int g_modex_back = 1;          // Página oculta, la que se actualiza
+static int g_modex_stale_full = 1;
+#if VIDEO_HEADLESS
+// Modelo de la VGA planar: 4 planos de 64 KB y dirección de inicio
+static unsigned char g_modex_planes[4][0x10000UL];
+static unsigned int g_modex_start = 0;
+#endif
+#endif
+
+// Fuente expandida a una máscara 0x00/0xFF por píxel (96 glifos x 8x8)
+static unsigned char g_font_mask[96][64];
+static int g_font_ready = 0;
+
+#if USE_TEXT_CACHE
+// Textos que se repiten frame a frame (HUD, menús) guardados ya rasterizados
+typedef struct {
+    int x;
+    int y;
+    int len;
+    unsigned char color;
+    unsigned char hits;
+    unsigned short stamp;
+    char text[TEXT_CACHE_MAX_LEN + 1];
+    SpanSprite spans;
+} TextCacheEntry;
+
+static TextCacheEntry g_text_cache[TEXT_CACHE_SLOTS];
+static unsigned short g_text_cache_clock = 0;
+
+static void text_cache_reset(void);
+#endif
+
+static void v_font_expand(void);
+
+#if USE_BACKBUFFER && USE_DIRTY_RECTS
+typedef struct {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+} DirtyRect;
+
+// g_damage: lo que hay que copiar a VGA en el próximo present.
+// g_drawn: lo pintado desde el último v_clear; con eso sabemos qué ensució
+// el frame anterior cuando el siguiente vuelve a limpiar con el mismo color.
+static DirtyRect g_damage[DIRTY_MAX];
+static int g_damage_count = 0;
+static int g_damage_full = 1;
+static DirtyRect g_drawn[DIRTY_MAX];
+static int g_drawn_count = 0;
+static int g_base_valid = 0;
+static unsigned char g_base_color = 0;
+static const unsigned char far *g_base_src = NULL;
+static unsigned short g_base_serial = 0;
+
+static long dirty_area(const DirtyRect *r)
+{
+    return (long)(r->x1 - r->x0) * (long)(r->y1 - r->y0);
+}
+
+static int dirty_add(DirtyRect *list, int *count, int x0, int y0, int x1, int y1)
+{
+    DirtyRect r;
+    int i;
+
+    r.x0 = x0;
+    r.y0 = y0;
+    r.x1 = x1;
+    r.y1 = y1;
+
+    i = 0;
+    while (i < *count) {
+        DirtyRect *o = &list[i];
+        DirtyRect m;
+
+        if (r.x0 >= o->x0 && r.y0 >= o->y0 && r.x1 <= o->x1 && r.y1 <= o->y1) {
+            return 1;
+        }
+
+        m.x0 = r.x0 < o->x0 ? r.x0 : o->x0;
+        m.y0 = r.y0 < o->y0 ? r.y0 : o->y0;
+        m.x1 = r.x1 > o->x1 ? r.x1 : o->x1;
+        m.y1 = r.y1 > o->y1 ? r.y1 : o->y1;
+
+        if (dirty_area(&m) <= dirty_area(&r) + dirty_area(o) + DIRTY_MERGE_SLACK) {
+            // Se funde con este y se vuelve a probar contra el resto
+            r = m;
+            list[i] = list[*count - 1];
+            (*count)--;
+            i = 0;
+            continue;
+        }
+        ++i;
+    }
+
+    if (*count >= DIRTY_MAX) {
+        return 0;
+    }
+    list[*count] = r;
+    (*count)++;
+    return 1;
+}
+
+static void dirty_mark_full(void)
+{
+    g_damage_full = 1;
+    g_damage_count = 0;
+    g_base_valid = 0;
+    g_drawn_count = 0;
+}
+
+static void dirty_mark(int x0, int y0, int x1, int y1)
+{
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > VIDEO_WIDTH) x1 = VIDEO_WIDTH;
+    if (y1 > VIDEO_HEIGHT) y1 = VIDEO_HEIGHT;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    if (g_base_valid && !dirty_add(g_drawn, &g_drawn_count, x0, y0, x1, y1)) {
+        g_base_valid = 0;
+        g_drawn_count = 0;
+    }
+
+    if (!g_damage_full && !dirty_add(g_damage, &g_damage_count, x0, y0, x1, y1)) {
+        g_damage_full = 1;
+        g_damage_count = 0;
+    }
+}
+
+// La base es lo que se copió entero a la pantalla: un color sólido o una
+// superficie (puntero + serie). Si coincide con la anterior, la pantalla sólo
+// difiere de la base en g_drawn.
+static void dirty_rebase(const unsigned char far *src, unsigned short serial, unsigned char color)
+{
+    int i;
+
+    if (g_base_valid && g_base_src == src && g_base_serial == serial && g_base_color == color &&
+        !g_damage_full) {
+        for (i = 0; i < g_drawn_count; ++i) {
+            if (!dirty_add(g_damage, &g_damage_count, g_drawn[i].x0, g_drawn[i].y0,
+                           g_drawn[i].x1, g_drawn[i].y1)) {
+                g_damage_full = 1;
+                g_damage_count = 0;
+                break;
+            }
+        }
+    } else {
+        g_damage_full = 1;
+        g_damage_count = 0;
+    }
+
+    g_base_valid = 1;
+    g_base_src = src;
+    g_base_serial = serial;
+    g_base_color = color;
+    g_drawn_count = 0;
+}
+
+// Guardar-bajo: la pantalla sólo difiere de la base en g_drawn, así que volver
+// a la misma base es reponer esos rectángulos (cuesta lo que los objetos móviles).
+static int dirty_restore(const unsigned char far *src, unsigned short serial, unsigned char color)
+{
+    int i;
+
+    if (!g_base_valid || g_base_src != src || g_base_serial != serial || g_base_color != color) {
+        return 0;
+    }
+
+    for (i = 0; i < g_drawn_count; ++i) {
+        const DirtyRect *r = &g_drawn[i];
+        unsigned int w = (unsigned int)(r->x1 - r->x0);
+        unsigned int offset = (unsigned int)r->y0 * VIDEO_WIDTH + r->x0;
+        int iy;
+
+        g_frame_bytes += (unsigned long)w * (unsigned long)(r->y1 - r->y0);
+        for (iy = r->y0; iy < r->y1; ++iy) {
+            if (src) {
+                _fmemcpy(backbuffer + offset, src + offset, w);
+            } else {
+                _fmemset(backbuffer + offset, color, w);
+            }
+            offset += VIDEO_WIDTH;
+        }
+
+        if (!g_damage_full && !dirty_add(g_damage, &g_damage_count, r->x0, r->y0, r->x1, r->y1)) {
+            g_damage_full = 1;
+            g_damage_count = 0;
+        }
+    }
+
+    g_drawn_count = 0;
+    return 1;
+}
+
+// Se ha pintado en la capa que hace de base: la pantalla queda desfasada ahí
+static void dirty_base_touched(const unsigned char far *src, unsigned short serial, int x0, int y0, int x1,
+                               int y1)
+{
+    if (!g_base_valid || g_base_src != src || g_base_serial != serial) {
+        return;
+    }
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > VIDEO_WIDTH) x1 = VIDEO_WIDTH;
+    if (y1 > VIDEO_HEIGHT) y1 = VIDEO_HEIGHT;
+    if (x0 < x1 && y0 < y1 && !dirty_add(g_drawn, &g_drawn_count, x0, y0, x1, y1)) {
+        g_base_valid = 0;
+        g_drawn_count = 0;
+        return;
+    }
+
+    // La serie sube a la par que la de la capa
+    g_base_serial = (unsigned short)(serial + 1);
+}
+
+static void dirty_base_forget(const unsigned char far *src)
+{
+    if (g_base_src == src) {
+        g_base_valid = 0;
+        g_drawn_count = 0;
+    }
+}
+
+// Decide si el present va entero y anota qué filas cambian (para la captura)
+static void dirty_resolve(void)
+{
+    long total = 0;
+    int i;
+
+    if (!g_damage_full) {
+        for (i = 0; i < g_damage_count; ++i) {
+            total += dirty_area(&g_damage[i]);
+        }
+        if (total >= DIRTY_FULL_AREA) {
+            g_damage_full = 1;
+        }
+    }
+
+    if (g_damage_full) {
+        g_present_y0 = 0;
+        g_present_y1 = VIDEO_HEIGHT;
+        return;
+    }
+
+    g_present_y0 = VIDEO_HEIGHT;
+    g_present_y1 = 0;
+    for (i = 0; i < g_damage_count; ++i) {
+        if (g_damage[i].y0 < g_present_y0) g_present_y0 = g_damage[i].y0;
+        if (g_damage[i].y1 > g_present_y1) g_present_y1 = g_damage[i].y1;
+    }
+}
+
+static void dirty_copy_to_vga(void)
+{
+    int i;
+
+    dirty_resolve();
+
+    if (g_damage_full) {
+        _fmemcpy(VGA, backbuffer, VIDEO_WIDTH * VIDEO_HEIGHT);
+    } else {
+        for (i = 0; i < g_damage_count; ++i) {
+            // Alinear a par para que el compilador copie por words
+            int x0 = g_damage[i].x0 & ~1;
+            int x1 = (g_damage[i].x1 + 1) & ~1;
+            unsigned int w = (unsigned int)(x1 - x0);
+            unsigned int offset = (unsigned int)g_damage[i].y0 * VIDEO_WIDTH + x0;
+            int iy;
+
+            if (w == VIDEO_WIDTH) {
+                _fmemcpy(VGA + offset, backbuffer + offset,
+                         (unsigned int)(g_damage[i].y1 - g_damage[i].y0) * VIDEO_WIDTH);
+                continue;
+            }
+
+            for (iy = g_damage[i].y0; iy < g_damage[i].y1; ++iy) {
+                _fmemcpy(VGA + offset, backbuffer + offset, w);
+                offset += VIDEO_WIDTH;
+            }
+        }
+    }
+
+    g_damage_full = 0;
+    g_damage_count = 0;
+}
+
+#define DIRTY_MARK(x0, y0, x1, y1) dirty_mark((x0), (y0), (x1), (y1))
+#define DIRTY_MARK_FULL() dirty_mark_full()
+#define DIRTY_REBASE(src, serial, color) dirty_rebase((src), (serial), (color))
+#define DIRTY_RESTORE(src, serial, color) dirty_restore((src), (serial), (color))
+#define DIRTY_BASE_TOUCHED(src, serial, x0, y0, x1, y1) dirty_base_touched((src), (serial), (x0), (y0), (x1), (y1))
+#define DIRTY_BASE_FORGET(src) dirty_base_forget(src)
+#else
+#define DIRTY_MARK(x0, y0, x1, y1) ((void)0)
+#define DIRTY_MARK_FULL() ((void)0)
+#define DIRTY_REBASE(src, serial, color) ((void)0)
+#define DIRTY_RESTORE(src, serial, color) 0
+#define DIRTY_BASE_TOUCHED(src, serial, x0, y0, x1, y1) ((void)0)
+#define DIRTY_BASE_FORGET(src) ((void)0)
+#endif
+
+#if USE_MODEX
+#if VIDEO_HEADLESS
+#define MODEX_PLANE(p) ((unsigned char far *)g_modex_planes[p])
+#define MODEX_MASK(m) ((void)0)
+#else
+#define MODEX_PLANE(p) VGA
+#define MODEX_MASK(m) outpw(0x3C4, (unsigned int)(((m) << 8) | 0x02))
+#endif
+
+#if USE_DIRTY_RECTS
+// Lo que cambió en el present anterior: la página oculta aún no lo tiene
+static DirtyRect g_modex_stale[DIRTY_MAX];
+static int g_modex_stale_count = 0;
+#endif
+
+static void modex_upload_rect(int x0, int y0, int x1, int y1)
+{
+    unsigned int page = (unsigned int)g_modex_back * g_modex_page_size +
+                        (unsigned int)g_modex_top * (VIDEO_WIDTH / 4);
+    int p;
+
+    // Un plano cada vez: una sola escritura al registro de máscara por plano
+    for (p = 0; p < 4; ++p) {
+        int xs = x0 + ((p - x0) & 3);
+        unsigned int n;
+        int y;
+
+        if (xs >= x1) {
+            continue;
+        }
+        n = (unsigned int)((x1 - xs + 3) >> 2);
+
+        MODEX_MASK(1 << p);
+        for (y = y0; y < y1; ++y) {
+            const unsigned char far *src = backbuffer + (unsigned int)y * VIDEO_WIDTH + xs;
+            unsigned char far *dst = MODEX_PLANE(p) + page + (unsigned int)y * (VIDEO_WIDTH / 4) + (xs >> 2);
+            unsigned int i;
+
+            for (i = 0; i < n; ++i) {
+                dst[i] = src[i << 2];
+            }
+        }
+    }
+}
+
+static void modex_upload(void)
+{
+#if USE_DIRTY_RECTS
+    int i;
+
+    dirty_resolve();
+
+    if (g_damage_full || g_modex_stale_full) {
+        modex_upload_rect(0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+    } else {
+        for (i = 0; i < g_modex_stale_count; ++i) {
+            modex_upload_rect(g_modex_stale[i].x0, g_modex_stale[i].y0, g_modex_stale[i].x1, g_modex_stale[i].y1);
+        }
+        for (i = 0; i < g_damage_count; ++i) {
+            modex_upload_rect(g_damage[i].x0, g_damage[i].y0, g_damage[i].x1, g_damage[i].y1);
+        }
+    }
+
+    g_modex_stale_full = g_damage_full;
+    g_modex_stale_count = g_damage_count;
+    for (i = 0; i < g_damage_count; ++i) {
+        g_modex_stale[i] = g_damage[i];
+    }
+    g_damage_full = 0;
+    g_damage_count = 0;
+#else
+    modex_upload_rect(0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+#endif
+}
+
+#if VIDEO_HEADLESS
+// Lo que barrería el CRTC: la página visible vuelta a lineal
+static void modex_scanout(void)
+{
+    unsigned int page = g_modex_start + (unsigned int)g_modex_top * (VIDEO_WIDTH / 4);
+    int x;
+    int y;
+
+    for (y = 0; y < VIDEO_HEIGHT; ++y) {
+        for (x = 0; x < VIDEO_WIDTH; ++x) {
+            g_headless_vram[(unsigned int)y * VIDEO_WIDTH + x] =
+                g_modex_planes[x & 3][page + (unsigned int)y * (VIDEO_WIDTH / 4) + (x >> 2)];
+        }
+    }
+}
+#endif
+
+static void modex_flip(void)
+{
+    unsigned int start = (unsigned int)g_modex_back * g_modex_page_size;
+
+#if VIDEO_HEADLESS
+    g_modex_start = start;
+    modex_scanout();
+#else
+    // La dirección se toma al empezar el retrace: se cambia fuera de él
+    while (inp(0x3DA) & 0x08) { }
+    outpw(0x3D4, (start & 0xFF00) | 0x0C);
+    outpw(0x3D4, ((start & 0x00FF) << 8) | 0x0D);
+#endif
+
+    g_modex_back = (g_modex_back + 1) % MODEX_PAGES;
+}
+#endif
 
 static const unsigned char font8x8_basic[96][8] = {
     { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
@@ -117,25 +597,88 @@ static const unsigned char font8x8_basic[96][8] = {
 
 void v_init_mode13(void)
 {
+#if !VIDEO_HEADLESS
     union REGS regs;
 
     regs.h.ah = 0x00;
     regs.h.al = 0x13;
     int86(0x10, &regs, &regs);
+#endif
 
 #if USE_BACKBUFFER
     backbuffer = (unsigned char far *)_fmalloc((unsigned long)VIDEO_WIDTH * VIDEO_HEIGHT);
 #endif
+#if USE_MODEX
+    g_modex = 0;
+#endif
+    DIRTY_MARK_FULL();
+    v_font_expand();
+}
+
+int v_init_modex(int height)
+{
+    v_init_mode13();
+
+#if USE_MODEX
+    if (backbuffer == NULL) {
+        // Sin backbuffer no hay con qué componer: se queda en 13h
+        return 0;
+    }
+
+    if (height != 240) {
+        height = 200;
+    }
+
+#if !VIDEO_HEADLESS
+    outpw(0x3C4, 0x0604); // Chain-4 fuera
+    outpw(0x3D4, 0x0014); // Sin direccionamiento por dword
+    outpw(0x3D4, 0xE317); // Direccionamiento por byte
+
+    if (height == 240) {
+        // Temporización de 480 líneas con doble scan
+        outpw(0x3C4, 0x0100);
+        outp(0x3C2, 0xE3);
+        outpw(0x3C4, 0x0300);
+        outpw(0x3D4, 0x2C11); // Desproteger registros 0-7
+        outpw(0x3D4, 0x0D06);
+        outpw(0x3D4, 0x3E07);
+        outpw(0x3D4, 0xEA10);
+        outpw(0x3D4, 0xAC11);
+        outpw(0x3D4, 0xDF12);
+        outpw(0x3D4, 0xE715);
+        outpw(0x3D4, 0x0616);
+    }
+
+    outpw(0x3C4, 0x0F02);
+    _fmemset(VGA, 0, 0x8000U);
+    _fmemset(VGA + 0x8000U, 0, 0x8000U);
+#else
+    memset(g_modex_planes, 0, sizeof(g_modex_planes));
+    g_modex_start = 0;
+#endif
 
+    g_modex = 1;
+    g_modex_top = (height - VIDEO_HEIGHT) / 2;
+    g_modex_page_size = (unsigned int)(VIDEO_WIDTH / 4) * (unsigned int)height;
+    g_modex_back = 1;
+    g_modex_stale_full = 1;
+    DIRTY_MARK_FULL();
+    return 1;
+#else
+    (void)height;
+    return 0;
+#endif
 }
 
 void v_text_mode(void)
 {
+#if !VIDEO_HEADLESS
     union REGS regs;
 
     regs.h.ah = 0x00;
     regs.h.al = 0x03;
     int86(0x10, &regs, &regs);
+#endif
 
 #if USE_BACKBUFFER
     if (backbuffer != NULL) {
@@ -143,114 +686,607 @@ void v_text_mode(void)
         backbuffer = NULL;
     }
 #endif
-
+#if USE_MODEX
+    g_modex = 0;
+#endif
+#if USE_TEXT_CACHE
+    text_cache_reset();
+#endif
 }
 
-void v_clear(unsigned char color)
+static Surface *v_screen(void)
 {
-    unsigned char far *dst;
-
 #if USE_BACKBUFFER
-    if (backbuffer != NULL) {
-        _fmemset(backbuffer, color, VIDEO_WIDTH * VIDEO_HEIGHT);
-        return;
-    }
+    g_screen.pixels = backbuffer != NULL ? backbuffer : VGA;
+#else
+    g_screen.pixels = VGA;
 #endif
-
-    dst = VGA;
-    _fmemset(dst, color, VIDEO_WIDTH * VIDEO_HEIGHT);
+    return &g_screen;
 }
 
-static void v_put_pixel(int x, int y, unsigned char color)
+#define TARGET() (g_target != NULL ? g_target : v_screen())
+
+static int surf_is_backbuffer(const Surface *s)
 {
-    if (x < 0 || y < 0 || x >= VIDEO_WIDTH || y >= VIDEO_HEIGHT) {
-        return;
-    }
 #if USE_BACKBUFFER
-    if (backbuffer != NULL) {
-        backbuffer[y * VIDEO_WIDTH + x] = color;
-        return;
-    }
+    return backbuffer != NULL && s->pixels == backbuffer;
+#else
+    (void)s;
+    return 0;
 #endif
-    VGA[y * VIDEO_WIDTH + x] = color;
 }
 
-void v_putpixel(int x, int y, unsigned char color)
+// Antes de escribir en [x0,x1)x[y0,y1), ya recortado a la superficie
+static void surf_touch(Surface *s, int x0, int y0, int x1, int y1)
 {
-    v_put_pixel(x, y, color);
+    if (surf_is_backbuffer(s)) {
+        g_frame_bytes += (unsigned long)(x1 - x0) * (unsigned long)(y1 - y0);
+        DIRTY_MARK(x0, y0, x1, y1);
+    } else {
+        DIRTY_BASE_TOUCHED(s->pixels, s->serial, x0, y0, x1, y1);
+        s->serial++;
+    }
 }
 
-void v_fill_rect(int x, int y, int w, int h, unsigned char color)
+static int surf_clip(const Surface *s, int *x0, int *y0, int *x1, int *y1)
 {
-    int x0;
-    int y0;
-    int x1;
-    int y1;
-    int row_w;
-    int iy;
-    unsigned char far *dst;
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 > s->w) *x1 = s->w;
+    if (*y1 > s->h) *y1 = s->h;
+    return *x0 < *x1 && *y0 < *y1;
+}
 
-    if (w <= 0 || h <= 0) {
-        return;
-    }
+// Recorte contra el origen y luego contra el destino
+static int surf_blit_clip(const Surface *dst, const Surface *src, int *dx, int *dy, int *sx, int *sy, int *w,
+                          int *h)
+{
+    if (*sx < 0) { *dx -= *sx; *w += *sx; *sx = 0; }
+    if (*sy < 0) { *dy -= *sy; *h += *sy; *sy = 0; }
+    if (*sx + *w > src->w) *w = src->w - *sx;
+    if (*sy + *h > src->h) *h = src->h - *sy;
+    if (*dx < 0) { *sx -= *dx; *w += *dx; *dx = 0; }
+    if (*dy < 0) { *sy -= *dy; *h += *dy; *dy = 0; }
+    if (*dx + *w > dst->w) *w = dst->w - *dx;
+    if (*dy + *h > dst->h) *h = dst->h - *dy;
+    return *w > 0 && *h > 0;
+}
 
-    x0 = x;
-    y0 = y;
-    x1 = x + w;
-    y1 = y + h;
+Surface *v_surface_screen(void)
+{
+    return v_screen();
+}
 
-    if (x0 < 0) {
-        x0 = 0;
-    }
-    if (y0 < 0) {
-        y0 = 0;
+int v_surface_alloc(Surface *s, int w, int h)
+{
+    if (!s) {
+        return 0;
     }
-    if (x1 > VIDEO_WIDTH) {
-        x1 = VIDEO_WIDTH;
+    s->pixels = NULL;
+    s->w = 0;
+    s->h = 0;
+    s->pitch = 0;
+    s->serial = 0;
+    // OJO: un solo segmento, como mucho una pantalla
+    if (w <= 0 || h <= 0 || (unsigned long)w * (unsigned long)h > (unsigned long)VIDEO_WIDTH * VIDEO_HEIGHT) {
+        return 0;
     }
-    if (y1 > VIDEO_HEIGHT) {
-        y1 = VIDEO_HEIGHT;
+
+    s->pixels = (unsigned char far *)_fmalloc((unsigned int)w * (unsigned int)h);
+    if (!s->pixels) {
+        return 0;
     }
+    s->w = w;
+    s->h = h;
+    s->pitch = (unsigned int)w;
+    return 1;
+}
 
-    if (x0 >= x1 || y0 >= y1) {
+void v_surface_free(Surface *s)
+{
+    if (!s) {
         return;
     }
-
-    row_w = x1 - x0;
-#if USE_BACKBUFFER
-    if (backbuffer != NULL) {
-        dst = backbuffer;
-    } else
-#endif
-    {
-        dst = VGA;
+    if (s == g_target) {
+        g_target = NULL;
     }
-
-    for (iy = y0; iy < y1; ++iy) {
-        unsigned char far *row = dst + (iy * VIDEO_WIDTH) + x0;
-        _fmemset(row, color, row_w);
+    if (s->pixels) {
+        // Otro _fmalloc puede devolver la misma dirección
+        DIRTY_BASE_FORGET(s->pixels);
+        _ffree(s->pixels);
     }
+    s->pixels = NULL;
+    s->w = 0;
+    s->h = 0;
+    s->pitch = 0;
 }
 
-void v_draw_dotted_rect(int x, int y, int w, int h, unsigned char base_color, unsigned char dot_color,
-                        int horizontal)
+void v_set_target(Surface *s)
 {
-    int ix;
-    int iy;
-    const int dot_step = 6;
-    const int dot_size = 2;
-    const int phase = -2;
+    g_target = s;
+}
 
-    for (iy = 0; iy < h; ++iy) {
-        for (ix = 0; ix < w; ++ix) {
-            v_put_pixel(x + ix, y + iy, base_color);
-        }
-    }
+Surface *v_get_target(void)
+{
+    return TARGET();
+}
 
-    if (!horizontal) {
-        for (iy = y; iy < y + h; ++iy) {
-            int row = iy / dot_step;
-            int x_offset = (row % 2) * (dot_step / 2);
+#if USE_RENDER_QUEUE
+typedef enum {
+    RQ_CLEAR = 0,
+    RQ_FILL,
+    RQ_PIXEL,
+    RQ_DOTTED,
+    RQ_SPRITE,
+    RQ_SPANS,
+    RQ_PUTS,
+    RQ_BLIT,
+    RQ_BLIT_KEYED
+} RqKind;
+
+typedef struct {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+} RqRect;
+
+typedef struct {
+    unsigned char kind;
+    unsigned char color;      // Color, transparente o base del punteado
+    unsigned char color2;     // Puntos del punteado
+    unsigned char culled;
+    int x;
+    int y;
+    int w;
+    int h;
+    int sx;
+    int sy;
+    int flag;                 // Punteado horizontal / offset del texto
+    RqRect bounds;            // En pantalla: exacto si es opaco, si no lo que puede tocar
+    const void far *ptr;      // Píxeles, SpanSprite o Surface
+    unsigned int frag_first;
+    unsigned int frag_count;
+} RqCmd;
+
+static RqCmd g_rq[RQ_MAX];
+static int g_rq_count = 0;
+static int g_rq_enabled = 0;
+static int g_rq_flushing = 0;
+static char g_rq_text[RQ_TEXT_BYTES];
+static unsigned int g_rq_text_used = 0;
+static RqRect g_rq_frags[RQ_FRAGS];
+static unsigned int g_rq_frag_used = 0;
+
+#define RQ_RECORDING(s) (g_rq_enabled && !g_rq_flushing && (s) == &g_screen)
+
+static long rq_area(const RqRect *r)
+{
+    return (long)(r->x1 - r->x0) * (long)(r->y1 - r->y0);
+}
+
+static int rq_contains(const RqRect *o, const RqRect *r)
+{
+    return r->x0 >= o->x0 && r->y0 >= o->y0 && r->x1 <= o->x1 && r->y1 <= o->y1;
+}
+
+static int rq_opaque(const RqCmd *c)
+{
+    return c->kind == RQ_CLEAR || c->kind == RQ_FILL || c->kind == RQ_DOTTED || c->kind == RQ_BLIT;
+}
+
+static void rq_add_occluder(RqRect *occ, int *count, const RqRect *r)
+{
+    int i;
+    int smallest = 0;
+
+    if (rq_area(r) < RQ_OCCLUDER_MIN_AREA) {
+        return;
+    }
+    if (*count < RQ_OCCLUDERS) {
+        occ[(*count)++] = *r;
+        return;
+    }
+    for (i = 1; i < *count; ++i) {
+        if (rq_area(&occ[i]) < rq_area(&occ[smallest])) {
+            smallest = i;
+        }
+    }
+    if (rq_area(r) > rq_area(&occ[smallest])) {
+        occ[smallest] = *r;
+    }
+}
+
+// Trocea un relleno quitando lo que tapan los opacos posteriores. 0 si no queda nada.
+static int rq_fragment(RqCmd *c, const RqRect *occ, int occ_count)
+{
+    RqRect pieces[RQ_FRAGS_PER_FILL];
+    int count = 1;
+    int i;
+
+    pieces[0] = c->bounds;
+    for (i = 0; i < occ_count && count > 0; ++i) {
+        const RqRect *o = &occ[i];
+        RqRect next[RQ_FRAGS_PER_FILL];
+        int next_count = 0;
+        int k;
+
+        for (k = 0; k < count; ++k) {
+            RqRect r = pieces[k];
+
+            if (o->x0 >= r.x1 || o->x1 <= r.x0 || o->y0 >= r.y1 || o->y1 <= r.y0) {
+                if (next_count >= RQ_FRAGS_PER_FILL) return 1;
+                next[next_count++] = r;
+                continue;
+            }
+            // Hasta 4 trozos: arriba, abajo y los lados de la franja central
+            if (next_count + 4 > RQ_FRAGS_PER_FILL) {
+                return 1;
+            }
+            if (o->y0 > r.y0) {
+                next[next_count].x0 = r.x0; next[next_count].y0 = r.y0;
+                next[next_count].x1 = r.x1; next[next_count].y1 = o->y0;
+                ++next_count;
+            }
+            if (o->y1 < r.y1) {
+                next[next_count].x0 = r.x0; next[next_count].y0 = o->y1;
+                next[next_count].x1 = r.x1; next[next_count].y1 = r.y1;
+                ++next_count;
+            }
+            if (o->x0 > r.x0) {
+                next[next_count].x0 = r.x0; next[next_count].y0 = o->y0 > r.y0 ? o->y0 : r.y0;
+                next[next_count].x1 = o->x0; next[next_count].y1 = o->y1 < r.y1 ? o->y1 : r.y1;
+                ++next_count;
+            }
+            if (o->x1 < r.x1) {
+                next[next_count].x0 = o->x1; next[next_count].y0 = o->y0 > r.y0 ? o->y0 : r.y0;
+                next[next_count].x1 = r.x1; next[next_count].y1 = o->y1 < r.y1 ? o->y1 : r.y1;
+                ++next_count;
+            }
+        }
+
+        for (k = 0; k < next_count; ++k) {
+            pieces[k] = next[k];
+        }
+        count = next_count;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+    if (count == 1 && pieces[0].x0 == c->bounds.x0 && pieces[0].y0 == c->bounds.y0 &&
+        pieces[0].x1 == c->bounds.x1 && pieces[0].y1 == c->bounds.y1) {
+        return 1;
+    }
+    if (g_rq_frag_used + (unsigned int)count > RQ_FRAGS) {
+        return 1;
+    }
+
+    c->frag_first = g_rq_frag_used;
+    c->frag_count = (unsigned int)count;
+    for (i = 0; i < count; ++i) {
+        g_rq_frags[g_rq_frag_used++] = pieces[i];
+    }
+    return 1;
+}
+
+static void rq_exec(const RqCmd *c)
+{
+    Surface *s = v_screen();
+    unsigned int i;
+
+    switch (c->kind) {
+    case RQ_CLEAR:
+        v_surf_clear(s, c->color);
+        break;
+    case RQ_FILL:
+        if (c->frag_count) {
+            for (i = 0; i < c->frag_count; ++i) {
+                const RqRect *r = &g_rq_frags[c->frag_first + i];
+                v_surf_fill_rect(s, r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0, c->color);
+            }
+        } else {
+            v_surf_fill_rect(s, c->bounds.x0, c->bounds.y0, c->bounds.x1 - c->bounds.x0,
+                             c->bounds.y1 - c->bounds.y0, c->color);
+        }
+        break;
+    case RQ_PIXEL:
+        v_surf_putpixel(s, c->x, c->y, c->color);
+        break;
+    case RQ_DOTTED:
+        v_surf_draw_dotted_rect(s, c->x, c->y, c->w, c->h, c->color, c->color2, c->flag);
+        break;
+    case RQ_SPRITE:
+        v_surf_blit_sprite(s, c->x, c->y, c->w, c->h, (const unsigned char far *)c->ptr, c->color);
+        break;
+    case RQ_SPANS:
+        v_surf_blit_sprite_spans(s, c->x, c->y, (const SpanSprite *)c->ptr);
+        break;
+    case RQ_PUTS:
+        v_surf_puts(s, c->x, c->y, g_rq_text + c->flag, c->color);
+        break;
+    case RQ_BLIT:
+        v_surf_blit(s, c->x, c->y, (const Surface *)c->ptr, c->sx, c->sy, c->w, c->h);
+        break;
+    case RQ_BLIT_KEYED:
+        v_surf_blit_keyed(s, c->x, c->y, (const Surface *)c->ptr, c->sx, c->sy, c->w, c->h, c->color);
+        break;
+    default:
+        break;
+    }
+}
+
+static void rq_flush(void)
+{
+    RqRect occ[RQ_OCCLUDERS];
+    int occ_count = 0;
+    int i;
+
+    if (g_rq_count == 0) {
+        return;
+    }
+
+    g_rq_flushing = 1;
+    g_rq_frag_used = 0;
+
+    // De atrás adelante: sólo tapa lo que se pinta después
+    for (i = g_rq_count - 1; i >= 0; --i) {
+        RqCmd *c = &g_rq[i];
+        int k;
+
+        c->culled = 0;
+        c->frag_count = 0;
+        for (k = 0; k < occ_count; ++k) {
+            if (rq_contains(&occ[k], &c->bounds)) {
+                c->culled = 1;
+                break;
+            }
+        }
+        if (!c->culled && c->kind == RQ_FILL && !rq_fragment(c, occ, occ_count)) {
+            c->culled = 1;
+        }
+        if (!c->culled && rq_opaque(c)) {
+            rq_add_occluder(occ, &occ_count, &c->bounds);
+        }
+    }
+
+    for (i = 0; i < g_rq_count; ++i) {
+        if (!g_rq[i].culled) {
+            rq_exec(&g_rq[i]);
+        }
+    }
+
+    g_rq_count = 0;
+    g_rq_text_used = 0;
+    g_rq_flushing = 0;
+}
+
+static RqCmd *rq_push(int kind, int x0, int y0, int x1, int y1)
+{
+    RqCmd *c;
+
+    if (g_rq_count >= RQ_MAX) {
+        // Cola llena: se ejecuta lo que hay y se sigue apuntando
+        rq_flush();
+    }
+
+    c = &g_rq[g_rq_count++];
+    c->kind = (unsigned char)kind;
+    c->bounds.x0 = x0;
+    c->bounds.y0 = y0;
+    c->bounds.x1 = x1;
+    c->bounds.y1 = y1;
+    c->ptr = NULL;
+    return c;
+}
+
+static void rq_fill(int x, int y, int w, int h, unsigned char color)
+{
+    int x0 = x;
+    int y0 = y;
+    int x1 = x + w;
+    int y1 = y + h;
+    RqCmd *c;
+
+    if (w <= 0 || h <= 0 || !surf_clip(&g_screen, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+
+    // Pegado a un relleno anterior del mismo color: se amplía ese
+    if (g_rq_count > 0) {
+        RqRect *p = &g_rq[g_rq_count - 1].bounds;
+
+        if (g_rq[g_rq_count - 1].kind == RQ_FILL && g_rq[g_rq_count - 1].color == color) {
+            if (p->x0 == x0 && p->x1 == x1 && (p->y1 == y0 || p->y0 == y1)) {
+                if (y0 < p->y0) p->y0 = y0;
+                if (y1 > p->y1) p->y1 = y1;
+                return;
+            }
+            if (p->y0 == y0 && p->y1 == y1 && (p->x1 == x0 || p->x0 == x1)) {
+                if (x0 < p->x0) p->x0 = x0;
+                if (x1 > p->x1) p->x1 = x1;
+                return;
+            }
+        }
+    }
+
+    c = rq_push(RQ_FILL, x0, y0, x1, y1);
+    c->color = color;
+}
+
+void v_set_deferred(int on)
+{
+    if (!on) {
+        rq_flush();
+    }
+    g_rq_enabled = on ? 1 : 0;
+}
+
+#define RQ_FLUSH() rq_flush()
+#else
+#define RQ_RECORDING(s) 0
+#define RQ_FLUSH() ((void)0)
+
+void v_set_deferred(int on)
+{
+    (void)on;
+}
+#endif
+
+void v_surf_clear(Surface *s, unsigned char color)
+{
+    int iy;
+
+    if (!s || !s->pixels) {
+        return;
+    }
+
+#if USE_RENDER_QUEUE
+    if (RQ_RECORDING(s)) {
+        rq_push(RQ_CLEAR, 0, 0, s->w, s->h)->color = color;
+        return;
+    }
+#endif
+
+    if (surf_is_backbuffer(s) && DIRTY_RESTORE(NULL, 0, color)) {
+        return;
+    }
+
+    if (s->pitch == (unsigned int)s->w) {
+        _fmemset(s->pixels, color, (unsigned int)s->w * (unsigned int)s->h);
+    } else {
+        for (iy = 0; iy < s->h; ++iy) {
+            _fmemset(s->pixels + (unsigned int)iy * s->pitch, color, s->w);
+        }
+    }
+
+    if (surf_is_backbuffer(s)) {
+        DIRTY_REBASE(NULL, 0, color);
+        g_frame_bytes += (unsigned long)s->w * (unsigned long)s->h;
+    } else {
+        s->serial++;
+    }
+}
+
+void v_clear(unsigned char color)
+{
+    v_surf_clear(TARGET(), color);
+}
+
+// Sin marcar: quien la llame toca el rectángulo entero una vez
+static void surf_plot(Surface *s, int x, int y, unsigned char color)
+{
+    if (x < 0 || y < 0 || x >= s->w || y >= s->h) {
+        return;
+    }
+    s->pixels[(unsigned int)y * s->pitch + x] = color;
+}
+
+void v_surf_putpixel(Surface *s, int x, int y, unsigned char color)
+{
+    if (!s || !s->pixels || x < 0 || y < 0 || x >= s->w || y >= s->h) {
+        return;
+    }
+#if USE_RENDER_QUEUE
+    if (RQ_RECORDING(s)) {
+        RqCmd *c = rq_push(RQ_PIXEL, x, y, x + 1, y + 1);
+        c->x = x;
+        c->y = y;
+        c->color = color;
+        return;
+    }
+#endif
+    surf_touch(s, x, y, x + 1, y + 1);
+    s->pixels[(unsigned int)y * s->pitch + x] = color;
+}
+
+void v_putpixel(int x, int y, unsigned char color)
+{
+    v_surf_putpixel(TARGET(), x, y, color);
+}
+
+void v_surf_fill_rect(Surface *s, int x, int y, int w, int h, unsigned char color)
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+    int iy;
+    unsigned char far *row;
+
+    if (!s || !s->pixels || w <= 0 || h <= 0) {
+        return;
+    }
+#if USE_RENDER_QUEUE
+    if (RQ_RECORDING(s)) {
+        rq_fill(x, y, w, h, color);
+        return;
+    }
+#endif
+
+    x0 = x;
+    y0 = y;
+    x1 = x + w;
+    y1 = y + h;
+    if (!surf_clip(s, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+
+    surf_touch(s, x0, y0, x1, y1);
+    row = s->pixels + (unsigned int)y0 * s->pitch + x0;
+    for (iy = y0; iy < y1; ++iy) {
+        _fmemset(row, color, x1 - x0);
+        row += s->pitch;
+    }
+}
+
+void v_fill_rect(int x, int y, int w, int h, unsigned char color)
+{
+    v_surf_fill_rect(TARGET(), x, y, w, h, color);
+}
+
+void v_surf_draw_dotted_rect(Surface *s, int x, int y, int w, int h, unsigned char base_color,
+                             unsigned char dot_color, int horizontal)
+{
+    int ix;
+    int iy;
+    const int dot_step = 6;
+    const int dot_size = 2;
+    const int phase = -2;
+
+    if (!s || !s->pixels || w <= 0 || h <= 0) {
+        return;
+    }
+
+#if USE_RENDER_QUEUE
+    if (RQ_RECORDING(s)) {
+        int x0 = x;
+        int y0 = y;
+        int x1 = x + w;
+        int y1 = y + h;
+        RqCmd *c;
+
+        if (surf_clip(s, &x0, &y0, &x1, &y1)) {
+            c = rq_push(RQ_DOTTED, x0, y0, x1, y1);
+            c->x = x;
+            c->y = y;
+            c->w = w;
+            c->h = h;
+            c->color = base_color;
+            c->color2 = dot_color;
+            c->flag = horizontal;
+        }
+        return;
+    }
+#endif
+
+    // La base es un rectángulo lleno; sólo los puntos van píxel a píxel
+    v_surf_fill_rect(s, x, y, w, h, base_color);
+
+    if (!horizontal) {
+        for (iy = y; iy < y + h; ++iy) {
+            int row = iy / dot_step;
+            int x_offset = (row % 2) * (dot_step / 2);
 
             if ((iy % dot_step) != 0) {
                 continue;
@@ -273,7 +1309,7 @@ void v_draw_dotted_rect(int x, int y, int w, int h, unsigned char base_color, un
 
                     for (dy = 0; dy < dot_h; ++dy) {
                         for (dx = 0; dx < dot_w; ++dx) {
-                            v_put_pixel(ix + dx, iy + dy, dot_color);
+                            surf_plot(s, ix + dx, iy + dy, dot_color);
                         }
                     }
                 }
@@ -305,7 +1341,7 @@ void v_draw_dotted_rect(int x, int y, int w, int h, unsigned char base_color, un
 
                     for (dy = 0; dy < dot_h; ++dy) {
                         for (dx = 0; dx < dot_w; ++dx) {
-                            v_put_pixel(ix + dx, iy + dy, dot_color);
+                            surf_plot(s, ix + dx, iy + dy, dot_color);
                         }
                     }
                 }
@@ -314,74 +1350,433 @@ void v_draw_dotted_rect(int x, int y, int w, int h, unsigned char base_color, un
     }
 }
 
-static void v_put_char(int x, int y, char c, unsigned char color)
+void v_draw_dotted_rect(int x, int y, int w, int h, unsigned char base_color, unsigned char dot_color,
+                        int horizontal)
+{
+    v_surf_draw_dotted_rect(TARGET(), x, y, w, h, base_color, dot_color, horizontal);
+}
+
+static int v_glyph_index(char c)
+{
+    if (c < 32 || c > 127) {
+        c = '?';
+    }
+    return c - 32;
+}
+
+static void v_font_expand(void)
+{
+    int g;
+    int i;
+    int j;
+
+    if (g_font_ready) {
+        return;
+    }
+
+    for (g = 0; g < 96; ++g) {
+        for (i = 0; i < 8; ++i) {
+            for (j = 0; j < 8; ++j) {
+                g_font_mask[g][i * 8 + j] = (font8x8_basic[g][i] & (1 << (7 - j))) ? 0xFF : 0x00;
+            }
+        }
+    }
+    g_font_ready = 1;
+}
+
+// Glifo entero dentro de la superficie: máscara por words, sin tests por píxel
+static void surf_put_char_fast(unsigned char far *dst, unsigned int pitch, int index, unsigned char color)
+{
+    const unsigned short *m = (const unsigned short *)g_font_mask[index];
+    unsigned short c2 = (unsigned short)(color | (color << 8));
+    int i;
+
+    for (i = 0; i < 8; ++i) {
+        if (font8x8_basic[index][i]) {
+            unsigned short far *d = (unsigned short far *)dst;
+            d[0] = (unsigned short)((d[0] & ~m[0]) | (c2 & m[0]));
+            d[1] = (unsigned short)((d[1] & ~m[1]) | (c2 & m[1]));
+            d[2] = (unsigned short)((d[2] & ~m[2]) | (c2 & m[2]));
+            d[3] = (unsigned short)((d[3] & ~m[3]) | (c2 & m[3]));
+        }
+        m += 4;
+        dst += pitch;
+    }
+}
+
+static void surf_put_char(Surface *s, int x, int y, char c, unsigned char color)
 {
     unsigned char row;
     int i;
     int j;
     unsigned char mask;
-    int index;
+    int index = v_glyph_index(c);
 
-    if (c < 32 || c > 127) {
-        c = '?';
+    for (i = 0; i < 8; ++i) {
+        row = font8x8_basic[index][i];
+        for (j = 0; j < 8; ++j) {
+            mask = 1 << (7 - j);
+            if (row & mask) {
+                surf_plot(s, x + j, y + i, color);
+            }
+        }
+    }
+}
+
+static void surf_puts_raw(Surface *s, int x, int y, const char *text, int len, unsigned char color)
+{
+    int cursor;
+
+    v_font_expand();
+
+    // Un solo test de recorte para toda la cadena
+    if (x >= 0 && y >= 0 && x + len * 8 <= s->w && y + 8 <= s->h) {
+        unsigned char far *dst = s->pixels + (unsigned int)y * s->pitch + x;
+
+        for (cursor = 0; cursor < len; ++cursor) {
+            surf_put_char_fast(dst, s->pitch, v_glyph_index(text[cursor]), color);
+            dst += 8;
+        }
+        return;
+    }
+
+    for (cursor = 0; cursor < len; ++cursor) {
+        int cx = x + cursor * 8;
+
+        if (cx >= 0 && y >= 0 && cx + 8 <= s->w && y + 8 <= s->h) {
+            surf_put_char_fast(s->pixels + (unsigned int)y * s->pitch + cx, s->pitch,
+                               v_glyph_index(text[cursor]), color);
+        } else {
+            surf_put_char(s, cx, y, text[cursor], color);
+        }
+    }
+}
+
+#if USE_TEXT_CACHE
+static void text_cache_drop(TextCacheEntry *e)
+{
+    v_sprite_spans_free(&e->spans);
+    e->text[0] = '\0';
+    e->len = 0;
+    e->hits = 0;
+}
+
+static void text_cache_reset(void)
+{
+    int i;
+
+    for (i = 0; i < TEXT_CACHE_SLOTS; ++i) {
+        text_cache_drop(&g_text_cache[i]);
+    }
+}
+
+// Rasteriza la cadena a un buffer y la guarda como tramos opacos
+static void text_cache_build(TextCacheEntry *e)
+{
+    static unsigned char tmp[TEXT_CACHE_MAX_LEN * 8 * 8];
+    Surface scratch;
+    unsigned char key = (unsigned char)(e->color ^ 0xFF);
+
+    scratch.w = e->len * 8;
+    scratch.h = 8;
+    scratch.pitch = (unsigned int)scratch.w;
+    scratch.serial = 0;
+    scratch.pixels = (unsigned char far *)tmp;
+
+    _fmemset(scratch.pixels, key, scratch.pitch * 8);
+    surf_puts_raw(&scratch, 0, 0, e->text, e->len, e->color);
+    v_sprite_spans_build(&e->spans, scratch.w, 8, scratch.pixels, key);
+}
+
+static int text_cache_draw(Surface *s, int x, int y, const char *text, int len, unsigned char color)
+{
+    TextCacheEntry *e = NULL;
+    TextCacheEntry *oldest = &g_text_cache[0];
+    int i;
+
+    if (len > TEXT_CACHE_MAX_LEN) {
+        return 0;
+    }
+
+    g_text_cache_clock++;
+    for (i = 0; i < TEXT_CACHE_SLOTS; ++i) {
+        TextCacheEntry *c = &g_text_cache[i];
+        if (c->len > 0 && c->x == x && c->y == y) {
+            e = c;
+            break;
+        }
+        if ((unsigned short)(g_text_cache_clock - c->stamp) >
+            (unsigned short)(g_text_cache_clock - oldest->stamp)) {
+            oldest = c;
+        }
+    }
+
+    if (e && (e->color != color || e->len != len || strcmp(e->text, text) != 0)) {
+        text_cache_drop(e);
+    }
+    if (!e) {
+        e = oldest;
+        text_cache_drop(e);
+    }
+
+    if (e->len == 0) {
+        e->x = x;
+        e->y = y;
+        e->color = color;
+        e->len = len;
+        memcpy(e->text, text, len + 1);
+    }
+    e->stamp = g_text_cache_clock;
+
+    // OJO: sólo se codifica lo que se repite; un texto que cambia cada frame no paga el coste
+    if (!e->spans.data) {
+        if (e->hits < 1) {
+            e->hits++;
+            return 0;
+        }
+        text_cache_build(e);
+        if (!e->spans.data) {
+            return 0;
+        }
+    }
+
+    v_surf_blit_sprite_spans(s, x, y, &e->spans);
+    return 1;
+}
+#endif
+
+void v_surf_puts(Surface *s, int x, int y, const char *text, unsigned char color)
+{
+    int len = 0;
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+
+    if (!s || !s->pixels || !text) {
+        return;
+    }
+
+    while (text[len] != '\0') {
+        ++len;
+    }
+    x0 = x;
+    y0 = y;
+    x1 = x + len * 8;
+    y1 = y + 8;
+    if (len == 0 || !surf_clip(s, &x0, &y0, &x1, &y1)) {
+        return;
     }
-    index = c - 32;
 
-    for (i = 0; i < 8; ++i) {
-        row = font8x8_basic[index][i];
-        for (j = 0; j < 8; ++j) {
-            mask = 1 << (7 - j);
-            if (row & mask) {
-                v_put_pixel(x + j, y + i, color);
+#if USE_RENDER_QUEUE
+    if (RQ_RECORDING(s)) {
+        RqCmd *c;
+
+        // El texto suele estar en la pila de quien llama: se copia
+        if (g_rq_text_used + (unsigned int)len + 1 > RQ_TEXT_BYTES) {
+            rq_flush();
+            if ((unsigned int)len + 1 > RQ_TEXT_BYTES) {
+                v_surf_puts(s, x, y, text, color);
+                return;
             }
         }
+        c = rq_push(RQ_PUTS, x0, y0, x1, y1);
+        c->x = x;
+        c->y = y;
+        c->color = color;
+        c->flag = (int)g_rq_text_used;
+        memcpy(g_rq_text + g_rq_text_used, text, (unsigned int)len + 1);
+        g_rq_text_used += (unsigned int)len + 1;
+        return;
     }
+#endif
+
+#if USE_TEXT_CACHE
+    if (surf_is_backbuffer(s) && text_cache_draw(s, x, y, text, len, color)) {
+        return;
+    }
+#endif
+
+    surf_touch(s, x0, y0, x1, y1);
+    surf_puts_raw(s, x, y, text, len, color);
 }
 
 void v_puts(int x, int y, const char *text, unsigned char color)
 {
-    int cursor = 0;
-
-    while (text[cursor] != '\0') {
-        v_put_char(x + cursor * 8, y, text[cursor], color);
-        ++cursor;
-    }
+    v_surf_puts(TARGET(), x, y, text, color);
 }
 
+static uint32_t g_vsync_wait_us = 0;
+
 static void v_wait_vsync(void)
 {
+#if !VIDEO_HEADLESS
+    uint32_t t0 = timer_now_us();
+
     // Espera fin de retrace actual
     while (inp(0x3DA) & 0x08) { }
     // Espera inicio del siguiente retrace
     while (!(inp(0x3DA) & 0x08)) { }
+    g_vsync_wait_us = timer_now_us() - t0;
+#endif
 }
 
-void v_present(void)
+uint32_t v_vsync_wait_us(void)
+{
+    return g_vsync_wait_us;
+}
+
+static uint64_t v_hash_bytes(uint64_t h, const unsigned char far *p, unsigned int n)
+{
+    // De 8 en 8 bytes: xor, multiplicación y plegado
+    while (n >= 8) {
+        uint64_t v = (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
+                     ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+                     ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+        h ^= v;
+        h *= 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 32;
+        p += 8;
+        n -= 8;
+    }
+    while (n-- > 0) {
+        h ^= *p++;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// Frame visible en lineal
+static const unsigned char far *v_scanout(void)
+{
+#if USE_MODEX && !VIDEO_HEADLESS
+    // La VGA planar no se lee en lineal; tras el present coincide con el backbuffer
+    if (g_modex) {
+        return backbuffer;
+    }
+#endif
+    return VGA;
+}
+
+static uint64_t v_hash_screen(void)
+{
+    uint64_t h = 0xCBF29CE484222325ULL;
+
+    h = v_hash_bytes(h, v_scanout(), VIDEO_WIDTH * VIDEO_HEIGHT);
+    h = v_hash_bytes(h, (const unsigned char far *)g_dac_shadow, sizeof(g_dac_shadow));
+    return h;
+}
+
+static void v_frame_presented(void)
+{
+    g_frame_count++;
+    g_frame_bytes_last = g_frame_bytes;
+    g_frame_bytes = 0;
+#if VIDEO_FRAME_HASH
+    g_frame_hash = v_hash_screen();
+#else
+    if (g_hash_log) {
+        g_frame_hash = v_hash_screen();
+    }
+#endif
+    if (g_hash_log) {
+        fprintf(g_hash_log, "%lu %08lx%08lx\n", g_frame_count,
+                (unsigned long)(g_frame_hash >> 32), (unsigned long)(g_frame_hash & 0xFFFFFFFFUL));
+    }
+#if USE_CAPTURE
+    if (cap_active()) {
+#if USE_BACKBUFFER
+        // Se lee del backbuffer: leer de la VGA es lento
+        cap_frame(backbuffer ? backbuffer : VGA, g_dac_shadow, g_present_y0, g_present_y1);
+#else
+        cap_frame(VGA, g_dac_shadow, 0, VIDEO_HEIGHT);
+#endif
+    }
+#endif
+}
+
+static void v_present_frame(void)
 {
+    RQ_FLUSH();
 #if USE_BACKBUFFER
     if (backbuffer != NULL) {
+#if USE_MODEX
+        if (g_modex) {
+            modex_upload();
+            modex_flip();
+            // Hasta el retrace la página recién oculta sigue en pantalla
+            v_wait_vsync();
+            pal_fx_update();
+            v_frame_presented();
+            return;
+        }
+#endif
         v_wait_vsync();
+        pal_fx_update();
+#if USE_DIRTY_RECTS
+        dirty_copy_to_vga();
+#else
         _fmemcpy(VGA, backbuffer, VIDEO_WIDTH * VIDEO_HEIGHT);
+#endif
+        v_frame_presented();
+        return;
     }
 #endif
+    // Sin backbuffer ya se pinta en la VGA: el retrace sólo hace falta para la paleta
+    v_wait_vsync();
+    pal_fx_update();
+    v_frame_presented();
 }
 
 unsigned char far *v_backbuffer_ptr(void)
 {
 #if USE_BACKBUFFER
+    // Quien pide el puntero puede escribir donde quiera
+    RQ_FLUSH();
+    DIRTY_MARK_FULL();
     return backbuffer;
 #else
     return VGA;
 #endif
 }
 
+void v_present(void)
+{
+    g_vsync_wait_us = 0;
+    prof_begin(PROF_PRESENT);
+    prof_overlay_draw();
+    v_present_frame();
+    prof_overlay_restore();
+    prof_end(PROF_PRESENT);
+}
+
 void v_present_fast(void)
 {
+    g_vsync_wait_us = 0;
+    prof_begin(PROF_PRESENT);
+    prof_overlay_draw();
+    RQ_FLUSH();
 #if USE_BACKBUFFER
+#if USE_MODEX
+    if (g_modex) {
+        // OJO: con dos páginas no se puede saltar la espera del flip
+        v_present_frame();
+        prof_overlay_restore();
+        prof_end(PROF_PRESENT);
+        return;
+    }
+#endif
     if (backbuffer != NULL) {
+#if USE_DIRTY_RECTS
+        dirty_copy_to_vga();
+#else
         _fmemcpy(VGA, backbuffer, VIDEO_WIDTH * VIDEO_HEIGHT);
+#endif
     }
 #endif
+    v_frame_presented();
+    prof_overlay_restore();
+    prof_end(PROF_PRESENT);
 }
 
 void v_blit_fullscreen_fast(const unsigned char far *src)
@@ -393,52 +1788,369 @@ void v_blit_fullscreen_fast(const unsigned char far *src)
     _fmemcpy(dst, src, VIDEO_WIDTH * VIDEO_HEIGHT);
 }
 
+void v_surf_blit_sprite(Surface *s, int x, int y, int w, int h, const unsigned char far *pixels,
+                        unsigned char transparent)
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+    int sy;
+
+    if (!s || !s->pixels || !pixels || w <= 0 || h <= 0) return;
+
+#if USE_RENDER_QUEUE
+    if (RQ_RECORDING(s)) {
+        RqCmd *c = rq_push(RQ_SPRITE, x, y, x + w, y + h);
+        c->x = x;
+        c->y = y;
+        c->w = w;
+        c->h = h;
+        c->ptr = pixels;
+        c->color = transparent;
+        return;
+    }
+#endif
+
+    x0 = x;
+    y0 = y;
+    x1 = x + w;
+    y1 = y + h;
+    if (!surf_clip(s, &x0, &y0, &x1, &y1)) return;
+    surf_touch(s, x0, y0, x1, y1);
+
+    for (sy = y0; sy < y1; ++sy) {
+        const unsigned char far *src = pixels + (unsigned int)(sy - y) * w + (x0 - x);
+        unsigned char far *dst = s->pixels + (unsigned int)sy * s->pitch + x0;
+        int n = x1 - x0;
+
+        while (n-- > 0) {
+            unsigned char p = *src++;
+            if (p != transparent) {
+                *dst = p;
+            }
+            ++dst;
+        }
+    }
+}
+
 void v_blit_sprite(int x, int y, int w, int h, const unsigned char far *pixels, unsigned char transparent)
 {
-    int sx, sy;
-    int dx, dy;
-    unsigned char p;
+    v_surf_blit_sprite(TARGET(), x, y, w, h, pixels, transparent);
+}
+
+void v_surf_blit(Surface *dst, int dx, int dy, const Surface *src, int sx, int sy, int w, int h)
+{
+    int iy;
+    const unsigned char far *sp;
+    unsigned char far *dp;
+
+    if (!dst || !src || !dst->pixels || !src->pixels || w <= 0 || h <= 0) {
+        return;
+    }
+
+#if USE_RENDER_QUEUE
+    if (src == &g_screen) {
+        RQ_FLUSH();
+    }
+    if (RQ_RECORDING(dst)) {
+        RqCmd *c;
+
+        if (surf_blit_clip(dst, src, &dx, &dy, &sx, &sy, &w, &h)) {
+            c = rq_push(RQ_BLIT, dx, dy, dx + w, dy + h);
+            c->x = dx;
+            c->y = dy;
+            c->sx = sx;
+            c->sy = sy;
+            c->w = w;
+            c->h = h;
+            c->ptr = src;
+        }
+        return;
+    }
+#endif
+
+    if (!surf_blit_clip(dst, src, &dx, &dy, &sx, &sy, &w, &h)) {
+        return;
+    }
+
+    sp = src->pixels + (unsigned int)sy * src->pitch + sx;
+    dp = dst->pixels + (unsigned int)dy * dst->pitch + dx;
+
+    if (w == dst->w && h == dst->h && surf_is_backbuffer(dst)) {
+        // Capa de fondo completa: si ya era la base basta con reponer lo pintado encima
+        if (DIRTY_RESTORE(src->pixels, src->serial, 0)) {
+            return;
+        }
+        DIRTY_REBASE(src->pixels, src->serial, 0);
+        g_frame_bytes += (unsigned long)w * (unsigned long)h;
+    } else {
+        surf_touch(dst, dx, dy, dx + w, dy + h);
+    }
+
+    if (w == dst->w && (unsigned int)w == dst->pitch && (unsigned int)w == src->pitch) {
+        _fmemcpy(dp, sp, (unsigned int)w * (unsigned int)h);
+        return;
+    }
+    for (iy = 0; iy < h; ++iy) {
+        _fmemcpy(dp, sp, w);
+        sp += src->pitch;
+        dp += dst->pitch;
+    }
+}
+
+void v_surf_blit_keyed(Surface *dst, int dx, int dy, const Surface *src, int sx, int sy, int w, int h,
+                       unsigned char transparent)
+{
+    int iy;
+
+    if (!dst || !src || !dst->pixels || !src->pixels || w <= 0 || h <= 0) {
+        return;
+    }
+
+#if USE_RENDER_QUEUE
+    if (src == &g_screen) {
+        RQ_FLUSH();
+    }
+    if (RQ_RECORDING(dst)) {
+        RqCmd *c;
+
+        if (surf_blit_clip(dst, src, &dx, &dy, &sx, &sy, &w, &h)) {
+            c = rq_push(RQ_BLIT_KEYED, dx, dy, dx + w, dy + h);
+            c->x = dx;
+            c->y = dy;
+            c->sx = sx;
+            c->sy = sy;
+            c->w = w;
+            c->h = h;
+            c->ptr = src;
+            c->color = transparent;
+        }
+        return;
+    }
+#endif
+
+    if (!surf_blit_clip(dst, src, &dx, &dy, &sx, &sy, &w, &h)) {
+        return;
+    }
+
+    surf_touch(dst, dx, dy, dx + w, dy + h);
+    for (iy = 0; iy < h; ++iy) {
+        const unsigned char far *sp = src->pixels + (unsigned int)(sy + iy) * src->pitch + sx;
+        unsigned char far *dp = dst->pixels + (unsigned int)(dy + iy) * dst->pitch + dx;
+        int n = w;
+
+        while (n-- > 0) {
+            unsigned char p = *sp++;
+            if (p != transparent) {
+                *dp = p;
+            }
+            ++dp;
+        }
+    }
+}
+
+#define SPAN_MAX_BYTES 65000UL
+
+// Recorre la fila y devuelve los bytes que ocupa codificada (emit == NULL sólo cuenta)
+static unsigned int v_span_encode_row(const unsigned char far *src, int w, unsigned char transparent,
+                                      unsigned char far *emit)
+{
+    unsigned int size = 0;
+    int x = 0;
+
+    while (x < w) {
+        int skip = 0;
+        int run = 0;
+
+        while (x + skip < w && src[x + skip] == transparent) {
+            ++skip;
+        }
+        if (x + skip >= w) {
+            break;
+        }
+        x += skip;
+        while (x + run < w && src[x + run] != transparent) {
+            ++run;
+        }
+
+        // OJO: los contadores son de un byte, los tramos largos se trocean
+        while (skip > 255) {
+            if (emit) {
+                emit[size] = 255;
+                emit[size + 1] = 0;
+            }
+            size += 2;
+            skip -= 255;
+        }
+        while (run > 0) {
+            int n = run > 255 ? 255 : run;
+
+            if (emit) {
+                emit[size] = (unsigned char)skip;
+                emit[size + 1] = (unsigned char)n;
+                _fmemcpy(emit + size + 2, src + x, n);
+            }
+            size += 2 + n;
+            x += n;
+            run -= n;
+            skip = 0;
+        }
+    }
+
+    if (emit) {
+        emit[size] = 0;
+        emit[size + 1] = 0;
+    }
+    return size + 2;
+}
+
+int v_sprite_spans_build(SpanSprite *spr, int w, int h, const unsigned char far *pixels, unsigned char transparent)
+{
+    unsigned long total;
+    unsigned long table;
+    unsigned int offset;
+    unsigned char far *block;
+    int sy;
+
+    if (!spr) {
+        return 0;
+    }
+    v_sprite_spans_free(spr);
+    if (!pixels || w <= 0 || h <= 0) {
+        return 0;
+    }
+
+    table = (unsigned long)h * sizeof(unsigned short);
+    total = table;
+    for (sy = 0; sy < h; ++sy) {
+        total += v_span_encode_row(pixels + (unsigned long)sy * w, w, transparent, NULL);
+    }
+    if (total > SPAN_MAX_BYTES) {
+        return 0;
+    }
 
-    if (w <= 0 || h <= 0) return;
+    block = (unsigned char far *)_fmalloc((unsigned int)total);
+    if (!block) {
+        return 0;
+    }
 
+    spr->rows = (unsigned short far *)block;
+    spr->data = block + (unsigned int)table;
+    offset = 0;
     for (sy = 0; sy < h; ++sy) {
-        dy = y + sy;
-        if (dy < 0 || dy >= VIDEO_HEIGHT) continue;
+        spr->rows[sy] = (unsigned short)offset;
+        offset += v_span_encode_row(pixels + (unsigned long)sy * w, w, transparent, spr->data + offset);
+    }
 
-        for (sx = 0; sx < w; ++sx) {
-            dx = x + sx;
-            if (dx < 0 || dx >= VIDEO_WIDTH) continue;
+    spr->w = (unsigned short)w;
+    spr->h = (unsigned short)h;
+    return 1;
+}
 
-            p = pixels[sy * w + sx];
-            if (p == transparent) continue;
+void v_sprite_spans_free(SpanSprite *spr)
+{
+    if (!spr) {
+        return;
+    }
+    if (spr->rows) {
+        _ffree(spr->rows);
+    }
+    spr->rows = NULL;
+    spr->data = NULL;
+    spr->w = 0;
+    spr->h = 0;
+}
 
-#if USE_BACKBUFFER
-            if (backbuffer != NULL) {
-                backbuffer[dy * VIDEO_WIDTH + dx] = p;
-            } else
+void v_surf_blit_sprite_spans(Surface *s, int x, int y, const SpanSprite *spr)
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+    int sy;
+
+    if (!s || !s->pixels || !spr || !spr->data || spr->w == 0 || spr->h == 0) return;
+
+#if USE_RENDER_QUEUE
+    if (RQ_RECORDING(s)) {
+        RqCmd *c = rq_push(RQ_SPANS, x, y, x + (int)spr->w, y + (int)spr->h);
+        c->x = x;
+        c->y = y;
+        c->ptr = spr;
+        return;
+    }
 #endif
-            {
-                VGA[dy * VIDEO_WIDTH + dx] = p;
+
+    x0 = x;
+    y0 = y;
+    x1 = x + spr->w;
+    y1 = y + spr->h;
+    if (!surf_clip(s, &x0, &y0, &x1, &y1)) return;
+    surf_touch(s, x0, y0, x1, y1);
+
+    for (sy = y0 - y; sy < y1 - y; ++sy) {
+        const unsigned char far *p = spr->data + spr->rows[sy];
+        unsigned char far *row = s->pixels + (unsigned int)(y + sy) * s->pitch;
+        int cx = x;
+
+        for (;;) {
+            int skip = p[0];
+            int run = p[1];
+            int left;
+            int n;
+            const unsigned char far *src;
+
+            if (skip == 0 && run == 0) {
+                break;
+            }
+            p += 2;
+            cx += skip;
+            if (cx >= s->w) {
+                break;
             }
+
+            // Recorte de tramos enteros en los bordes
+            left = cx;
+            n = run;
+            src = p;
+            if (left < 0) {
+                n += left;
+                src -= left;
+                left = 0;
+            }
+            if (left + n > s->w) {
+                n = s->w - left;
+            }
+            if (n > 0) {
+                _fmemcpy(row + left, src, n);
+            }
+
+            p += run;
+            cx += run;
         }
     }
 }
 
-void v_set_palette_raw(const unsigned char *rgb, int count)
+void v_blit_sprite_spans(int x, int y, const SpanSprite *spr)
+{
+    v_surf_blit_sprite_spans(TARGET(), x, y, spr);
+}
+
+void v_dac_write(int first, int count, const unsigned char *rgb)
 {
     int i;
-    if (!rgb || count <= 0) return;
 
-    if (count > 256) {
-        count = 256;
-    }
-    memcpy(current_palette, rgb, count * 3);
-    if (count < 256) {
-        memset(current_palette + (count * 3), 0, (256 - count) * 3);
+    if (!rgb || first < 0 || count <= 0) return;
+    if (first + count > 256) {
+        count = 256 - first;
     }
 
+    memcpy(g_dac_shadow + first * 3, rgb, count * 3);
+
+#if !VIDEO_HEADLESS
     // VGA DAC: índice 0x3C8, datos 0x3C9
-    outp(0x3C8, 0); // Empieza en el color 0
+    outp(0x3C8, first);
 
     for (i = 0; i < count; ++i) {
         // Componentes 0..63 (6 bits)
@@ -446,6 +2158,33 @@ void v_set_palette_raw(const unsigned char *rgb, int count)
         outp(0x3C9, rgb[i * 3 + 1]);
         outp(0x3C9, rgb[i * 3 + 2]);
     }
+#else
+    (void)i;
+#endif
+}
+
+void v_set_palette_raw(const unsigned char *rgb, int count)
+{
+    if (!rgb || count <= 0) return;
+
+    if (count > 256) {
+        count = 256;
+    }
+    memcpy(current_palette, rgb, count * 3);
+    if (count < 256) {
+        memset(current_palette + (count * 3), 0, (256 - count) * 3);
+    }
+
+    // Con un fundido o ciclo en marcha el DAC lo lleva palfx
+    if (pal_fx_palette_changed()) {
+        return;
+    }
+    v_dac_write(0, count, rgb);
+}
+
+const unsigned char *v_palette_ptr(void)
+{
+    return current_palette;
 }
 
 static int v_read_palette_file(const char *filename, unsigned char *pal, int size)
@@ -492,3 +2231,72 @@ void v_lock_palette(const char *filename)
     palette_locked = 1;
     v_set_palette_raw(locked_palette, 256);
 }
+
+uint64_t v_frame_hash(void)
+{
+#if VIDEO_FRAME_HASH
+    return g_frame_hash;
+#else
+    return v_hash_screen();
+#endif
+}
+
+unsigned long v_frame_count(void)
+{
+    return g_frame_count;
+}
+
+int v_dump_ppm(const char *path)
+{
+    FILE *f;
+    unsigned char line[VIDEO_WIDTH * 3];
+    int x;
+    int y;
+
+    if (!path) return 0;
+
+    f = fopen(path, "wb");
+    if (!f) return 0;
+
+    fprintf(f, "P6\n%d %d\n255\n", VIDEO_WIDTH, VIDEO_HEIGHT);
+    for (y = 0; y < VIDEO_HEIGHT; ++y) {
+        const unsigned char far *src = v_scanout() + (unsigned int)y * VIDEO_WIDTH;
+
+        for (x = 0; x < VIDEO_WIDTH; ++x) {
+            const unsigned char *rgb = g_dac_shadow + src[x] * 3;
+            // DAC de 6 bits a 8 bits
+            line[x * 3 + 0] = (unsigned char)((rgb[0] << 2) | (rgb[0] >> 4));
+            line[x * 3 + 1] = (unsigned char)((rgb[1] << 2) | (rgb[1] >> 4));
+            line[x * 3 + 2] = (unsigned char)((rgb[2] << 2) | (rgb[2] >> 4));
+        }
+        if (fwrite(line, 1, sizeof(line), f) != sizeof(line)) {
+            fclose(f);
+            return 0;
+        }
+    }
+
+    fclose(f);
+    return 1;
+}
+
+int v_hash_log_open(const char *path)
+{
+    v_hash_log_close();
+    if (!path) return 0;
+
+    g_hash_log = fopen(path, "w");
+    return g_hash_log != NULL;
+}
+
+void v_hash_log_close(void)
+{
+    if (g_hash_log) {
+        fclose(g_hash_log);
+        g_hash_log = NULL;
+    }
+}
+
+unsigned long v_frame_bytes(void)
+{
+    return g_frame_bytes_last;
+}
@@ -4,21 +4,92 @@
 #define VIDEO_WIDTH 320
 #define VIDEO_HEIGHT 200
 
+#include <stdint.h>
+
+#include "platform.h"
+
+// Backend sin hardware: VRAM y DAC en memoria, hash por frame y volcado a PPM
+#ifndef VIDEO_HEADLESS
+#define VIDEO_HEADLESS PLATFORM_HOST
+#endif
+
+// Superficie en memoria; la pantalla (backbuffer) es una más.
+// serial cambia cada vez que se pinta en ella (sirve para saber si una capa cambió).
+typedef struct {
+    int w;
+    int h;
+    unsigned int pitch;
+    unsigned short serial;
+    unsigned char far *pixels;
+} Surface;
+
+// Sprite codificado por filas: pares [salto][tramo] + tramo bytes opacos, fila acaba en [0][0]
+typedef struct {
+    unsigned short w;
+    unsigned short h;
+    unsigned short far *rows;
+    unsigned char far *data;
+} SpanSprite;
+
 void v_init_mode13(void);
+// Modo X de 320x200 o 320x240 con flip de páginas; devuelve 0 y se queda en 13h si no puede
+int v_init_modex(int height);
 void v_text_mode(void);
 void v_clear(unsigned char color);
 void v_puts(int x, int y, const char *text, unsigned char color);
 void v_present(void);
+// Lo que se fue esperando al retrace en el último v_present (no es coste de pintar)
+uint32_t v_vsync_wait_us(void);
 unsigned char far *v_backbuffer_ptr(void);
 void v_present_fast(void);
 void v_blit_fullscreen_fast(const unsigned char far *src);
 void v_putpixel(int x, int y, unsigned char color);
 void v_fill_rect(int x, int y, int w, int h, unsigned char color);
 void v_blit_sprite(int x, int y, int w, int h, const unsigned char far *pixels, unsigned char transparent);
+// 0 si no hay memoria (o no cabe): spr queda vacío y se sigue con el blit por píxel
+int v_sprite_spans_build(SpanSprite *spr, int w, int h, const unsigned char far *pixels, unsigned char transparent);
+void v_sprite_spans_free(SpanSprite *spr);
+void v_blit_sprite_spans(int x, int y, const SpanSprite *spr);
+
+Surface *v_surface_screen(void);
+int v_surface_alloc(Surface *s, int w, int h);
+void v_surface_free(Surface *s);
+// Redirige las primitivas v_* a otra superficie; NULL vuelve a la pantalla
+void v_set_target(Surface *s);
+Surface *v_get_target(void);
+void v_surf_clear(Surface *s, unsigned char color);
+void v_surf_putpixel(Surface *s, int x, int y, unsigned char color);
+void v_surf_fill_rect(Surface *s, int x, int y, int w, int h, unsigned char color);
+void v_surf_draw_dotted_rect(Surface *s, int x, int y, int w, int h, unsigned char base_color,
+                             unsigned char dot_color, int horizontal);
+void v_surf_puts(Surface *s, int x, int y, const char *text, unsigned char color);
+void v_surf_blit_sprite(Surface *s, int x, int y, int w, int h, const unsigned char far *pixels,
+                        unsigned char transparent);
+void v_surf_blit_sprite_spans(Surface *s, int x, int y, const SpanSprite *spr);
+void v_surf_blit(Surface *dst, int dx, int dy, const Surface *src, int sx, int sy, int w, int h);
+void v_surf_blit_keyed(Surface *dst, int dx, int dy, const Surface *src, int sx, int sy, int w, int h,
+                       unsigned char transparent);
+
 void v_set_palette_raw(const unsigned char *rgb, int count);
+const unsigned char *v_palette_ptr(void);
+void v_dac_write(int first, int count, const unsigned char *rgb);
 void v_load_palette(const char *filename);
 void v_lock_palette(const char *filename);
 void v_draw_dotted_rect(int x, int y, int w, int h, unsigned char base_color, unsigned char dot_color,
                         int horizontal);
 
+// Modo diferido: lo pintado en pantalla se ejecuta en v_present sin lo que queda tapado
+// OJO: la cola guarda los punteros a los píxeles de sprites, spans y blits, no una
+// copia; no se pueden liberar ni reescribir hasta v_present (o v_set_deferred(0))
+void v_set_deferred(int on);
+// Bytes que escribieron las primitivas en el backbuffer durante el último frame
+unsigned long v_frame_bytes(void);
+
+// Frame presentado: hash de índices + DAC, contador y volcado a PPM (P6)
+uint64_t v_frame_hash(void);
+unsigned long v_frame_count(void);
+int v_dump_ppm(const char *path);
+int v_hash_log_open(const char *path);
+void v_hash_log_close(void);
+
 #endif
@@ -1,8 +1,10 @@
 #include "cutscene.h"
 
 #include "../CORE/video.h"
+#include "../CORE/frame.h"
 #include "../CORE/input.h"
 #include "../CORE/keyboard.h"
+#include "../CORE/sound.h"
 #include "../CORE/sprite_dat.h"
 #include "../CORE/timer.h"
 
@@ -127,7 +129,9 @@ int Cutscene_Play(const char *scene_id)
         v_puts(8, 8, "CUTS.TXT NO ENCONTRADO", 12);
         v_puts(8, 20, "REVISA EL DIRECTORIO ACTUAL", 15);
         v_present();
-        while (in_poll() == IN_KEY_NONE) { }
+        while (in_poll() == IN_KEY_NONE) {
+            frame_wait_input();
+        }
         return 1;
     }
 
@@ -135,8 +139,10 @@ int Cutscene_Play(const char *scene_id)
     sprite_visible = 0;
     current_sprite[0] = '\0';
 
+    // escena|sprite|posición|borrar|texto[|muestra]: la muestra (SOUNDS\<nombre>.wav)
+    // suena al empezar la línea, p. ej. los ladridos de la Retro Police
     while (fgets(line, sizeof(line), file)) {
-        char *fields[5] = {0};
+        char *fields[6] = {0};
         char *p = line;
         int field = 0;
 
@@ -149,7 +155,7 @@ int Cutscene_Play(const char *scene_id)
         }
 
         fields[0] = line;
-        for (p = line; *p && field < 4; ++p) {
+        for (p = line; *p && field < 5; ++p) {
             if (*p == '|') {
                 *p = '\0';
                 fields[++field] = p + 1;
@@ -168,6 +174,7 @@ int Cutscene_Play(const char *scene_id)
             const char *pos_text = fields[2];
             const char *clear_text = fields[3];
             const char *raw_text = fields[4];
+            const char *sample_name = fields[5];
             char text[512];
             char pos = 'C';
             int clear_screen = 0;
@@ -175,6 +182,7 @@ int Cutscene_Play(const char *scene_id)
             int sprite_changed = 0;
             size_t text_len = 0;
             size_t visible = 0;
+            size_t drawn = (size_t)-1;
             uint32_t start_us = timer_now_us();
 
             if (pos_text && pos_text[0]) {
@@ -231,6 +239,15 @@ int Cutscene_Play(const char *scene_id)
                 current_sprite[0] = '\0';
             }
 
+            if (sample_name && sample_name[0] != '\0') {
+                char path[96];
+                snprintf(path, sizeof(path), "SOUNDS\\%s.wav", sample_name);
+                // Queda cargada hasta la siguiente: cortarla aquí la dejaría a medias
+                if (sound_load_sample(path)) {
+                    sound_play_sample();
+                }
+            }
+
             in_clear();
 
             for (;;) {
@@ -258,8 +275,13 @@ int Cutscene_Play(const char *scene_id)
                     }
                 }
 
-                cutscene_draw_text(text, visible);
-                v_present();
+                // Sólo se repinta cuando aparece una letra nueva
+                if (visible != drawn) {
+                    cutscene_draw_text(text, visible);
+                    v_present();
+                    drawn = visible;
+                }
+                frame_wait_input();
             }
         }
     }
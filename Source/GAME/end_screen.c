@@ -1,5 +1,6 @@
 #include "end_screen.h"
 
+#include "../CORE/frame.h"
 #include "../CORE/input.h"
 #include "../CORE/sound.h"
 #include "../CORE/timer.h"
@@ -7,22 +8,11 @@
 #include "../CORE/colors.h"
 #include "../CORE/keyboard.h"
 #include "../CORE/high_scores.h"
+#include "melodies.h"
 
 #include <stdint.h>
 #include <string.h>
 
-static const SoundNote g_end_win_melody[] = {
-    { 523, 120 },
-    { 659, 120 },
-    { 784, 180 }
-};
-
-static const SoundNote g_end_lose_melody[] = {
-    { 392, 140 },
-    { 330, 140 },
-    { 262, 220 }
-};
-
 static void draw_center_text(const char *text, int y, unsigned char color)
 {
     int len = 0;
@@ -193,6 +183,7 @@ static void high_scores_capture_initials(HighScoreGame game, int year, unsigned
                 draw_record_screen("HAS GANADO", detail, indices, position);
             }
         }
+        frame_wait_input();
     }
 
     {
@@ -235,9 +226,9 @@ void Game_ShowEndScreen(GameEndResult result, const char *detail, int sound_enab
 
     if (sound_enabled) {
         if (result == GAME_END_WIN) {
-            sound_play_melody(g_end_win_melody, (int)(sizeof(g_end_win_melody) / sizeof(g_end_win_melody[0])));
+            melody_play(MELODY_END_WIN);
         } else {
-            sound_play_melody(g_end_lose_melody, (int)(sizeof(g_end_lose_melody) / sizeof(g_end_lose_melody[0])));
+            melody_play(MELODY_END_LOSE);
         }
     }
 
@@ -253,11 +244,13 @@ void Game_ShowEndScreen(GameEndResult result, const char *detail, int sound_enab
         if (in_keyhit()) {
             in_clear();
         }
+        frame_wait_input();
     }
 
     in_clear();
     while (in_any_down()) {
         sound_update();
+        frame_wait();
     }
     in_clear();
     for (;;) {
@@ -265,6 +258,7 @@ void Game_ShowEndScreen(GameEndResult result, const char *detail, int sound_enab
         if (key == IN_KEY_ENTER) {
             break;
         }
+        frame_wait_input();
     }
     in_clear();
 }
@@ -275,5 +269,5 @@ void Game_PlayLoseMelody(int sound_enabled)
         return;
     }
 
-    sound_play_melody(g_end_lose_melody, (int)(sizeof(g_end_lose_melody) / sizeof(g_end_lose_melody[0])));
+    melody_play(MELODY_END_LOSE);
 }
@@ -0,0 +1,91 @@
+#include "melodies.h"
+
+#include <stddef.h>
+
+// Jingle de menú, motivo repetido
+static const SoundNote g_menu_jingle[] = {
+    // Motivo x2: C5 - G5 - A5
+    {523, 220}, // C5
+    {784, 220}, // G5
+    {880, 260}, // A5
+    {0,    90}, // Pausa
+
+    {523, 220}, // C5
+    {784, 220}, // G5
+    {880, 260}, // A5
+    {0,    90}, // Pausa
+
+    // Remate
+    {1046,300}, // C6
+    {784, 220}, // G5
+    {523, 520}, // C5 cierre
+    {0,   200}  // Silencio final
+};
+
+static const SoundNote g_end_win_melody[] = {
+    { 523, 120 },
+    { 659, 120 },
+    { 784, 180 }
+};
+
+static const SoundNote g_end_lose_melody[] = {
+    { 392, 140 },
+    { 330, 140 },
+    { 262, 220 }
+};
+
+// Impacto y, si la bola se parte, el chasquido de la división: un solo efecto
+static const SoundNote g_pang_hit_sound[] = {
+    { 740, 30 },
+    { 620, 40 }
+};
+
+// Fin de partida: no se los puede quitar ningún impacto
+static const SoundNote g_pang_over_sound[] = {
+    { 220, 160 }
+};
+
+static const SoundNote g_pang_win_sound[] = {
+    { 880, 120 }
+};
+
+static const SoundNote g_gori_throw_sound[] = {
+    { 620, 18 },
+    { 760, 22 }
+};
+
+static const SoundNote g_gori_explosion_sound[] = {
+    { 240, 60 },
+    { 180, 80 }
+};
+
+#define MELODY(name, notes, patch) { name, notes, (int)(sizeof(notes) / sizeof(notes[0])), patch }
+
+// Mismo orden que MelodyId
+static const Melody g_melodies[MELODY_COUNT] = {
+    MELODY("menu_jingle", g_menu_jingle, SOUND_PATCH_LEAD),
+    MELODY("end_win", g_end_win_melody, SOUND_PATCH_LEAD),
+    MELODY("end_lose", g_end_lose_melody, SOUND_PATCH_LEAD),
+    MELODY("pang_hit", g_pang_hit_sound, SOUND_PATCH_BEEP),
+    MELODY("pang_over", g_pang_over_sound, SOUND_PATCH_BEEP),
+    MELODY("pang_win", g_pang_win_sound, SOUND_PATCH_BEEP),
+    MELODY("gori_throw", g_gori_throw_sound, SOUND_PATCH_BEEP),
+    MELODY("gori_explosion", g_gori_explosion_sound, SOUND_PATCH_HIT)
+};
+
+const Melody *melody_get(MelodyId id)
+{
+    if ((int)id < 0 || id >= MELODY_COUNT) {
+        return NULL;
+    }
+    return &g_melodies[id];
+}
+
+void melody_play(MelodyId id)
+{
+    const Melody *melody = melody_get(id);
+
+    if (melody) {
+        sound_play_melody(melody->notes, melody->count);
+    }
+}
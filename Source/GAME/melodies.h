@@ -0,0 +1,30 @@
+#ifndef MELODIES_H
+#define MELODIES_H
+
+#include "../CORE/sound.h"
+
+// Melodías de las pantallas comunes y efectos de los minijuegos: todo lo que suena
+// pasa por aquí para que tbsnd -m all lo compruebe
+typedef enum {
+    MELODY_MENU_JINGLE = 0,
+    MELODY_END_WIN,
+    MELODY_END_LOSE,
+    MELODY_PANG_HIT,
+    MELODY_PANG_OVER,
+    MELODY_PANG_WIN,
+    MELODY_GORI_THROW,
+    MELODY_GORI_EXPLOSION,
+    MELODY_COUNT
+} MelodyId;
+
+typedef struct {
+    const char *name;
+    const SoundNote *notes;
+    int count;
+    int patch;  // SoundPatch con el que suena en el juego
+} Melody;
+
+const Melody *melody_get(MelodyId id);
+void melody_play(MelodyId id);
+
+#endif
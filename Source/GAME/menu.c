@@ -1,16 +1,23 @@
 #include "menu.h"
 
 #include "../CORE/video.h"
+#include "../CORE/frame.h"
 #include "../CORE/input.h"
 #include "../CORE/text.h"
 #include "../CORE/colors.h"
 #include "../CORE/sprite_dat.h"
 #include "../CORE/high_scores.h"
 #include "../CORE/options.h"
+#include "../CORE/palfx.h"
 #include "../CORE/sound.h"
+#include "../CORE/timer.h"
+#include "melodies.h"
 
 #include <string.h>
 
+// Sin tocar nada este rato arranca la demo
+#define MENU_DEMO_IDLE_MS 30000UL
+
 typedef struct {
     MenuOption option;
     TextId label;
@@ -20,26 +27,7 @@ static int spr_loaded = 0;
 static unsigned short spr_w = 0;
 static unsigned short spr_h = 0;
 static unsigned char spr_pixels[128 * 96];
-
-// Jingle de menú, motivo repetido
-static const SoundNote MENU_JINGLE[] = {
-    // Motivo x2: C5 - G5 - A5
-    {523, 220}, // C5
-    {784, 220}, // G5
-    {880, 260}, // A5
-    {0,    90}, // Pausa
-
-    {523, 220}, // C5
-    {784, 220}, // G5
-    {880, 260}, // A5
-    {0,    90}, // Pausa
-
-    // Remate
-    {1046,300}, // C6
-    {784, 220}, // G5
-    {523, 520}, // C5 cierre
-    {0,   200}  // Silencio final
-};
+static SpanSprite spr_spans;
 
 static int menu_build_entries(MenuEntry *entries, int max_entries, unsigned char difficulty)
 {
@@ -93,6 +81,8 @@ static void menu_try_load_sprite(void)
                               (unsigned long)sizeof(spr_pixels))) {
         spr_w = 0;
         spr_h = 0;
+    } else {
+        v_sprite_spans_build(&spr_spans, spr_w, spr_h, (const unsigned char far *)spr_pixels, 0);
     }
 
     spr_loaded = 1;
@@ -111,7 +101,9 @@ static void menu_draw(const MenuEntry *entries, int count, int selected)
 
     v_clear(0);
 
-    if (spr_w && spr_h) {
+    if (spr_spans.data) {
+        v_blit_sprite_spans((VIDEO_WIDTH - spr_w) / 2, 16, &spr_spans);
+    } else if (spr_w && spr_h) {
         v_blit_sprite((VIDEO_WIDTH - spr_w) / 2, 16, spr_w, spr_h, (const unsigned char far *)spr_pixels, 0);
     }
 
@@ -136,13 +128,25 @@ MenuOption menu_run(void)
     int count = menu_build_entries(entries, (int)(sizeof(entries) / sizeof(entries[0])),
                                    options ? options->difficulty : DIFFICULTY_NORMAL);
     int key;
+    unsigned long idle_start;
 
     menu_draw(entries, count, selected);
-    sound_play_melody(MENU_JINGLE, (int)(sizeof(MENU_JINGLE) / sizeof(MENU_JINGLE[0])));
+    melody_play(MELODY_MENU_JINGLE);
+    idle_start = t_now_ms();
 
     while (1) {
         key = in_poll();
+        if (key != IN_KEY_NONE || in_any_down()) {
+            idle_start = t_now_ms();
+        } else if ((t_now_ms() - idle_start) >= MENU_DEMO_IDLE_MS) {
+            return MENU_DEMO;
+        }
         if (key == IN_KEY_NONE) {
+            // Sin cambios no se presenta; sólo mientras dure el fundido
+            if (pal_fx_busy()) {
+                v_present();
+            }
+            frame_wait_input();
             continue;
         }
 
@@ -9,6 +9,7 @@ typedef enum {
     MENU_HIGH_SCORES,
     MENU_OPCIONES,
     MENU_SALIR,
+    MENU_DEMO, // No sale en la lista: menu_run la devuelve tras un rato sin tocar nada
     MENU_COUNT
 } MenuOption;
 
@@ -1,5 +1,6 @@
 #include "options_menu.h"
 
+#include "../CORE/frame.h"
 #include "../CORE/input.h"
 #include "../CORE/options.h"
 #include "../CORE/records.h"
@@ -208,6 +209,7 @@ void options_menu_run(void)
 
         key = in_poll();
         if (key == IN_KEY_NONE) {
+            frame_wait_input();
             continue;
         }
 
@@ -1,5 +1,6 @@
 #include "select_year.h"
 
+#include "../CORE/frame.h"
 #include "../CORE/input.h"
 #include "../CORE/options.h"
 #include "../CORE/video.h"
@@ -99,6 +100,7 @@ int select_year_run(void)
     while (1) {
         key = in_poll();
         if (key == IN_KEY_NONE) {
+            frame_wait_input();
             continue;
         }
 
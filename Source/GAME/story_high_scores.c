@@ -1,5 +1,6 @@
 #include "story_high_scores.h"
 
+#include "../CORE/frame.h"
 #include "../CORE/high_scores.h"
 #include "../CORE/input.h"
 #include "../CORE/video.h"
@@ -55,5 +56,6 @@ void StoryHighScores_Run(unsigned char difficulty)
         if (key == IN_KEY_ENTER || key == IN_KEY_ESC) {
             break;
         }
+        frame_wait_input();
     }
 }
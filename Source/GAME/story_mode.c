@@ -4,6 +4,7 @@
 #include "cutscene.h"
 #include "story_end_screen.h"
 #include "year_launcher.h"
+#include "year_registry.h"
 
 #include <stdint.h>
 
@@ -14,7 +15,6 @@ void StoryMode_Run(void)
     int sound_enabled = options ? options->sound_enabled : 0;
     uint64_t total_score = 0;
     uint32_t total_retries = 0;
-    const int years[] = {1972, 1978, 1979, 1981, 1982, 1983, 1989, 1991, 2013};
     const char *pre_ids[] = {
         "pre1978",
         "pre1979",
@@ -29,11 +29,12 @@ void StoryMode_Run(void)
 
     Cutscene_Play("intro");
 
-    for (i = 0; i < (int)(sizeof(years) / sizeof(years[0])); ++i) {
+    // El orden de los años es el de la tabla de year_registry.c
+    for (i = 0; i < year_registry_count(); ++i) {
         uint64_t score = 0;
         uint32_t retries = 0;
 
-        if (!launch_year_game_story(years[i], &score, &retries)) {
+        if (!launch_year_game_story(year_registry_at(i)->year, &score, &retries)) {
             return;
         }
 
@@ -1,44 +1,33 @@
 #include "year_launcher.h"
 
+#include "../CORE/frame.h"
 #include "../CORE/input.h"
 #include "../CORE/keyboard.h"
 #include "../CORE/options.h"
+#include "../CORE/profiler.h"
+#include "../CORE/replay.h"
+#include "../CORE/rng.h"
 #include "../CORE/text.h"
 #include "../CORE/timer.h"
 #include "../CORE/video.h"
 #include "../CORE/colors.h"
 #include "../CORE/high_scores.h"
+#include "../CORE/sprite_dat.h"
 #include "../GAME/end_screen.h"
-#include "../MINI/PONG/pong.h"
-#include "../MINI/INVADERS/invaders.h"
-#include "../MINI/BREAKOUT/breakout.h"
-#include "../MINI/FROG/frog.h"
-#include "../MINI/TRON/tron.h"
-#include "../MINI/TAPP/tapp.h"
-#include "../MINI/PANG/pang.h"
-#include "../MINI/GORI/gori.h"
-#include "../MINI/FLAPPY/flappy.h"
+#include "../GAME/year_registry.h"
 #include "../main.h"
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
-#define YEAR_1972 1972
-#define YEAR_1978 1978
-#define YEAR_1979 1979
-#define YEAR_1981 1981
-#define YEAR_1982 1982
-#define YEAR_1983 1983
-#define YEAR_1989 1989
-#define YEAR_1991 1991
-#define YEAR_2013 2013
 #define STEP_US 16667UL
 #define MAX_UPDATES_PER_FRAME 5
+// Demo: cada juego como mucho 40 s; sin IA propia, una tecla al azar cada 12 ticks
+#define DEMO_GAME_TICKS (60UL * 40UL)
+#define DEMO_KEY_HOLD_TICKS 12
 
-typedef void (*GameStorePreviousStateFn)(void);
-typedef void (*GameUpdateFn)(void);
-typedef void (*GameDrawInterpolatedFn)(float alpha);
-typedef int (*GameIsFinishedFn)(void);
 typedef enum {
     LOOP_RESULT_FINISHED = 0,
     LOOP_RESULT_ABORTED = 1,
@@ -46,6 +35,15 @@ typedef enum {
 } GameLoopResult;
 
 static int g_paused = 0;
+static int g_seed_fixed = 0;
+static uint32_t g_fixed_seed = 0;
+
+static const unsigned char g_demo_keys[] = {SC_UP, SC_DOWN, SC_LEFT, SC_RIGHT, SC_SPACE, SC_LCTRL};
+#define DEMO_KEY_COUNT ((int)(sizeof(g_demo_keys) / sizeof(g_demo_keys[0])))
+static Rng g_demo_rng;
+static int g_demo_key = -1;
+static int g_demo_hold = 0;
+static int g_demo_next = 0;
 
 static void draw_center_text(const char *text, int y, unsigned char color)
 {
@@ -69,6 +67,7 @@ static void show_option_screen(const char *title)
     v_present();
 
     while (!in_keyhit()) {
+        frame_wait_input();
     }
     while (in_keyhit()) {
         in_poll();
@@ -96,6 +95,7 @@ static int show_continue_screen(void)
         while (1) {
             int key = in_poll();
             if (key == IN_KEY_NONE) {
+                frame_wait_input();
                 continue;
             }
             if (key == IN_KEY_LEFT || key == IN_KEY_UP) {
@@ -121,118 +121,99 @@ static void show_next_game_placeholder(void)
     show_option_screen("PROXIMO JUEGO");
 }
 
-
-static GameLoopResult run_fixed_step_loop(GameIsFinishedFn is_finished,
-                                          GameStorePreviousStateFn store_previous_state, GameUpdateFn update,
-                                          GameDrawInterpolatedFn draw_interpolated)
+// Juegos sin IA de demo: una tecla de cada vez, a veces ninguna
+static void launcher_demo_random(unsigned char *keys)
 {
-    uint32_t last_us = timer_now_us();
-    uint32_t acc = 0;
-    int pause_was_down = 0;
-
-    g_paused = 0;
-
-    while (!is_finished()) {
-        int pause_down = 0;
-        const GameOptions *options = options_get();
-        uint32_t now = 0;
-        uint32_t frame_us = 0;
-        int updates = 0;
-
-        if (Input_Pressed(KEY_P)) {
-            g_paused = !g_paused;
-        }
-        if (kb_down(SC_ESC)) {
-            pause_down = 1;
-        } else if (options && options->input_mode == INPUT_JOYSTICK) {
-            JoystickState state;
-            if (in_joystick_state(&state)) {
-                if (state.buttons & JOY_BUTTON_ESC) {
-                    pause_down = 1;
-                }
-            }
-        }
-
-        if (pause_down && !pause_was_down) {
-            int wants_continue = show_continue_screen();
-            if (!wants_continue) {
-                return LOOP_RESULT_ABORTED;
-            }
-            in_clear();
-            last_us = timer_now_us();
-            acc = 0;
-        }
-
-        pause_was_down = pause_down;
-
-        now = timer_now_us();
-
-        if (g_paused) {
-            last_us = now;
-            draw_interpolated((float)acc / (float)STEP_US);
-            v_present();
-            continue;
-        }
-
-        frame_us = now - last_us;
-
-        // OJO: clamp por pausa de DOSBox o tirón
-        if (frame_us > 250000UL) frame_us = 250000UL;
-
-        last_us = now;
-        acc += frame_us;
+    if (g_demo_hold <= 0) {
+        g_demo_key = rng_below(&g_demo_rng, DEMO_KEY_COUNT + 2);
+        g_demo_hold = DEMO_KEY_HOLD_TICKS;
+    }
+    g_demo_hold--;
+    if (g_demo_key < DEMO_KEY_COUNT) {
+        kb_snapshot_press(keys, g_demo_keys[g_demo_key]);
+    }
+}
 
-        while (acc >= STEP_US && updates < MAX_UPDATES_PER_FRAME) {
-            store_previous_state();
-            update();
-            acc -= STEP_US;
-            updates++;
-        }
+// Un tick de demo con el teclado congelado: lo vivo sólo sirve para cortarla,
+// lo que ve el juego lo pone la IA. Devuelve 0 si el jugador tocó algo.
+static int launcher_demo_tick(const YearGame *game)
+{
+    const GameOptions *options = options_get();
+    unsigned char keys[KB_SNAPSHOT_BYTES];
+    int events[4];
+    int i;
 
-        if (updates >= MAX_UPDATES_PER_FRAME) {
-            acc = 0;
+    if (kb_snapshot_take(keys, events, 4) > 0) {
+        return 0;
+    }
+    for (i = 0; i < KB_SNAPSHOT_BYTES; ++i) {
+        if (keys[i]) {
+            return 0;
         }
+    }
+    if (options && options->input_mode == INPUT_JOYSTICK && joy_available()) {
+        JoystickState state;
 
-        draw_interpolated((float)acc / (float)STEP_US);
-
-        {
-            uint32_t frame_elapsed = timer_now_us() - last_us;
-            if (frame_elapsed < STEP_US) {
-                t_wait_us(STEP_US - frame_elapsed);
-            }
+        if (joy_read(&state) && state.buttons) {
+            return 0;
         }
     }
 
-    return LOOP_RESULT_FINISHED;
+    memset(keys, 0, sizeof(keys));
+    if (game->demo_input) {
+        game->demo_input(keys);
+    } else {
+        launcher_demo_random(keys);
+    }
+    kb_snapshot_set(keys, NULL, 0);
+    return 1;
 }
 
-static GameLoopResult run_fixed_step_loop_story(GameIsFinishedFn is_finished,
-                                                GameStorePreviousStateFn store_previous_state, GameUpdateFn update,
-                                                GameDrawInterpolatedFn draw_interpolated)
+static GameLoopResult run_fixed_step_loop(const YearGame *game, int allow_forced_win, int demo)
 {
     uint32_t last_us = timer_now_us();
     uint32_t acc = 0;
+    uint32_t step_cost_us = 0;
+    int step_cost_count = 0;
     int pause_was_down = 0;
+    unsigned long demo_ticks = 0;
 
     g_paused = 0;
+    frame_skip_reset();
 
-    while (!is_finished()) {
+    while (!game->is_finished()) {
         int pause_down = 0;
+        // Reproduciendo no hay pausa ni menú: lo elegido al grabar viene en rec_tick()
+        int replaying = !demo && rec_active() == REC_REPLAYING;
         const GameOptions *options = options_get();
         uint32_t now = 0;
         uint32_t frame_us = 0;
+        uint32_t step_t0;
         int updates = 0;
 
+        prof_frame_begin();
+        prof_begin(PROF_INPUT);
+
 #if SHOW_DEBUG
-        if (kb_down(SC_LCTRL) && kb_down(SC_W)) {
+        if (allow_forced_win && kb_down(SC_LCTRL) && kb_down(SC_W)) {
             return LOOP_RESULT_FORCED_WIN;
         }
+#else
+        (void)allow_forced_win;
 #endif
 
-        if (Input_Pressed(KEY_P)) {
+        if (Input_Pressed(SC_F11)) {
+            prof_overlay_toggle();
+        }
+        if (Input_Pressed(KEY_P) && !replaying) {
             g_paused = !g_paused;
+            // En pausa no hay ticks: la entrada vuelve a ser la viva
+            rec_pause(g_paused);
         }
-        if (kb_down(SC_ESC)) {
+        // En la demo no hay pausa: cualquier tecla la corta en el tick
+        if (demo || replaying) {
+            pause_down = 0;
+        } else if (kb_down(SC_ESC)) {
             pause_down = 1;
         } else if (options && options->input_mode == INPUT_JOYSTICK) {
             JoystickState state;
@@ -244,23 +225,37 @@ static GameLoopResult run_fixed_step_loop_story(GameIsFinishedFn is_finished,
         }
 
         if (pause_down && !pause_was_down) {
-            int wants_continue = show_continue_screen();
+            int wants_continue;
+
+            rec_pause(1);
+            wants_continue = show_continue_screen();
+            rec_menu(wants_continue);
             if (!wants_continue) {
                 return LOOP_RESULT_ABORTED;
             }
             in_clear();
+            rec_pause(g_paused);
             last_us = timer_now_us();
             acc = 0;
+            // Lo que estuvo el menú abierto no es un frame
+            prof_frame_discard();
+            prof_frame_begin();
         }
 
         pause_was_down = pause_down;
+        prof_end(PROF_INPUT);
 
         now = timer_now_us();
 
         if (g_paused) {
             last_us = now;
-            draw_interpolated((float)acc / (float)STEP_US);
+            prof_begin(PROF_DRAW);
+            game->draw_interpolated((float)acc / (float)STEP_US);
             v_present();
+            prof_end(PROF_DRAW);
+            prof_begin(PROF_IDLE);
+            frame_sleep_until(now + STEP_US, 1);
+            prof_end(PROF_IDLE);
             continue;
         }
 
@@ -272,703 +267,258 @@ static GameLoopResult run_fixed_step_loop_story(GameIsFinishedFn is_finished,
         last_us = now;
         acc += frame_us;
 
+        step_t0 = timer_now_us();
         while (acc >= STEP_US && updates < MAX_UPDATES_PER_FRAME) {
-            store_previous_state();
-            update();
+            prof_begin(PROF_INPUT);
+            if (!demo) {
+                if (rec_tick() == REC_TICK_QUIT) {
+                    prof_end(PROF_INPUT);
+                    return LOOP_RESULT_ABORTED;
+                }
+            } else if (!launcher_demo_tick(game)) {
+                prof_end(PROF_INPUT);
+                return LOOP_RESULT_ABORTED;
+            }
+            prof_end(PROF_INPUT);
+            prof_begin(PROF_UPDATE);
+            game->store_previous_state();
+            game->update();
+            prof_end(PROF_UPDATE);
             acc -= STEP_US;
             updates++;
+            demo_ticks++;
+        }
+
+        if (demo && demo_ticks >= DEMO_GAME_TICKS) {
+            return LOOP_RESULT_FINISHED;
+        }
+
+        if (updates) {
+            step_cost_us += timer_now_us() - step_t0;
+            step_cost_count += updates;
         }
 
         if (updates >= MAX_UPDATES_PER_FRAME) {
             acc = 0;
         }
 
-        draw_interpolated((float)acc / (float)STEP_US);
+        // Con la CPU justa se salta el pintado de algún paso, no la simulación
+        if (frame_skip_due(updates)) {
+            uint32_t draw_t0 = timer_now_us();
 
-        {
-            uint32_t frame_elapsed = timer_now_us() - last_us;
-            if (frame_elapsed < STEP_US) {
-                t_wait_us(STEP_US - frame_elapsed);
-            }
+            prof_begin(PROF_DRAW);
+            game->draw_interpolated((float)acc / (float)STEP_US);
+            prof_end(PROF_DRAW);
+
+            frame_skip_cost(step_cost_count ? step_cost_us / (uint32_t)step_cost_count : 0,
+                            timer_now_us() - draw_t0 - v_vsync_wait_us());
+            step_cost_us = 0;
+            step_cost_count = 0;
         }
+
+        // Duerme hasta el siguiente paso en vez de dar vueltas
+        prof_begin(PROF_IDLE);
+        frame_sleep_until(last_us + STEP_US, 0);
+        prof_end(PROF_IDLE);
     }
 
     return LOOP_RESULT_FINISHED;
 }
 
-static int handle_minigame_result(int did_win, LaunchMode mode, const char *detail, int sound_enabled,
-                                  HighScoreGame game, int year, unsigned char difficulty, uint64_t score)
+// Semilla de cada partida: la fija si la hay, si no una nueva del reloj.
+// Grabando se guarda; reproduciendo manda la de la grabación.
+static uint32_t launcher_session_begin(int year)
 {
-    if (did_win) {
-        Game_ShowEndScreen(GAME_END_WIN, detail, sound_enabled, game, year, difficulty, score);
-        if (mode == LAUNCH_MODE_HISTORIA) {
-            show_next_game_placeholder();
-            return 0;
-        }
-        return show_continue_screen();
-    }
+    uint32_t seed = g_seed_fixed ? g_fixed_seed : (uint32_t)timer_now_us();
 
-    Game_PlayLoseMelody(sound_enabled);
-    return 1;
+    return rec_session_begin((unsigned int)year, seed);
 }
 
-static void run_pong_1972(LaunchMode mode)
+static void launcher_settings(GameSettings *settings)
 {
     const GameOptions *options = options_get();
-    GameSettings settings;
-    int play_again = 1;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (play_again) {
-        GameLoopResult loop_result;
 
-        Pong_Init(&settings);
-
-        loop_result = run_fixed_step_loop(Pong_IsFinished, Pong_StorePreviousState,
-                                          Pong_Update, Pong_DrawInterpolated);
-
-        Pong_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            play_again = 0;
-            continue;
-        }
-        play_again = handle_minigame_result(Pong_DidWin(), mode, Pong_GetEndDetail(), settings.sound_enabled,
-                                            HIGH_SCORE_GAME_PONG, YEAR_1972, settings.difficulty,
-                                            Pong_DidWin() ? Pong_GetScore() : 0);
-    }
+    settings->difficulty = options->difficulty;
+    settings->sound_enabled = options->sound_enabled;
+    settings->input_mode = options->input_mode;
+    settings->game_speed = options->game_speed;
+    settings->speed_multiplier = options_speed_multiplier();
+    settings->seed = 0;
 }
 
-static void run_invaders_1978(LaunchMode mode)
+// Al entrar en un año: sus sprites quedan residentes para todos los reintentos
+static void launcher_enter(const YearGame *game)
 {
-    const GameOptions *options = options_get();
-    GameSettings settings;
-    int play_again = 1;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (play_again) {
-        GameLoopResult loop_result;
-
-        Invaders_Init(&settings);
-
-        loop_result = run_fixed_step_loop(Invaders_IsFinished, Invaders_StorePreviousState,
-                                          Invaders_Update, Invaders_DrawInterpolated);
-
-        Invaders_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            play_again = 0;
-            continue;
-        }
-        play_again = handle_minigame_result(Invaders_DidWin(), mode, Invaders_GetEndDetail(),
-                                            settings.sound_enabled, HIGH_SCORE_GAME_INVADERS, YEAR_1978,
-                                            settings.difficulty,
-                                            Invaders_DidWin() ? Invaders_GetScore() : 0);
-    }
+    year_registry_prefetch(game);
 }
 
-static void run_breakout_1979(LaunchMode mode)
+// Al salir: se libera lo suyo y en historia se adelanta la carga del siguiente año
+static void launcher_leave(const YearGame *game, int prefetch_next)
 {
-    const GameOptions *options = options_get();
-    GameSettings settings;
-    int play_again = 1;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (play_again) {
-        GameLoopResult loop_result;
-
-        Breakout_Init(&settings);
-
-        loop_result = run_fixed_step_loop(Breakout_IsFinished, Breakout_StorePreviousState,
-                                          Breakout_Update, Breakout_DrawInterpolated);
-
-        Breakout_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            play_again = 0;
-            continue;
-        }
-        play_again = handle_minigame_result(Breakout_DidWin(), mode, Breakout_GetEndDetail(),
-                                            settings.sound_enabled, HIGH_SCORE_GAME_BREAKOUT, YEAR_1979,
-                                            settings.difficulty,
-                                            Breakout_DidWin() ? Breakout_GetScore() : 0);
+    sprite_dat_cache_release();
+    if (prefetch_next) {
+        year_registry_prefetch(year_registry_next(game));
     }
 }
 
-static void run_frog_1981(LaunchMode mode)
+// Una partida: Init, bucle y End, con la grabación alrededor
+static GameLoopResult launcher_play_once(const YearGame *game, const GameSettings *settings, int allow_forced_win)
 {
-    const GameOptions *options = options_get();
-    GameSettings settings;
-    int play_again = 1;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (play_again) {
-        GameLoopResult loop_result;
+    GameSettings play = *settings;
+    GameLoopResult loop_result;
 
-        Frog_Init(&settings);
+    play.seed = launcher_session_begin(game->year);
+    game->init(&play);
 
-        loop_result = run_fixed_step_loop(Frog_IsFinished, Frog_StorePreviousState,
-                                          Frog_Update, Frog_DrawInterpolated);
+    prof_session_begin(game->name);
+    loop_result = run_fixed_step_loop(game, allow_forced_win, 0);
+    prof_session_end();
 
-        Frog_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            play_again = 0;
-            continue;
-        }
-        play_again = handle_minigame_result(Frog_DidWin(), mode, Frog_GetEndDetail(),
-                                            settings.sound_enabled, HIGH_SCORE_GAME_FROG, YEAR_1981,
-                                            settings.difficulty,
-                                            Frog_DidWin() ? Frog_GetScore() : 0);
-    }
+    game->end();
+    rec_session_end();
+    return loop_result;
 }
 
-static void run_tapp_1983(LaunchMode mode)
+// Una partida de demo: sin grabar, sin sonido y con la entrada congelada para la IA
+static GameLoopResult launcher_demo_once(const YearGame *game, const GameSettings *settings)
 {
-    const GameOptions *options = options_get();
-    GameSettings settings;
-    int play_again = 1;
+    GameSettings play = *settings;
+    GameLoopResult loop_result;
 
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
+    play.seed = g_seed_fixed ? g_fixed_seed : (uint32_t)timer_now_us();
+    rng_seed(&g_demo_rng, play.seed);
+    g_demo_hold = 0;
 
-    while (play_again) {
-        GameLoopResult loop_result;
-
-        Tapp_Init(&settings);
+    kb_freeze(1);
+    in_joystick_freeze(1, 0, 0, 0, 0);
+    game->init(&play);
 
-        loop_result = run_fixed_step_loop(Tapp_IsFinished, Tapp_StorePreviousState,
-                                          Tapp_Update, Tapp_DrawInterpolated);
+    prof_session_begin(game->name);
+    loop_result = run_fixed_step_loop(game, 0, 1);
+    prof_session_end();
 
-        Tapp_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            play_again = 0;
-            continue;
-        }
-        play_again = handle_minigame_result(Tapp_DidWin(), mode, Tapp_GetEndDetail(),
-                                            settings.sound_enabled, HIGH_SCORE_GAME_TAPP, YEAR_1983,
-                                            settings.difficulty,
-                                            Tapp_DidWin() ? Tapp_GetScore() : 0);
-    }
+    game->end();
+    in_joystick_freeze(0, 0, 0, 0, 0);
+    kb_freeze(0);
+    return loop_result;
 }
 
-static void run_tron_1982(LaunchMode mode)
+static int handle_minigame_result(int did_win, LaunchMode mode, const char *detail, int sound_enabled,
+                                  HighScoreGame game, int year, unsigned char difficulty, uint64_t score)
 {
-    const GameOptions *options = options_get();
-    GameSettings settings;
-    int play_again = 1;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (play_again) {
-        GameLoopResult loop_result;
-
-        Tron_Init(&settings);
-
-        loop_result = run_fixed_step_loop(Tron_IsFinished, Tron_StorePreviousState,
-                                          Tron_Update, Tron_DrawInterpolated);
-
-        Tron_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            play_again = 0;
-            continue;
+    if (did_win) {
+        Game_ShowEndScreen(GAME_END_WIN, detail, sound_enabled, game, year, difficulty, score);
+        if (mode == LAUNCH_MODE_HISTORIA) {
+            show_next_game_placeholder();
+            return 0;
         }
-        play_again = handle_minigame_result(Tron_DidWin(), mode, Tron_GetEndDetail(),
-                                            settings.sound_enabled, HIGH_SCORE_GAME_TRON, YEAR_1982,
-                                            settings.difficulty,
-                                            Tron_DidWin() ? Tron_GetScore() : 0);
+        return show_continue_screen();
     }
-}
-
-static void run_pang_1989(LaunchMode mode)
-{
-    const GameOptions *options = options_get();
-    GameSettings settings;
-    int play_again = 1;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (play_again) {
-        GameLoopResult loop_result;
-
-        Pang_Init(&settings);
-
-        loop_result = run_fixed_step_loop(Pang_IsFinished, Pang_StorePreviousState,
-                                          Pang_Update, Pang_DrawInterpolated);
 
-        Pang_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            play_again = 0;
-            continue;
-        }
-        play_again = handle_minigame_result(Pang_DidWin(), mode, Pang_GetEndDetail(),
-                                            settings.sound_enabled, HIGH_SCORE_GAME_PANG, YEAR_1989,
-                                            settings.difficulty,
-                                            Pang_DidWin() ? Pang_GetScore() : 0);
-    }
+    Game_PlayLoseMelody(sound_enabled);
+    return 1;
 }
 
-static void run_gori_1991(LaunchMode mode)
+static void run_year_game(const YearGame *game, LaunchMode mode)
 {
-    const GameOptions *options = options_get();
     GameSettings settings;
     int play_again = 1;
 
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
+    launcher_settings(&settings);
+    launcher_enter(game);
 
     while (play_again) {
-        GameLoopResult loop_result;
-
-        Gori_Init(&settings);
+        GameLoopResult loop_result = launcher_play_once(game, &settings, mode == LAUNCH_MODE_DEBUG);
 
-        loop_result = run_fixed_step_loop(Gori_IsFinished, Gori_StorePreviousState,
-                                          Gori_Update, Gori_DrawInterpolated);
-
-        Gori_End();
         if (loop_result == LOOP_RESULT_ABORTED) {
             play_again = 0;
             continue;
         }
-        play_again = handle_minigame_result(Gori_DidWin(), mode, Gori_GetEndDetail(),
-                                            settings.sound_enabled, HIGH_SCORE_GAME_GORI, YEAR_1991,
-                                            settings.difficulty,
-                                            Gori_DidWin() ? Gori_GetScore() : 0);
-    }
-}
-
-static void run_flappy_2013(LaunchMode mode)
-{
-    const GameOptions *options = options_get();
-    GameSettings settings;
-    int play_again = 1;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (play_again) {
-        GameLoopResult loop_result;
-
-        Flappy_Init(&settings);
-
-        loop_result = run_fixed_step_loop(Flappy_IsFinished, Flappy_StorePreviousState,
-                                          Flappy_Update, Flappy_DrawInterpolated);
-
-        Flappy_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            play_again = 0;
+        if (loop_result == LOOP_RESULT_FORCED_WIN) {
+            play_again = handle_minigame_result(1, mode, game->end_detail(), settings.sound_enabled,
+                                                game->score_id, game->year, settings.difficulty, game->score());
             continue;
         }
-        play_again = handle_minigame_result(Flappy_DidWin(), mode, Flappy_GetEndDetail(),
-                                            settings.sound_enabled, HIGH_SCORE_GAME_FLAPPY, YEAR_2013,
-                                            settings.difficulty,
-                                            Flappy_DidWin() ? Flappy_GetScore() : 0);
+        play_again = handle_minigame_result(game->did_win(), mode, game->end_detail(), settings.sound_enabled,
+                                            game->score_id, game->year, settings.difficulty,
+                                            game->did_win() ? game->score() : 0);
     }
-}
-
-static int run_pong_1972_story(uint64_t *out_score, uint32_t *out_retries)
-{
-    const GameOptions *options = options_get();
-    GameSettings settings;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (1) {
-        GameLoopResult loop_result;
-
-        Pong_Init(&settings);
 
-        loop_result = run_fixed_step_loop_story(Pong_IsFinished, Pong_StorePreviousState,
-                                                Pong_Update, Pong_DrawInterpolated);
-
-        Pong_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
-        }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Pong_DidWin()) {
-            if (out_score) {
-                *out_score = Pong_GetScore();
-            }
-            return 1;
-        }
-        if (out_retries) {
-            (*out_retries)++;
-        }
-        Game_PlayLoseMelody(settings.sound_enabled);
-    }
+    launcher_leave(game, 0);
 }
 
-static int run_invaders_1978_story(uint64_t *out_score, uint32_t *out_retries)
+static int run_year_game_story(const YearGame *game, uint64_t *out_score, uint32_t *out_retries)
 {
-    const GameOptions *options = options_get();
     GameSettings settings;
+    int won = 0;
 
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
+    launcher_settings(&settings);
+    launcher_enter(game);
 
     while (1) {
-        GameLoopResult loop_result;
+        GameLoopResult loop_result = launcher_play_once(game, &settings, 1);
 
-        Invaders_Init(&settings);
-
-        loop_result = run_fixed_step_loop_story(Invaders_IsFinished, Invaders_StorePreviousState,
-                                                Invaders_Update, Invaders_DrawInterpolated);
-
-        Invaders_End();
         if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
+            break;
         }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Invaders_DidWin()) {
+        if (loop_result == LOOP_RESULT_FORCED_WIN || game->did_win()) {
             if (out_score) {
-                *out_score = Invaders_GetScore();
+                *out_score = game->score();
             }
-            return 1;
+            won = 1;
+            break;
         }
         if (out_retries) {
             (*out_retries)++;
         }
         Game_PlayLoseMelody(settings.sound_enabled);
     }
-}
-
-static int run_breakout_1979_story(uint64_t *out_score, uint32_t *out_retries)
-{
-    const GameOptions *options = options_get();
-    GameSettings settings;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (1) {
-        GameLoopResult loop_result;
-
-        Breakout_Init(&settings);
-
-        loop_result = run_fixed_step_loop_story(Breakout_IsFinished, Breakout_StorePreviousState,
-                                                Breakout_Update, Breakout_DrawInterpolated);
 
-        Breakout_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
-        }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Breakout_DidWin()) {
-            if (out_score) {
-                *out_score = Breakout_GetScore();
-            }
-            return 1;
-        }
-        if (out_retries) {
-            (*out_retries)++;
-        }
-        Game_PlayLoseMelody(settings.sound_enabled);
-    }
+    launcher_leave(game, won);
+    return won;
 }
 
-static int run_frog_1981_story(uint64_t *out_score, uint32_t *out_retries)
+void launch_set_seed(const char *text)
 {
-    const GameOptions *options = options_get();
-    GameSettings settings;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (1) {
-        GameLoopResult loop_result;
-
-        Frog_Init(&settings);
-
-        loop_result = run_fixed_step_loop_story(Frog_IsFinished, Frog_StorePreviousState,
-                                                Frog_Update, Frog_DrawInterpolated);
-
-        Frog_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
-        }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Frog_DidWin()) {
-            if (out_score) {
-                *out_score = Frog_GetScore();
-            }
-            return 1;
-        }
-        if (out_retries) {
-            (*out_retries)++;
-        }
-        Game_PlayLoseMelody(settings.sound_enabled);
-    }
-}
-
-static int run_tron_1982_story(uint64_t *out_score, uint32_t *out_retries)
-{
-    const GameOptions *options = options_get();
-    GameSettings settings;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (1) {
-        GameLoopResult loop_result;
-
-        Tron_Init(&settings);
-
-        loop_result = run_fixed_step_loop_story(Tron_IsFinished, Tron_StorePreviousState,
-                                                Tron_Update, Tron_DrawInterpolated);
-
-        Tron_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
-        }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Tron_DidWin()) {
-            if (out_score) {
-                *out_score = Tron_GetScore();
-            }
-            return 1;
-        }
-        if (out_retries) {
-            (*out_retries)++;
-        }
-        Game_PlayLoseMelody(settings.sound_enabled);
-    }
+    g_seed_fixed = (text && text[0] != '\0') ? 1 : 0;
+    g_fixed_seed = g_seed_fixed ? (uint32_t)strtoul(text, NULL, 10) : 0;
 }
 
-static int run_tapp_1983_story(uint64_t *out_score, uint32_t *out_retries)
+void launch_attract(void)
 {
-    const GameOptions *options = options_get();
     GameSettings settings;
 
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
+    launcher_settings(&settings);
+    settings.sound_enabled = 0;
+    settings.input_mode = INPUT_KEYBOARD;
 
+    // Todos los juegos en orden, empezando donde se quedó la demo anterior
     while (1) {
+        const YearGame *game = year_registry_at(g_demo_next);
         GameLoopResult loop_result;
 
-        Tapp_Init(&settings);
-
-        loop_result = run_fixed_step_loop_story(Tapp_IsFinished, Tapp_StorePreviousState,
-                                                Tapp_Update, Tapp_DrawInterpolated);
-
-        Tapp_End();
+        g_demo_next = (g_demo_next + 1) % year_registry_count();
+        launcher_enter(game);
+        loop_result = launcher_demo_once(game, &settings);
+        launcher_leave(game, 0);
         if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
-        }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Tapp_DidWin()) {
-            if (out_score) {
-                *out_score = Tapp_GetScore();
-            }
-            return 1;
+            break;
         }
-        if (out_retries) {
-            (*out_retries)++;
-        }
-        Game_PlayLoseMelody(settings.sound_enabled);
     }
-}
 
-static int run_pang_1989_story(uint64_t *out_score, uint32_t *out_retries)
-{
-    const GameOptions *options = options_get();
-    GameSettings settings;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (1) {
-        GameLoopResult loop_result;
-
-        Pang_Init(&settings);
-
-        loop_result = run_fixed_step_loop_story(Pang_IsFinished, Pang_StorePreviousState,
-                                                Pang_Update, Pang_DrawInterpolated);
-
-        Pang_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
-        }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Pang_DidWin()) {
-            if (out_score) {
-                *out_score = Pang_GetScore();
-            }
-            return 1;
-        }
-        if (out_retries) {
-            (*out_retries)++;
-        }
-        Game_PlayLoseMelody(settings.sound_enabled);
-    }
-}
-
-static int run_gori_1991_story(uint64_t *out_score, uint32_t *out_retries)
-{
-    const GameOptions *options = options_get();
-    GameSettings settings;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (1) {
-        GameLoopResult loop_result;
-
-        Gori_Init(&settings);
-
-        loop_result = run_fixed_step_loop_story(Gori_IsFinished, Gori_StorePreviousState,
-                                                Gori_Update, Gori_DrawInterpolated);
-
-        Gori_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
-        }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Gori_DidWin()) {
-            if (out_score) {
-                *out_score = Gori_GetScore();
-            }
-            return 1;
-        }
-        if (out_retries) {
-            (*out_retries)++;
-        }
-        Game_PlayLoseMelody(settings.sound_enabled);
-    }
-}
-
-static int run_flappy_2013_story(uint64_t *out_score, uint32_t *out_retries)
-{
-    const GameOptions *options = options_get();
-    GameSettings settings;
-
-    settings.difficulty = options->difficulty;
-    settings.sound_enabled = options->sound_enabled;
-    settings.input_mode = options->input_mode;
-    settings.game_speed = options->game_speed;
-    settings.speed_multiplier = options_speed_multiplier();
-
-    while (1) {
-        GameLoopResult loop_result;
-
-        Flappy_Init(&settings);
-
-        loop_result = run_fixed_step_loop_story(Flappy_IsFinished, Flappy_StorePreviousState,
-                                                Flappy_Update, Flappy_DrawInterpolated);
-
-        Flappy_End();
-        if (loop_result == LOOP_RESULT_ABORTED) {
-            return 0;
-        }
-        if (loop_result == LOOP_RESULT_FORCED_WIN || Flappy_DidWin()) {
-            if (out_score) {
-                *out_score = Flappy_GetScore();
-            }
-            return 1;
-        }
-        if (out_retries) {
-            (*out_retries)++;
-        }
-        Game_PlayLoseMelody(settings.sound_enabled);
+    // La tecla que cortó la demo no llega al menú
+    while (in_keyhit()) {
+        in_poll();
     }
 }
 
 void launch_year_game(int year, LaunchMode mode)
 {
+    const YearGame *game = year_registry_find(year);
     char year_text[8];
 
-    if (year == YEAR_1972) {
-        run_pong_1972(mode);
-        return;
-    }
-
-    if (year == YEAR_1978) {
-        run_invaders_1978(mode);
-        return;
-    }
-
-    if (year == YEAR_1979) {
-        run_breakout_1979(mode);
-        return;
-    }
-
-    if (year == YEAR_1981) {
-        run_frog_1981(mode);
-        return;
-    }
-
-    if (year == YEAR_1982) {
-        run_tron_1982(mode);
-        return;
-    }
-
-    if (year == YEAR_1983) {
-        run_tapp_1983(mode);
-        return;
-    }
-
-    if (year == YEAR_1989) {
-        run_pang_1989(mode);
-        return;
-    }
-
-    if (year == YEAR_1991) {
-        run_gori_1991(mode);
-        return;
-    }
-
-    if (year == YEAR_2013) {
-        run_flappy_2013(mode);
+    if (game) {
+        run_year_game(game, mode);
         return;
     }
 
@@ -978,6 +528,8 @@ void launch_year_game(int year, LaunchMode mode)
 
 int launch_year_game_story(int year, uint64_t *out_score, uint32_t *out_retries)
 {
+    const YearGame *game = year_registry_find(year);
+
     if (out_score) {
         *out_score = 0;
     }
@@ -985,40 +537,8 @@ int launch_year_game_story(int year, uint64_t *out_score, uint32_t *out_retries)
         *out_retries = 0;
     }
 
-    if (year == YEAR_1972) {
-        return run_pong_1972_story(out_score, out_retries);
-    }
-
-    if (year == YEAR_1978) {
-        return run_invaders_1978_story(out_score, out_retries);
-    }
-
-    if (year == YEAR_1979) {
-        return run_breakout_1979_story(out_score, out_retries);
-    }
-
-    if (year == YEAR_1981) {
-        return run_frog_1981_story(out_score, out_retries);
-    }
-
-    if (year == YEAR_1982) {
-        return run_tron_1982_story(out_score, out_retries);
-    }
-
-    if (year == YEAR_1983) {
-        return run_tapp_1983_story(out_score, out_retries);
-    }
-
-    if (year == YEAR_1989) {
-        return run_pang_1989_story(out_score, out_retries);
-    }
-
-    if (year == YEAR_1991) {
-        return run_gori_1991_story(out_score, out_retries);
-    }
-
-    if (year == YEAR_2013) {
-        return run_flappy_2013_story(out_score, out_retries);
+    if (game) {
+        return run_year_game_story(game, out_score, out_retries);
     }
 
     return 0;
@@ -9,7 +9,11 @@ typedef enum {
     LAUNCH_MODE_DEBUG = 2
 } LaunchMode;
 
+// Semilla fija para todas las partidas (benchmarks, pruebas); NULL o "" la quita
+void launch_set_seed(const char *text);
 void launch_year_game(int year, LaunchMode mode);
+// Demo: va pasando los minijuegos con la IA de jugador hasta que se toca una tecla
+void launch_attract(void);
 int launch_year_game_story(int year, uint64_t *out_score, uint32_t *out_retries);
 
 #endif
@@ -0,0 +1,118 @@
+#include "year_registry.h"
+
+#include "../CORE/sprite_dat.h"
+#include "../MINI/PONG/pong.h"
+#include "../MINI/INVADERS/invaders.h"
+#include "../MINI/BREAKOUT/breakout.h"
+#include "../MINI/FROG/frog.h"
+#include "../MINI/TRON/tron.h"
+#include "../MINI/TAPP/tapp.h"
+#include "../MINI/PANG/pang.h"
+#include "../MINI/GORI/gori.h"
+#include "../MINI/FLAPPY/flappy.h"
+
+#include <string.h>
+
+static const char *const g_assets_none[] = {NULL};
+
+static const char *const g_assets_frog[] = {
+    "SPRITES\\frog1.dat", "SPRITES\\frog2.dat", "SPRITES\\car1.dat", "SPRITES\\car2.dat",
+    "SPRITES\\truck1.dat", "SPRITES\\tree1.dat", "SPRITES\\tree2.dat", "SPRITES\\tree3.dat",
+    "SPRITES\\turtle1.dat", "SPRITES\\lilly1.dat", NULL
+};
+
+static const char *const g_assets_tron[] = {"SPRITES\\bike1.dat", "SPRITES\\bike2.dat", NULL};
+
+static const char *const g_assets_tapp[] = {
+    "SPRITES\\bar1.dat", "SPRITES\\bart1.dat", "SPRITES\\bart2.dat", "SPRITES\\bart3.dat",
+    "SPRITES\\cust1.dat", "SPRITES\\cust2.dat", "SPRITES\\cust3.dat", "SPRITES\\beer1.dat",
+    "SPRITES\\mug1.dat", NULL
+};
+
+static const char *const g_assets_pang[] = {
+    "SPRITES\\pang1.dat", "SPRITES\\pang2.dat", "SPRITES\\pang3.dat", "SPRITES\\ballxl.dat",
+    "SPRITES\\ballm.dat", "SPRITES\\balls.dat", "SPRITES\\arrow.dat", NULL
+};
+
+static const char *const g_assets_flappy[] = {"SPRITES\\flappy.dat", NULL};
+
+#define YEAR_GAME(year, name, score_id, prefix, assets, demo)                                        \
+    {year, name, score_id, prefix##_Init, prefix##_StorePreviousState, prefix##_Update,             \
+     prefix##_DrawInterpolated, prefix##_End, prefix##_IsFinished, prefix##_DidWin,                 \
+     prefix##_GetEndDetail, prefix##_GetScore, assets, demo}
+
+static const YearGame g_years[] = {
+    YEAR_GAME(1972, "pong", HIGH_SCORE_GAME_PONG, Pong, g_assets_none, Pong_DemoInput),
+    YEAR_GAME(1978, "invaders", HIGH_SCORE_GAME_INVADERS, Invaders, g_assets_none, NULL),
+    YEAR_GAME(1979, "breakout", HIGH_SCORE_GAME_BREAKOUT, Breakout, g_assets_none, Breakout_DemoInput),
+    YEAR_GAME(1981, "frog", HIGH_SCORE_GAME_FROG, Frog, g_assets_frog, NULL),
+    YEAR_GAME(1982, "tron", HIGH_SCORE_GAME_TRON, Tron, g_assets_tron, Tron_DemoInput),
+    YEAR_GAME(1983, "tapp", HIGH_SCORE_GAME_TAPP, Tapp, g_assets_tapp, NULL),
+    YEAR_GAME(1989, "pang", HIGH_SCORE_GAME_PANG, Pang, g_assets_pang, NULL),
+    YEAR_GAME(1991, "gori", HIGH_SCORE_GAME_GORI, Gori, g_assets_none, Gori_DemoInput),
+    YEAR_GAME(2013, "flappy", HIGH_SCORE_GAME_FLAPPY, Flappy, g_assets_flappy, NULL)
+};
+
+#define YEAR_COUNT ((int)(sizeof(g_years) / sizeof(g_years[0])))
+
+int year_registry_count(void)
+{
+    return YEAR_COUNT;
+}
+
+const YearGame *year_registry_at(int index)
+{
+    if (index < 0 || index >= YEAR_COUNT) {
+        return NULL;
+    }
+    return &g_years[index];
+}
+
+const YearGame *year_registry_find(int year)
+{
+    int i;
+
+    for (i = 0; i < YEAR_COUNT; ++i) {
+        if (g_years[i].year == year) {
+            return &g_years[i];
+        }
+    }
+    return NULL;
+}
+
+const YearGame *year_registry_find_name(const char *name)
+{
+    int i;
+
+    if (!name) {
+        return NULL;
+    }
+    for (i = 0; i < YEAR_COUNT; ++i) {
+        if (strcmp(g_years[i].name, name) == 0) {
+            return &g_years[i];
+        }
+    }
+    return NULL;
+}
+
+const YearGame *year_registry_next(const YearGame *game)
+{
+    if (!game || game < g_years || game >= g_years + YEAR_COUNT - 1) {
+        return NULL;
+    }
+    return game + 1;
+}
+
+int year_registry_prefetch(const YearGame *game)
+{
+    int loaded = 0;
+    int i;
+
+    if (!game || !game->assets) {
+        return 0;
+    }
+    for (i = 0; game->assets[i]; ++i) {
+        loaded += sprite_dat_prefetch(game->assets[i]);
+    }
+    return loaded;
+}
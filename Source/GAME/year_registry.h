@@ -0,0 +1,39 @@
+#ifndef YEAR_REGISTRY_H
+#define YEAR_REGISTRY_H
+
+#include "../CORE/high_scores.h"
+#include "../MINI/game_settings.h"
+
+#include <stdint.h>
+
+// Un minijuego por año: funciones, tabla de récords y sprites que usa.
+// El orden de la tabla es el del modo historia.
+typedef struct {
+    int year;
+    const char *name;
+    HighScoreGame score_id;
+    void (*init)(const GameSettings *settings);
+    void (*store_previous_state)(void);
+    void (*update)(void);
+    void (*draw_interpolated)(float alpha);
+    void (*end)(void);
+    int (*is_finished)(void);
+    int (*did_win)(void);
+    const char *(*end_detail)(void);
+    uint64_t (*score)(void);
+    const char *const *assets; // Lista acabada en NULL
+    // Demo: la IA llena las teclas del jugador para el siguiente tick (NULL: teclas al azar)
+    void (*demo_input)(unsigned char *keys);
+} YearGame;
+
+int year_registry_count(void);
+const YearGame *year_registry_at(int index);
+const YearGame *year_registry_find(int year);
+const YearGame *year_registry_find_name(const char *name);
+// Siguiente en el orden de la historia, NULL tras el último
+const YearGame *year_registry_next(const YearGame *game);
+
+// Deja residentes los sprites del juego; devuelve cuántos quedaron en memoria
+int year_registry_prefetch(const YearGame *game);
+
+#endif
@@ -0,0 +1,343 @@
+// runner.c
+//
+// Runner de host: mueve cualquier minijuego con el reloj virtual, sin esperar
+// al tiempo real. Sirve para medir cuánto cuesta un tick y para dejar un juego
+// jugando solo miles de partidas en segundos.
+//
+// Uso: tbrun [-g juego|all] [-t ticks] [-r cada_n] [-s semilla] [-d dificultad] [-k | -a] [-h hash.log]
+//            [-w grabar.rec | -p repetir.rec]
+//   -r 0 no pinta nada; -k pulsa teclas al azar (con la semilla) para que el juego avance
+//   -a juega la IA de la demo donde la hay (en el resto, como -k)
+//   -w/-p graban o repiten la entrada por tick (CORE/replay.c), también las de DOS;
+//   con -p sale con 1 si la grabación es de otro juego o se acaba antes que una partida
+
+#include "../CORE/keyboard.h"
+#include "../CORE/replay.h"
+#include "../CORE/rng.h"
+#include "../CORE/timer.h"
+#include "../CORE/video.h"
+#include "../GAME/year_registry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STEP_US 16667UL
+#define RUN_DEFAULT_TICKS 36000UL // 10 minutos de juego
+#define RUN_KEY_HOLD_TICKS 12
+
+// Teclas que leen los minijuegos
+static const unsigned char g_run_keys[] = {SC_UP, SC_DOWN, SC_LEFT, SC_RIGHT, SC_SPACE, SC_LCTRL,
+                                           SC_W, SC_A, SC_S, SC_D};
+
+#define RUN_KEY_COUNT ((int)(sizeof(g_run_keys) / sizeof(g_run_keys[0])))
+
+typedef struct {
+    unsigned long ticks;
+    unsigned long ticks_max;
+    unsigned long render_every;
+    unsigned long seed;
+    unsigned char difficulty;
+    int random_keys;
+    int demo_ai;
+} RunConfig;
+
+// Teclas al azar: serie propia, aparte de la del juego
+static Rng g_keys_rng;
+
+static double run_wall_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
+
+static void run_release_keys(void)
+{
+    int i;
+
+    for (i = 0; i < RUN_KEY_COUNT; ++i) {
+        if (kb_down(g_run_keys[i])) {
+            kb_inject(g_run_keys[i], 0);
+        }
+    }
+}
+
+static void run_press_keys(unsigned long tick)
+{
+    if ((tick % RUN_KEY_HOLD_TICKS) != 0) {
+        return;
+    }
+
+    run_release_keys();
+    // Una tecla de cada vez, a veces ninguna
+    {
+        int idx = rng_below(&g_keys_rng, RUN_KEY_COUNT + 2);
+
+        if (idx < RUN_KEY_COUNT) {
+            kb_inject(g_run_keys[idx], 1);
+        }
+    }
+}
+
+// IA de la demo: se pulsa o suelta sólo lo que cambia respecto al tick anterior
+static void run_demo_keys(const YearGame *game)
+{
+    unsigned char keys[KB_SNAPSHOT_BYTES];
+    int i;
+
+    memset(keys, 0, sizeof(keys));
+    game->demo_input(keys);
+    for (i = 0; i < RUN_KEY_COUNT; ++i) {
+        unsigned char sc = g_run_keys[i];
+        int down = (keys[sc >> 3] >> (sc & 7)) & 1;
+
+        if (down != kb_down(sc)) {
+            kb_inject(sc, down);
+        }
+    }
+}
+
+// Cada partida es una sesión de la grabación, como en year_launcher.c. Repitiendo,
+// 0 si ya no quedan partidas grabadas y -1 si la siguiente es de otro juego
+static int run_session_begin(const YearGame *game, GameSettings *settings, uint32_t seed)
+{
+    if (rec_active() == REC_REPLAYING) {
+        unsigned int year;
+
+        if (!rec_session_peek(&year)) {
+            return 0;
+        }
+        if (year != (unsigned int)game->year) {
+            printf("%s: la grabación sigue con el año %u\n", game->name, year);
+            return -1;
+        }
+    }
+
+    settings->seed = rec_session_begin((unsigned int)game->year, seed);
+    game->init(settings);
+    return 1;
+}
+
+static int run_game(const YearGame *game, const RunConfig *cfg)
+{
+    GameSettings settings;
+    unsigned long tick;
+    unsigned long sessions = 0;
+    unsigned long wins = 0;
+    double update_us = 0.0;
+    double draw_us = 0.0;
+    unsigned long draws = 0;
+    double draw_bytes = 0.0;
+    double t0;
+    int playing;
+    int ok = 1;
+
+    settings.difficulty = cfg->difficulty;
+    settings.sound_enabled = 0;
+    settings.input_mode = 0;
+    settings.game_speed = 0;
+    settings.speed_multiplier = 1.0f;
+
+    timer_set_virtual(1, 0);
+    kb_init();
+
+    // Repitiendo, la semilla es la de la grabación
+    playing = run_session_begin(game, &settings, (uint32_t)cfg->seed);
+    if (playing <= 0) {
+        if (playing == 0) {
+            printf("%s: no quedan partidas en la grabación\n", game->name);
+        }
+        kb_shutdown();
+        return 0;
+    }
+    rng_seed(&g_keys_rng, ~settings.seed);
+
+    for (tick = 0; tick < cfg->ticks_max; ++tick) {
+        int rec_end;
+
+        if (rec_active() == REC_REPLAYING) {
+            // La entrada es la de la grabación
+        } else if (cfg->demo_ai && game->demo_input) {
+            run_demo_keys(game);
+        } else if (cfg->random_keys || cfg->demo_ai) {
+            run_press_keys(tick);
+        }
+
+        timer_advance_us(STEP_US);
+        rec_end = rec_tick();
+        if (rec_end == REC_TICK_EARLY) {
+            printf("%s: la grabación se acaba en el tick %lu sin acabar la partida\n", game->name, tick);
+            ok = 0;
+            break;
+        }
+        if (rec_end == REC_TICK_QUIT) {
+            // Al grabar se salió desde el menú: la partida acaba aquí, sin update
+            ++sessions;
+            game->end();
+            rec_session_end();
+            run_release_keys();
+            playing = run_session_begin(game, &settings, settings.seed + 1);
+            if (playing <= 0) {
+                ok = playing == 0;
+                ++tick;
+                break;
+            }
+            continue;
+        }
+
+        t0 = run_wall_us();
+        game->store_previous_state();
+        game->update();
+        update_us += run_wall_us() - t0;
+
+        if (cfg->render_every && (tick % cfg->render_every) == 0) {
+            t0 = run_wall_us();
+            game->draw_interpolated(0.0f);
+            draw_us += run_wall_us() - t0;
+            draw_bytes += (double)v_frame_bytes();
+            ++draws;
+        }
+
+        if (game->is_finished()) {
+            if (game->did_win()) {
+                ++wins;
+            }
+            ++sessions;
+            game->end();
+            rec_session_end();
+            run_release_keys();
+            // Cada partida con su semilla, derivada de la anterior
+            playing = run_session_begin(game, &settings, settings.seed + 1);
+            if (playing <= 0) {
+                // Repitiendo: se acabó la grabación o sigue con otro juego
+                ok = playing == 0;
+                ++tick;
+                break;
+            }
+        }
+    }
+
+    if (playing > 0) {
+        game->end();
+        rec_session_end();
+    }
+    kb_shutdown();
+
+    printf("%-9s ticks %lu  partidas %lu (ganadas %lu)  update %.2f us/tick", game->name, tick, sessions, wins,
+           tick ? update_us / (double)tick : 0.0);
+    if (draws) {
+        // Bytes que pintan las primitivas por frame: lo que cuesta en la VGA de verdad
+        printf("  draw %.2f us/frame %.1f KB/frame  hash %016llx", draw_us / (double)draws,
+               draw_bytes / (double)draws / 1024.0, (unsigned long long)v_frame_hash());
+    }
+    printf("  %.0f ticks/s\n", (update_us + draw_us) > 0.0 ? (double)tick * 1000000.0 / (update_us + draw_us) : 0.0);
+    return ok;
+}
+
+static void run_usage(void)
+{
+    int i;
+
+    printf("Uso: tbrun [-g juego|all] [-t ticks] [-r cada_n] [-s semilla] [-d 0-2] [-k | -a] [-h hash.log]\n");
+    printf("           [-w grabar.rec | -p repetir.rec]\n");
+    printf("Juegos:");
+    for (i = 0; i < year_registry_count(); ++i) {
+        printf(" %s", year_registry_at(i)->name);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    RunConfig cfg;
+    const char *only = "all";
+    const char *hash_log = NULL;
+    const char *rec_path = NULL;
+    const char *replay_path = NULL;
+    int ran = 0;
+    int failed = 0;
+    int i;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.ticks_max = RUN_DEFAULT_TICKS;
+    cfg.render_every = 1;
+    cfg.seed = 1;
+    cfg.difficulty = 1;
+
+    for (i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "-k") == 0) {
+            cfg.random_keys = 1;
+            continue;
+        }
+        if (strcmp(arg, "-a") == 0) {
+            cfg.demo_ai = 1;
+            continue;
+        }
+        if (!val || arg[0] != '-') {
+            run_usage();
+            return 1;
+        }
+        if (strcmp(arg, "-g") == 0) {
+            only = val;
+        } else if (strcmp(arg, "-t") == 0) {
+            cfg.ticks_max = strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "-r") == 0) {
+            cfg.render_every = strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "-s") == 0) {
+            cfg.seed = strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "-d") == 0) {
+            cfg.difficulty = (unsigned char)atoi(val);
+        } else if (strcmp(arg, "-h") == 0) {
+            hash_log = val;
+        } else if (strcmp(arg, "-w") == 0) {
+            rec_path = val;
+        } else if (strcmp(arg, "-p") == 0) {
+            replay_path = val;
+        } else {
+            run_usage();
+            return 1;
+        }
+        ++i;
+    }
+
+    v_init_mode13();
+    if (hash_log && !v_hash_log_open(hash_log)) {
+        printf("No se puede abrir %s\n", hash_log);
+        return 1;
+    }
+
+    if (replay_path && !rec_replay(replay_path)) {
+        printf("No se puede repetir %s\n", replay_path);
+        return 1;
+    }
+    if (rec_path && !rec_record(rec_path)) {
+        printf("No se puede grabar en %s\n", rec_path);
+        return 1;
+    }
+
+    for (i = 0; i < year_registry_count(); ++i) {
+        const YearGame *game = year_registry_at(i);
+
+        if (strcmp(only, "all") == 0 || strcmp(only, game->name) == 0) {
+            ++ran;
+            if (!run_game(game, &cfg)) {
+                failed = 1;
+                break;
+            }
+        }
+    }
+
+    rec_close();
+    v_hash_log_close();
+    if (!ran) {
+        run_usage();
+        return 1;
+    }
+    return failed;
+}
@@ -0,0 +1,491 @@
+// sound_dump.c
+//
+// Volcado de host de las melodías a WAV con el backend RENDER de CORE/sound.c y el
+// reloj virtual: se oyen sin altavoz y se comprueba que cada nota empieza en su
+// muestra, dura lo que dice y tiene su frecuencia. Sale con 1 si alguna falla.
+//
+// Uso: tbsnd [-b pcm|opl] [-m melodia|all] [-o directorio] [-c directorio] [-n repeticiones]
+//        tbsnd -s muestra.wav [-o directorio]
+//   sin -o sólo comprueba; -n repite el render para medir el secuenciador
+//   -b opl registra las escrituras de la OPL2 (.imf en -o), las compara con las
+//   buenas de -c (las del repositorio están en SOUNDS/OPL) y comprueba que el
+//   stream de registros las repite igual
+//   -s pasa una muestra digitalizada por el PWM del altavoz (pwm.wav en -o)
+
+#include "../CORE/opl.h"
+#include "../CORE/sound.h"
+#include "../CORE/timer.h"
+#include "../GAME/melodies.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DUMP_MAX_SECONDS 30UL
+#define DUMP_MAX_SAMPLES (SOUND_RENDER_RATE * DUMP_MAX_SECONDS)
+#define DUMP_PIT_FREQ 1193182UL
+
+static unsigned char g_pcm[DUMP_MAX_SAMPLES];
+static unsigned char g_log[DUMP_MAX_SAMPLES];
+static unsigned char g_golden[DUMP_MAX_SAMPLES];
+
+static double dump_wall_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
+
+static unsigned long dump_wait_silence(void)
+{
+    unsigned long ms = 0;
+
+    while (sound_is_playing()) {
+        timer_advance_us(1000UL);
+        sound_update();
+        ++ms;
+    }
+    return ms;
+}
+
+static unsigned long dump_render(const Melody *melody)
+{
+    sound_set_backend(SOUND_BACKEND_RENDER);
+    sound_render_start(g_pcm, DUMP_MAX_SAMPLES);
+    sound_play_patch(melody->notes, melody->count, SOUND_PRIO_MUSIC, melody->patch);
+    dump_wait_silence();
+    return sound_render_length();
+}
+
+// Cada melodía con la tarjeta recién puesta a cero: el registro no depende del orden
+static void dump_opl_reset(void)
+{
+    sound_set_backend(SOUND_BACKEND_NONE);
+    sound_set_backend(SOUND_BACKEND_OPL2);
+}
+
+static unsigned long dump_read(const char *path, unsigned char *buf)
+{
+    FILE *f = fopen(path, "rb");
+    unsigned long length;
+
+    if (!f) {
+        return 0;
+    }
+    length = (unsigned long)fread(buf, 1, DUMP_MAX_SAMPLES, f);
+    fclose(f);
+    return length;
+}
+
+static unsigned long dump_melody_ms(const Melody *melody)
+{
+    unsigned long ms = 0;
+    int i;
+
+    for (i = 0; i < melody->count; ++i) {
+        ms += melody->notes[i].duration_ms ? melody->notes[i].duration_ms : 1;
+    }
+    return ms;
+}
+
+// Registro de la melodía en log_path; luego lo repite como stream y el registro de
+// la repetición tiene que ser el mismo byte a byte
+static int dump_opl(const Melody *melody, const char *log_path, const char *golden_path, unsigned long *out_ms,
+                    unsigned long *out_bytes)
+{
+    char again_path[520];
+    unsigned long length;
+    unsigned long again_length;
+    unsigned long ms;
+    int ok = 1;
+
+    dump_opl_reset();
+    if (!opl_log_open(log_path)) {
+        printf("  No se puede escribir %s\n", log_path);
+        return 0;
+    }
+    sound_play_patch(melody->notes, melody->count, SOUND_PRIO_MUSIC, melody->patch);
+    ms = dump_wait_silence();
+    opl_log_close();
+    length = dump_read(log_path, g_log);
+    *out_ms = ms;
+    *out_bytes = length;
+
+    if (ms != dump_melody_ms(melody)) {
+        printf("  %lu ms, esperados %lu\n", ms, dump_melody_ms(melody));
+        ok = 0;
+    }
+
+    snprintf(again_path, sizeof(again_path), "%s.rep", log_path);
+    dump_opl_reset();
+    opl_log_open(again_path);
+    sound_play_stream(g_log, length);
+    dump_wait_silence();
+    opl_log_close();
+    again_length = dump_read(again_path, g_pcm);
+    remove(again_path);
+    if (again_length != length || memcmp(g_log, g_pcm, (size_t)length) != 0) {
+        printf("  el stream no repite el registro (%lu bytes, %lu repetidos)\n", length, again_length);
+        ok = 0;
+    }
+
+    if (golden_path) {
+        unsigned long golden_length = dump_read(golden_path, g_golden);
+        unsigned long i;
+
+        if (golden_length == 0) {
+            printf("  falta %s\n", golden_path);
+            return 0;
+        }
+        for (i = 0; i < length && i < golden_length; ++i) {
+            if (g_log[i] != g_golden[i]) {
+                break;
+            }
+        }
+        if (i < length || i < golden_length) {
+            // Registro de 4 bytes: reg, valor, espera
+            printf("  distinto de %s en la escritura %lu\n", golden_path, i / 4);
+            ok = 0;
+        }
+    }
+    return ok;
+}
+
+static void wav_put16(FILE *f, unsigned int v)
+{
+    fputc((int)(v & 0xFF), f);
+    fputc((int)((v >> 8) & 0xFF), f);
+}
+
+static void wav_put32(FILE *f, unsigned long v)
+{
+    wav_put16(f, (unsigned int)(v & 0xFFFFUL));
+    wav_put16(f, (unsigned int)((v >> 16) & 0xFFFFUL));
+}
+
+static int dump_write_wav(const char *path, unsigned long length)
+{
+    FILE *f = fopen(path, "wb");
+
+    if (!f) {
+        return 0;
+    }
+    fwrite("RIFF", 1, 4, f);
+    wav_put32(f, 36UL + length);
+    fwrite("WAVEfmt ", 1, 8, f);
+    wav_put32(f, 16);
+    wav_put16(f, 1); // PCM
+    wav_put16(f, 1); // Mono
+    wav_put32(f, SOUND_RENDER_RATE);
+    wav_put32(f, SOUND_RENDER_RATE); // 1 byte por muestra
+    wav_put16(f, 1);
+    wav_put16(f, 8);
+    fwrite("data", 1, 4, f);
+    wav_put32(f, length);
+    fwrite(g_pcm, 1, (size_t)length, f);
+    if (length & 1) {
+        fputc(0, f);
+    }
+    fclose(f);
+    return 1;
+}
+
+static unsigned long dump_le(const unsigned char *p, int bytes)
+{
+    unsigned long v = 0;
+
+    while (bytes-- > 0) {
+        v = (v << 8) | p[bytes];
+    }
+    return v;
+}
+
+// Frecuencia y muestras del WAV, para saber cuánto tiene que durar
+static int dump_wav_info(const char *path, unsigned long *rate, unsigned long *count)
+{
+    FILE *f = fopen(path, "rb");
+    unsigned char head[16];
+    int ok = 0;
+
+    if (!f) {
+        return 0;
+    }
+    *rate = 0;
+    if (fread(head, 1, 12, f) == 12 && memcmp(head, "RIFF", 4) == 0) {
+        while (fread(head, 1, 8, f) == 8) {
+            unsigned long size = dump_le(head + 4, 4);
+
+            if (memcmp(head, "data", 4) == 0) {
+                *count = size;
+                ok = *rate > 0;
+                break;
+            }
+            if (memcmp(head, "fmt ", 4) == 0 && size >= 16 && fread(head, 1, 16, f) == 16) {
+                *rate = dump_le(head + 4, 4);
+                size -= 16;
+            }
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+// Por el mismo camino que en DOS salvo la IRQ0 rápida: niveles de 6 bits y lo
+// que dura el WAV (la frecuencia se redondea a muestras por ms: 1% de margen)
+static int dump_sample(const char *path, const char *out_dir)
+{
+    unsigned long rate = 0;
+    unsigned long count = 0;
+    unsigned long expected_ms;
+    unsigned long length;
+    unsigned long ms;
+    unsigned long i;
+    int ok = 1;
+
+    if (!dump_wav_info(path, &rate, &count)) {
+        printf("No se puede leer %s\n", path);
+        return 0;
+    }
+    sound_set_backend(SOUND_BACKEND_RENDER);
+    sound_render_start(g_pcm, DUMP_MAX_SAMPLES);
+    if (!sound_load_sample(path) || !sound_play_sample()) {
+        printf("%s no es PCM mono de 8 bits\n", path);
+        return 0;
+    }
+    ms = dump_wait_silence();
+    length = sound_render_length();
+
+    for (i = 0; i < length; ++i) {
+        if (g_pcm[i] & 3) {
+            printf("  muestra %lu: %u no es un nivel de 6 bits\n", i, (unsigned int)g_pcm[i]);
+            ok = 0;
+            break;
+        }
+    }
+    expected_ms = (count * 1000UL + rate - 1) / rate;
+    if (ms * 100UL < expected_ms * 99UL || ms > expected_ms * 101UL / 100UL + 2) {
+        printf("  %lu ms, esperados %lu\n", ms, expected_ms);
+        ok = 0;
+    }
+
+    // Otra vez la misma: sale del principio ya leído y del resto del fichero, igual
+    memcpy(g_golden, g_pcm, (size_t)length);
+    sound_render_start(g_pcm, DUMP_MAX_SAMPLES);
+    sound_play_sample();
+    dump_wait_silence();
+    if (sound_render_length() != length || memcmp(g_golden, g_pcm, (size_t)length) != 0) {
+        printf("  la segunda vez no suena igual\n");
+        ok = 0;
+    }
+    sound_unload_sample();
+    printf("%-12s %5lu Hz  %6lu ms  %7lu muestras  %s\n", "pwm", rate, ms, length, ok ? "OK" : "MAL");
+
+    if (out_dir) {
+        char out_path[512];
+
+        snprintf(out_path, sizeof(out_path), "%s/pwm.wav", out_dir);
+        if (!dump_write_wav(out_path, length)) {
+            printf("No se puede escribir %s\n", out_path);
+            return 0;
+        }
+    }
+    return ok;
+}
+
+static unsigned long dump_sample_at(unsigned long ms)
+{
+    return ms * SOUND_RENDER_RATE / 1000UL;
+}
+
+static unsigned int dump_divisor(unsigned int freq)
+{
+    unsigned long divisor;
+
+    if (freq == 0) {
+        return 0;
+    }
+    divisor = DUMP_PIT_FREQ / freq;
+    return (unsigned int)(divisor > 0xFFFFUL ? 0xFFFFUL : (divisor ? divisor : 1));
+}
+
+// Una nota: silencio entero o tono entero con sus subidas; al cambiar de tono
+// el PIT se reprograma y la primera muestra es la parte alta
+static int dump_check_note(const Melody *melody, int index, unsigned long first, unsigned long last)
+{
+    const SoundNote *note = &melody->notes[index];
+    unsigned int divisor = dump_divisor(note->freq);
+    unsigned long expected_edges;
+    unsigned long edges = 0;
+    unsigned long i;
+
+    for (i = first; i < last; ++i) {
+        int silent = g_pcm[i] == 0x80;
+
+        if (silent != (divisor == 0)) {
+            printf("  nota %d: muestra %lu %s\n", index, i, silent ? "en silencio" : "suena");
+            return 0;
+        }
+        if (i > first && g_pcm[i] > g_pcm[i - 1]) {
+            ++edges;
+        }
+    }
+    if (divisor == 0 || first == last) {
+        return 1;
+    }
+
+    if ((index == 0 || dump_divisor(melody->notes[index - 1].freq) != divisor) && g_pcm[first] <= 0x80) {
+        printf("  nota %d: no arranca en la muestra %lu\n", index, first);
+        return 0;
+    }
+    // Periodo real del PIT, no la frecuencia pedida
+    expected_edges = (last - first) * DUMP_PIT_FREQ / ((unsigned long)divisor * SOUND_RENDER_RATE);
+    if (edges + 1 < expected_edges || edges > expected_edges + 1) {
+        printf("  nota %d: %lu ciclos, esperados %lu\n", index, edges, expected_edges);
+        return 0;
+    }
+    return 1;
+}
+
+static int dump_check(const Melody *melody, unsigned long length)
+{
+    unsigned long ms = 0;
+    int ok = 1;
+    int i;
+
+    for (i = 0; i < melody->count; ++i) {
+        unsigned long dur = melody->notes[i].duration_ms ? melody->notes[i].duration_ms : 1;
+
+        if (!dump_check_note(melody, i, dump_sample_at(ms), dump_sample_at(ms + dur))) {
+            ok = 0;
+        }
+        ms += dur;
+    }
+    if (length != dump_sample_at(ms)) {
+        printf("  %lu muestras, esperadas %lu (%lu ms)\n", length, dump_sample_at(ms), ms);
+        ok = 0;
+    }
+    return ok;
+}
+
+static void dump_usage(void)
+{
+    int i;
+
+    printf("Uso: tbsnd [-b pcm|opl] [-m melodia|all] [-o directorio] [-c directorio] [-n repeticiones]\n");
+    printf("     tbsnd -s muestra.wav [-o directorio]\n");
+    printf("Melodias:");
+    for (i = 0; i < MELODY_COUNT; ++i) {
+        printf(" %s", melody_get((MelodyId)i)->name);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *only = "all";
+    const char *out_dir = NULL;
+    const char *golden_dir = NULL;
+    const char *sample_path = NULL;
+    int use_opl = 0;
+    unsigned long repeat = 1;
+    int ran = 0;
+    int failed = 0;
+    int i;
+
+    for (i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-m") == 0) {
+            only = argv[i + 1];
+        } else if (strcmp(argv[i], "-o") == 0) {
+            out_dir = argv[i + 1];
+        } else if (strcmp(argv[i], "-s") == 0) {
+            sample_path = argv[i + 1];
+        } else if (strcmp(argv[i], "-c") == 0) {
+            golden_dir = argv[i + 1];
+        } else if (strcmp(argv[i], "-b") == 0) {
+            use_opl = strcmp(argv[i + 1], "opl") == 0;
+            if (!use_opl && strcmp(argv[i + 1], "pcm") != 0) {
+                break;
+            }
+        } else if (strcmp(argv[i], "-n") == 0) {
+            repeat = strtoul(argv[i + 1], NULL, 10);
+        } else {
+            break;
+        }
+    }
+    if (i < argc || repeat == 0) {
+        dump_usage();
+        return 1;
+    }
+
+    timer_set_virtual(1, 0);
+    sound_init();
+
+    if (sample_path) {
+        failed = !dump_sample(sample_path, out_dir);
+        sound_shutdown();
+        return failed;
+    }
+
+    for (i = 0; i < MELODY_COUNT; ++i) {
+        const Melody *melody = melody_get((MelodyId)i);
+        unsigned long length = 0;
+        unsigned long r;
+        double start;
+        double us;
+        int ok;
+
+        if (strcmp(only, "all") != 0 && strcmp(only, melody->name) != 0) {
+            continue;
+        }
+        ++ran;
+
+        if (use_opl) {
+            char log_path[512];
+            char golden_path[512];
+            unsigned long ms = 0;
+            unsigned long bytes = 0;
+
+            snprintf(log_path, sizeof(log_path), "%s/%s.imf", out_dir ? out_dir : ".", melody->name);
+            snprintf(golden_path, sizeof(golden_path), "%s/%s.imf", golden_dir ? golden_dir : ".", melody->name);
+            ok = dump_opl(melody, log_path, golden_dir ? golden_path : NULL, &ms, &bytes);
+            failed += !ok;
+            printf("%-14s notas %2d  %6lu ms  %7lu escrituras  %s\n", melody->name, melody->count, ms, bytes / 4,
+                   ok ? "OK" : "MAL");
+            if (!out_dir) {
+                remove(log_path);
+            }
+            continue;
+        }
+
+        start = dump_wall_us();
+        for (r = 0; r < repeat; ++r) {
+            length = dump_render(melody);
+        }
+        us = (dump_wall_us() - start) / (double)repeat;
+
+        ok = dump_check(melody, length);
+        failed += !ok;
+        printf("%-14s notas %2d  %6lu ms  %7lu muestras  %8.1f us  %s\n", melody->name, melody->count,
+               length * 1000UL / SOUND_RENDER_RATE, length, us, ok ? "OK" : "MAL");
+
+        if (out_dir) {
+            char path[512];
+
+            snprintf(path, sizeof(path), "%s/%s.wav", out_dir, melody->name);
+            if (!dump_write_wav(path, length)) {
+                printf("No se puede escribir %s\n", path);
+                return 1;
+            }
+        }
+    }
+
+    sound_shutdown();
+    if (!ran) {
+        dump_usage();
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
@@ -1,7 +1,9 @@
 #include "breakout.h"
+#include "../../CORE/fixed.h"
 
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
+#include "../../CORE/rng.h"
 #include "../../CORE/sound.h"
 #include "../../CORE/video.h"
 #include "../../CORE/keyboard.h"
@@ -43,9 +45,9 @@
 #define BRK_DIFFICULTY_SPEED_HARD 0.65f
 
 typedef struct {
-    float paddle_speed;
-    float ball_speed_x;
-    float ball_speed_y;
+    phys_t paddle_speed;
+    phys_t ball_speed_x;
+    phys_t ball_speed_y;
     int paddle_w;
     int hits_per_drop;
     int wall_start_row_offset;
@@ -60,6 +62,7 @@ typedef struct {
 } BrickGrid;
 
 static GameSettings g_settings;
+static Rng g_rng;
 static BrkParams g_params;
 static BrickGrid g_grid;
 
@@ -68,15 +71,15 @@ static int g_did_win = 0;
 static int g_sound_enabled = 0;
 static int g_use_keyboard = 1;
 
-static float g_paddle_x = 0.0f;
-static float g_paddle_x_prev = 0.0f;
+static phys_t g_paddle_x = PHYS_C(0.0f);
+static phys_t g_paddle_x_prev = PHYS_C(0.0f);
 
-static float g_ball_x = 0.0f;
-static float g_ball_y = 0.0f;
-static float g_ball_x_prev = 0.0f;
-static float g_ball_y_prev = 0.0f;
-static float g_ball_vx = 0.0f;
-static float g_ball_vy = 0.0f;
+static phys_t g_ball_x = PHYS_C(0.0f);
+static phys_t g_ball_y = PHYS_C(0.0f);
+static phys_t g_ball_x_prev = PHYS_C(0.0f);
+static phys_t g_ball_y_prev = PHYS_C(0.0f);
+static phys_t g_ball_vx = PHYS_C(0.0f);
+static phys_t g_ball_vy = PHYS_C(0.0f);
 static int g_ball_attached = 0;
 static int g_ball_launch_ticks = 0;
 
@@ -89,7 +92,7 @@ static char g_end_detail[32] = "";
 
 static const unsigned char g_brick_colors[BRICK_ROWS] = {87, 86, 85, 84, 83, 82};
 
-static float clampf(float value, float min_value, float max_value)
+static phys_t clamp_phys(phys_t value, phys_t min_value, phys_t max_value)
 {
     if (value < min_value) {
         return min_value;
@@ -100,9 +103,9 @@ static float clampf(float value, float min_value, float max_value)
     return value;
 }
 
-static float absf(float value)
+static phys_t abs_phys(phys_t value)
 {
-    return value < 0.0f ? -value : value;
+    return value < PHYS_C(0.0f) ? -value : value;
 }
 
 static int text_len(const char *text)
@@ -155,9 +158,9 @@ static void breakout_select_params(unsigned char difficulty, BrkParams *params)
 
     switch (difficulty) {
     case DIFFICULTY_EASY:
-        params->paddle_speed = 3.0f;
-        params->ball_speed_x = 1.6f;
-        params->ball_speed_y = 1.7f;
+        params->paddle_speed = PHYS_C(3.0f);
+        params->ball_speed_x = PHYS_C(1.6f);
+        params->ball_speed_y = PHYS_C(1.7f);
         params->paddle_w = 48;
         params->hits_per_drop = 6;
         params->wall_start_row_offset = 0;
@@ -165,9 +168,9 @@ static void breakout_select_params(unsigned char difficulty, BrkParams *params)
         params->score_drop_bonus = 250;
         break;
     case DIFFICULTY_HARD:
-        params->paddle_speed = 3.6f;
-        params->ball_speed_x = 2.2f;
-        params->ball_speed_y = 2.3f;
+        params->paddle_speed = PHYS_C(3.6f);
+        params->ball_speed_x = PHYS_C(2.2f);
+        params->ball_speed_y = PHYS_C(2.3f);
         params->paddle_w = 34;
         params->hits_per_drop = 4;
         params->wall_start_row_offset = 0;
@@ -176,9 +179,9 @@ static void breakout_select_params(unsigned char difficulty, BrkParams *params)
         break;
     case DIFFICULTY_NORMAL:
     default:
-        params->paddle_speed = 3.3f;
-        params->ball_speed_x = 1.9f;
-        params->ball_speed_y = 2.0f;
+        params->paddle_speed = PHYS_C(3.3f);
+        params->ball_speed_x = PHYS_C(1.9f);
+        params->ball_speed_y = PHYS_C(2.0f);
         params->paddle_w = 40;
         params->hits_per_drop = 5;
         params->wall_start_row_offset = 0;
@@ -188,16 +191,16 @@ static void breakout_select_params(unsigned char difficulty, BrkParams *params)
     }
 }
 
-static float breakout_difficulty_speed_scale(unsigned char difficulty)
+static phys_t breakout_difficulty_speed_scale(unsigned char difficulty)
 {
     switch (difficulty) {
     case DIFFICULTY_EASY:
-        return BRK_DIFFICULTY_SPEED_EASY;
+        return PHYS_C(BRK_DIFFICULTY_SPEED_EASY);
     case DIFFICULTY_HARD:
-        return BRK_DIFFICULTY_SPEED_HARD;
+        return PHYS_C(BRK_DIFFICULTY_SPEED_HARD);
     case DIFFICULTY_NORMAL:
     default:
-        return BRK_DIFFICULTY_SPEED_NORMAL;
+        return PHYS_C(BRK_DIFFICULTY_SPEED_NORMAL);
     }
 }
 
@@ -205,26 +208,26 @@ static void breakout_prepare_ball(void)
 {
     g_ball_attached = 1;
     g_ball_launch_ticks = BRK_LAUNCH_TIMEOUT_TICKS;
-    g_ball_x = g_paddle_x + (g_params.paddle_w * 0.5f) - (BALL_SIZE * 0.5f);
-    g_ball_y = PADDLE_Y - BALL_SIZE - 2;
-    g_ball_vx = 0.0f;
-    g_ball_vy = 0.0f;
+    g_ball_x = g_paddle_x + PHYS_MUL(PHYS_I(g_params.paddle_w), PHYS_C(0.5f)) - PHYS_MUL(PHYS_I(BALL_SIZE), PHYS_C(0.5f));
+    g_ball_y = PHYS_I(PADDLE_Y - BALL_SIZE - 2);
+    g_ball_vx = PHYS_C(0.0f);
+    g_ball_vy = PHYS_C(0.0f);
 }
 
 static void breakout_launch_ball(void)
 {
-    int dir = (rand() % 2) ? 1 : -1;
+    int dir = rng_below(&g_rng, 2) ? 1 : -1;
     g_ball_attached = 0;
-    g_ball_vx = g_params.ball_speed_x * (float)dir;
+    g_ball_vx = PHYS_MUL(g_params.ball_speed_x, PHYS_I(dir));
     g_ball_vy = -g_params.ball_speed_y;
-    if (absf(g_ball_vx) < 0.1f) {
-        g_ball_vx = 0.1f * (float)dir;
+    if (abs_phys(g_ball_vx) < PHYS_C(0.1f)) {
+        g_ball_vx = PHYS_MUL(PHYS_C(0.1f), PHYS_I(dir));
     }
 }
 
 static void breakout_reset_positions(void)
 {
-    g_paddle_x = (PLAY_LEFT + PLAY_RIGHT - g_params.paddle_w) * 0.5f;
+    g_paddle_x = PHYS_MUL(PHYS_I(PLAY_LEFT + PLAY_RIGHT - g_params.paddle_w), PHYS_C(0.5f));
     g_paddle_x_prev = g_paddle_x;
     breakout_prepare_ball();
     g_ball_x_prev = g_ball_x;
@@ -247,21 +250,22 @@ void Breakout_Init(const GameSettings *settings)
 {
     int row;
     int col;
-    float difficulty_speed_scale;
+    phys_t difficulty_speed_scale;
 
     if (!settings) {
         return;
     }
 
     g_settings = *settings;
+    rng_seed(&g_rng, g_settings.seed);
     breakout_select_params(g_settings.difficulty, &g_params);
     difficulty_speed_scale = breakout_difficulty_speed_scale(g_settings.difficulty);
-    g_params.paddle_speed *= difficulty_speed_scale;
-    g_params.ball_speed_x *= difficulty_speed_scale;
-    g_params.ball_speed_y *= difficulty_speed_scale;
-    g_params.paddle_speed *= g_settings.speed_multiplier;
-    g_params.ball_speed_x *= g_settings.speed_multiplier;
-    g_params.ball_speed_y *= g_settings.speed_multiplier;
+    g_params.paddle_speed = PHYS_MUL(g_params.paddle_speed, difficulty_speed_scale);
+    g_params.ball_speed_x = PHYS_MUL(g_params.ball_speed_x, difficulty_speed_scale);
+    g_params.ball_speed_y = PHYS_MUL(g_params.ball_speed_y, difficulty_speed_scale);
+    g_params.paddle_speed = PHYS_MUL(g_params.paddle_speed, PHYS_F(g_settings.speed_multiplier));
+    g_params.ball_speed_x = PHYS_MUL(g_params.ball_speed_x, PHYS_F(g_settings.speed_multiplier));
+    g_params.ball_speed_y = PHYS_MUL(g_params.ball_speed_y, PHYS_F(g_settings.speed_multiplier));
 
     g_finished = 0;
     g_did_win = 0;
@@ -307,9 +311,9 @@ void Breakout_StorePreviousState(void)
 
 void Breakout_Update(void)
 {
-    float paddle_speed = g_params.paddle_speed;
-    float ball_next_x;
-    float ball_next_y;
+    phys_t paddle_speed = g_params.paddle_speed;
+    phys_t ball_next_x;
+    phys_t ball_next_y;
 
     if (g_finished) {
         return;
@@ -335,23 +339,23 @@ void Breakout_Update(void)
             move_dir += 1;
         }
 
-        g_paddle_x += (float)move_dir * paddle_speed;
+        g_paddle_x += PHYS_MUL(PHYS_I(move_dir), paddle_speed);
     } else {
         int dx = 0;
         int dy = 0;
 
         if (in_joystick_direction(&dx, &dy, NULL)) {
-            g_paddle_x += (float)dx * paddle_speed;
+            g_paddle_x += PHYS_MUL(PHYS_I(dx), paddle_speed);
         }
     }
 
-    g_paddle_x = clampf(g_paddle_x, (float)PLAY_LEFT, (float)(PLAY_RIGHT - g_params.paddle_w));
+    g_paddle_x = clamp_phys(g_paddle_x, PHYS_I(PLAY_LEFT), PHYS_I(PLAY_RIGHT - g_params.paddle_w));
 
     if (g_ball_attached) {
         int launch_now = 0;
 
-        g_ball_x = g_paddle_x + (g_params.paddle_w * 0.5f) - (BALL_SIZE * 0.5f);
-        g_ball_y = PADDLE_Y - BALL_SIZE - 2;
+        g_ball_x = g_paddle_x + PHYS_MUL(PHYS_I(g_params.paddle_w), PHYS_C(0.5f)) - PHYS_MUL(PHYS_I(BALL_SIZE), PHYS_C(0.5f));
+        g_ball_y = PHYS_I(PADDLE_Y - BALL_SIZE - 2);
 
         if (g_ball_launch_ticks > 0) {
             g_ball_launch_ticks--;
@@ -375,29 +379,29 @@ void Breakout_Update(void)
     ball_next_x = g_ball_x + g_ball_vx;
     ball_next_y = g_ball_y + g_ball_vy;
 
-    if (ball_next_x <= PLAY_LEFT) {
-        ball_next_x = (float)PLAY_LEFT;
+    if (ball_next_x <= PHYS_I(PLAY_LEFT)) {
+        ball_next_x = PHYS_I(PLAY_LEFT);
         g_ball_vx = -g_ball_vx;
         if (g_sound_enabled) {
             sound_play_tone(460, 20);
         }
-    } else if ((ball_next_x + BALL_SIZE) >= PLAY_RIGHT) {
-        ball_next_x = (float)(PLAY_RIGHT - BALL_SIZE);
+    } else if ((ball_next_x + PHYS_I(BALL_SIZE)) >= PHYS_I(PLAY_RIGHT)) {
+        ball_next_x = PHYS_I(PLAY_RIGHT - BALL_SIZE);
         g_ball_vx = -g_ball_vx;
         if (g_sound_enabled) {
             sound_play_tone(460, 20);
         }
     }
 
-    if (ball_next_y <= PLAY_TOP) {
-        ball_next_y = (float)PLAY_TOP;
+    if (ball_next_y <= PHYS_I(PLAY_TOP)) {
+        ball_next_y = PHYS_I(PLAY_TOP);
         g_ball_vy = -g_ball_vy;
         if (g_sound_enabled) {
             sound_play_tone(500, 20);
         }
     }
 
-    if (ball_next_y > PLAY_BOTTOM) {
+    if (ball_next_y > PHYS_I(PLAY_BOTTOM)) {
         g_lives--;
         if (g_sound_enabled) {
             sound_play_tone(180, 120);
@@ -412,40 +416,42 @@ void Breakout_Update(void)
     }
 
     {
-        float paddle_right = g_paddle_x + g_params.paddle_w;
-        float paddle_top = (float)PADDLE_Y;
-        float paddle_bottom = (float)(PADDLE_Y + PADDLE_H);
+        phys_t paddle_right = g_paddle_x + PHYS_I(g_params.paddle_w);
+        phys_t paddle_top = PHYS_I(PADDLE_Y);
+        phys_t paddle_bottom = PHYS_I(PADDLE_Y + PADDLE_H);
 
-        if (g_ball_vy > 0.0f &&
-            (ball_next_x + BALL_SIZE) >= g_paddle_x &&
+        if (g_ball_vy > PHYS_C(0.0f) &&
+            (ball_next_x + PHYS_I(BALL_SIZE)) >= g_paddle_x &&
             ball_next_x <= paddle_right &&
-            (ball_next_y + BALL_SIZE) >= paddle_top &&
+            (ball_next_y + PHYS_I(BALL_SIZE)) >= paddle_top &&
             ball_next_y <= paddle_bottom) {
-            float paddle_center = g_paddle_x + (g_params.paddle_w * 0.5f);
-            float ball_center = ball_next_x + (BALL_SIZE * 0.5f);
-            float rel = (ball_center - paddle_center) / (g_params.paddle_w * 0.5f);
-            float base_vx = g_params.ball_speed_x;
-            float min_vx = absf(base_vx) * BALL_MIN_VX_SCALE;
-            float new_vx;
-            float magnitude;
-            float sign;
-
-            if (rel < -1.0f) {
-                rel = -1.0f;
-            } else if (rel > 1.0f) {
-                rel = 1.0f;
+            phys_t paddle_center = g_paddle_x + PHYS_MUL(PHYS_I(g_params.paddle_w), PHYS_C(0.5f));
+            phys_t ball_center = ball_next_x + PHYS_MUL(PHYS_I(BALL_SIZE), PHYS_C(0.5f));
+            phys_t rel = PHYS_DIV(ball_center - paddle_center, PHYS_MUL(PHYS_I(g_params.paddle_w), PHYS_C(0.5f)));
+            phys_t base_vx = g_params.ball_speed_x;
+            phys_t min_vx = PHYS_MUL(abs_phys(base_vx), PHYS_C(BALL_MIN_VX_SCALE));
+            phys_t new_vx;
+            phys_t magnitude;
+            phys_t sign;
+
+            if (rel < PHYS_C(-1.0f)) {
+                rel = PHYS_C(-1.0f);
+            } else if (rel > PHYS_C(1.0f)) {
+                rel = PHYS_C(1.0f);
             }
 
-            magnitude = absf(base_vx) * (0.4f + (0.6f * absf(rel)));
-            sign = (rel < -0.2f) ? -1.0f : (rel > 0.2f) ? 1.0f : (g_ball_vx < 0.0f ? -1.0f : 1.0f);
+            magnitude = PHYS_MUL(abs_phys(base_vx), PHYS_C(0.4f) + PHYS_MUL(PHYS_C(0.6f), abs_phys(rel)));
+            sign = (rel < PHYS_C(-0.2f)) ? PHYS_C(-1.0f)
+                 : (rel > PHYS_C(0.2f)) ? PHYS_C(1.0f)
+                 : (g_ball_vx < PHYS_C(0.0f) ? PHYS_C(-1.0f) : PHYS_C(1.0f));
             if (magnitude < min_vx) {
                 magnitude = min_vx;
             }
-            new_vx = magnitude * sign;
+            new_vx = PHYS_MUL(magnitude, sign);
 
             g_ball_vx = new_vx;
-            g_ball_vy = -absf(g_ball_vy);
-            ball_next_y = paddle_top - BALL_SIZE;
+            g_ball_vy = -abs_phys(g_ball_vy);
+            ball_next_y = paddle_top - PHYS_I(BALL_SIZE);
 
             g_hits_since_drop++;
             if (g_hits_since_drop >= g_params.hits_per_drop) {
@@ -460,17 +466,17 @@ void Breakout_Update(void)
     }
 
     {
-        float ball_center_x = ball_next_x + (BALL_SIZE * 0.5f);
-        float ball_center_y = ball_next_y + (BALL_SIZE * 0.5f);
-        float grid_left = (float)BRICK_LEFT;
-        float grid_right = grid_left + BRICK_AREA_WIDTH;
-        float grid_top = (float)g_grid.top_y;
-        float grid_bottom = grid_top + BRICK_AREA_HEIGHT;
+        phys_t ball_center_x = ball_next_x + PHYS_MUL(PHYS_I(BALL_SIZE), PHYS_C(0.5f));
+        phys_t ball_center_y = ball_next_y + PHYS_MUL(PHYS_I(BALL_SIZE), PHYS_C(0.5f));
+        phys_t grid_left = PHYS_I(BRICK_LEFT);
+        phys_t grid_right = grid_left + PHYS_I(BRICK_AREA_WIDTH);
+        phys_t grid_top = PHYS_I(g_grid.top_y);
+        phys_t grid_bottom = grid_top + PHYS_I(BRICK_AREA_HEIGHT);
 
         if (ball_center_x >= grid_left && ball_center_x < grid_right &&
             ball_center_y >= grid_top && ball_center_y < grid_bottom) {
-            int local_x = (int)(ball_center_x - grid_left);
-            int local_y = (int)(ball_center_y - grid_top);
+            int local_x = PHYS_INT(ball_center_x - grid_left);
+            int local_y = PHYS_INT(ball_center_y - grid_top);
             int cell_w = BRICK_W + BRICK_GAP;
             int cell_h = BRICK_H + BRICK_GAP;
             int col = local_x / cell_w;
@@ -516,10 +522,10 @@ void Breakout_DrawInterpolated(float alpha)
 {
     char hud[64];
     char score_text[32];
-    float clamped_alpha = clampf(alpha, 0.0f, 1.0f);
-    float paddle_x = g_paddle_x_prev + (g_paddle_x - g_paddle_x_prev) * clamped_alpha;
-    float ball_x = g_ball_x_prev + (g_ball_x - g_ball_x_prev) * clamped_alpha;
-    float ball_y = g_ball_y_prev + (g_ball_y - g_ball_y_prev) * clamped_alpha;
+    phys_t clamped_alpha = clamp_phys(PHYS_F(alpha), PHYS_C(0.0f), PHYS_C(1.0f));
+    phys_t paddle_x = PHYS_LERP(g_paddle_x_prev, g_paddle_x, clamped_alpha);
+    phys_t ball_x = PHYS_LERP(g_ball_x_prev, g_ball_x, clamped_alpha);
+    phys_t ball_y = PHYS_LERP(g_ball_y_prev, g_ball_y, clamped_alpha);
     int row;
     int col;
     v_clear(0);
@@ -538,9 +544,9 @@ void Breakout_DrawInterpolated(float alpha)
         }
     }
 
-    v_fill_rect((int)ball_x, (int)ball_y, BALL_SIZE, BALL_SIZE, 15);
+    v_fill_rect(PHYS_INT(ball_x), PHYS_INT(ball_y), BALL_SIZE, BALL_SIZE, 15);
 
-    v_draw_dotted_rect((int)paddle_x, PADDLE_Y, g_params.paddle_w, PADDLE_H,
+    v_draw_dotted_rect(PHYS_INT(paddle_x), PADDLE_Y, g_params.paddle_w, PADDLE_H,
                        BRK_COLOR_PLAYER_SHIP_BASE, BRK_COLOR_PLAYER_SHIP_DOTS, 1);
 
     snprintf(hud, sizeof(hud), "D:%s x%.2f", difficulty_short(g_settings.difficulty), g_settings.speed_multiplier);
@@ -592,3 +598,21 @@ uint64_t Breakout_GetScore(void)
 {
     return g_score;
 }
+
+void Breakout_DemoInput(unsigned char *keys)
+{
+    // La pala se pone debajo de la bola y saca en cuanto puede
+    phys_t center = g_paddle_x + PHYS_MUL(PHYS_I(g_params.paddle_w), PHYS_C(0.5f));
+    phys_t target = g_ball_x + PHYS_MUL(PHYS_I(BALL_SIZE), PHYS_C(0.5f));
+
+    if (g_ball_attached) {
+        kb_snapshot_press(keys, SC_SPACE);
+        return;
+    }
+
+    if (target < center - g_params.paddle_speed) {
+        kb_snapshot_press(keys, SC_LEFT);
+    } else if (target > center + g_params.paddle_speed) {
+        kb_snapshot_press(keys, SC_RIGHT);
+    }
+}
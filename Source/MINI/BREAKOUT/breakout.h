@@ -18,5 +18,7 @@ int Breakout_IsFinished(void);
 int Breakout_DidWin(void);
 const char *Breakout_GetEndDetail(void);
 uint64_t Breakout_GetScore(void);
+// Demo: teclas del jugador que pondría la IA
+void Breakout_DemoInput(unsigned char *keys);
 
 #endif
@@ -1,7 +1,9 @@
 #include "flappy.h"
+#include "../../CORE/fixed.h"
 
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
+#include "../../CORE/rng.h"
 #include "../../CORE/sound.h"
 #include "../../CORE/video.h"
 #include "../../CORE/sprite_dat.h"
@@ -42,7 +44,7 @@
 #define FLAPPY_JUMP_TUNE      1.0f   // < 1.0 = salto menos bestia
 #define FLAPPY_TERMINAL_VY    3.2f    // Velocidad máxima de caída en px/frame
 
-static float g_terminal_vy = 0.0f;
+static phys_t g_terminal_vy = PHYS_C(0.0f);
 
 #define FLAPPY_PLAYER_MAX_PIXELS 4096UL
 static const char *g_ad_texts[] = {
@@ -69,11 +71,11 @@ typedef enum {
 } FlappyState;
 
 typedef struct {
-    float pipe_speed;
+    phys_t pipe_speed;
     int gap_height;
     int spacing;
-    float gravity;
-    float jump_vy;
+    phys_t gravity;
+    phys_t jump_vy;
     int min_pipes;
 } FlappyParams;
 
@@ -82,22 +84,24 @@ typedef struct {
     unsigned short h;
     unsigned long max_pixels;
     unsigned char far *pixels;
+    SpanSprite spans;
 } FlappySprite;
 
 typedef struct {
-    float x;
-    float prev_x;
+    phys_t x;
+    phys_t prev_x;
     int gap_y;
     int scored;
 } FlappyPipe;
 
 static GameSettings g_settings;
+static Rng g_rng;
 static FlappyParams g_params;
 
 static FlappySprite g_player_sprite;
 static FlappyPipe g_pipes[FLAPPY_MAX_PIPES];
 static int g_pipe_count = 0;
-static float g_rightmost_pipe_x = 0.0f;
+static phys_t g_rightmost_pipe_x = PHYS_C(0.0f);
 
 static FlappyState g_state = FLAPPY_STATE_READY;
 static int g_finished = 0;
@@ -107,10 +111,10 @@ static int g_sound_enabled = 0;
 static int g_jump_held = 0;
 static int g_ad_text_index = 0;
 
-static float g_player_x = 0.0f;
-static float g_player_y = 0.0f;
-static float g_player_y_prev = 0.0f;
-static float g_player_vy = 0.0f;
+static phys_t g_player_x = PHYS_C(0.0f);
+static phys_t g_player_y = PHYS_C(0.0f);
+static phys_t g_player_y_prev = PHYS_C(0.0f);
+static phys_t g_player_vy = PHYS_C(0.0f);
 
 static uint64_t g_score = 0;
 static uint64_t g_final_score = 0;
@@ -151,14 +155,6 @@ static const char *difficulty_short(unsigned char difficulty)
     }
 }
 
-static int rand_range(int min_value, int max_value)
-{
-    if (max_value <= min_value) {
-        return min_value;
-    }
-    return min_value + (rand() % (max_value - min_value + 1));
-}
-
 static void flappy_select_params(unsigned char difficulty, FlappyParams *params)
 {
     if (!params) {
@@ -167,28 +163,28 @@ static void flappy_select_params(unsigned char difficulty, FlappyParams *params)
 
     switch (difficulty) {
     case DIFFICULTY_EASY:
-        params->pipe_speed = 1.5f;
+        params->pipe_speed = PHYS_C(1.5f);
         params->gap_height = 58;
         params->spacing = 140;
-        params->gravity = 0.25f;
-        params->jump_vy = -3.5f;
+        params->gravity = PHYS_C(0.25f);
+        params->jump_vy = PHYS_C(-3.5f);
         params->min_pipes = 3;
         break;
     case DIFFICULTY_HARD:
-        params->pipe_speed = 3.5f;
+        params->pipe_speed = PHYS_C(3.5f);
         params->gap_height = 40;
         params->spacing = 110;
-        params->gravity = 0.33f;
-        params->jump_vy = -3.8f;
+        params->gravity = PHYS_C(0.33f);
+        params->jump_vy = PHYS_C(-3.8f);
         params->min_pipes = 10;
         break;
     case DIFFICULTY_NORMAL:
     default:
-        params->pipe_speed = 2.5f;
+        params->pipe_speed = PHYS_C(2.5f);
         params->gap_height = 48;
         params->spacing = 120;
-        params->gravity = 0.29f;
-        params->jump_vy = -3.6f;
+        params->gravity = PHYS_C(0.29f);
+        params->jump_vy = PHYS_C(-3.6f);
         params->min_pipes = 5;
         break;
     }
@@ -221,12 +217,21 @@ static int flappy_load_sprite(const char *path, FlappySprite *sprite)
         return 0;
     }
 
-    return sprite_dat_load_auto(path, &sprite->w, &sprite->h, sprite->pixels, sprite->max_pixels);
+    if (!sprite_dat_load_auto(path, &sprite->w, &sprite->h, sprite->pixels, sprite->max_pixels)) {
+        return 0;
+    }
+
+    v_sprite_spans_build(&sprite->spans, sprite->w, sprite->h, sprite->pixels, 0);
+    return 1;
 }
 
 static void flappy_free_sprite(FlappySprite *sprite)
 {
-    if (!sprite || !sprite->pixels) {
+    if (!sprite) {
+        return;
+    }
+    v_sprite_spans_free(&sprite->spans);
+    if (!sprite->pixels) {
         return;
     }
 
@@ -243,7 +248,7 @@ static void flappy_pick_ad_text(void)
         g_ad_text_index = 0;
         return;
     }
-    g_ad_text_index = rand() % count;
+    g_ad_text_index = rng_below(&g_rng, count);
 }
 
 static int flappy_jump_pressed(void)
@@ -277,7 +282,7 @@ static int flappy_rects_intersect(int ax, int ay, int aw, int ah, int bx, int by
 static int flappy_random_gap_y(void)
 {
     int max_gap_y = FLAPPY_GAME_H - g_params.gap_height - FLAPPY_GAP_MARGIN;
-    return rand_range(FLAPPY_MIN_GAP_Y, max_gap_y);
+    return rng_range(&g_rng, FLAPPY_MIN_GAP_Y, max_gap_y);
 }
 
 static void flappy_update_score_cached(void)
@@ -343,7 +348,7 @@ static void flappy_init_pipes(void)
 
     g_pipe_count = FLAPPY_MAX_PIPES;
     for (i = 0; i < g_pipe_count; ++i) {
-        g_pipes[i].x = (float)(start_x + (i * g_params.spacing));
+        g_pipes[i].x = PHYS_I(start_x + (i * g_params.spacing));
         g_pipes[i].prev_x = g_pipes[i].x;
         g_pipes[i].gap_y = flappy_random_gap_y();
         g_pipes[i].scored = 0;
@@ -354,7 +359,7 @@ static void flappy_init_pipes(void)
 static void flappy_update_pipes(void)
 {
     int i;
-    float step = g_params.pipe_speed;
+    phys_t step = g_params.pipe_speed;
     g_rightmost_pipe_x -= step;
 
     for (i = 0; i < g_pipe_count; ++i) {
@@ -362,14 +367,14 @@ static void flappy_update_pipes(void)
 
         pipe->x -= step;
 
-        if ((pipe->x + FLAPPY_PIPE_W) < 0.0f) {
-            pipe->x = g_rightmost_pipe_x + g_params.spacing;
+        if ((pipe->x + PHYS_I(FLAPPY_PIPE_W)) < PHYS_C(0.0f)) {
+            pipe->x = g_rightmost_pipe_x + PHYS_I(g_params.spacing);
             g_rightmost_pipe_x = pipe->x;
             pipe->gap_y = flappy_random_gap_y();
             pipe->scored = 0;
         }
 
-        if (!pipe->scored && g_player_x > (pipe->x + FLAPPY_PIPE_W)) {
+        if (!pipe->scored && g_player_x > (pipe->x + PHYS_I(FLAPPY_PIPE_W))) {
             pipe->scored = 1;
             g_score++;
             if (g_sound_enabled) {
@@ -388,10 +393,10 @@ static void flappy_quick_restart(void)
 
     g_jump_held = 0;
 
-    g_player_x = (float)FLAPPY_PLAYER_X;
-    g_player_y = (float)((FLAPPY_GAME_H - FLAPPY_PLAYER_H) / 2);
+    g_player_x = PHYS_I(FLAPPY_PLAYER_X);
+    g_player_y = PHYS_I((FLAPPY_GAME_H - FLAPPY_PLAYER_H) / 2);
     g_player_y_prev = g_player_y;
-    g_player_vy = 0.0f;
+    g_player_vy = PHYS_C(0.0f);
 
     g_score = 0;
     g_final_score = 0;
@@ -433,14 +438,14 @@ static void flappy_die(void)
 static void flappy_check_collisions(void)
 {
     int i;
-    int player_x = (int)g_player_x + 4;
-    int player_y = (int)g_player_y + 3;
+    int player_x = PHYS_INT(g_player_x) + 4;
+    int player_y = PHYS_INT(g_player_y) + 3;
     int player_w = 16;
     int player_h = 10;
 
     for (i = 0; i < g_pipe_count; ++i) {
         FlappyPipe *pipe = &g_pipes[i];
-        int pipe_x = (int)pipe->x;
+        int pipe_x = PHYS_INT(pipe->x);
         int gap_y = pipe->gap_y;
         int top_h = gap_y;
         int bottom_y = gap_y + g_params.gap_height;
@@ -482,9 +487,8 @@ static void flappy_draw_pipe_segment(int x, int y, int h)
     }
 }
 
-static void flappy_draw_pipe(float x, int gap_y)
+static void flappy_draw_pipe(int pipe_x, int gap_y)
 {
-    int pipe_x = (int)x;
     int top_h = gap_y;
     int bottom_y = gap_y + g_params.gap_height;
     int bottom_h = FLAPPY_GAME_H - bottom_y;
@@ -527,6 +531,10 @@ void Flappy_Init(const GameSettings *settings)
     } else {
         memset(&g_settings, 0, sizeof(g_settings));
     }
+    rng_seed(&g_rng, g_settings.seed);
+
+    // Mucho repintado encima del cielo: que lo recorte la cola diferida
+    v_set_deferred(1);
 
     g_use_keyboard = 1;
     if (g_settings.input_mode == INPUT_JOYSTICK) {
@@ -540,20 +548,20 @@ void Flappy_Init(const GameSettings *settings)
     flappy_select_params(g_settings.difficulty, &g_params);
 
     {
-        float mul = g_settings.speed_multiplier * FLAPPY_GLOBAL_SPEED_SCALE;
+        phys_t mul = PHYS_F(g_settings.speed_multiplier * FLAPPY_GLOBAL_SPEED_SCALE);
 
-        g_params.pipe_speed *= mul;
+        g_params.pipe_speed = PHYS_MUL(g_params.pipe_speed, mul);
 
         // Física base escalada
-        g_params.gravity *= mul;
-        g_params.jump_vy *= mul;
+        g_params.gravity = PHYS_MUL(g_params.gravity, mul);
+        g_params.jump_vy = PHYS_MUL(g_params.jump_vy, mul);
 
         // Ajuste global aplicado tras el escalado
-        g_params.gravity *= FLAPPY_GRAVITY_TUNE;
-        g_params.jump_vy *= FLAPPY_JUMP_TUNE;
+        g_params.gravity = PHYS_MUL(g_params.gravity, PHYS_C(FLAPPY_GRAVITY_TUNE));
+        g_params.jump_vy = PHYS_MUL(g_params.jump_vy, PHYS_C(FLAPPY_JUMP_TUNE));
 
         // Velocidad terminal escalada con el mul
-        g_terminal_vy = FLAPPY_TERMINAL_VY * mul;
+        g_terminal_vy = PHYS_MUL(PHYS_C(FLAPPY_TERMINAL_VY), mul);
     }
 
 
@@ -562,10 +570,10 @@ void Flappy_Init(const GameSettings *settings)
     g_did_win = 0;
     g_jump_held = 0;
 
-    g_player_x = (float)FLAPPY_PLAYER_X;
-    g_player_y = (float)((FLAPPY_GAME_H - FLAPPY_PLAYER_H) / 2);
+    g_player_x = PHYS_I(FLAPPY_PLAYER_X);
+    g_player_y = PHYS_I((FLAPPY_GAME_H - FLAPPY_PLAYER_H) / 2);
     g_player_y_prev = g_player_y;
-    g_player_vy = 0.0f;
+    g_player_vy = PHYS_C(0.0f);
 
     g_score = 0;
     g_final_score = 0;
@@ -641,14 +649,14 @@ void Flappy_Update(void)
     g_player_y += g_player_vy;
 
 
-    if (g_player_y < 0.0f) {
-        g_player_y = 0.0f;
+    if (g_player_y < PHYS_C(0.0f)) {
+        g_player_y = PHYS_C(0.0f);
         flappy_die();
         return;
     }
 
-    if (g_player_y > (float)(FLAPPY_GAME_H - FLAPPY_PLAYER_H)) {
-        g_player_y = (float)(FLAPPY_GAME_H - FLAPPY_PLAYER_H);
+    if (g_player_y > PHYS_I(FLAPPY_GAME_H - FLAPPY_PLAYER_H)) {
+        g_player_y = PHYS_I(FLAPPY_GAME_H - FLAPPY_PLAYER_H);
         flappy_die();
         return;
     }
@@ -660,12 +668,19 @@ void Flappy_Update(void)
 void Flappy_DrawInterpolated(float alpha)
 {
     int i;
+    int player_x = PHYS_INT(g_player_x);
     int player_y;
+#if USE_FIXED_PHYSICS
+    phys_t t = PHYS_F(alpha);
 
+    // En coma fija interpolar es barato
+    player_y = PHYS_INT(PHYS_LERP(g_player_y_prev, g_player_y, t));
+#else
     // OJO: en 486 la interpolación con float mata, se ignora
     (void)alpha;
 
-    player_y = (int)g_player_y;
+    player_y = PHYS_INT(g_player_y);
+#endif
 
     // Área de juego sin pisar la barra superior
     v_fill_rect(0, 8, FLAPPY_GAME_W, FLAPPY_GAME_H - 8, FLAPPY_SKY_COLOR);
@@ -674,20 +689,27 @@ void Flappy_DrawInterpolated(float alpha)
     v_fill_rect(0, FLAPPY_AD_Y, FLAPPY_GAME_W, FLAPPY_AD_H, 0);
 
     for (i = 0; i < g_pipe_count; ++i) {
-        int pipe_x = (int)g_pipes[i].x;
+        int pipe_x = PHYS_INT(g_pipes[i].x);
 
+#if USE_FIXED_PHYSICS
+        // La tubería que vuelve a entrar por la derecha no se interpola
+        if (g_pipes[i].prev_x >= g_pipes[i].x) {
+            pipe_x = PHYS_INT(PHYS_LERP(g_pipes[i].prev_x, g_pipes[i].x, t));
+        }
+#endif
         if ((pipe_x + FLAPPY_PIPE_W) < 0 || pipe_x >= FLAPPY_GAME_W) {
             continue;
         }
-        flappy_draw_pipe((float)pipe_x, g_pipes[i].gap_y);
-        // Convierte a float una sola vez para el blit
+        flappy_draw_pipe(pipe_x, g_pipes[i].gap_y);
     }
 
-    if (g_player_sprite.pixels) {
-        v_blit_sprite((int)g_player_x, player_y, g_player_sprite.w, g_player_sprite.h,
+    if (g_player_sprite.spans.data) {
+        v_blit_sprite_spans(player_x, player_y, &g_player_sprite.spans);
+    } else if (g_player_sprite.pixels) {
+        v_blit_sprite(player_x, player_y, g_player_sprite.w, g_player_sprite.h,
                       g_player_sprite.pixels, 0);
     } else {
-        v_fill_rect((int)g_player_x, player_y, FLAPPY_PLAYER_W, FLAPPY_PLAYER_H, 15);
+        v_fill_rect(player_x, player_y, FLAPPY_PLAYER_W, FLAPPY_PLAYER_H, 15);
     }
 
     // HUD
@@ -716,6 +738,8 @@ void Flappy_End(void)
     high_scores_format_score(score_text, sizeof(score_text), g_score);
     snprintf(g_end_detail, sizeof(g_end_detail), "PUNTOS %s", score_text);
 
+    // Antes de liberar: la cola aún puede apuntar al sprite
+    v_set_deferred(0);
     flappy_free_sprite(&g_player_sprite);
 }
 
@@ -1,5 +1,6 @@
 #include "frog.h"
 
+#include "../../CORE/fixed.h"
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
 #include "../../CORE/sound.h"
@@ -11,7 +12,6 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <math.h>
 #include <stdint.h>
 #include <malloc.h>
 
@@ -62,8 +62,8 @@
 #define FROG_GOAL_SLOTS 5
 
 typedef struct {
-    float road_speed[FROG_MAX_ROAD_LANES];
-    float river_speed[FROG_MAX_RIVER_LANES];
+    phys_t road_speed[FROG_MAX_ROAD_LANES];
+    phys_t river_speed[FROG_MAX_RIVER_LANES];
     int road_count[FROG_MAX_ROAD_LANES];
     int river_count[FROG_MAX_RIVER_LANES];
     int timer_seconds;
@@ -73,16 +73,17 @@ typedef struct {
     unsigned short w;
     unsigned short h;
     unsigned char far *pixels;
+    SpanSprite spans;
 } FrogSprite;
 
 typedef struct {
-    float x[FROG_MAX_VEHICLES_PER_LANE];
-    float x_prev[FROG_MAX_VEHICLES_PER_LANE];
+    phys_t x[FROG_MAX_VEHICLES_PER_LANE];
+    phys_t x_prev[FROG_MAX_VEHICLES_PER_LANE];
 } FrogLanePositions;
 
 typedef struct {
-    float x[FROG_MAX_PLATFORMS_PER_LANE];
-    float x_prev[FROG_MAX_PLATFORMS_PER_LANE];
+    phys_t x[FROG_MAX_PLATFORMS_PER_LANE];
+    phys_t x_prev[FROG_MAX_PLATFORMS_PER_LANE];
 } FrogPlatformPositions;
 
 typedef enum {
@@ -133,10 +134,10 @@ static int g_sprites_loaded = 0;
 static FrogLanePositions g_road_positions[FROG_MAX_ROAD_LANES];
 static FrogPlatformPositions g_river_positions[FROG_MAX_RIVER_LANES];
 
-static float g_frog_x = 0.0f;
-static float g_frog_y = 0.0f;
-static float g_frog_x_prev = 0.0f;
-static float g_frog_y_prev = 0.0f;
+static phys_t g_frog_x = PHYS_C(0.0f);
+static phys_t g_frog_y = PHYS_C(0.0f);
+static phys_t g_frog_x_prev = PHYS_C(0.0f);
+static phys_t g_frog_y_prev = PHYS_C(0.0f);
 static FrogDirection g_frog_dir = FROG_DIR_UP;
 static int g_hop_ticks = 0;
 static int g_move_held = 0;
@@ -150,8 +151,11 @@ static char g_last_death_reason[32] = "";
 static int g_frame_counter = 0;
 static int g_water_scroll_px = 0;
 static int g_water_scroll_acc = 0;
+static Surface g_bg_layer;
+static int g_bg_ready = 0;
+static int g_bg_scroll_px = 0;
 
-static float clampf(float value, float min_value, float max_value)
+static phys_t clamp_phys(phys_t value, phys_t min_value, phys_t max_value)
 {
     if (value < min_value) {
         return min_value;
@@ -198,14 +202,14 @@ static void frog_select_params(unsigned char difficulty, FrogParams *params)
 
     switch (difficulty) {
     case DIFFICULTY_EASY:
-        params->road_speed[0] = 0.60f;
-        params->road_speed[1] = 0.70f;
-        params->road_speed[2] = 0.80f;
-        params->road_speed[3] = 0.90f;
-        params->river_speed[0] = 0.45f;
-        params->river_speed[1] = 0.55f;
-        params->river_speed[2] = 0.50f;
-        params->river_speed[3] = 0.60f;
+        params->road_speed[0] = PHYS_C(0.60f);
+        params->road_speed[1] = PHYS_C(0.70f);
+        params->road_speed[2] = PHYS_C(0.80f);
+        params->road_speed[3] = PHYS_C(0.90f);
+        params->river_speed[0] = PHYS_C(0.45f);
+        params->river_speed[1] = PHYS_C(0.55f);
+        params->river_speed[2] = PHYS_C(0.50f);
+        params->river_speed[3] = PHYS_C(0.60f);
         params->road_count[0] = 2;
         params->road_count[1] = 2;
         params->road_count[2] = 2;
@@ -217,14 +221,14 @@ static void frog_select_params(unsigned char difficulty, FrogParams *params)
         params->timer_seconds = 45;
         break;
     case DIFFICULTY_HARD:
-        params->road_speed[0] = 1.00f;
-        params->road_speed[1] = 1.20f;
-        params->road_speed[2] = 1.30f;
-        params->road_speed[3] = 1.40f;
-        params->river_speed[0] = 0.85f;
-        params->river_speed[1] = 1.00f;
-        params->river_speed[2] = 0.90f;
-        params->river_speed[3] = 1.10f;
+        params->road_speed[0] = PHYS_C(1.00f);
+        params->road_speed[1] = PHYS_C(1.20f);
+        params->road_speed[2] = PHYS_C(1.30f);
+        params->road_speed[3] = PHYS_C(1.40f);
+        params->river_speed[0] = PHYS_C(0.85f);
+        params->river_speed[1] = PHYS_C(1.00f);
+        params->river_speed[2] = PHYS_C(0.90f);
+        params->river_speed[3] = PHYS_C(1.10f);
         params->road_count[0] = 3;
         params->road_count[1] = 3;
         params->road_count[2] = 4;
@@ -237,14 +241,14 @@ static void frog_select_params(unsigned char difficulty, FrogParams *params)
         break;
     case DIFFICULTY_NORMAL:
     default:
-        params->road_speed[0] = 0.80f;
-        params->road_speed[1] = 0.95f;
-        params->road_speed[2] = 1.05f;
-        params->road_speed[3] = 1.15f;
-        params->river_speed[0] = 0.65f;
-        params->river_speed[1] = 0.75f;
-        params->river_speed[2] = 0.70f;
-        params->river_speed[3] = 0.80f;
+        params->road_speed[0] = PHYS_C(0.80f);
+        params->road_speed[1] = PHYS_C(0.95f);
+        params->road_speed[2] = PHYS_C(1.05f);
+        params->road_speed[3] = PHYS_C(1.15f);
+        params->river_speed[0] = PHYS_C(0.65f);
+        params->river_speed[1] = PHYS_C(0.75f);
+        params->river_speed[2] = PHYS_C(0.70f);
+        params->river_speed[3] = PHYS_C(0.80f);
         params->road_count[0] = 3;
         params->road_count[1] = 3;
         params->road_count[2] = 3;
@@ -285,8 +289,13 @@ static int frog_load_sprite(const char *path, FrogSprite *sprite)
         return 0;
     }
 
-    return sprite_dat_load_auto(path, &sprite->w, &sprite->h, sprite->pixels,
-                                (unsigned long)FROG_MAX_SPRITE_PIXELS);
+    if (!sprite_dat_load_auto(path, &sprite->w, &sprite->h, sprite->pixels,
+                              (unsigned long)FROG_MAX_SPRITE_PIXELS)) {
+        return 0;
+    }
+
+    v_sprite_spans_build(&sprite->spans, sprite->w, sprite->h, sprite->pixels, 0);
+    return 1;
 }
 
 static void frog_load_sprites(void)
@@ -311,7 +320,11 @@ static void frog_load_sprites(void)
 
 static void frog_free_sprite(FrogSprite *sprite)
 {
-    if (!sprite || !sprite->pixels) {
+    if (!sprite) {
+        return;
+    }
+    v_sprite_spans_free(&sprite->spans);
+    if (!sprite->pixels) {
         return;
     }
 
@@ -363,6 +376,10 @@ static void frog_blit_sprite(int x, int y, const FrogSprite *sprite)
         return;
     }
 
+    if (sprite->spans.data) {
+        v_blit_sprite_spans(x, y, &sprite->spans);
+        return;
+    }
     v_blit_sprite(x, y, sprite->w, sprite->h, (const unsigned char far *)sprite->pixels, 0);
 }
 
@@ -448,8 +465,8 @@ static void frog_reset_frog_position(void)
 {
     int frog_w = frog_sprite_width(&g_frog1, FROG_TILE);
 
-    g_frog_x = (float)((VIDEO_WIDTH - frog_w) / 2);
-    g_frog_y = (float)(FROG_GRID_Y + (FROG_ROW_START_BOTTOM * FROG_TILE));
+    g_frog_x = PHYS_I((VIDEO_WIDTH - frog_w) / 2);
+    g_frog_y = PHYS_I(FROG_GRID_Y + (FROG_ROW_START_BOTTOM * FROG_TILE));
     g_frog_x_prev = g_frog_x;
     g_frog_y_prev = g_frog_y;
     g_frog_dir = FROG_DIR_UP;
@@ -463,7 +480,7 @@ static void frog_spawn_lanes(void)
     for (lane = 0; lane < FROG_MAX_ROAD_LANES; ++lane) {
         int count = g_params.road_count[lane];
         int sprite_w = FROG_TILE;
-        float spacing = 0.0f;
+        phys_t spacing = PHYS_C(0.0f);
         int i;
 
         if (g_road_vehicle_type[lane] == 2) {
@@ -475,11 +492,11 @@ static void frog_spawn_lanes(void)
         }
 
         if (count > 0) {
-            spacing = (float)(VIDEO_WIDTH + sprite_w) / (float)count;
+            spacing = PHYS_RATIO(VIDEO_WIDTH + sprite_w, count);
         }
 
         for (i = 0; i < count; ++i) {
-            g_road_positions[lane].x[i] = (float)(-sprite_w) + spacing * (float)i;
+            g_road_positions[lane].x[i] = PHYS_I(-sprite_w) + PHYS_MUL(spacing, PHYS_I(i));
             g_road_positions[lane].x_prev[i] = g_road_positions[lane].x[i];
         }
     }
@@ -487,7 +504,7 @@ static void frog_spawn_lanes(void)
     for (lane = 0; lane < FROG_MAX_RIVER_LANES; ++lane) {
         int count = g_params.river_count[lane];
         int sprite_w = FROG_TILE;
-        float spacing = 0.0f;
+        phys_t spacing = PHYS_C(0.0f);
         int i;
 
         if (g_river_platform_type[lane] == FROG_PLATFORM_LOG) {
@@ -497,17 +514,17 @@ static void frog_spawn_lanes(void)
         }
 
         if (count > 0) {
-            spacing = (float)(VIDEO_WIDTH + sprite_w) / (float)count;
+            spacing = PHYS_RATIO(VIDEO_WIDTH + sprite_w, count);
         }
 
         for (i = 0; i < count; ++i) {
-            g_river_positions[lane].x[i] = (float)(-sprite_w) + spacing * (float)i;
+            g_river_positions[lane].x[i] = PHYS_I(-sprite_w) + PHYS_MUL(spacing, PHYS_I(i));
             g_river_positions[lane].x_prev[i] = g_river_positions[lane].x[i];
         }
     }
 }
 
-static int frog_rect_intersect(float x0, float y0, float w0, float h0, float x1, float y1, float w1, float h1)
+static int frog_rect_intersect(phys_t x0, phys_t y0, phys_t w0, phys_t h0, phys_t x1, phys_t y1, phys_t w1, phys_t h1)
 {
     if (x0 + w0 <= x1) {
         return 0;
@@ -568,6 +585,18 @@ void Frog_Init(const GameSettings *settings)
 {
     g_settings = *settings;
     frog_select_params(g_settings.difficulty, &g_params);
+    {
+        // Las velocidades ya salen escaladas: el update no multiplica por tick
+        phys_t mul = PHYS_F(g_settings.speed_multiplier);
+        int lane;
+
+        for (lane = 0; lane < FROG_MAX_ROAD_LANES; ++lane) {
+            g_params.road_speed[lane] = PHYS_MUL(g_params.road_speed[lane], mul);
+        }
+        for (lane = 0; lane < FROG_MAX_RIVER_LANES; ++lane) {
+            g_params.river_speed[lane] = PHYS_MUL(g_params.river_speed[lane], mul);
+        }
+    }
     frog_load_sprites();
 
     g_finished = 0;
@@ -588,6 +617,7 @@ void Frog_Init(const GameSettings *settings)
     g_frame_counter = 0;
     g_water_scroll_px = 0;
     g_water_scroll_acc = 0;
+    g_bg_ready = 0;
 
     frog_reset_frog_position();
     frog_reset_timer();
@@ -678,12 +708,12 @@ static void frog_handle_input(void)
     }
 
     if (move_x != 0 || move_y != 0) {
-        float new_x = g_frog_x + (float)(move_x * FROG_TILE);
-        float new_y = g_frog_y + (float)(move_y * FROG_TILE);
+        phys_t new_x = g_frog_x + PHYS_I(move_x * FROG_TILE);
+        phys_t new_y = g_frog_y + PHYS_I(move_y * FROG_TILE);
         int frog_w = frog_sprite_width(&g_frog1, FROG_TILE);
 
-        new_x = clampf(new_x, 0.0f, (float)(VIDEO_WIDTH - frog_w));
-        new_y = clampf(new_y, (float)FROG_GRID_Y, (float)(FROG_GRID_Y + (FROG_GRID_ROWS - 1) * FROG_TILE));
+        new_x = clamp_phys(new_x, PHYS_C(0.0f), PHYS_I(VIDEO_WIDTH - frog_w));
+        new_y = clamp_phys(new_y, PHYS_I(FROG_GRID_Y), PHYS_I(FROG_GRID_Y + (FROG_GRID_ROWS - 1) * FROG_TILE));
 
         if (new_y < g_frog_y) {
             g_score += FROG_SCORE_HOP;
@@ -707,7 +737,7 @@ static void frog_update_lanes(void)
     for (lane = 0; lane < FROG_MAX_ROAD_LANES; ++lane) {
         int count = g_params.road_count[lane];
         int dir = g_lane_direction[lane];
-        float speed = g_params.road_speed[lane] * g_settings.speed_multiplier;
+        phys_t speed = g_params.road_speed[lane];
         int sprite_w = FROG_TILE;
 
         if (g_road_vehicle_type[lane] == 2) {
@@ -719,12 +749,12 @@ static void frog_update_lanes(void)
         }
 
         for (i = 0; i < count; ++i) {
-            g_road_positions[lane].x[i] += speed * dir;
-            if (dir > 0 && g_road_positions[lane].x[i] > VIDEO_WIDTH) {
-                g_road_positions[lane].x[i] = -sprite_w;
+            g_road_positions[lane].x[i] += PHYS_MUL(speed, PHYS_I(dir));
+            if (dir > 0 && g_road_positions[lane].x[i] > PHYS_I(VIDEO_WIDTH)) {
+                g_road_positions[lane].x[i] = PHYS_I(-sprite_w);
                 g_road_positions[lane].x_prev[i] = g_road_positions[lane].x[i];
-            } else if (dir < 0 && g_road_positions[lane].x[i] < -sprite_w) {
-                g_road_positions[lane].x[i] = (float)VIDEO_WIDTH;
+            } else if (dir < 0 && g_road_positions[lane].x[i] < PHYS_I(-sprite_w)) {
+                g_road_positions[lane].x[i] = PHYS_I(VIDEO_WIDTH);
                 g_road_positions[lane].x_prev[i] = g_road_positions[lane].x[i];
             }
         }
@@ -733,7 +763,7 @@ static void frog_update_lanes(void)
     for (lane = 0; lane < FROG_MAX_RIVER_LANES; ++lane) {
         int count = g_params.river_count[lane];
         int dir = g_river_direction[lane];
-        float speed = g_params.river_speed[lane] * g_settings.speed_multiplier;
+        phys_t speed = g_params.river_speed[lane];
         int sprite_w = FROG_TILE;
 
         if (g_river_platform_type[lane] == FROG_PLATFORM_LOG) {
@@ -743,12 +773,12 @@ static void frog_update_lanes(void)
         }
 
         for (i = 0; i < count; ++i) {
-            g_river_positions[lane].x[i] += speed * dir;
-            if (dir > 0 && g_river_positions[lane].x[i] > VIDEO_WIDTH) {
-                g_river_positions[lane].x[i] = -sprite_w;
+            g_river_positions[lane].x[i] += PHYS_MUL(speed, PHYS_I(dir));
+            if (dir > 0 && g_river_positions[lane].x[i] > PHYS_I(VIDEO_WIDTH)) {
+                g_river_positions[lane].x[i] = PHYS_I(-sprite_w);
                 g_river_positions[lane].x_prev[i] = g_river_positions[lane].x[i];
-            } else if (dir < 0 && g_river_positions[lane].x[i] < -sprite_w) {
-                g_river_positions[lane].x[i] = (float)VIDEO_WIDTH;
+            } else if (dir < 0 && g_river_positions[lane].x[i] < PHYS_I(-sprite_w)) {
+                g_river_positions[lane].x[i] = PHYS_I(VIDEO_WIDTH);
                 g_river_positions[lane].x_prev[i] = g_river_positions[lane].x[i];
             }
         }
@@ -759,10 +789,10 @@ static void frog_handle_collisions(void)
 {
     int frog_w = frog_sprite_width(&g_frog1, FROG_TILE);
     int frog_h = frog_sprite_height(&g_frog1, FROG_TILE);
-    int row = (int)((g_frog_y - FROG_GRID_Y) / FROG_TILE);
+    int row = PHYS_INT(g_frog_y - PHYS_I(FROG_GRID_Y)) / FROG_TILE;
 
     if (row == FROG_ROW_GOAL) {
-        int col = (int)((g_frog_x + (frog_w / 2)) / FROG_TILE);
+        int col = PHYS_INT(g_frog_x + PHYS_I(frog_w / 2)) / FROG_TILE;
         int i;
         int on_slot = 0;
 
@@ -808,10 +838,10 @@ static void frog_handle_collisions(void)
         }
 
         for (i = 0; i < count; ++i) {
-            float car_x = g_road_positions[lane].x[i];
-            float car_y = (float)(FROG_GRID_Y + row * FROG_TILE);
-            if (frog_rect_intersect(g_frog_x, g_frog_y, (float)frog_w, (float)frog_h,
-                                    car_x, car_y, (float)sprite_w, (float)sprite_h)) {
+            phys_t car_x = g_road_positions[lane].x[i];
+            phys_t car_y = PHYS_I(FROG_GRID_Y + row * FROG_TILE);
+            if (frog_rect_intersect(g_frog_x, g_frog_y, PHYS_I(frog_w), PHYS_I(frog_h),
+                                    car_x, car_y, PHYS_I(sprite_w), PHYS_I(sprite_h))) {
                 frog_kill("ATROPELLADO");
                 return;
             }
@@ -823,7 +853,7 @@ static void frog_handle_collisions(void)
         int count;
         int i;
         int on_platform = 0;
-        float carry_speed = 0.0f;
+        phys_t carry_speed = PHYS_C(0.0f);
 
         if (lane < 0) {
             return;
@@ -832,23 +862,23 @@ static void frog_handle_collisions(void)
         count = g_params.river_count[lane];
 
         for (i = 0; i < count; ++i) {
-            float plat_x = g_river_positions[lane].x[i];
-            float plat_y = (float)(FROG_GRID_Y + row * FROG_TILE);
-            float plat_w = (float)FROG_TILE;
-            float plat_h = (float)FROG_TILE;
+            phys_t plat_x = g_river_positions[lane].x[i];
+            phys_t plat_y = PHYS_I(FROG_GRID_Y + row * FROG_TILE);
+            phys_t plat_w = PHYS_I(FROG_TILE);
+            phys_t plat_h = PHYS_I(FROG_TILE);
 
             if (g_river_platform_type[lane] == FROG_PLATFORM_LOG) {
-                plat_w = (float)(g_log_length[lane] * FROG_TILE);
-                plat_h = (float)FROG_TILE;
+                plat_w = PHYS_I(g_log_length[lane] * FROG_TILE);
+                plat_h = PHYS_I(FROG_TILE);
             } else {
-                plat_w = (float)frog_sprite_width(&g_turtle1, FROG_TILE);
-                plat_h = (float)frog_sprite_height(&g_turtle1, FROG_TILE);
+                plat_w = PHYS_I(frog_sprite_width(&g_turtle1, FROG_TILE));
+                plat_h = PHYS_I(frog_sprite_height(&g_turtle1, FROG_TILE));
             }
 
-            if (frog_rect_intersect(g_frog_x, g_frog_y, (float)frog_w, (float)frog_h,
+            if (frog_rect_intersect(g_frog_x, g_frog_y, PHYS_I(frog_w), PHYS_I(frog_h),
                                     plat_x, plat_y, plat_w, plat_h)) {
                 on_platform = 1;
-                carry_speed = g_params.river_speed[lane] * g_settings.speed_multiplier * g_river_direction[lane];
+                carry_speed = PHYS_MUL(g_params.river_speed[lane], PHYS_I(g_river_direction[lane]));
                 break;
             }
         }
@@ -859,7 +889,7 @@ static void frog_handle_collisions(void)
         }
 
         g_frog_x += carry_speed;
-        if (g_frog_x < 0.0f || g_frog_x > (float)(VIDEO_WIDTH - frog_w)) {
+        if (g_frog_x < PHYS_C(0.0f) || g_frog_x > PHYS_I(VIDEO_WIDTH - frog_w)) {
             frog_kill("AHOGADO");
             return;
         }
@@ -1012,6 +1042,30 @@ static void frog_draw_stage_background(uint8_t *backbuf)
     v_fill_rect(0, start_y - 1, VIDEO_WIDTH, 1, FROG_COLOR_SEPARATOR);
 }
 
+// Escenario fijo en una capa; sólo el río se repinta en ella cuando avanza el scroll
+static void frog_draw_stage_layer(void)
+{
+    if (!g_bg_ready) {
+        if (!g_bg_layer.pixels && !v_surface_alloc(&g_bg_layer, VIDEO_WIDTH, VIDEO_HEIGHT)) {
+            frog_draw_stage_background(NULL);
+            return;
+        }
+        v_set_target(&g_bg_layer);
+        frog_draw_stage_background(NULL);
+        v_set_target(NULL);
+        g_bg_scroll_px = g_water_scroll_px;
+        g_bg_ready = 1;
+    } else if (g_bg_scroll_px != g_water_scroll_px) {
+        v_set_target(&g_bg_layer);
+        frog_draw_water(NULL, 0, FROG_GRID_Y + FROG_ROW_RIVER_START * FROG_TILE, VIDEO_WIDTH,
+                        FROG_ROW_RIVER_COUNT * FROG_TILE);
+        v_set_target(NULL);
+        g_bg_scroll_px = g_water_scroll_px;
+    }
+
+    v_surf_blit(v_surface_screen(), 0, 0, &g_bg_layer, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+}
+
 static void frog_draw_goal_slots(void)
 {
     int i;
@@ -1023,11 +1077,10 @@ static void frog_draw_goal_slots(void)
     }
 }
 
-static void frog_draw_logs(float x, int row, int length)
+static void frog_draw_logs(int start_x, int row, int length)
 {
     int i;
     int y = FROG_GRID_Y + row * FROG_TILE;
-    int start_x = (int)x;
 
     if (length <= 0) {
         return;
@@ -1053,6 +1106,7 @@ static void frog_draw_logs(float x, int row, int length)
 
 static void frog_draw_vehicles(float alpha)
 {
+    phys_t t = PHYS_F(alpha);
     int lane;
     int i;
 
@@ -1070,12 +1124,11 @@ static void frog_draw_vehicles(float alpha)
         }
 
         for (i = 0; i < count; ++i) {
-            float x = g_road_positions[lane].x_prev[i] +
-                (g_road_positions[lane].x[i] - g_road_positions[lane].x_prev[i]) * alpha;
+            int x = PHYS_INT(PHYS_LERP(g_road_positions[lane].x_prev[i], g_road_positions[lane].x[i], t));
             if (flip) {
-                frog_blit_sprite_flipped((int)x, y, sprite, 1, 0);
+                frog_blit_sprite_flipped(x, y, sprite, 1, 0);
             } else {
-                frog_blit_sprite((int)x, y, sprite);
+                frog_blit_sprite(x, y, sprite);
             }
         }
     }
@@ -1083,6 +1136,7 @@ static void frog_draw_vehicles(float alpha)
 
 static void frog_draw_platforms(float alpha)
 {
+    phys_t t = PHYS_F(alpha);
     int lane;
     int i;
 
@@ -1091,13 +1145,12 @@ static void frog_draw_platforms(float alpha)
         int row = g_river_rows[lane];
 
         for (i = 0; i < count; ++i) {
-            float x = g_river_positions[lane].x_prev[i] +
-                (g_river_positions[lane].x[i] - g_river_positions[lane].x_prev[i]) * alpha;
+            int x = PHYS_INT(PHYS_LERP(g_river_positions[lane].x_prev[i], g_river_positions[lane].x[i], t));
             if (g_river_platform_type[lane] == FROG_PLATFORM_LOG) {
                 frog_draw_logs(x, row, g_log_length[lane]);
             } else {
                 int y = FROG_GRID_Y + row * FROG_TILE;
-                frog_blit_sprite((int)x, y, &g_turtle1);
+                frog_blit_sprite(x, y, &g_turtle1);
             }
         }
     }
@@ -1105,18 +1158,19 @@ static void frog_draw_platforms(float alpha)
 
 static void frog_draw_frog(float alpha)
 {
-    float x = g_frog_x_prev + (g_frog_x - g_frog_x_prev) * alpha;
-    float y = g_frog_y_prev + (g_frog_y - g_frog_y_prev) * alpha;
+    phys_t t = PHYS_F(alpha);
+    int x = PHYS_INT(PHYS_LERP(g_frog_x_prev, g_frog_x, t));
+    int y = PHYS_INT(PHYS_LERP(g_frog_y_prev, g_frog_y, t));
     const FrogSprite *sprite = (g_hop_ticks > 0) ? &g_frog2 : &g_frog1;
 
     if (g_frog_dir == FROG_DIR_LEFT) {
-        frog_blit_sprite_rotated_45((int)x, (int)y, sprite, 0);
+        frog_blit_sprite_rotated_45(x, y, sprite, 0);
     } else if (g_frog_dir == FROG_DIR_RIGHT) {
-        frog_blit_sprite_rotated_45((int)x, (int)y, sprite, 1);
+        frog_blit_sprite_rotated_45(x, y, sprite, 1);
     } else if (g_frog_dir == FROG_DIR_DOWN) {
-        frog_blit_sprite_flipped((int)x, (int)y, sprite, 0, 1);
+        frog_blit_sprite_flipped(x, y, sprite, 0, 1);
     } else {
-        frog_blit_sprite((int)x, (int)y, sprite);
+        frog_blit_sprite(x, y, sprite);
     }
 }
 
@@ -1126,7 +1180,7 @@ void Frog_DrawInterpolated(float alpha)
     char score[24];
     int timer_seconds = g_timer_ticks / FROG_TICKS_PER_SECOND;
 
-    frog_draw_stage_background(NULL);
+    frog_draw_stage_layer();
     frog_draw_goal_slots();
     frog_draw_vehicles(alpha);
     frog_draw_platforms(alpha);
@@ -1171,6 +1225,8 @@ void Frog_End(void)
     }
 
     frog_free_sprites();
+    v_surface_free(&g_bg_layer);
+    g_bg_ready = 0;
 }
 
 int Frog_IsFinished(void)
@@ -1,17 +1,19 @@
 #include "gori.h"
 
+#include "../../CORE/fixed.h"
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
+#include "../../CORE/rng.h"
 #include "../../CORE/sound.h"
 #include "../../CORE/video.h"
 #include "../../CORE/keyboard.h"
 #include "../../CORE/high_scores.h"
+#include "../../GAME/melodies.h"
 
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
 #include <limits.h>
 
 #define GORI_MIN_BUILDING_W 14
@@ -76,12 +78,12 @@ typedef struct {
 } GoriRect;
 
 typedef struct {
-    float x;
-    float y;
-    float prev_x;
-    float prev_y;
-    float vx;
-    float vy;
+    phys_t x;
+    phys_t y;
+    phys_t prev_x;
+    phys_t prev_y;
+    phys_t vx;
+    phys_t vy;
     int active;
 } GoriBanana;
 
@@ -92,20 +94,25 @@ typedef struct {
     int cpu_error;
     int cpu_adjust;
     int cpu_think_ticks;
-    float cpu_power_scale;
-    float gravity;
-    float power_scale;
-    float wind_scale;
+    phys_t cpu_power_scale;
+    phys_t gravity;
+    phys_t power_scale;
+    phys_t wind_scale;
     int substeps;
     int miss_penalty;
 } GoriParams;
 
 static GameSettings g_settings;
+static Rng g_rng;
+// La IA de la demo tira de su propia serie: la entrada no toca la de la partida
+static Rng g_demo_rng;
 static GoriParams g_params;
 
 static int gori_point_in_rect(int x, int y, const GoriRect *r);
 
 static GoriBuilding g_buildings[GORI_MAX_BUILDINGS];
+static Surface g_bg_layer;
+static int g_bg_ready = 0;
 static int g_building_count = 0;
 static int g_roof_y[VIDEO_WIDTH];
 
@@ -147,17 +154,14 @@ static int g_cpu_last_hit_roof = 0;
 static int g_cpu_last_flew_past = 0;
 static int g_cpu_has_guess = 0;
 static int g_cpu_think = 0;
-static int g_last_miss_x = 0;
-
-static const SoundNote gori_throw_sound[] = {
-    { 620, 18 },
-    { 760, 22 }
-};
 
-static const SoundNote gori_explosion_sound[] = {
-    { 240, 60 },
-    { 180, 80 }
-};
+// Demo: tiro elegido para el turno del jugador y toque alterno de teclas
+#define GORI_DEMO_HOLD_MIN 8
+static int g_demo_aim_ready = 0;
+static int g_demo_angle = 45;
+static int g_demo_power = 55;
+static int g_demo_tap = 0;
+static int g_last_miss_x = 0;
 
 static int clamp_int(int value, int min_value, int max_value)
 {
@@ -170,17 +174,9 @@ static int clamp_int(int value, int min_value, int max_value)
     return value;
 }
 
-static float lerpf(float a, float b, float t)
-{
-    return a + (b - a) * t;
-}
-
-static int rand_range(int min_value, int max_value)
+static phys_t lerp_phys(phys_t a, phys_t b, phys_t t)
 {
-    if (max_value <= min_value) {
-        return min_value;
-    }
-    return min_value + (rand() % (max_value - min_value + 1));
+    return PHYS_LERP(a, b, t);
 }
 
 static void gori_draw_circle(int cx, int cy, int r, unsigned char color)
@@ -242,10 +238,10 @@ static void gori_select_params(unsigned char difficulty, float speed_multiplier,
         params->cpu_error = 10;
         params->cpu_adjust = 3;
         params->cpu_think_ticks = 10;
-        params->cpu_power_scale = 0.45f;
-        params->gravity = 0.25f;
-        params->power_scale = 0.15f;
-        params->wind_scale = 0.018f;
+        params->cpu_power_scale = PHYS_C(0.45f);
+        params->gravity = PHYS_C(0.25f);
+        params->power_scale = PHYS_C(0.15f);
+        params->wind_scale = PHYS_C(0.018f);
         params->substeps = 3;
         params->miss_penalty = 25;
         break;
@@ -256,10 +252,10 @@ static void gori_select_params(unsigned char difficulty, float speed_multiplier,
         params->cpu_error = 4;
         params->cpu_adjust = 8;
         params->cpu_think_ticks = 4;
-        params->cpu_power_scale = 0.48f;
-        params->gravity = 0.26f;
-        params->power_scale = 0.16f;
-        params->wind_scale = 0.025f;
+        params->cpu_power_scale = PHYS_C(0.48f);
+        params->gravity = PHYS_C(0.26f);
+        params->power_scale = PHYS_C(0.16f);
+        params->wind_scale = PHYS_C(0.025f);
         params->substeps = 4;
         params->miss_penalty = 40;
         break;
@@ -271,19 +267,21 @@ static void gori_select_params(unsigned char difficulty, float speed_multiplier,
         params->cpu_error = 6;
         params->cpu_adjust = 5;
         params->cpu_think_ticks = 7;
-        params->cpu_power_scale = 0.46f;
-        params->gravity = 0.25f;
-        params->power_scale = 0.155f;
-        params->wind_scale = 0.022f;
+        params->cpu_power_scale = PHYS_C(0.46f);
+        params->gravity = PHYS_C(0.25f);
+        params->power_scale = PHYS_C(0.155f);
+        params->wind_scale = PHYS_C(0.022f);
         params->substeps = 3;
         params->miss_penalty = 30;
         break;
     }
 
     if (speed_multiplier > 1.01f) {
-        params->gravity *= speed_multiplier;
-        params->power_scale *= speed_multiplier;
-        params->wind_scale *= speed_multiplier;
+        phys_t mul = PHYS_F(speed_multiplier);
+
+        params->gravity = PHYS_MUL(params->gravity, mul);
+        params->power_scale = PHYS_MUL(params->power_scale, mul);
+        params->wind_scale = PHYS_MUL(params->wind_scale, mul);
         params->substeps = clamp_int((int)((float)params->substeps * speed_multiplier + 0.5f), 2, 6);
     }
 }
@@ -297,9 +295,9 @@ static void gori_generate_city(void)
     g_building_count = 0;
 
     while (x < VIDEO_WIDTH && g_building_count < GORI_MAX_BUILDINGS) {
-        int w = rand_range(GORI_MIN_BUILDING_W, GORI_MAX_BUILDING_W);
-        int h = rand_range(GORI_MIN_BUILDING_H, GORI_MAX_BUILDING_H);
-        unsigned char color = colors[rand() % (int)(sizeof(colors) / sizeof(colors[0]))];
+        int w = rng_range(&g_rng, GORI_MIN_BUILDING_W, GORI_MAX_BUILDING_W);
+        int h = rng_range(&g_rng, GORI_MIN_BUILDING_H, GORI_MAX_BUILDING_H);
+        unsigned char color = colors[rng_below(&g_rng, (int)(sizeof(colors) / sizeof(colors[0])))];
         GoriBuilding *b = &g_buildings[g_building_count];
 
         if (x + w > VIDEO_WIDTH) {
@@ -341,7 +339,7 @@ static int gori_pick_building(int min_x, int max_x)
         return -1;
     }
 
-    return candidates[rand() % count];
+    return candidates[rng_below(&g_rng, count)];
 }
 
 static void gori_place_gorillas(void)
@@ -380,9 +378,10 @@ static void gori_place_gorillas(void)
 static void gori_reset_round(void)
 {
     gori_generate_city();
+    g_bg_ready = 0;
     gori_place_gorillas();
 
-    g_wind = rand_range(g_params.wind_min, g_params.wind_max);
+    g_wind = rng_range(&g_rng, g_params.wind_min, g_params.wind_max);
 
     g_player_turns_left = g_params.turn_limit;
     g_current_shooter = 0;
@@ -438,6 +437,36 @@ static void gori_draw_buildings(void)
     }
 }
 
+static void gori_draw_scenery(void)
+{
+    // Fondo base
+    v_fill_rect(0, 0, VIDEO_WIDTH, VIDEO_HEIGHT / 2, GORI_SKY_BAND_COLOR);
+    v_fill_rect(0, VIDEO_HEIGHT / 2, VIDEO_WIDTH, VIDEO_HEIGHT / 2, GORI_SKY_COLOR);
+
+    // Franja HUD superior
+    v_fill_rect(0, 0, VIDEO_WIDTH, 8, 0);
+
+    gori_draw_circle(40, 36, 8, GORI_SUN_COLOR);
+    gori_draw_buildings();
+}
+
+// Cielo, sol y ciudad sólo cambian al generar ronda: se pintan una vez en una capa
+static void gori_draw_scenery_layer(void)
+{
+    if (!g_bg_ready) {
+        if (!g_bg_layer.pixels && !v_surface_alloc(&g_bg_layer, VIDEO_WIDTH, VIDEO_HEIGHT)) {
+            gori_draw_scenery();
+            return;
+        }
+        v_set_target(&g_bg_layer);
+        gori_draw_scenery();
+        v_set_target(NULL);
+        g_bg_ready = 1;
+    }
+
+    v_surf_blit(v_surface_screen(), 0, 0, &g_bg_layer, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+}
+
 static void gori_draw_gorilla(const GoriRect *g, int is_player)
 {
     int body_x = g->x + 2;
@@ -531,10 +560,11 @@ static void gori_draw_banana(float alpha)
     }
 
     {
-        float x = lerpf(g_banana.prev_x, g_banana.x, alpha);
-        float y = lerpf(g_banana.prev_y, g_banana.y, alpha);
-        int px = (int)(x + 0.5f);
-        int py = (int)(y + 0.5f);
+        phys_t t = PHYS_F(alpha);
+        phys_t x = lerp_phys(g_banana.prev_x, g_banana.x, t);
+        phys_t y = lerp_phys(g_banana.prev_y, g_banana.y, t);
+        int px = PHYS_INT(x + PHYS_C(0.5f));
+        int py = PHYS_INT(y + PHYS_C(0.5f));
 
         int dx, dy, i;
 
@@ -598,8 +628,9 @@ static void gori_start_explosion(int x, int y, GoriAfter after)
     g_state = GORI_STATE_EXPLOSION;
 
     if (g_sound_enabled) {
-        sound_play_melody(gori_explosion_sound,
-                          (int)(sizeof(gori_explosion_sound) / sizeof(gori_explosion_sound[0])));
+        const Melody *boom = melody_get(MELODY_GORI_EXPLOSION);
+
+        sound_play_patch(boom->notes, boom->count, SOUND_PRIO_HIGH, boom->patch);
     }
 }
 
@@ -693,13 +724,12 @@ static void gori_adjust_cpu_guess(void)
 
 static void gori_start_shot(int shooter, int angle, int power)
 {
-    float radians = (float)angle * 3.1415926f / 180.0f;
-    float speed = (float)power * g_params.power_scale;
-    float vx = speed * (float)cos(radians);
-    float vy = -speed * (float)sin(radians);
+    phys_t speed = PHYS_MUL(PHYS_I(power), g_params.power_scale);
+    phys_t vx = PHYS_MUL(speed, PHYS_COS_DEG(angle));
+    phys_t vy = -PHYS_MUL(speed, PHYS_SIN_DEG(angle));
     GoriRect *g = (shooter == 0) ? &g_player_gorilla : &g_cpu_gorilla;
-    float start_x = (float)(g->x + g->w / 2);
-    float start_y = (float)(g->y + 2);
+    phys_t start_x = PHYS_I(g->x + g->w / 2);
+    phys_t start_y = PHYS_I(g->y + 2);
 
     if (shooter != 0) {
         vx = -vx;
@@ -721,8 +751,9 @@ static void gori_start_shot(int shooter, int angle, int power)
     g_state = GORI_STATE_BANANA;
 
     if (g_sound_enabled) {
-        sound_play_melody(gori_throw_sound,
-                          (int)(sizeof(gori_throw_sound) / sizeof(gori_throw_sound[0])));
+        const Melody *throw_sound = melody_get(MELODY_GORI_THROW);
+
+        sound_play_patch(throw_sound->notes, throw_sound->count, SOUND_PRIO_SFX, throw_sound->patch);
     }
 }
 
@@ -861,22 +892,21 @@ static void gori_handle_player_input(void)
 static long gori_cpu_eval_shot(int angle, int power, int wind_used, int *out_hit)
 {
     // OJO: si impacta, *out_hit=1 y devuelve 0
-    float radians = (float)angle * 3.1415926f / 180.0f;
-    float speed = (float)power * g_params.power_scale;
-    float vx = speed * (float)cos(radians);
-    float vy = -speed * (float)sin(radians);
+    phys_t speed = PHYS_MUL(PHYS_I(power), g_params.power_scale);
+    phys_t vx = PHYS_MUL(speed, PHYS_COS_DEG(angle));
+    phys_t vy = -PHYS_MUL(speed, PHYS_SIN_DEG(angle));
 
     // CPU dispara hacia la izquierda
     vx = -vx;
 
     // Punto de salida igual que gori_start_shot
     {
-        float x = (float)(g_cpu_gorilla.x + g_cpu_gorilla.w / 2);
-        float y = (float)(g_cpu_gorilla.y + 2);
+        phys_t x = PHYS_I(g_cpu_gorilla.x + g_cpu_gorilla.w / 2);
+        phys_t y = PHYS_I(g_cpu_gorilla.y + 2);
 
-        float wind_accel = (float)wind_used * g_params.wind_scale;
+        phys_t wind_accel = PHYS_MUL(PHYS_I(wind_used), g_params.wind_scale);
         int steps = clamp_int(g_params.substeps, 1, 6);
-        float step = 1.0f / (float)steps;
+        phys_t step = PHYS_RATIO(1, steps);
 
         int tx = g_player_gorilla.x + g_player_gorilla.w / 2;
         int ty = g_player_gorilla.y + g_player_gorilla.h / 2;
@@ -893,13 +923,13 @@ static long gori_cpu_eval_shot(int angle, int power, int wind_used, int *out_hit
                 long dx, dy;
                 long d2;
 
-                vy += g_params.gravity * step;
-                vx += wind_accel * step;
-                x += vx * step;
-                y += vy * step;
+                vy += PHYS_MUL(g_params.gravity, step);
+                vx += PHYS_MUL(wind_accel, step);
+                x += PHYS_MUL(vx, step);
+                y += PHYS_MUL(vy, step);
 
-                bx = (int)(x + 0.5f);
-                by = (int)(y + 0.5f);
+                bx = PHYS_INT(x + PHYS_C(0.5f));
+                by = PHYS_INT(y + PHYS_C(0.5f));
 
                 if (bx < 0 || bx >= VIDEO_WIDTH || by >= VIDEO_HEIGHT) {
                     return best;
@@ -935,20 +965,19 @@ typedef enum {
 
 static CpuSimResult gori_cpu_simulate_shot(int shooter, int angle, int power, int *out_last_x)
 {
-    float radians = (float)angle * 3.1415926f / 180.0f;
-    float speed = (float)power * g_params.power_scale;
-    float vx = speed * (float)cos(radians);
-    float vy = -speed * (float)sin(radians);
+    phys_t speed = PHYS_MUL(PHYS_I(power), g_params.power_scale);
+    phys_t vx = PHYS_MUL(speed, PHYS_COS_DEG(angle));
+    phys_t vy = -PHYS_MUL(speed, PHYS_SIN_DEG(angle));
 
     const GoriRect *g = (shooter == 0) ? &g_player_gorilla : &g_cpu_gorilla;
     const GoriRect *target = (shooter == 0) ? &g_cpu_gorilla : &g_player_gorilla;
 
-    float x = (float)(g->x + g->w / 2);
-    float y = (float)(g->y + 2);
+    phys_t x = PHYS_I(g->x + g->w / 2);
+    phys_t y = PHYS_I(g->y + 2);
 
-    float wind_accel = (float)g_wind * g_params.wind_scale;
+    phys_t wind_accel = PHYS_MUL(PHYS_I(g_wind), g_params.wind_scale);
     int steps = clamp_int(g_params.substeps, 1, 6);
-    float step = 1.0f / (float)steps;
+    phys_t step = PHYS_RATIO(1, steps);
 
     int i;
     int it;
@@ -963,13 +992,13 @@ static CpuSimResult gori_cpu_simulate_shot(int shooter, int angle, int power, in
             int bx;
             int by;
 
-            vy += g_params.gravity * step;
-            vx += wind_accel * step;
-            x += vx * step;
-            y += vy * step;
+            vy += PHYS_MUL(g_params.gravity, step);
+            vx += PHYS_MUL(wind_accel, step);
+            x += PHYS_MUL(vx, step);
+            y += PHYS_MUL(vy, step);
 
-            bx = (int)(x + 0.5f);
-            by = (int)(y + 0.5f);
+            bx = PHYS_INT(x + PHYS_C(0.5f));
+            by = PHYS_INT(y + PHYS_C(0.5f));
 
             if (out_last_x) {
                 *out_last_x = bx;
@@ -992,9 +1021,11 @@ static CpuSimResult gori_cpu_simulate_shot(int shooter, int angle, int power, in
     return CPU_SIM_OFFSCREEN;
 }
 
-static void gori_cpu_pick_shot(int *out_angle, int *out_power)
+// shooter 1 es la CPU; con 0 apunta por el jugador (demo). rng, el del error de puntería
+static void gori_cpu_pick_shot(Rng *rng, int shooter, int *out_angle, int *out_power)
 {
-    int target_x = g_player_gorilla.x + g_player_gorilla.w / 2;
+    const GoriRect *target = (shooter == 0) ? &g_cpu_gorilla : &g_player_gorilla;
+    int target_x = target->x + target->w / 2;
 
     // Calidad de búsqueda según dificultad
     int a_min = 15, a_max = GORI_MAX_ANGLE;
@@ -1023,7 +1054,7 @@ static void gori_cpu_pick_shot(int *out_angle, int *out_power)
             int power;
             for (power = p_min; power <= p_max; power += p_step) {
                 int last_x = 0;
-                CpuSimResult r = gori_cpu_simulate_shot(1, angle, power, &last_x);
+                CpuSimResult r = gori_cpu_simulate_shot(shooter, angle, power, &last_x);
 
                 if (r == CPU_SIM_HIT_TARGET) {
                     best_angle = angle;
@@ -1051,8 +1082,8 @@ static void gori_cpu_pick_shot(int *out_angle, int *out_power)
 
 done_search:
         // Mete error humano sin romper el tiro
-        best_angle += rand_range(-aim_jitter, aim_jitter);
-        best_power += rand_range(-aim_jitter, aim_jitter);
+        best_angle += rng_range(rng, -aim_jitter, aim_jitter);
+        best_power += rng_range(rng, -aim_jitter, aim_jitter);
 
         *out_angle = clamp_int(best_angle, 10, GORI_MAX_ANGLE);
         *out_power = clamp_int(best_power, 10, GORI_MAX_POWER);
@@ -1067,7 +1098,7 @@ static void gori_handle_cpu_turn(void)
     }
 
     // CPU elige tiro probando la física real
-    gori_cpu_pick_shot(&g_cpu_angle, &g_cpu_power);
+    gori_cpu_pick_shot(&g_rng, 1, &g_cpu_angle, &g_cpu_power);
 
     g_current_shooter = 1;
     gori_start_shot(1, g_cpu_angle, g_cpu_power);
@@ -1080,9 +1111,9 @@ static int gori_point_in_rect(int x, int y, const GoriRect *r)
 
 static void gori_update_banana(void)
 {
-    float wind_accel = (float)g_wind * g_params.wind_scale;
+    phys_t wind_accel = PHYS_MUL(PHYS_I(g_wind), g_params.wind_scale);
     int steps = clamp_int(g_params.substeps, 1, 6);
-    float step = 1.0f / (float)steps;
+    phys_t step = PHYS_RATIO(1, steps);
     int i;
 
     for (i = 0; i < steps; ++i) {
@@ -1090,13 +1121,13 @@ static void gori_update_banana(void)
         int by;
         const GoriRect *target = (g_current_shooter == 0) ? &g_cpu_gorilla : &g_player_gorilla;
 
-        g_banana.vy += g_params.gravity * step;
-        g_banana.vx += wind_accel * step;
-        g_banana.x += g_banana.vx * step;
-        g_banana.y += g_banana.vy * step;
+        g_banana.vy += PHYS_MUL(g_params.gravity, step);
+        g_banana.vx += PHYS_MUL(wind_accel, step);
+        g_banana.x += PHYS_MUL(g_banana.vx, step);
+        g_banana.y += PHYS_MUL(g_banana.vy, step);
 
-        bx = (int)(g_banana.x + 0.5f);
-        by = (int)(g_banana.y + 0.5f);
+        bx = PHYS_INT(g_banana.x + PHYS_C(0.5f));
+        by = PHYS_INT(g_banana.y + PHYS_C(0.5f));
 
         if (bx < 0 || bx >= VIDEO_WIDTH || by >= VIDEO_HEIGHT) {
             g_banana.active = 0;
@@ -1140,6 +1171,8 @@ void Gori_Init(const GameSettings *settings)
     } else {
         memset(&g_settings, 0, sizeof(g_settings));
     }
+    rng_seed(&g_rng, g_settings.seed);
+    rng_seed(&g_demo_rng, ~g_settings.seed);
 
     g_use_keyboard = 1;
     if (g_settings.input_mode == INPUT_JOYSTICK) {
@@ -1254,15 +1287,7 @@ void Gori_DrawInterpolated(float alpha)
     char hud[64];
     char bottom[32];
 
-    // Fondo base
-    v_fill_rect(0, 0, VIDEO_WIDTH, VIDEO_HEIGHT / 2, GORI_SKY_BAND_COLOR);
-    v_fill_rect(0, VIDEO_HEIGHT / 2, VIDEO_WIDTH, VIDEO_HEIGHT / 2, GORI_SKY_COLOR);
-
-    // Franja HUD superior
-    v_fill_rect(0, 0, VIDEO_WIDTH, 8, 0);
-
-    gori_draw_circle(40, 36, 8, GORI_SUN_COLOR);
-    gori_draw_buildings();
+    gori_draw_scenery_layer();
     gori_draw_gorilla(&g_player_gorilla, 1);
     gori_draw_gorilla(&g_cpu_gorilla, 0);
     gori_draw_banana(alpha);
@@ -1297,6 +1322,8 @@ void Gori_End(void)
     }
     // Limpieza mínima
     g_banana.active = 0;
+    v_surface_free(&g_bg_layer);
+    g_bg_ready = 0;
 }
 
 int Gori_IsFinished(void)
@@ -1318,3 +1345,44 @@ uint64_t Gori_GetScore(void)
 {
     return g_score;
 }
+
+// Lejos del objetivo se mantiene la tecla (autorepetición, como mucho 4 por tick);
+// cerca, un toque cada dos ticks para que cada uno sume 1
+static void gori_demo_steer(unsigned char *keys, int diff, unsigned char more, unsigned char less)
+{
+    if (diff == 0) {
+        return;
+    }
+    if (diff > -GORI_DEMO_HOLD_MIN && diff < GORI_DEMO_HOLD_MIN && !g_demo_tap) {
+        return;
+    }
+    kb_snapshot_press(keys, (unsigned char)(diff > 0 ? more : less));
+}
+
+void Gori_DemoInput(unsigned char *keys)
+{
+    int angle_diff;
+    int power_diff;
+
+    if (g_finished || g_finish_timer > 0 || g_state != GORI_STATE_PLAYER_AIM) {
+        g_demo_aim_ready = 0;
+        return;
+    }
+
+    // El mismo buscador de la CPU, una vez por turno
+    if (!g_demo_aim_ready) {
+        gori_cpu_pick_shot(&g_demo_rng, 0, &g_demo_angle, &g_demo_power);
+        g_demo_aim_ready = 1;
+        g_demo_tap = 0;
+    }
+
+    g_demo_tap = !g_demo_tap;
+    angle_diff = g_demo_angle - g_player_angle;
+    power_diff = g_demo_power - g_player_power;
+    gori_demo_steer(keys, angle_diff, SC_RIGHT, SC_LEFT);
+    gori_demo_steer(keys, power_diff, SC_UP, SC_DOWN);
+
+    if (angle_diff == 0 && power_diff == 0 && g_demo_tap) {
+        kb_snapshot_press(keys, SC_SPACE);
+    }
+}
@@ -13,5 +13,7 @@ int Gori_IsFinished(void);
 int Gori_DidWin(void);
 const char *Gori_GetEndDetail(void);
 uint64_t Gori_GetScore(void);
+// Demo: teclas del jugador que pondría la IA
+void Gori_DemoInput(unsigned char *keys);
 
 #endif
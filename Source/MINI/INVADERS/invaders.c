@@ -1,7 +1,9 @@
 #include "invaders.h"
 
+#include "../../CORE/fixed.h"
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
+#include "../../CORE/rng.h"
 #include "../../CORE/sound.h"
 #include "../../CORE/video.h"
 #include "../../CORE/keyboard.h"
@@ -26,14 +28,15 @@
     ((int)(INVADER_ANIM_INTERVAL_BASE_SECONDS * INVADER_TICKS_PER_SECOND))
 #define EXPLOSION_PARTICLE_MAX 32
 #define EXPLOSION_PARTICLE_LIFE 10
+#define EXPLOSION_SAMPLE "SOUNDS\\explode.wav"
 
 typedef struct {
-    float player_speed;
-    float player_shot_speed;
-    float enemy_speed;
-    float enemy_speed_max;
-    float enemy_accel;
-    float enemy_shot_speed;
+    phys_t player_speed;
+    phys_t player_shot_speed;
+    phys_t enemy_speed;
+    phys_t enemy_speed_max;
+    phys_t enemy_accel;
+    phys_t enemy_shot_speed;
     int step_down;
     int target_seconds;
     int enemy_fire_interval;
@@ -44,45 +47,47 @@ typedef struct {
 } InvaderParams;
 
 typedef struct {
-    float x;
-    float y;
-    float vx;
-    float vy;
+    phys_t x;
+    phys_t y;
+    phys_t vx;
+    phys_t vy;
     int life;
     int active;
 } ExplosionParticle;
 
 static GameSettings g_settings;
+static Rng g_rng;
 static InvaderParams g_params;
 static int g_finished = 0;
 static int g_did_win = 0;
 static int g_sound_enabled = 0;
+static int g_explosion_sample = 0;
 static int g_use_keyboard = 1;
 
 static int g_enemies[INVADER_ROWS][INVADER_COLS];
-static float g_form_x = 0.0f;
-static float g_form_y = 0.0f;
-static float g_form_x_prev = 0.0f;
-static float g_form_y_prev = 0.0f;
+static phys_t g_form_x = PHYS_C(0.0f);
+static phys_t g_form_y = PHYS_C(0.0f);
+static phys_t g_form_x_prev = PHYS_C(0.0f);
+static phys_t g_form_y_prev = PHYS_C(0.0f);
 static int g_direction = 1;
-static float g_enemy_speed = 0.0f;
+static phys_t g_enemy_speed = PHYS_C(0.0f);
 
-static float g_player_x = 0.0f;
-static float g_player_x_prev = 0.0f;
+static phys_t g_player_x = PHYS_C(0.0f);
+static phys_t g_player_x_prev = PHYS_C(0.0f);
 
 static int g_player_shot_active = 0;
-static float g_player_shot_x = 0.0f;
-static float g_player_shot_y = 0.0f;
-static float g_player_shot_x_prev = 0.0f;
-static float g_player_shot_y_prev = 0.0f;
+static phys_t g_player_shot_x = PHYS_C(0.0f);
+static phys_t g_player_shot_y = PHYS_C(0.0f);
+static phys_t g_player_shot_x_prev = PHYS_C(0.0f);
+static phys_t g_player_shot_y_prev = PHYS_C(0.0f);
 static int g_player_shot_cooldown = 0;
 static int g_fire_held = 0;
 
 static int g_enemy_shot_active = 0;
-static float g_enemy_shot_x = 0.0f;
-static float g_enemy_shot_y = 0.0f;
-static float g_enemy_shot_x_prev = 0.0f;
-static float g_enemy_shot_y_prev = 0.0f;
+static phys_t g_enemy_shot_x = PHYS_C(0.0f);
+static phys_t g_enemy_shot_y = PHYS_C(0.0f);
+static phys_t g_enemy_shot_x_prev = PHYS_C(0.0f);
+static phys_t g_enemy_shot_y_prev = PHYS_C(0.0f);
 static int g_invaders_alive = 0;
 static int g_inv_anim_ticks = 0;
 static int g_inv_anim_frame = 0; // Índice: 0 = INV_SPR_CRAB_A, 1 = INV_SPR_CRAB_B
@@ -93,7 +98,7 @@ static int g_elapsed_ticks = 0;
 static int g_target_ticks = 0;
 static ExplosionParticle g_explosion_particles[EXPLOSION_PARTICLE_MAX];
 
-static float clampf(float value, float min_value, float max_value)
+static phys_t clamp_phys(phys_t value, phys_t min_value, phys_t max_value)
 {
     if (value < min_value) {
         return min_value;
@@ -212,12 +217,12 @@ static void invaders_select_params(unsigned char difficulty, InvaderParams *para
 
     switch (difficulty) {
     case DIFFICULTY_EASY:
-        params->player_speed = 2.2f;
-        params->player_shot_speed = 3.2f;
-        params->enemy_speed = 0.6f;          // Ajuste de dificultad
-        params->enemy_speed_max = 2.2f;      // Límite máximo suavizado
-        params->enemy_accel = 0.0007f;
-        params->enemy_shot_speed = 1.4f;
+        params->player_speed = PHYS_C(2.2f);
+        params->player_shot_speed = PHYS_C(3.2f);
+        params->enemy_speed = PHYS_C(0.6f);          // Ajuste de dificultad
+        params->enemy_speed_max = PHYS_C(2.2f);      // Límite máximo suavizado
+        params->enemy_accel = PHYS_C(0.0007f);
+        params->enemy_shot_speed = PHYS_C(1.4f);
         params->step_down = 6;               // OJO: entero
         params->target_seconds = 34;
         params->enemy_fire_interval = 120;
@@ -228,12 +233,12 @@ static void invaders_select_params(unsigned char difficulty, InvaderParams *para
         break;
 
     case DIFFICULTY_HARD:
-        params->player_speed = 2.9f;
-        params->player_shot_speed = 3.6f;
-        params->enemy_speed = 0.6f;
-        params->enemy_speed_max = 2.0f;
-        params->enemy_accel = 0.0007f;
-        params->enemy_shot_speed = 2.0f;
+        params->player_speed = PHYS_C(2.9f);
+        params->player_shot_speed = PHYS_C(3.6f);
+        params->enemy_speed = PHYS_C(0.6f);
+        params->enemy_speed_max = PHYS_C(2.0f);
+        params->enemy_accel = PHYS_C(0.0007f);
+        params->enemy_shot_speed = PHYS_C(2.0f);
         params->step_down = 8;               // OJO: entero
         params->target_seconds = 46;
         params->enemy_fire_interval = 45;
@@ -245,12 +250,12 @@ static void invaders_select_params(unsigned char difficulty, InvaderParams *para
 
     case DIFFICULTY_NORMAL:
     default:
-        params->player_speed = 2.5f;
-        params->player_shot_speed = 3.4f;
-        params->enemy_speed = 0.6f;          // Base común
-        params->enemy_speed_max = 2.0f;
-        params->enemy_accel = 0.0007f;
-        params->enemy_shot_speed = 1.5f;
+        params->player_speed = PHYS_C(2.5f);
+        params->player_shot_speed = PHYS_C(3.4f);
+        params->enemy_speed = PHYS_C(0.6f);          // Base común
+        params->enemy_speed_max = PHYS_C(2.0f);
+        params->enemy_accel = PHYS_C(0.0007f);
+        params->enemy_shot_speed = PHYS_C(1.5f);
         params->step_down = 6;               // OJO: entero
         params->target_seconds = 40;
         params->enemy_fire_interval = 100;
@@ -275,7 +280,7 @@ static void invaders_reset_formation(void)
 {
     int row;
     int col;
-    float formation_w = (INVADER_COLS * (INVADER_W + INVADER_SPACING_X)) - INVADER_SPACING_X;
+    phys_t formation_w = PHYS_I((INVADER_COLS * (INVADER_W + INVADER_SPACING_X)) - INVADER_SPACING_X);
 
     for (row = 0; row < INVADER_ROWS; ++row) {
         for (col = 0; col < INVADER_COLS; ++col) {
@@ -284,8 +289,8 @@ static void invaders_reset_formation(void)
     }
 
     g_invaders_alive = INVADER_ROWS * INVADER_COLS;
-    g_form_x = (VIDEO_WIDTH - formation_w) * 0.5f;
-    g_form_y = INVADER_START_Y;
+    g_form_x = PHYS_MUL(PHYS_I(VIDEO_WIDTH) - formation_w, PHYS_C(0.5f));
+    g_form_y = PHYS_I(INVADER_START_Y);
     g_form_x_prev = g_form_x;
     g_form_y_prev = g_form_y;
     g_direction = 1;
@@ -299,7 +304,7 @@ static int invaders_any_alive(void)
     return g_invaders_alive > 0;
 }
 
-static float invaders_bottom_y(void)
+static phys_t invaders_bottom_y(void)
 {
     int row;
     int col;
@@ -307,15 +312,15 @@ static float invaders_bottom_y(void)
     for (row = INVADER_ROWS - 1; row >= 0; --row) {
         for (col = 0; col < INVADER_COLS; ++col) {
             if (g_enemies[row][col]) {
-                return g_form_y + (row * (INVADER_H + INVADER_SPACING_Y)) + INVADER_H;
+                return g_form_y + PHYS_I((row * (INVADER_H + INVADER_SPACING_Y)) + INVADER_H);
             }
         }
     }
 
-    return g_form_y + (INVADER_ROWS * (INVADER_H + INVADER_SPACING_Y));
+    return g_form_y + PHYS_I(INVADER_ROWS * (INVADER_H + INVADER_SPACING_Y));
 }
 
-static int invaders_hit_enemy(float shot_x, float shot_y, float *out_x, float *out_y)
+static int invaders_hit_enemy(phys_t shot_x, phys_t shot_y, phys_t *out_x, phys_t *out_y)
 {
     int row;
     int col;
@@ -327,20 +332,20 @@ static int invaders_hit_enemy(float shot_x, float shot_y, float *out_x, float *o
             }
 
             {
-                float ex = g_form_x + (col * (INVADER_W + INVADER_SPACING_X));
-                float ey = g_form_y + (row * (INVADER_H + INVADER_SPACING_Y));
+                phys_t ex = g_form_x + PHYS_I(col * (INVADER_W + INVADER_SPACING_X));
+                phys_t ey = g_form_y + PHYS_I(row * (INVADER_H + INVADER_SPACING_Y));
 
-                if ((shot_x + PLAYER_SHOT_W) >= ex && shot_x <= (ex + INVADER_W) &&
-                    (shot_y + PLAYER_SHOT_H) >= ey && shot_y <= (ey + INVADER_H)) {
+                if ((shot_x + PHYS_I(PLAYER_SHOT_W)) >= ex && shot_x <= (ex + PHYS_I(INVADER_W)) &&
+                    (shot_y + PHYS_I(PLAYER_SHOT_H)) >= ey && shot_y <= (ey + PHYS_I(INVADER_H))) {
                     g_enemies[row][col] = 0;
                     if (g_invaders_alive > 0) {
                         g_invaders_alive--;
                     }
                     if (out_x) {
-                        *out_x = ex + (INVADER_W * 0.5f);
+                        *out_x = ex + PHYS_RATIO(INVADER_W, 2);
                     }
                     if (out_y) {
-                        *out_y = ey + (INVADER_H * 0.5f);
+                        *out_y = ey + PHYS_RATIO(INVADER_H, 2);
                     }
                     return 1;
                 }
@@ -359,8 +364,8 @@ static int invaders_pick_shooter(int *out_x, int *out_y)
     int targeted_count = 0;
     int row;
     int col;
-    float player_center = g_player_x + (g_params.player_w * 0.5f);
-    float targeting_range = 26.0f;
+    phys_t player_center = g_player_x + PHYS_RATIO(g_params.player_w, 2);
+    phys_t targeting_range = PHYS_C(26.0f);
 
     for (col = 0; col < INVADER_COLS; ++col) {
         for (row = INVADER_ROWS - 1; row >= 0; --row) {
@@ -381,8 +386,8 @@ static int invaders_pick_shooter(int *out_x, int *out_y)
         for (col = 0; col < count; ++col) {
             int r = indices[col][0];
             int c = indices[col][1];
-            float ex = g_form_x + (c * (INVADER_W + INVADER_SPACING_X));
-            float center_x = ex + (INVADER_W * 0.5f);
+            phys_t ex = g_form_x + PHYS_I(c * (INVADER_W + INVADER_SPACING_X));
+            phys_t center_x = ex + PHYS_RATIO(INVADER_W, 2);
             if (center_x >= (player_center - targeting_range) &&
                 center_x <= (player_center + targeting_range)) {
                 targeted[targeted_count] = col;
@@ -391,41 +396,41 @@ static int invaders_pick_shooter(int *out_x, int *out_y)
         }
 
         if (targeted_count > 0) {
-            int pick = targeted[rand() % targeted_count];
+            int pick = targeted[rng_below(&g_rng, targeted_count)];
             int r = indices[pick][0];
             int c = indices[pick][1];
-            float ex = g_form_x + (c * (INVADER_W + INVADER_SPACING_X));
-            float ey = g_form_y + (r * (INVADER_H + INVADER_SPACING_Y));
-            *out_x = (int)(ex + (INVADER_W / 2));
-            *out_y = (int)(ey + INVADER_H);
+            phys_t ex = g_form_x + PHYS_I(c * (INVADER_W + INVADER_SPACING_X));
+            phys_t ey = g_form_y + PHYS_I(r * (INVADER_H + INVADER_SPACING_Y));
+            *out_x = PHYS_INT(ex + PHYS_I(INVADER_W / 2));
+            *out_y = PHYS_INT(ey + PHYS_I(INVADER_H));
         } else {
-            int pick = rand() % count;
+            int pick = rng_below(&g_rng, count);
             int r = indices[pick][0];
             int c = indices[pick][1];
-            float ex = g_form_x + (c * (INVADER_W + INVADER_SPACING_X));
-            float ey = g_form_y + (r * (INVADER_H + INVADER_SPACING_Y));
-            *out_x = (int)(ex + (INVADER_W / 2));
-            *out_y = (int)(ey + INVADER_H);
+            phys_t ex = g_form_x + PHYS_I(c * (INVADER_W + INVADER_SPACING_X));
+            phys_t ey = g_form_y + PHYS_I(r * (INVADER_H + INVADER_SPACING_Y));
+            *out_x = PHYS_INT(ex + PHYS_I(INVADER_W / 2));
+            *out_y = PHYS_INT(ey + PHYS_I(INVADER_H));
         }
     }
 
     return 1;
 }
 
-static void invaders_spawn_explosion(float x, float y)
+static void invaders_spawn_explosion(phys_t x, phys_t y)
 {
     int i;
     int slot = 0;
-    const float speed = 0.9f;
-    const float dirs[8][2] = {
-        { -1.0f, -1.0f },
-        { 1.0f, -1.0f },
-        { -1.0f, 1.0f },
-        { 1.0f, 1.0f },
-        { 0.0f, -1.0f },
-        { 0.0f, 1.0f },
-        { -1.0f, 0.0f },
-        { 1.0f, 0.0f }
+    const phys_t speed = PHYS_C(0.9f);
+    const phys_t dirs[8][2] = {
+        { PHYS_C(-1.0f), PHYS_C(-1.0f) },
+        { PHYS_C(1.0f), PHYS_C(-1.0f) },
+        { PHYS_C(-1.0f), PHYS_C(1.0f) },
+        { PHYS_C(1.0f), PHYS_C(1.0f) },
+        { PHYS_C(0.0f), PHYS_C(-1.0f) },
+        { PHYS_C(0.0f), PHYS_C(1.0f) },
+        { PHYS_C(-1.0f), PHYS_C(0.0f) },
+        { PHYS_C(1.0f), PHYS_C(0.0f) }
     };
 
     for (i = 0; i < 8; ++i) {
@@ -434,8 +439,8 @@ static void invaders_spawn_explosion(float x, float y)
                 g_explosion_particles[slot].active = 1;
                 g_explosion_particles[slot].x = x;
                 g_explosion_particles[slot].y = y;
-                g_explosion_particles[slot].vx = dirs[i][0] * speed;
-                g_explosion_particles[slot].vy = dirs[i][1] * speed;
+                g_explosion_particles[slot].vx = PHYS_MUL(dirs[i][0], speed);
+                g_explosion_particles[slot].vy = PHYS_MUL(dirs[i][1], speed);
                 g_explosion_particles[slot].life = EXPLOSION_PARTICLE_LIFE;
                 slot++;
                 break;
@@ -487,20 +492,25 @@ void Invaders_Init(const GameSettings *settings)
     } else {
         memset(&g_settings, 0, sizeof(g_settings));
     }
+    rng_seed(&g_rng, g_settings.seed);
 
     invaders_select_params(g_settings.difficulty, &g_params);
-    g_params.player_speed *= g_settings.speed_multiplier;
-    g_params.player_shot_speed *= g_settings.speed_multiplier;
-    g_params.enemy_speed *= g_settings.speed_multiplier;
-    g_params.enemy_speed_max *= g_settings.speed_multiplier;
-    g_params.enemy_accel *= g_settings.speed_multiplier;
-    g_params.enemy_shot_speed *= g_settings.speed_multiplier;
+    {
+        phys_t mul = PHYS_F(g_settings.speed_multiplier);
+
+        g_params.player_speed = PHYS_MUL(g_params.player_speed, mul);
+        g_params.player_shot_speed = PHYS_MUL(g_params.player_shot_speed, mul);
+        g_params.enemy_speed = PHYS_MUL(g_params.enemy_speed, mul);
+        g_params.enemy_speed_max = PHYS_MUL(g_params.enemy_speed_max, mul);
+        g_params.enemy_accel = PHYS_MUL(g_params.enemy_accel, mul);
+        g_params.enemy_shot_speed = PHYS_MUL(g_params.enemy_shot_speed, mul);
+    }
 
     g_finished = 0;
     g_did_win = 0;
     g_elapsed_ticks = 0;
     g_target_ticks = g_params.target_seconds * INVADER_TICKS_PER_SECOND;
-    g_player_x = (VIDEO_WIDTH - g_params.player_w) * 0.5f;
+    g_player_x = PHYS_MUL(PHYS_I(VIDEO_WIDTH - g_params.player_w), PHYS_C(0.5f));
     g_player_x_prev = g_player_x;
 
     g_player_shot_active = 0;
@@ -516,6 +526,8 @@ void Invaders_Init(const GameSettings *settings)
 
     g_use_keyboard = 1;
     g_sound_enabled = g_settings.sound_enabled ? 1 : 0;
+    // Se abre aquí: en el tick sólo se arranca
+    g_explosion_sample = g_sound_enabled && sound_load_sample(EXPLOSION_SAMPLE);
     if (g_settings.input_mode == INPUT_JOYSTICK) {
         if (in_joystick_available()) {
             g_use_keyboard = 0;
@@ -584,8 +596,8 @@ void Invaders_Update(void)
     fire_pressed = fire_down && !g_fire_held;
     g_fire_held = fire_down;
 
-    g_player_x += (float)move_dir * g_params.player_speed;
-    g_player_x = clampf(g_player_x, 0.0f, (float)(VIDEO_WIDTH - g_params.player_w));
+    g_player_x += PHYS_MUL(PHYS_I(move_dir), g_params.player_speed);
+    g_player_x = clamp_phys(g_player_x, PHYS_C(0.0f), PHYS_I(VIDEO_WIDTH - g_params.player_w));
 
     if (g_player_shot_cooldown > 0) {
         g_player_shot_cooldown--;
@@ -595,8 +607,8 @@ void Invaders_Update(void)
         int player_y = invaders_player_y();
 
         g_player_shot_active = 1;
-        g_player_shot_x = g_player_x + (g_params.player_w * 0.5f) - (PLAYER_SHOT_W * 0.5f);
-        g_player_shot_y = player_y - PLAYER_SHOT_H;
+        g_player_shot_x = g_player_x + PHYS_RATIO(g_params.player_w, 2) - PHYS_RATIO(PLAYER_SHOT_W, 2);
+        g_player_shot_y = PHYS_I(player_y - PLAYER_SHOT_H);
         g_player_shot_x_prev = g_player_shot_x;
         g_player_shot_y_prev = g_player_shot_y;
         g_player_shot_cooldown = g_params.player_shot_cooldown_ticks;
@@ -607,11 +619,11 @@ void Invaders_Update(void)
 
     if (g_player_shot_active) {
         g_player_shot_y -= g_params.player_shot_speed;
-        if (g_player_shot_y < -PLAYER_SHOT_H) {
+        if (g_player_shot_y < PHYS_I(-PLAYER_SHOT_H)) {
             g_player_shot_active = 0;
         } else {
-            float hit_x = 0.0f;
-            float hit_y = 0.0f;
+            phys_t hit_x = PHYS_C(0.0f);
+            phys_t hit_y = PHYS_C(0.0f);
 
             if (invaders_hit_enemy(g_player_shot_x, g_player_shot_y, &hit_x, &hit_y)) {
                 g_player_shot_active = 0;
@@ -625,14 +637,14 @@ void Invaders_Update(void)
     }
 
     if (!g_enemy_shot_active) {
-        if (invaders_any_alive() && (rand() % g_params.enemy_fire_interval) == 0) {
+        if (invaders_any_alive() && rng_below(&g_rng, g_params.enemy_fire_interval) == 0) {
             int sx = 0;
             int sy = 0;
 
             if (invaders_pick_shooter(&sx, &sy)) {
                 g_enemy_shot_active = 1;
-                g_enemy_shot_x = (float)sx;
-                g_enemy_shot_y = (float)sy;
+                g_enemy_shot_x = PHYS_I(sx);
+                g_enemy_shot_y = PHYS_I(sy);
                 g_enemy_shot_x_prev = g_enemy_shot_x;
                 g_enemy_shot_y_prev = g_enemy_shot_y;
             }
@@ -641,17 +653,18 @@ void Invaders_Update(void)
 
     if (g_enemy_shot_active) {
         g_enemy_shot_y += g_params.enemy_shot_speed;
-        if (g_enemy_shot_y > VIDEO_HEIGHT) {
+        if (g_enemy_shot_y > PHYS_I(VIDEO_HEIGHT)) {
             g_enemy_shot_active = 0;
         } else {
-            float px = g_player_x;
-            float py = (float)invaders_player_y();
+            phys_t px = g_player_x;
+            phys_t py = PHYS_I(invaders_player_y());
 
-            if ((g_enemy_shot_x + ENEMY_SHOT_W) >= px && g_enemy_shot_x <= (px + g_params.player_w) &&
-                (g_enemy_shot_y + ENEMY_SHOT_H) >= py && g_enemy_shot_y <= (py + g_params.player_h)) {
+            if ((g_enemy_shot_x + PHYS_I(ENEMY_SHOT_W)) >= px && g_enemy_shot_x <= (px + PHYS_I(g_params.player_w)) &&
+                (g_enemy_shot_y + PHYS_I(ENEMY_SHOT_H)) >= py && g_enemy_shot_y <= (py + PHYS_I(g_params.player_h))) {
                 g_finished = 1;
                 g_did_win = 0;
-                if (g_sound_enabled) {
+                // Sin la muestra en disco, el pitido de siempre
+                if (g_sound_enabled && !(g_explosion_sample && sound_play_sample())) {
                     sound_play_tone(180, 120);
                 }
                 return;
@@ -664,19 +677,19 @@ void Invaders_Update(void)
     }
 
     {
-        float formation_w = (INVADER_COLS * (INVADER_W + INVADER_SPACING_X)) - INVADER_SPACING_X;
-        float left_limit = (float)g_params.formation_margin_x;
-        float right_limit = (float)(VIDEO_WIDTH - g_params.formation_margin_x) - formation_w;
-        g_form_x += g_enemy_speed * (float)g_direction;
+        phys_t formation_w = PHYS_I((INVADER_COLS * (INVADER_W + INVADER_SPACING_X)) - INVADER_SPACING_X);
+        phys_t left_limit = PHYS_I(g_params.formation_margin_x);
+        phys_t right_limit = PHYS_I(VIDEO_WIDTH - g_params.formation_margin_x) - formation_w;
+        g_form_x += PHYS_MUL(g_enemy_speed, PHYS_I(g_direction));
 
         if (g_direction > 0 && g_form_x >= right_limit) {
             g_form_x = right_limit;
             g_direction = -1;
-            g_form_y += (float)g_params.step_down;
+            g_form_y += PHYS_I(g_params.step_down);
         } else if (g_direction < 0 && g_form_x <= left_limit) {
             g_form_x = left_limit;
             g_direction = 1;
-            g_form_y += (float)g_params.step_down;
+            g_form_y += PHYS_I(g_params.step_down);
         }
     }
 
@@ -687,7 +700,7 @@ void Invaders_Update(void)
 
     invaders_update_particles();
 
-    if (invaders_bottom_y() >= invaders_player_y()) {
+    if (invaders_bottom_y() >= PHYS_I(invaders_player_y())) {
         g_finished = 1;
         g_did_win = 0;
         if (g_sound_enabled) {
@@ -711,13 +724,14 @@ void Invaders_DrawInterpolated(float alpha)
 {
     char hud[64];
     char timer[32];
-    float form_x = g_form_x_prev + (g_form_x - g_form_x_prev) * alpha;
-    float form_y = g_form_y_prev + (g_form_y - g_form_y_prev) * alpha;
-    float player_x = g_player_x_prev + (g_player_x - g_player_x_prev) * alpha;
-    float shot_x = g_player_shot_x_prev + (g_player_shot_x - g_player_shot_x_prev) * alpha;
-    float shot_y = g_player_shot_y_prev + (g_player_shot_y - g_player_shot_y_prev) * alpha;
-    float enemy_shot_x = g_enemy_shot_x_prev + (g_enemy_shot_x - g_enemy_shot_x_prev) * alpha;
-    float enemy_shot_y = g_enemy_shot_y_prev + (g_enemy_shot_y - g_enemy_shot_y_prev) * alpha;
+    phys_t t = PHYS_F(alpha);
+    phys_t form_x = PHYS_LERP(g_form_x_prev, g_form_x, t);
+    phys_t form_y = PHYS_LERP(g_form_y_prev, g_form_y, t);
+    int player_x = PHYS_INT(PHYS_LERP(g_player_x_prev, g_player_x, t));
+    int shot_x = PHYS_INT(PHYS_LERP(g_player_shot_x_prev, g_player_shot_x, t));
+    int shot_y = PHYS_INT(PHYS_LERP(g_player_shot_y_prev, g_player_shot_y, t));
+    int enemy_shot_x = PHYS_INT(PHYS_LERP(g_enemy_shot_x_prev, g_enemy_shot_x, t));
+    int enemy_shot_y = PHYS_INT(PHYS_LERP(g_enemy_shot_y_prev, g_enemy_shot_y, t));
     int row;
     int col;
     int remaining = g_target_ticks - g_elapsed_ticks;
@@ -731,8 +745,8 @@ void Invaders_DrawInterpolated(float alpha)
                 continue;
             }
             {
-                int x = (int)(form_x + (col * (INVADER_W + INVADER_SPACING_X)));
-                int y = (int)(form_y + (row * (INVADER_H + INVADER_SPACING_Y)));
+                int x = PHYS_INT(form_x + PHYS_I(col * (INVADER_W + INVADER_SPACING_X)));
+                int y = PHYS_INT(form_y + PHYS_I(row * (INVADER_H + INVADER_SPACING_Y)));
                 int color_index = row;
                 unsigned char color = INV_COLOR_ALIEN_ROW[0];
                 const unsigned char *spr =
@@ -748,16 +762,16 @@ void Invaders_DrawInterpolated(float alpha)
         }
     }
 
-    v_draw_dotted_rect((int)player_x, player_y, g_params.player_w, g_params.player_h,
+    v_draw_dotted_rect(player_x, player_y, g_params.player_w, g_params.player_h,
                        INV_COLOR_PLAYER_SHIP_BASE, INV_COLOR_PLAYER_SHIP_DOTS, 1);
-    draw_rect((int)player_x + (g_params.player_w / 2) - 1, player_y - 2, 2, 2, INV_COLOR_PLAYER_TURRET);
+    draw_rect(player_x + (g_params.player_w / 2) - 1, player_y - 2, 2, 2, INV_COLOR_PLAYER_TURRET);
 
     if (g_player_shot_active) {
-        draw_rect((int)shot_x, (int)shot_y, PLAYER_SHOT_W, PLAYER_SHOT_H, INV_COLOR_BULLET_PLAYER);
+        draw_rect(shot_x, shot_y, PLAYER_SHOT_W, PLAYER_SHOT_H, INV_COLOR_BULLET_PLAYER);
     }
 
     if (g_enemy_shot_active) {
-        draw_rect((int)enemy_shot_x, (int)enemy_shot_y, ENEMY_SHOT_W, ENEMY_SHOT_H, INV_COLOR_BULLET_ENEMY);
+        draw_rect(enemy_shot_x, enemy_shot_y, ENEMY_SHOT_W, ENEMY_SHOT_H, INV_COLOR_BULLET_ENEMY);
     }
 
     for (row = 0; row < EXPLOSION_PARTICLE_MAX; ++row) {
@@ -769,7 +783,7 @@ void Invaders_DrawInterpolated(float alpha)
             if (g_explosion_particles[row].life < (EXPLOSION_PARTICLE_LIFE / 2)) {
                 color = INV_COLOR_EXPLOSION_1;
             }
-            draw_rect((int)g_explosion_particles[row].x, (int)g_explosion_particles[row].y, 2, 2, color);
+            draw_rect(PHYS_INT(g_explosion_particles[row].x), PHYS_INT(g_explosion_particles[row].y), 2, 2, color);
         }
     }
 
@@ -795,7 +809,10 @@ void Invaders_DrawInterpolated(float alpha)
 void Invaders_End(void)
 {
     (void)g_did_win;
-    (void)g_sound_enabled;
+    if (g_explosion_sample) {
+        sound_unload_sample();
+        g_explosion_sample = 0;
+    }
     invaders_format_score(g_end_detail, sizeof(g_end_detail));
 }
 
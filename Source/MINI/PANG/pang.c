@@ -1,5 +1,6 @@
 #include "pang.h"
 
+#include "../../CORE/fixed.h"
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
 #include "../../CORE/sound.h"
@@ -7,6 +8,7 @@
 #include "../../CORE/sprite_dat.h"
 #include "../../CORE/keyboard.h"
 #include "../../CORE/high_scores.h"
+#include "../../GAME/melodies.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -71,11 +73,11 @@ typedef enum {
 } PangBallSize;
 
 typedef struct {
-    float player_speed;
-    float ball_speed_x;
-    float ball_bounce_vy;
-    float gravity;
-    float arrow_speed;
+    phys_t player_speed;
+    phys_t ball_speed_x;
+    phys_t ball_bounce_vy;
+    phys_t gravity;
+    phys_t arrow_speed;
     int initial_balls;
 } PangParams;
 
@@ -84,15 +86,16 @@ typedef struct {
     unsigned short h;
     unsigned long max_pixels;
     unsigned char far *pixels;
+    SpanSprite spans;
 } PangSprite;
 
 typedef struct {
-    float x;
-    float y;
-    float x_prev;
-    float y_prev;
-    float vx;
-    float vy;
+    phys_t x;
+    phys_t y;
+    phys_t x_prev;
+    phys_t y_prev;
+    phys_t vx;
+    phys_t vy;
     PangBallSize size;
     int active;
 } PangBall;
@@ -104,37 +107,39 @@ static int g_did_win = 0;
 static int g_sound_enabled = 0;
 static int g_use_keyboard = 1;
 
-static PangSprite g_player1 = {0, 0, PANG_PLAYER_W * PANG_PLAYER_H, NULL};
-static PangSprite g_player2 = {0, 0, PANG_PLAYER_W * PANG_PLAYER_H, NULL};
-static PangSprite g_player3 = {0, 0, PANG_PLAYER_W * PANG_PLAYER_H, NULL};
-static PangSprite g_ball_xl = {0, 0, PANG_BALL_XL * PANG_BALL_XL, NULL};
-static PangSprite g_ball_m = {0, 0, PANG_BALL_M * PANG_BALL_M, NULL};
-static PangSprite g_ball_s = {0, 0, PANG_BALL_S * PANG_BALL_S, NULL};
-static PangSprite g_arrow = {0, 0, PANG_ARROW_W * PANG_ARROW_H, NULL};
+static PangSprite g_player1 = {0, 0, PANG_PLAYER_W * PANG_PLAYER_H, NULL, {0}};
+static PangSprite g_player2 = {0, 0, PANG_PLAYER_W * PANG_PLAYER_H, NULL, {0}};
+static PangSprite g_player3 = {0, 0, PANG_PLAYER_W * PANG_PLAYER_H, NULL, {0}};
+static PangSprite g_ball_xl = {0, 0, PANG_BALL_XL * PANG_BALL_XL, NULL, {0}};
+static PangSprite g_ball_m = {0, 0, PANG_BALL_M * PANG_BALL_M, NULL, {0}};
+static PangSprite g_ball_s = {0, 0, PANG_BALL_S * PANG_BALL_S, NULL, {0}};
+static PangSprite g_arrow = {0, 0, PANG_ARROW_W * PANG_ARROW_H, NULL, {0}};
+static Surface g_bg_layer;
+static int g_bg_ready = 0;
 static int g_sprites_loaded = 0;
 
 static PangBall g_balls[PANG_MAX_BALLS];
 
-static float g_player_x = 0.0f;
-static float g_player_x_prev = 0.0f;
-static float g_player_y = 0.0f;
+static phys_t g_player_x = PHYS_C(0.0f);
+static phys_t g_player_x_prev = PHYS_C(0.0f);
+static phys_t g_player_y = PHYS_C(0.0f);
 static int g_player_dir = 1;
 static int g_player_move_dir = 0;
 static int g_walk_ticks = 0;
 static int g_walk_frame = 0;
 
 static int g_arrow_active = 0;
-static float g_arrow_x = 0.0f;
-static float g_arrow_y = 0.0f;
-static float g_arrow_x_prev = 0.0f;
-static float g_arrow_y_prev = 0.0f;
+static phys_t g_arrow_x = PHYS_C(0.0f);
+static phys_t g_arrow_y = PHYS_C(0.0f);
+static phys_t g_arrow_x_prev = PHYS_C(0.0f);
+static phys_t g_arrow_y_prev = PHYS_C(0.0f);
 static int g_fire_held = 0;
 
 static char g_end_detail[32] = "";
 static uint64_t g_score = 0;
 static uint32_t g_elapsed_ticks = 0;
 
-static float clampf(float value, float min_value, float max_value)
+static phys_t clamp_phys(phys_t value, phys_t min_value, phys_t max_value)
 {
     if (value < min_value) {
         return min_value;
@@ -145,9 +150,9 @@ static float clampf(float value, float min_value, float max_value)
     return value;
 }
 
-static float lerpf(float a, float b, float t)
+static phys_t lerp_phys(phys_t a, phys_t b, phys_t t)
 {
-    return a + (b - a) * t;
+    return PHYS_LERP(a, b, t);
 }
 
 static int text_len(const char *text)
@@ -178,6 +183,14 @@ static const char *difficulty_short(unsigned char difficulty)
     }
 }
 
+// Fin de partida: prioridad alta, no se los puede quitar ningún impacto
+static void pang_play_sound(MelodyId id)
+{
+    const Melody *melody = melody_get(id);
+
+    sound_play_patch(melody->notes, melody->count, SOUND_PRIO_HIGH, melody->patch);
+}
+
 static int pang_ball_size_px(PangBallSize size)
 {
     switch (size) {
@@ -230,13 +243,13 @@ static uint32_t pang_time_limit_seconds(unsigned char difficulty)
     }
 }
 
-static float pang_ball_bounce_vy(PangBallSize size)
+static phys_t pang_ball_bounce_vy(PangBallSize size)
 {
     switch (size) {
     case PANG_SIZE_XL:
-        return g_params.ball_bounce_vy * 1.2f;
+        return PHYS_MUL(g_params.ball_bounce_vy, PHYS_C(1.2f));
     case PANG_SIZE_M:
-        return g_params.ball_bounce_vy * 1.1f;
+        return PHYS_MUL(g_params.ball_bounce_vy, PHYS_C(1.1f));
     case PANG_SIZE_S:
     default:
         return g_params.ball_bounce_vy;
@@ -283,7 +296,12 @@ static int pang_load_sprite(const char *path, PangSprite *sprite)
         return 0;
     }
 
-    return sprite_dat_load_auto(path, &sprite->w, &sprite->h, sprite->pixels, sprite->max_pixels);
+    if (!sprite_dat_load_auto(path, &sprite->w, &sprite->h, sprite->pixels, sprite->max_pixels)) {
+        return 0;
+    }
+
+    v_sprite_spans_build(&sprite->spans, sprite->w, sprite->h, sprite->pixels, 0);
+    return 1;
 }
 
 static void pang_load_sprites(void)
@@ -305,7 +323,11 @@ static void pang_load_sprites(void)
 
 static void pang_free_sprite(PangSprite *sprite)
 {
-    if (!sprite || !sprite->pixels) {
+    if (!sprite) {
+        return;
+    }
+    v_sprite_spans_free(&sprite->spans);
+    if (!sprite->pixels) {
         return;
     }
 
@@ -337,6 +359,10 @@ static void pang_blit_sprite(int x, int y, const PangSprite *sprite)
     if (!sprite || sprite->w == 0 || sprite->h == 0) {
         return;
     }
+    if (sprite->spans.data) {
+        v_blit_sprite_spans(x, y, &sprite->spans);
+        return;
+    }
     v_blit_sprite(x, y, sprite->w, sprite->h, sprite->pixels, 0);
 }
 
@@ -389,6 +415,27 @@ static void pang_draw_background(void)
     }
 }
 
+// El fondo y las bandas del HUD no cambian: se pintan una vez en una capa
+static void pang_draw_background_layer(void)
+{
+    if (!g_bg_ready) {
+        if (!g_bg_layer.pixels && !v_surface_alloc(&g_bg_layer, VIDEO_WIDTH, VIDEO_HEIGHT)) {
+            pang_draw_background();
+            v_fill_rect(0, 0, VIDEO_WIDTH, 16, PANG_HUD_BG_COLOR);
+            v_fill_rect(0, 184, VIDEO_WIDTH, 16, PANG_HUD_BG_COLOR);
+            return;
+        }
+        v_set_target(&g_bg_layer);
+        pang_draw_background();
+        v_fill_rect(0, 0, VIDEO_WIDTH, 16, PANG_HUD_BG_COLOR);
+        v_fill_rect(0, 184, VIDEO_WIDTH, 16, PANG_HUD_BG_COLOR);
+        v_set_target(NULL);
+        g_bg_ready = 1;
+    }
+
+    v_surf_blit(v_surface_screen(), 0, 0, &g_bg_layer, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+}
+
 static void pang_select_params(unsigned char difficulty, PangParams *params)
 {
     if (!params) {
@@ -397,28 +444,28 @@ static void pang_select_params(unsigned char difficulty, PangParams *params)
 
     switch (difficulty) {
     case DIFFICULTY_EASY:
-        params->player_speed = 2.6f;
-        params->ball_speed_x = 1.0f;
-        params->ball_bounce_vy = 4.2f;
-        params->gravity = 0.18f;
-        params->arrow_speed = 3.0f;
+        params->player_speed = PHYS_C(2.6f);
+        params->ball_speed_x = PHYS_C(1.0f);
+        params->ball_bounce_vy = PHYS_C(4.2f);
+        params->gravity = PHYS_C(0.18f);
+        params->arrow_speed = PHYS_C(3.0f);
         params->initial_balls = 1;
         break;
     case DIFFICULTY_HARD:
-        params->player_speed = 3.4f;
-        params->ball_speed_x = 1.8f;
-        params->ball_bounce_vy = 5.6f;
-        params->gravity = 0.26f;
-        params->arrow_speed = 4.0f;
+        params->player_speed = PHYS_C(3.4f);
+        params->ball_speed_x = PHYS_C(1.8f);
+        params->ball_bounce_vy = PHYS_C(5.6f);
+        params->gravity = PHYS_C(0.26f);
+        params->arrow_speed = PHYS_C(4.0f);
         params->initial_balls = 3;
         break;
     case DIFFICULTY_NORMAL:
     default:
-        params->player_speed = 3.0f;
-        params->ball_speed_x = 1.4f;
-        params->ball_bounce_vy = 5.0f;
-        params->gravity = 0.22f;
-        params->arrow_speed = 3.5f;
+        params->player_speed = PHYS_C(3.0f);
+        params->ball_speed_x = PHYS_C(1.4f);
+        params->ball_bounce_vy = PHYS_C(5.0f);
+        params->gravity = PHYS_C(0.22f);
+        params->arrow_speed = PHYS_C(3.5f);
         params->initial_balls = 2;
         break;
     }
@@ -442,24 +489,24 @@ static void pang_reset_balls(void)
     }
 
     for (i = 0; i < count; ++i) {
-        float fx = (float)PANG_LEFT + ((float)(i + 1) / (float)(count + 1)) * (float)span;
-        float player_center = g_player_x + (float)PANG_PLAYER_W * 0.5f;
-        float ball_center = fx + (float)PANG_BALL_XL * 0.5f;
+        phys_t fx = PHYS_I(PANG_LEFT) + PHYS_MUL(PHYS_RATIO(i + 1, count + 1), PHYS_I(span));
+        phys_t player_center = g_player_x + PHYS_RATIO(PANG_PLAYER_W, 2);
+        phys_t ball_center = fx + PHYS_RATIO(PANG_BALL_XL, 2);
         int dir;
 
         if (count == 1) {
-            fx = (float)PANG_LEFT + 0.75f * (float)span;
-            ball_center = fx + (float)PANG_BALL_XL * 0.5f;
+            fx = PHYS_I(PANG_LEFT) + PHYS_MUL(PHYS_C(0.75f), PHYS_I(span));
+            ball_center = fx + PHYS_RATIO(PANG_BALL_XL, 2);
         }
 
         dir = (ball_center < player_center) ? -1 : 1;
         g_balls[i].active = 1;
         g_balls[i].size = PANG_SIZE_XL;
         g_balls[i].x = fx;
-        g_balls[i].y = (float)(PANG_TOP + 12);
+        g_balls[i].y = PHYS_I(PANG_TOP + 12);
         g_balls[i].x_prev = g_balls[i].x;
         g_balls[i].y_prev = g_balls[i].y;
-        g_balls[i].vx = g_params.ball_speed_x * (float)dir;
+        g_balls[i].vx = PHYS_MUL(g_params.ball_speed_x, PHYS_I(dir));
         g_balls[i].vy = -pang_ball_bounce_vy(g_balls[i].size);
     }
 }
@@ -469,10 +516,10 @@ static void pang_spawn_split(const PangBall *source, PangBallSize next_size)
     int i;
     int size_old = pang_ball_size_px(source->size);
     int size_new = pang_ball_size_px(next_size);
-    float center_x = source->x + (float)size_old * 0.5f;
-    float center_y = source->y + (float)size_old * 0.5f;
-    float start_x = center_x - (float)size_new * 0.5f;
-    float start_y = center_y - (float)size_new * 0.5f;
+    phys_t center_x = source->x + PHYS_RATIO(size_old, 2);
+    phys_t center_y = source->y + PHYS_RATIO(size_old, 2);
+    phys_t start_x = center_x - PHYS_RATIO(size_new, 2);
+    phys_t start_y = center_y - PHYS_RATIO(size_new, 2);
 
     for (i = 0; i < PANG_MAX_BALLS; ++i) {
         if (!g_balls[i].active) {
@@ -507,14 +554,14 @@ static int pang_check_player_hit(const PangBall *ball)
 {
     int size = pang_ball_size_px(ball->size);
     int margin = pang_ball_margin(ball->size);
-    float ball_x = ball->x + (float)margin;
-    float ball_y = ball->y + (float)margin;
-    float ball_w = (float)(size - margin * 2);
-    float ball_h = (float)(size - margin * 2);
-    float player_hit_w = 20.0f;
-    float player_hit_h = 32.0f;
-    float player_hit_x = g_player_x + ((float)PANG_PLAYER_W - player_hit_w) * 0.5f;
-    float player_hit_y = g_player_y + ((float)PANG_PLAYER_H - player_hit_h);
+    phys_t ball_x = ball->x + PHYS_I(margin);
+    phys_t ball_y = ball->y + PHYS_I(margin);
+    phys_t ball_w = PHYS_I(size - margin * 2);
+    phys_t ball_h = PHYS_I(size - margin * 2);
+    phys_t player_hit_w = PHYS_C(20.0f);
+    phys_t player_hit_h = PHYS_C(32.0f);
+    phys_t player_hit_x = g_player_x + PHYS_MUL(PHYS_I(PANG_PLAYER_W) - player_hit_w, PHYS_C(0.5f));
+    phys_t player_hit_y = g_player_y + (PHYS_I(PANG_PLAYER_H) - player_hit_h);
 
     if (ball_x < player_hit_x + player_hit_w &&
         ball_x + ball_w > player_hit_x &&
@@ -530,19 +577,19 @@ static int pang_check_rope_hit(const PangBall *ball)
 {
     int size = pang_ball_size_px(ball->size);
     int margin = pang_ball_margin(ball->size);
-    float ball_x = ball->x + (float)margin;
-    float ball_y = ball->y + (float)margin;
-    float ball_w = (float)(size - margin * 2);
-    float ball_h = (float)(size - margin * 2);
-    float rope_x = g_arrow_x + (float)PANG_ARROW_W * 0.5f;
-    float rope_half = 1.5f;
-    float rope_left = rope_x - rope_half;
-    float rope_right = rope_x + rope_half;
-    float rope_top = g_arrow_y + (float)PANG_ARROW_H;
-    float rope_bottom = (float)PANG_FLOOR;
+    phys_t ball_x = ball->x + PHYS_I(margin);
+    phys_t ball_y = ball->y + PHYS_I(margin);
+    phys_t ball_w = PHYS_I(size - margin * 2);
+    phys_t ball_h = PHYS_I(size - margin * 2);
+    phys_t rope_x = g_arrow_x + PHYS_RATIO(PANG_ARROW_W, 2);
+    phys_t rope_half = PHYS_C(1.5f);
+    phys_t rope_left = rope_x - rope_half;
+    phys_t rope_right = rope_x + rope_half;
+    phys_t rope_top = g_arrow_y + PHYS_I(PANG_ARROW_H);
+    phys_t rope_bottom = PHYS_I(PANG_FLOOR);
 
     if (rope_bottom < rope_top) {
-        float temp = rope_bottom;
+        phys_t temp = rope_bottom;
         rope_bottom = rope_top;
         rope_top = temp;
     }
@@ -578,22 +625,22 @@ static void pang_handle_ball_hit(int index)
     g_balls[index].active = 0;
 
     if (g_sound_enabled) {
-        sound_play_tone(740, 30);
+        const Melody *hit = melody_get(MELODY_PANG_HIT);
+
+        // Sin división sólo suena el impacto
+        sound_play_patch(hit->notes, spawn_split ? hit->count : 1, SOUND_PRIO_SFX, hit->patch);
     }
 
     if (spawn_split) {
         pang_spawn_split(&g_balls[index], next_size);
-        if (g_sound_enabled) {
-            sound_play_tone(620, 40);
-        }
     }
 }
 
 static void pang_fire_arrow(void)
 {
     g_arrow_active = 1;
-    g_arrow_x = g_player_x + ((float)PANG_PLAYER_W - (float)PANG_ARROW_W) * 0.5f;
-    g_arrow_y = g_player_y - (float)PANG_ARROW_H;
+    g_arrow_x = g_player_x + PHYS_MUL(PHYS_I(PANG_PLAYER_W) - PHYS_I(PANG_ARROW_W), PHYS_C(0.5f));
+    g_arrow_y = g_player_y - PHYS_I(PANG_ARROW_H);
     g_arrow_x_prev = g_arrow_x;
     g_arrow_y_prev = g_arrow_y;
 
@@ -611,23 +658,27 @@ void Pang_Init(const GameSettings *settings)
     }
 
     pang_select_params(g_settings.difficulty, &g_params);
-    g_params.player_speed *= g_settings.speed_multiplier;
-    g_params.ball_speed_x *= g_settings.speed_multiplier;
-    g_params.ball_bounce_vy *= g_settings.speed_multiplier;
-    g_params.gravity *= g_settings.speed_multiplier;
-    g_params.arrow_speed *= g_settings.speed_multiplier;
+    {
+        phys_t mul = PHYS_F(g_settings.speed_multiplier);
+
+        g_params.player_speed = PHYS_MUL(g_params.player_speed, mul);
+        g_params.ball_speed_x = PHYS_MUL(g_params.ball_speed_x, mul);
+        g_params.ball_bounce_vy = PHYS_MUL(g_params.ball_bounce_vy, mul);
+        g_params.gravity = PHYS_MUL(g_params.gravity, mul);
+        g_params.arrow_speed = PHYS_MUL(g_params.arrow_speed, mul);
+    }
 
         // OJO: ralentización global fija (0.25 = muy lento, 0.50 = normal)
     {
-        const float slow = 0.25f;
+        const phys_t slow = PHYS_C(0.25f);
 
-        g_params.player_speed *= slow;
-        g_params.ball_speed_x *= slow;
-        g_params.ball_bounce_vy *= slow;
-        g_params.arrow_speed *= slow;
+        g_params.player_speed = PHYS_MUL(g_params.player_speed, slow);
+        g_params.ball_speed_x = PHYS_MUL(g_params.ball_speed_x, slow);
+        g_params.ball_bounce_vy = PHYS_MUL(g_params.ball_bounce_vy, slow);
+        g_params.arrow_speed = PHYS_MUL(g_params.arrow_speed, slow);
 
         // Mantiene rebotes altos: gravedad al cuadrado
-        g_params.gravity *= (slow * slow);
+        g_params.gravity = PHYS_MUL(g_params.gravity, PHYS_MUL(slow, slow));
     }
 
     pang_load_sprites();
@@ -642,9 +693,9 @@ void Pang_Init(const GameSettings *settings)
         }
     }
 
-    g_player_x = (float)(PANG_LEFT + (PANG_RIGHT - PANG_LEFT - PANG_PLAYER_W) / 2);
+    g_player_x = PHYS_I(PANG_LEFT + (PANG_RIGHT - PANG_LEFT - PANG_PLAYER_W) / 2);
     g_player_x_prev = g_player_x;
-    g_player_y = (float)(PANG_FLOOR - PANG_PLAYER_H);
+    g_player_y = PHYS_I(PANG_FLOOR - PANG_PLAYER_H);
     g_player_dir = 1;
     g_player_move_dir = 0;
     g_walk_ticks = 0;
@@ -705,7 +756,7 @@ void Pang_Update(void)
             g_did_win = 0;
             snprintf(g_end_detail, sizeof(g_end_detail), "TIEMPO AGOTADO");
             if (g_sound_enabled) {
-                sound_play_tone(220, 160);
+                pang_play_sound(MELODY_PANG_OVER);
             }
             return;
         }
@@ -742,8 +793,8 @@ void Pang_Update(void)
     if (move_dir != 0) {
         g_player_dir = (move_dir < 0) ? -1 : 1;
         g_player_move_dir = move_dir;
-        g_player_x += (float)move_dir * g_params.player_speed;
-        g_player_x = clampf(g_player_x, (float)PANG_LEFT, (float)(PANG_RIGHT - PANG_PLAYER_W));
+        g_player_x += PHYS_MUL(PHYS_I(move_dir), g_params.player_speed);
+        g_player_x = clamp_phys(g_player_x, PHYS_I(PANG_LEFT), PHYS_I(PANG_RIGHT - PANG_PLAYER_W));
         g_walk_ticks++;
         if (g_walk_ticks >= PANG_WALK_TICKS) {
             g_walk_ticks = 0;
@@ -761,7 +812,7 @@ void Pang_Update(void)
 
     if (g_arrow_active) {
         g_arrow_y -= g_params.arrow_speed;
-        if (g_arrow_y <= (float)PANG_TOP) {
+        if (g_arrow_y <= PHYS_I(PANG_TOP)) {
             g_arrow_active = 0;
         }
     }
@@ -769,8 +820,8 @@ void Pang_Update(void)
     for (i = 0; i < PANG_MAX_BALLS; ++i) {
         PangBall *ball = &g_balls[i];
         int size;
-        float next_x;
-        float next_y;
+        phys_t next_x;
+        phys_t next_y;
 
         if (!ball->active) {
             continue;
@@ -783,19 +834,19 @@ void Pang_Update(void)
         next_y = ball->y + ball->vy;
         size = pang_ball_size_px(ball->size);
 
-        if (next_x <= (float)PANG_LEFT) {
-            next_x = (float)PANG_LEFT;
-            ball->vx = (ball->vx < 0.0f) ? -ball->vx : ball->vx;
-        } else if (next_x + (float)size >= (float)PANG_RIGHT) {
-            next_x = (float)(PANG_RIGHT - size);
-            ball->vx = (ball->vx > 0.0f) ? -ball->vx : ball->vx;
+        if (next_x <= PHYS_I(PANG_LEFT)) {
+            next_x = PHYS_I(PANG_LEFT);
+            ball->vx = (ball->vx < PHYS_C(0.0f)) ? -ball->vx : ball->vx;
+        } else if (next_x + PHYS_I(size) >= PHYS_I(PANG_RIGHT)) {
+            next_x = PHYS_I(PANG_RIGHT - size);
+            ball->vx = (ball->vx > PHYS_C(0.0f)) ? -ball->vx : ball->vx;
         }
 
-        if (next_y <= (float)PANG_TOP) {
-            next_y = (float)PANG_TOP;
-            ball->vy = (ball->vy < 0.0f) ? -ball->vy : ball->vy;
-        } else if (next_y + (float)size >= (float)PANG_FLOOR) {
-            next_y = (float)(PANG_FLOOR - size);
+        if (next_y <= PHYS_I(PANG_TOP)) {
+            next_y = PHYS_I(PANG_TOP);
+            ball->vy = (ball->vy < PHYS_C(0.0f)) ? -ball->vy : ball->vy;
+        } else if (next_y + PHYS_I(size) >= PHYS_I(PANG_FLOOR)) {
+            next_y = PHYS_I(PANG_FLOOR - size);
             ball->vy = -pang_ball_bounce_vy(ball->size);
         }
 
@@ -806,7 +857,7 @@ void Pang_Update(void)
             g_finished = 1;
             g_did_win = 0;
             if (g_sound_enabled) {
-                sound_play_tone(220, 160);
+                pang_play_sound(MELODY_PANG_OVER);
             }
             return;
         }
@@ -837,7 +888,7 @@ void Pang_Update(void)
         g_finished = 1;
         g_did_win = 1;
         if (g_sound_enabled) {
-            sound_play_tone(880, 120);
+            pang_play_sound(MELODY_PANG_WIN);
         }
     }
 }
@@ -864,20 +915,19 @@ void Pang_DrawInterpolated(float alpha)
     uint32_t elapsed_seconds = g_elapsed_ticks / PANG_TICKS_PER_SECOND;
     uint32_t remaining_seconds = 0;
     int i;
-    float player_x = lerpf(g_player_x_prev, g_player_x, alpha);
-    float arrow_x = lerpf(g_arrow_x_prev, g_arrow_x, alpha);
-    float arrow_y = lerpf(g_arrow_y_prev, g_arrow_y, alpha);
-    int player_x_i = (int)(player_x + 0.5f);
-    int player_y_i = (int)(g_player_y + 0.5f);
+    phys_t t = PHYS_F(alpha);
+    phys_t player_x = lerp_phys(g_player_x_prev, g_player_x, t);
+    phys_t arrow_x = lerp_phys(g_arrow_x_prev, g_arrow_x, t);
+    phys_t arrow_y = lerp_phys(g_arrow_y_prev, g_arrow_y, t);
+    int player_x_i = PHYS_INT(player_x + PHYS_C(0.5f));
+    int player_y_i = PHYS_INT(g_player_y + PHYS_C(0.5f));
     const PangSprite *player_sprite = &g_player1;
 
-    pang_draw_background();
-    v_fill_rect(0, 0, VIDEO_WIDTH, 16, PANG_HUD_BG_COLOR);
-    v_fill_rect(0, 184, VIDEO_WIDTH, 16, PANG_HUD_BG_COLOR);
+    pang_draw_background_layer();
 
     if (g_arrow_active) {
-        int rope_x = (int)(arrow_x + (float)PANG_ARROW_W * 0.5f);
-        int rope_top = (int)(arrow_y + (float)PANG_ARROW_H);
+        int rope_x = PHYS_INT(arrow_x + PHYS_RATIO(PANG_ARROW_W, 2));
+        int rope_top = PHYS_INT(arrow_y + PHYS_I(PANG_ARROW_H));
         int rope_bottom = (int)PANG_FLOOR;
         int y;
 
@@ -895,17 +945,17 @@ void Pang_DrawInterpolated(float alpha)
     for (i = 0; i < PANG_MAX_BALLS; ++i) {
         const PangBall *ball = &g_balls[i];
         const PangSprite *sprite;
-        float x;
-        float y;
+        phys_t x;
+        phys_t y;
 
         if (!ball->active) {
             continue;
         }
 
         sprite = pang_ball_sprite(ball->size);
-        x = lerpf(ball->x_prev, ball->x, alpha);
-        y = lerpf(ball->y_prev, ball->y, alpha);
-        pang_blit_sprite((int)(x + 0.5f), (int)(y + 0.5f), sprite);
+        x = lerp_phys(ball->x_prev, ball->x, t);
+        y = lerp_phys(ball->y_prev, ball->y, t);
+        pang_blit_sprite(PHYS_INT(x + PHYS_C(0.5f)), PHYS_INT(y + PHYS_C(0.5f)), sprite);
     }
 
     if (g_player_move_dir != 0) {
@@ -919,7 +969,7 @@ void Pang_DrawInterpolated(float alpha)
     }
 
     if (g_arrow_active) {
-        pang_blit_sprite((int)(arrow_x + 0.5f), (int)(arrow_y + 0.5f), &g_arrow);
+        pang_blit_sprite(PHYS_INT(arrow_x + PHYS_C(0.5f)), PHYS_INT(arrow_y + PHYS_C(0.5f)), &g_arrow);
     }
 
     if (elapsed_seconds < limit_seconds) {
@@ -946,6 +996,8 @@ void Pang_End(void)
     high_scores_format_score(score_text, sizeof(score_text), g_score);
     snprintf(g_end_detail, sizeof(g_end_detail), "PUNTOS %s", score_text);
     pang_free_sprites();
+    v_surface_free(&g_bg_layer);
+    g_bg_ready = 0;
 }
 
 int Pang_IsFinished(void)
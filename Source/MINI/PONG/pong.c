@@ -1,7 +1,9 @@
 #include "pong.h"
 
+#include "../../CORE/fixed.h"
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
+#include "../../CORE/rng.h"
 #include "../../CORE/sound.h"
 #include "../../CORE/timer.h"
 #include "../../CORE/video.h"
@@ -23,38 +25,39 @@
 #define PONG_TIME_TARGET_MS 60000UL
 #define PONG_TIME_BONUS_MAX 20000UL
 typedef struct {
-    float paddle_speed;
-    float ball_speed_x;
-    float ball_speed_y;
-    float cpu_step;
+    phys_t paddle_speed;
+    phys_t ball_speed_x;
+    phys_t ball_speed_y;
+    phys_t cpu_step;
     int paddle_h;
-    float cpu_error;
-    float cpu_deadzone;
-    float cpu_react_delay;
+    phys_t cpu_error;
+    phys_t cpu_deadzone;
+    phys_t cpu_react_delay;
 } PongParams;
 
 static GameSettings g_settings;
+static Rng g_rng;
 static PongParams g_params;
 static int g_finished = 0;
 static int g_did_win = 0;
 static int g_player_score = 0;
 static int g_cpu_score = 0;
 static int g_win_target = PONG_WIN_TARGET_DEFAULT;
-static float g_player_y = 0.0f;
-static float g_cpu_y = 0.0f;
-static float g_ball_x = 0.0f;
-static float g_ball_y = 0.0f;
-static float g_player_y_prev = 0.0f;
-static float g_cpu_y_prev = 0.0f;
-static float g_ball_x_prev = 0.0f;
-static float g_ball_y_prev = 0.0f;
-static float g_ball_vx = 0.0f;
-static float g_ball_vy = 0.0f;
-static float g_ball_base_vx = 0.0f;
-static float g_ball_base_vy = 0.0f;
+static phys_t g_player_y = PHYS_C(0.0f);
+static phys_t g_cpu_y = PHYS_C(0.0f);
+static phys_t g_ball_x = PHYS_C(0.0f);
+static phys_t g_ball_y = PHYS_C(0.0f);
+static phys_t g_player_y_prev = PHYS_C(0.0f);
+static phys_t g_cpu_y_prev = PHYS_C(0.0f);
+static phys_t g_ball_x_prev = PHYS_C(0.0f);
+static phys_t g_ball_y_prev = PHYS_C(0.0f);
+static phys_t g_ball_vx = PHYS_C(0.0f);
+static phys_t g_ball_vy = PHYS_C(0.0f);
+static phys_t g_ball_base_vx = PHYS_C(0.0f);
+static phys_t g_ball_base_vy = PHYS_C(0.0f);
 static int g_use_keyboard = 1;
 static int g_last_scorer = 0;
-static float g_cpu_react_cd = 0.0f;
+static phys_t g_cpu_react_cd = PHYS_C(0.0f);
 static int g_initial_serve = 0;
 static int g_serve_delay_ticks = 0;
 static int g_sound_enabled = 0;
@@ -63,7 +66,7 @@ static uint32_t g_start_time_us = 0;
 static uint32_t g_finish_time_us = 0;
 static uint64_t g_final_score = 0;
 
-static float clampf(float value, float min_value, float max_value)
+static phys_t clamp_phys(phys_t value, phys_t min_value, phys_t max_value)
 {
     if (value < min_value) {
         return min_value;
@@ -74,9 +77,9 @@ static float clampf(float value, float min_value, float max_value)
     return value;
 }
 
-static float absf(float value)
+static phys_t abs_phys(phys_t value)
 {
-    return value < 0.0f ? -value : value;
+    return value < PHYS_C(0.0f) ? -value : value;
 }
 
 static void draw_center_text(const char *text, int y, unsigned char color)
@@ -128,57 +131,57 @@ static void pong_select_params(unsigned char difficulty, PongParams *params)
 
     switch (difficulty) {
     case DIFFICULTY_EASY:
-        params->paddle_speed = 3.5f;
-        params->ball_speed_x = 2.5f;
-        params->ball_speed_y = 1.3f;
-        params->cpu_step = 2.0f;
+        params->paddle_speed = PHYS_C(3.5f);
+        params->ball_speed_x = PHYS_C(2.5f);
+        params->ball_speed_y = PHYS_C(1.3f);
+        params->cpu_step = PHYS_C(2.0f);
         params->paddle_h = 24;
-        params->cpu_error = 6.0f;
-        params->cpu_deadzone = 4.0f;
-        params->cpu_react_delay = 2.2f;
+        params->cpu_error = PHYS_C(6.0f);
+        params->cpu_deadzone = PHYS_C(4.0f);
+        params->cpu_react_delay = PHYS_C(2.2f);
         break;
     case DIFFICULTY_HARD:
-        params->paddle_speed = 4.0f;
-        params->ball_speed_x = 3.0f;
-        params->ball_speed_y = 1.6f;
-        params->cpu_step = 2.55f;       // Ajuste de dificultad
+        params->paddle_speed = PHYS_C(4.0f);
+        params->ball_speed_x = PHYS_C(3.0f);
+        params->ball_speed_y = PHYS_C(1.6f);
+        params->cpu_step = PHYS_C(2.55f);       // Ajuste de dificultad
         params->paddle_h = 20;
-        params->cpu_error = 2.8f;       // Ajuste de dificultad
-        params->cpu_deadzone = 1.2f;    // Ajuste de dificultad
-        params->cpu_react_delay = 0.95f; // Ajuste de dificultad
+        params->cpu_error = PHYS_C(2.8f);       // Ajuste de dificultad
+        params->cpu_deadzone = PHYS_C(1.2f);    // Ajuste de dificultad
+        params->cpu_react_delay = PHYS_C(0.95f); // Ajuste de dificultad
         break;
     case DIFFICULTY_NORMAL:
     default:
-        params->paddle_speed = 3.0f;
-        params->ball_speed_x = 2.2f;
-        params->ball_speed_y = 1.4f;
-        params->cpu_step = 2.35f;        // Ajuste de dificultad
+        params->paddle_speed = PHYS_C(3.0f);
+        params->ball_speed_x = PHYS_C(2.2f);
+        params->ball_speed_y = PHYS_C(1.4f);
+        params->cpu_step = PHYS_C(2.35f);        // Ajuste de dificultad
         params->paddle_h = 22;
-        params->cpu_error = 4.6f;        // Ajuste de dificultad
-        params->cpu_deadzone = 2.5f;     // Ajuste de dificultad
-        params->cpu_react_delay = 1.15f; // Ajuste de dificultad
+        params->cpu_error = PHYS_C(4.6f);        // Ajuste de dificultad
+        params->cpu_deadzone = PHYS_C(2.5f);     // Ajuste de dificultad
+        params->cpu_react_delay = PHYS_C(1.15f); // Ajuste de dificultad
         break;
     }
 }
 
 static void pong_reset_ball(int scorer)
 {
-    float vy_scale = 0;
+    phys_t vy_scale = 0;
     if (g_initial_serve) {
         // Variación suave estilo Pong original
-        float jitter = ((float)(rand() % 21) - 10.0f) / 100.0f; 
+        phys_t jitter = PHYS_DIV(PHYS_I(rng_below(&g_rng, 21)) - PHYS_C(10.0f), PHYS_C(100.0f)); 
         // Variación en [-0.10, +0.10]
 
-        vy_scale = PONG_INITIAL_VY_SCALE * (1.0f + jitter);
+        vy_scale = PHYS_MUL(PHYS_C(PONG_INITIAL_VY_SCALE), PHYS_C(1.0f) + jitter);
 
         // OJO: evita tiro vertical o muerto
-        if (vy_scale < 0.18f) vy_scale = 0.18f;
-        if (vy_scale > 0.32f) vy_scale = 0.32f;
+        if (vy_scale < PHYS_C(0.18f)) vy_scale = PHYS_C(0.18f);
+        if (vy_scale > PHYS_C(0.32f)) vy_scale = PHYS_C(0.32f);
     } else {
-        vy_scale = 0.85f + ((float)(rand() % 31) / 100.0f); // Rango 0.85–1.15
+        vy_scale = PHYS_C(0.85f) + PHYS_DIV(PHYS_I(rng_below(&g_rng, 31)), PHYS_C(100.0f)); // Rango 0.85–1.15
     }
-    g_ball_x = (VIDEO_WIDTH - PONG_BALL_SIZE) * 0.5f;
-    g_ball_y = (VIDEO_HEIGHT - PONG_BALL_SIZE) * 0.5f;
+    g_ball_x = PHYS_MUL(PHYS_I(VIDEO_WIDTH - PONG_BALL_SIZE), PHYS_C(0.5f));
+    g_ball_y = PHYS_MUL(PHYS_I(VIDEO_HEIGHT - PONG_BALL_SIZE), PHYS_C(0.5f));
 
     if (scorer > 0) {
         g_ball_vx = -g_ball_base_vx;
@@ -187,9 +190,9 @@ static void pong_reset_ball(int scorer)
     }
 
     if (g_last_scorer >= 0) {
-        g_ball_vy = g_ball_base_vy * vy_scale;
+        g_ball_vy = PHYS_MUL(g_ball_base_vy, vy_scale);
     } else {
-        g_ball_vy = -g_ball_base_vy * vy_scale;
+        g_ball_vy = PHYS_MUL(-g_ball_base_vy, vy_scale);
     }
 
     g_last_scorer = scorer;
@@ -258,30 +261,31 @@ void Pong_Init(const GameSettings *settings)
     } else {
         memset(&g_settings, 0, sizeof(g_settings));
     }
+    rng_seed(&g_rng, g_settings.seed);
 
     pong_select_params(g_settings.difficulty, &g_params);
-    g_params.paddle_speed *= PONG_SPEED_SCALE;
-    g_params.ball_speed_x *= PONG_SPEED_SCALE;
-    g_params.ball_speed_y *= PONG_SPEED_SCALE;
-    g_params.cpu_step *= PONG_SPEED_SCALE;
-    g_params.paddle_speed *= g_settings.speed_multiplier;
-    g_params.cpu_step *= g_settings.speed_multiplier;
-    g_ball_base_vx = g_params.ball_speed_x * g_settings.speed_multiplier;
-    g_ball_base_vy = g_params.ball_speed_y * g_settings.speed_multiplier;
+    g_params.paddle_speed = PHYS_MUL(g_params.paddle_speed, PHYS_C(PONG_SPEED_SCALE));
+    g_params.ball_speed_x = PHYS_MUL(g_params.ball_speed_x, PHYS_C(PONG_SPEED_SCALE));
+    g_params.ball_speed_y = PHYS_MUL(g_params.ball_speed_y, PHYS_C(PONG_SPEED_SCALE));
+    g_params.cpu_step = PHYS_MUL(g_params.cpu_step, PHYS_C(PONG_SPEED_SCALE));
+    g_params.paddle_speed = PHYS_MUL(g_params.paddle_speed, PHYS_F(g_settings.speed_multiplier));
+    g_params.cpu_step = PHYS_MUL(g_params.cpu_step, PHYS_F(g_settings.speed_multiplier));
+    g_ball_base_vx = PHYS_MUL(g_params.ball_speed_x, PHYS_F(g_settings.speed_multiplier));
+    g_ball_base_vy = PHYS_MUL(g_params.ball_speed_y, PHYS_F(g_settings.speed_multiplier));
 
     g_player_score = 0;
     g_cpu_score = 0;
     g_finished = 0;
     g_did_win = 0;
     g_last_scorer = 0;
-    g_cpu_react_cd = 0.0f;
+    g_cpu_react_cd = PHYS_C(0.0f);
     g_initial_serve = 1;
     g_serve_delay_ticks = 0;
     g_start_time_us = timer_now_us();
     g_finish_time_us = g_start_time_us;
     g_final_score = 0;
 
-    g_player_y = (VIDEO_HEIGHT - g_params.paddle_h) * 0.5f;
+    g_player_y = PHYS_MUL(PHYS_I(VIDEO_HEIGHT - g_params.paddle_h), PHYS_C(0.5f));
     g_cpu_y = g_player_y;
     g_player_y_prev = g_player_y;
     g_cpu_y_prev = g_cpu_y;
@@ -314,11 +318,11 @@ void Pong_StorePreviousState(void)
 
 void Pong_Update(void)
 {
-    float ball_center_y;
-    float paddle_center_y;
-    float impact;
-    float target_y;
-    float delta;
+    phys_t ball_center_y;
+    phys_t paddle_center_y;
+    phys_t impact;
+    phys_t target_y;
+    phys_t delta;
 
     if (g_finished) {
         return;
@@ -332,33 +336,33 @@ void Pong_Update(void)
         if (kb_down(SC_UP))   move_dir -= 1;
         if (kb_down(SC_DOWN)) move_dir += 1;
 
-        g_player_y += (float)move_dir * g_params.paddle_speed;
+        g_player_y += PHYS_MUL(PHYS_I(move_dir), g_params.paddle_speed);
     } else {
         int dx = 0;
         int dy = 0;
 
         if (in_joystick_direction(&dx, &dy, NULL)) {
-            g_player_y += (float)dy * g_params.paddle_speed;
+            g_player_y += PHYS_MUL(PHYS_I(dy), g_params.paddle_speed);
         }
     }
 
-    g_player_y = clampf(g_player_y, 0.0f, (float)(VIDEO_HEIGHT - g_params.paddle_h));
+    g_player_y = clamp_phys(g_player_y, PHYS_C(0.0f), PHYS_I(VIDEO_HEIGHT - g_params.paddle_h));
 
     {
         int should_move = 1;
 
         // Enfriamiento de reacción de CPU con fracciones
         {
-            float delay = g_params.cpu_react_delay;
+            phys_t delay = g_params.cpu_react_delay;
 
             // Si la bola se aleja, reacciona más lento
-            if (g_ball_vx < 0.0f && delay > 0.0f) {
-                delay *= 1.6f;
+            if (g_ball_vx < PHYS_C(0.0f) && delay > PHYS_C(0.0f)) {
+                delay = PHYS_MUL(delay, PHYS_C(1.6f));
             }
 
-            if (delay > 0.0f) {
-                if (g_cpu_react_cd > 0.0f) {
-                    g_cpu_react_cd -= 1.0f;
+            if (delay > PHYS_C(0.0f)) {
+                if (g_cpu_react_cd > PHYS_C(0.0f)) {
+                    g_cpu_react_cd -= PHYS_C(1.0f);
                     should_move = 0;
                 } else {
                     g_cpu_react_cd = delay;
@@ -367,29 +371,29 @@ void Pong_Update(void)
         }
 
         if (g_settings.difficulty == DIFFICULTY_HARD) {
-            target_y = g_ball_y - (g_params.paddle_h * 0.5f) + g_params.cpu_error;
-            if (should_move && absf(target_y - g_cpu_y) > g_params.cpu_deadzone) {
-                delta = clampf(target_y - g_cpu_y, -g_params.cpu_step, g_params.cpu_step);
+            target_y = g_ball_y - PHYS_MUL(PHYS_I(g_params.paddle_h), PHYS_C(0.5f)) + g_params.cpu_error;
+            if (should_move && abs_phys(target_y - g_cpu_y) > g_params.cpu_deadzone) {
+                delta = clamp_phys(target_y - g_cpu_y, -g_params.cpu_step, g_params.cpu_step);
                 g_cpu_y += delta;
             }
         } else {
-            float ball_center = g_ball_y + (PONG_BALL_SIZE * 0.5f);
-            float paddle_center = g_cpu_y + (g_params.paddle_h * 0.5f);
-            float target_center = ball_center + g_params.cpu_error;
+            phys_t ball_center = g_ball_y + PHYS_MUL(PHYS_I(PONG_BALL_SIZE), PHYS_C(0.5f));
+            phys_t paddle_center = g_cpu_y + PHYS_MUL(PHYS_I(g_params.paddle_h), PHYS_C(0.5f));
+            phys_t target_center = ball_center + g_params.cpu_error;
 
-            if (g_ball_vx < 0.0f) {
-                target_center = VIDEO_HEIGHT * 0.5f;
+            if (g_ball_vx < PHYS_C(0.0f)) {
+                target_center = PHYS_MUL(PHYS_I(VIDEO_HEIGHT), PHYS_C(0.5f));
             }
 
-            if (should_move && absf(target_center - paddle_center) > g_params.cpu_deadzone) {
-                target_y = target_center - (g_params.paddle_h * 0.5f);
-                delta = clampf(target_y - g_cpu_y, -g_params.cpu_step, g_params.cpu_step);
+            if (should_move && abs_phys(target_center - paddle_center) > g_params.cpu_deadzone) {
+                target_y = target_center - PHYS_MUL(PHYS_I(g_params.paddle_h), PHYS_C(0.5f));
+                delta = clamp_phys(target_y - g_cpu_y, -g_params.cpu_step, g_params.cpu_step);
                 g_cpu_y += delta;
             }
         }
     }
 
-    g_cpu_y = clampf(g_cpu_y, 0.0f, (float)(VIDEO_HEIGHT - g_params.paddle_h));
+    g_cpu_y = clamp_phys(g_cpu_y, PHYS_C(0.0f), PHYS_I(VIDEO_HEIGHT - g_params.paddle_h));
 
     if (g_serve_delay_ticks > 0) {
         g_serve_delay_ticks--;
@@ -399,65 +403,65 @@ void Pong_Update(void)
     g_ball_x += g_ball_vx;
     g_ball_y += g_ball_vy;
 
-    if (g_ball_y <= 0.0f) {
-        g_ball_y = 0.0f;
+    if (g_ball_y <= PHYS_C(0.0f)) {
+        g_ball_y = PHYS_C(0.0f);
         g_ball_vy = -g_ball_vy;
         if (g_sound_enabled) {
             sound_play_tone(320, 35);
         }
-    } else if (g_ball_y >= (VIDEO_HEIGHT - PONG_BALL_SIZE)) {
-        g_ball_y = (float)(VIDEO_HEIGHT - PONG_BALL_SIZE);
+    } else if (g_ball_y >= PHYS_I(VIDEO_HEIGHT - PONG_BALL_SIZE)) {
+        g_ball_y = PHYS_I(VIDEO_HEIGHT - PONG_BALL_SIZE);
         g_ball_vy = -g_ball_vy;
         if (g_sound_enabled) {
             sound_play_tone(320, 35);
         }
     }
 
-    if (g_ball_vx < 0.0f &&
-        g_ball_x <= (PONG_LEFT_X + PONG_PADDLE_W) &&
-        (g_ball_x + PONG_BALL_SIZE) >= PONG_LEFT_X) {
-        int paddle_y = (int)g_player_y;
-        int ball_y = (int)g_ball_y;
+    if (g_ball_vx < PHYS_C(0.0f) &&
+        g_ball_x <= PHYS_I(PONG_LEFT_X + PONG_PADDLE_W) &&
+        (g_ball_x + PHYS_I(PONG_BALL_SIZE)) >= PHYS_I(PONG_LEFT_X)) {
+        int paddle_y = PHYS_INT(g_player_y);
+        int ball_y = PHYS_INT(g_ball_y);
 
         if ((ball_y + PONG_BALL_SIZE - 1) >= paddle_y &&
             ball_y <= (paddle_y + g_params.paddle_h - 1)) {
-            g_ball_x = (float)(PONG_LEFT_X + PONG_PADDLE_W + 1);
+            g_ball_x = PHYS_I(PONG_LEFT_X + PONG_PADDLE_W + 1);
             g_ball_vx = -g_ball_vx;
             if (g_sound_enabled) {
                 sound_play_tone(440, 45);
             }
 
-            ball_center_y = g_ball_y + (PONG_BALL_SIZE * 0.5f);
-            paddle_center_y = g_player_y + (g_params.paddle_h * 0.5f);
-            impact = (ball_center_y - paddle_center_y) / (g_params.paddle_h * 0.5f);
-            impact = clampf(impact, -1.0f, 1.0f);
-            g_ball_vy = impact * g_ball_base_vy;
+            ball_center_y = g_ball_y + PHYS_MUL(PHYS_I(PONG_BALL_SIZE), PHYS_C(0.5f));
+            paddle_center_y = g_player_y + PHYS_MUL(PHYS_I(g_params.paddle_h), PHYS_C(0.5f));
+            impact = PHYS_DIV(ball_center_y - paddle_center_y, PHYS_MUL(PHYS_I(g_params.paddle_h), PHYS_C(0.5f)));
+            impact = clamp_phys(impact, PHYS_C(-1.0f), PHYS_C(1.0f));
+            g_ball_vy = PHYS_MUL(impact, g_ball_base_vy);
         }
     }
 
-    if (g_ball_vx > 0.0f &&
-        (g_ball_x + PONG_BALL_SIZE) >= PONG_RIGHT_X &&
-        g_ball_x <= (PONG_RIGHT_X + PONG_PADDLE_W)) {
-        int paddle_y = (int)g_cpu_y;
-        int ball_y = (int)g_ball_y;
+    if (g_ball_vx > PHYS_C(0.0f) &&
+        (g_ball_x + PHYS_I(PONG_BALL_SIZE)) >= PHYS_I(PONG_RIGHT_X) &&
+        g_ball_x <= PHYS_I(PONG_RIGHT_X + PONG_PADDLE_W)) {
+        int paddle_y = PHYS_INT(g_cpu_y);
+        int ball_y = PHYS_INT(g_ball_y);
 
         if ((ball_y + PONG_BALL_SIZE - 1) >= paddle_y &&
             ball_y <= (paddle_y + g_params.paddle_h - 1)) {
-            g_ball_x = (float)(PONG_RIGHT_X - PONG_BALL_SIZE - 1);
+            g_ball_x = PHYS_I(PONG_RIGHT_X - PONG_BALL_SIZE - 1);
             g_ball_vx = -g_ball_vx;
             if (g_sound_enabled) {
                 sound_play_tone(380, 45);
             }
 
-            ball_center_y = g_ball_y + (PONG_BALL_SIZE * 0.5f);
-            paddle_center_y = g_cpu_y + (g_params.paddle_h * 0.5f);
-            impact = (ball_center_y - paddle_center_y) / (g_params.paddle_h * 0.5f);
-            impact = clampf(impact, -1.0f, 1.0f);
-            g_ball_vy = impact * g_ball_base_vy;
+            ball_center_y = g_ball_y + PHYS_MUL(PHYS_I(PONG_BALL_SIZE), PHYS_C(0.5f));
+            paddle_center_y = g_cpu_y + PHYS_MUL(PHYS_I(g_params.paddle_h), PHYS_C(0.5f));
+            impact = PHYS_DIV(ball_center_y - paddle_center_y, PHYS_MUL(PHYS_I(g_params.paddle_h), PHYS_C(0.5f)));
+            impact = clamp_phys(impact, PHYS_C(-1.0f), PHYS_C(1.0f));
+            g_ball_vy = PHYS_MUL(impact, g_ball_base_vy);
         }
     }
 
-    if (g_ball_x < -PONG_BALL_SIZE) {
+    if (g_ball_x < PHYS_I(-PONG_BALL_SIZE)) {
         g_cpu_score++;
         if (g_sound_enabled) {
             sound_play_tone(260, 80);
@@ -469,7 +473,7 @@ void Pong_Update(void)
             return;
         }
         pong_reset_ball(-1);
-    } else if (g_ball_x > VIDEO_WIDTH) {
+    } else if (g_ball_x > PHYS_I(VIDEO_WIDTH)) {
         g_player_score++;
         if (g_sound_enabled) {
             sound_play_tone(520, 80);
@@ -488,16 +492,17 @@ void Pong_DrawInterpolated(float alpha)
 {
     char hud[64];
     char score[32];
-    float player_y = g_player_y_prev + (g_player_y - g_player_y_prev) * alpha;
-    float cpu_y = g_cpu_y_prev + (g_cpu_y - g_cpu_y_prev) * alpha;
-    float ball_x = g_ball_x_prev + (g_ball_x - g_ball_x_prev) * alpha;
-    float ball_y = g_ball_y_prev + (g_ball_y - g_ball_y_prev) * alpha;
+    phys_t t = PHYS_F(alpha);
+    phys_t player_y = PHYS_LERP(g_player_y_prev, g_player_y, t);
+    phys_t cpu_y = PHYS_LERP(g_cpu_y_prev, g_cpu_y, t);
+    phys_t ball_x = PHYS_LERP(g_ball_x_prev, g_ball_x, t);
+    phys_t ball_y = PHYS_LERP(g_ball_y_prev, g_ball_y, t);
 
     v_clear(0);
 
-    pong_draw_player_paddle(PONG_LEFT_X, (int)player_y, PONG_PADDLE_W, g_params.paddle_h);
-    pong_draw_rect(PONG_RIGHT_X, (int)cpu_y, PONG_PADDLE_W, g_params.paddle_h, 15);
-    pong_draw_rect((int)ball_x, (int)ball_y, PONG_BALL_SIZE, PONG_BALL_SIZE, 12);
+    pong_draw_player_paddle(PONG_LEFT_X, PHYS_INT(player_y), PONG_PADDLE_W, g_params.paddle_h);
+    pong_draw_rect(PONG_RIGHT_X, PHYS_INT(cpu_y), PONG_PADDLE_W, g_params.paddle_h, 15);
+    pong_draw_rect(PHYS_INT(ball_x), PHYS_INT(ball_y), PONG_BALL_SIZE, PONG_BALL_SIZE, 12);
 
     snprintf(hud, sizeof(hud), "D:%s x%.2f", difficulty_short(g_settings.difficulty), g_settings.speed_multiplier);
     v_puts(0, 0, "1972", 7);
@@ -540,3 +545,24 @@ uint64_t Pong_GetScore(void)
 {
     return g_final_score;
 }
+
+void Pong_DemoInput(unsigned char *keys)
+{
+    // Sigue la bola si viene, si no vuelve al centro. Le da con un extremo de la pala
+    // para mandarla hacia el lado con más sitio; al centro, la CPU la devuelve siempre.
+    phys_t center = g_player_y + PHYS_MUL(PHYS_I(g_params.paddle_h), PHYS_C(0.5f));
+    phys_t target = PHYS_MUL(PHYS_I(VIDEO_HEIGHT), PHYS_C(0.5f));
+
+    if (g_ball_vx < PHYS_C(0.0f)) {
+        phys_t ball_center = g_ball_y + PHYS_MUL(PHYS_I(PONG_BALL_SIZE), PHYS_C(0.5f));
+        phys_t edge = PHYS_DIV(PHYS_I(g_params.paddle_h), PHYS_C(3.0f));
+
+        target = (ball_center < target) ? ball_center - edge : ball_center + edge;
+    }
+
+    if (target < center - g_params.paddle_speed) {
+        kb_snapshot_press(keys, SC_UP);
+    } else if (target > center + g_params.paddle_speed) {
+        kb_snapshot_press(keys, SC_DOWN);
+    }
+}
@@ -13,5 +13,7 @@ int Pong_IsFinished(void);
 int Pong_DidWin(void);
 const char *Pong_GetEndDetail(void);
 uint64_t Pong_GetScore(void);
+// Demo: teclas del jugador que pondría la IA
+void Pong_DemoInput(unsigned char *keys);
 
 #endif
@@ -1,7 +1,9 @@
 #include "tapp.h"
 
+#include "../../CORE/fixed.h"
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
+#include "../../CORE/rng.h"
 #include "../../CORE/sound.h"
 #include "../../CORE/video.h"
 #include "../../CORE/sprite_dat.h"
@@ -12,7 +14,6 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
-#include <math.h>
 #include <malloc.h>
 #include <memory.h>
 
@@ -77,10 +78,10 @@ typedef struct {
     int max_customers_per_bar;
     int max_beers_in_flight_per_bar;
     int spawn_interval_ticks;
-    float customer_speed;
-    float beer_speed;
-    float mug_speed;
-    float bartender_speed;
+    phys_t customer_speed;
+    phys_t beer_speed;
+    phys_t mug_speed;
+    phys_t bartender_speed;
     int serve_anim_ticks;
     int pickup_anim_ticks;
     int danger_dist_px;
@@ -101,6 +102,7 @@ typedef struct {
     unsigned short h;
     unsigned long max_pixels;
     unsigned char far *pixels;
+    SpanSprite spans;
 } TapSprite;
 
 typedef enum {
@@ -110,15 +112,15 @@ typedef enum {
 } TapCustomerState;
 
 typedef struct {
-    float x;
-    float x_prev;
+    phys_t x;
+    phys_t x_prev;
     TapCustomerState state;
     unsigned char skin;
 } TapCustomer;
 
 typedef struct {
-    float x;
-    float x_prev;
+    phys_t x;
+    phys_t x_prev;
     int active;
 } TapProjectile;
 
@@ -131,6 +133,7 @@ typedef enum {
 static const int g_bar_y[TAP_BAR_COUNT] = {132, 96, 60};
 
 static GameSettings g_settings;
+static Rng g_rng;
 static TapParams g_params;
 static TapSpawnParams g_spawn_params;
 static int g_finished = 0;
@@ -138,15 +141,17 @@ static int g_did_win = 0;
 static int g_sound_enabled = 0;
 static int g_use_keyboard = 1;
 
-static TapSprite g_bar1 = {0, 0, TAP_BAR_W * TAP_BAR_H, NULL};
-static TapSprite g_bart1 = {0, 0, TAP_BART_W * TAP_BART_H, NULL};
-static TapSprite g_bart2 = {0, 0, TAP_BART_W * TAP_BART_H, NULL};
-static TapSprite g_bart3 = {0, 0, TAP_BART_W * TAP_BART_H, NULL};
-static TapSprite g_cust1 = {0, 0, TAP_CUST_W * TAP_CUST_H, NULL};
-static TapSprite g_cust2 = {0, 0, TAP_CUST_W * TAP_CUST_H, NULL};
-static TapSprite g_cust3 = {0, 0, TAP_CUST_W * TAP_CUST_H, NULL};
-static TapSprite g_beer1 = {0, 0, TAP_BEER_W * TAP_BEER_H, NULL};
-static TapSprite g_mug1 = {0, 0, TAP_MUG_W * TAP_MUG_H, NULL};
+static TapSprite g_bar1 = {0, 0, TAP_BAR_W * TAP_BAR_H, NULL, {0}};
+static TapSprite g_bart1 = {0, 0, TAP_BART_W * TAP_BART_H, NULL, {0}};
+static TapSprite g_bart2 = {0, 0, TAP_BART_W * TAP_BART_H, NULL, {0}};
+static TapSprite g_bart3 = {0, 0, TAP_BART_W * TAP_BART_H, NULL, {0}};
+static TapSprite g_cust1 = {0, 0, TAP_CUST_W * TAP_CUST_H, NULL, {0}};
+static TapSprite g_cust2 = {0, 0, TAP_CUST_W * TAP_CUST_H, NULL, {0}};
+static TapSprite g_cust3 = {0, 0, TAP_CUST_W * TAP_CUST_H, NULL, {0}};
+static TapSprite g_beer1 = {0, 0, TAP_BEER_W * TAP_BEER_H, NULL, {0}};
+static TapSprite g_mug1 = {0, 0, TAP_MUG_W * TAP_MUG_H, NULL, {0}};
+static Surface g_bg_layer;
+static int g_bg_ready = 0;
 static int g_sprites_loaded = 0;
 static int g_sprite_load_failed = 0;
 static char g_sprite_fail_name[32] = {0};
@@ -155,8 +160,8 @@ static TapCustomer g_customers[TAP_BAR_COUNT][TAP_MAX_CUSTOMERS_PER_BAR];
 static TapProjectile g_beers[TAP_BAR_COUNT][TAP_MAX_BEERS_PER_BAR];
 static TapProjectile g_mugs[TAP_BAR_COUNT][TAP_MAX_MUGS_PER_BAR];
 
-static float g_bartender_x = 0.0f;
-static float g_bartender_x_prev = 0.0f;
+static phys_t g_bartender_x = PHYS_C(0.0f);
+static phys_t g_bartender_x_prev = PHYS_C(0.0f);
 static int g_bart_move_dir = 0;
 static int g_active_bar = 0;
 static TapBartState g_bart_state = TAP_BART_IDLE;
@@ -171,7 +176,7 @@ static char g_last_fail_reason[32] = "";
 static int g_action_held = 0;
 static int g_bar_switch_held = 0;
 
-static float clampf(float value, float min_value, float max_value)
+static phys_t clamp_phys(phys_t value, phys_t min_value, phys_t max_value)
 {
     if (value < min_value) {
         return min_value;
@@ -193,9 +198,9 @@ static int clampi(int value, int min_value, int max_value)
     return value;
 }
 
-static float absf(float value)
+static phys_t abs_phys(phys_t value)
 {
-    return value < 0.0f ? -value : value;
+    return value < PHYS_C(0.0f) ? -value : value;
 }
 
 static void tapper_draw_background(void)
@@ -232,13 +237,30 @@ static void tapper_draw_background(void)
     }
 }
 
-static int lerp_int(int a, int b, float t)
+// Decorado estático: se pinta una vez en una capa y se copia cada frame
+static void tapper_draw_background_layer(void)
 {
-    float value = (float)a + ((float)(b - a) * t);
-    if (value >= 0.0f) {
-        return (int)(value + 0.5f);
+    if (!g_bg_ready) {
+        if (!g_bg_layer.pixels && !v_surface_alloc(&g_bg_layer, VIDEO_WIDTH, VIDEO_HEIGHT)) {
+            tapper_draw_background();
+            return;
+        }
+        v_set_target(&g_bg_layer);
+        tapper_draw_background();
+        v_set_target(NULL);
+        g_bg_ready = 1;
     }
-    return (int)(value - 0.5f);
+
+    v_surf_blit(v_surface_screen(), 0, 0, &g_bg_layer, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+}
+
+static int lerp_int(int a, int b, phys_t t)
+{
+    phys_t value = PHYS_I(a) + PHYS_MUL(PHYS_I(b - a), t);
+    if (value >= PHYS_C(0.0f)) {
+        return PHYS_INT(value + PHYS_C(0.5f));
+    }
+    return PHYS_INT(value - PHYS_C(0.5f));
 }
 
 static int text_len(const char *text)
@@ -281,10 +303,10 @@ static void tap_select_params(unsigned char difficulty, TapParams *params)
         params->max_customers_per_bar = 2;
         params->max_beers_in_flight_per_bar = 1;
         params->spawn_interval_ticks = 90;
-        params->customer_speed = 0.25f;
-        params->beer_speed = 1.25f;
-        params->mug_speed = 0.65f;
-        params->bartender_speed = 1.35f;
+        params->customer_speed = PHYS_C(0.25f);
+        params->beer_speed = PHYS_C(1.25f);
+        params->mug_speed = PHYS_C(0.65f);
+        params->bartender_speed = PHYS_C(1.35f);
         params->serve_anim_ticks = 6;
         params->pickup_anim_ticks = 6;
         params->danger_dist_px = 18;
@@ -301,10 +323,10 @@ static void tap_select_params(unsigned char difficulty, TapParams *params)
         params->max_customers_per_bar = 4;
         params->max_beers_in_flight_per_bar = 2;
         params->spawn_interval_ticks = 55;
-        params->customer_speed = 0.38f;
-        params->beer_speed = 1.55f;
-        params->mug_speed = 0.90f;
-        params->bartender_speed = 1.70f;
+        params->customer_speed = PHYS_C(0.38f);
+        params->beer_speed = PHYS_C(1.55f);
+        params->mug_speed = PHYS_C(0.90f);
+        params->bartender_speed = PHYS_C(1.70f);
         params->serve_anim_ticks = 5;
         params->pickup_anim_ticks = 5;
         params->danger_dist_px = 24;
@@ -322,10 +344,10 @@ static void tap_select_params(unsigned char difficulty, TapParams *params)
         params->max_customers_per_bar = 3;
         params->max_beers_in_flight_per_bar = 1;
         params->spawn_interval_ticks = 70;
-        params->customer_speed = 0.30f;
-        params->beer_speed = 1.35f;
-        params->mug_speed = 0.75f;
-        params->bartender_speed = 1.50f;
+        params->customer_speed = PHYS_C(0.30f);
+        params->beer_speed = PHYS_C(1.35f);
+        params->mug_speed = PHYS_C(0.75f);
+        params->bartender_speed = PHYS_C(1.50f);
         params->serve_anim_ticks = 6;
         params->pickup_anim_ticks = 6;
         params->danger_dist_px = 20;
@@ -339,10 +361,10 @@ static void tap_select_params(unsigned char difficulty, TapParams *params)
         break;
     }
 
-    params->customer_speed *= TAP_SPEED_GLOBAL;
-    params->beer_speed *= TAP_SPEED_GLOBAL;
-    params->mug_speed *= TAP_SPEED_GLOBAL;
-    params->bartender_speed *= TAP_SPEED_GLOBAL;
+    params->customer_speed = PHYS_MUL(params->customer_speed, PHYS_C(TAP_SPEED_GLOBAL));
+    params->beer_speed = PHYS_MUL(params->beer_speed, PHYS_C(TAP_SPEED_GLOBAL));
+    params->mug_speed = PHYS_MUL(params->mug_speed, PHYS_C(TAP_SPEED_GLOBAL));
+    params->bartender_speed = PHYS_MUL(params->bartender_speed, PHYS_C(TAP_SPEED_GLOBAL));
 }
 
 static int tap_alloc_sprite(TapSprite *sprite)
@@ -361,7 +383,11 @@ static int tap_alloc_sprite(TapSprite *sprite)
 
 static void tap_free_sprite(TapSprite *sprite)
 {
-    if (!sprite || !sprite->pixels) {
+    if (!sprite) {
+        return;
+    }
+    v_sprite_spans_free(&sprite->spans);
+    if (!sprite->pixels) {
         return;
     }
 
@@ -504,6 +530,8 @@ static int tap_load_sprite(const char *path, TapSprite *sprite)
     fclose(file);
     sprite->w = w;
     sprite->h = h;
+
+    v_sprite_spans_build(&sprite->spans, sprite->w, sprite->h, sprite->pixels, 0);
     return 1;
 }
 
@@ -582,6 +610,10 @@ static void tap_blit_sprite(int x, int y, const TapSprite *sprite)
         return;
     }
 
+    if (sprite->spans.data) {
+        v_blit_sprite_spans(x, y, &sprite->spans);
+        return;
+    }
     v_blit_sprite(x, y, sprite->w, sprite->h, sprite->pixels, 0);
 }
 
@@ -668,7 +700,7 @@ static void tap_blit_sprite_rows(int x, int y, const TapSprite *sprite, int src_
     }
 }
 
-static void tap_draw_placeholder(float alpha, float bartender_x, TapBartState bart_state)
+static void tap_draw_placeholder(phys_t t, int bartender_x, TapBartState bart_state)
 {
     int bar;
     int i;
@@ -686,16 +718,16 @@ static void tap_draw_placeholder(float alpha, float bartender_x, TapBartState ba
                 continue;
             }
             {
-                float cx = cust->x_prev + (cust->x - cust->x_prev) * alpha;
+                int cx = PHYS_INT(PHYS_LERP(cust->x_prev, cust->x, t));
                 unsigned char color = 10;
                 if (cust->state == TAP_CUSTOMER_RETURN) {
                     color = 12;
                 } else if (cust->state == TAP_CUSTOMER_ADVANCE) {
-                    if (cust->x <= (float)(TAP_FAIL_LINE + g_params.danger_dist_px)) {
+                    if (cust->x <= PHYS_I(TAP_FAIL_LINE + g_params.danger_dist_px)) {
                         color = 4;
                     }
                 }
-                v_fill_rect((int)cx, y_customer, TAP_CUST_W, TAP_CUST_H, color);
+                v_fill_rect(cx, y_customer, TAP_CUST_W, TAP_CUST_H, color);
             }
         }
 
@@ -707,7 +739,7 @@ static void tap_draw_placeholder(float alpha, float bartender_x, TapBartState ba
             } else if (bart_state == TAP_BART_PICKUP) {
                 color = 7;
             }
-            v_fill_rect((int)bartender_x, y_bart, TAP_BART_W, TAP_BART_H, color);
+            v_fill_rect(bartender_x, y_bart, TAP_BART_W, TAP_BART_H, color);
         }
 
         v_fill_rect(TAP_BAR_X, g_bar_y[bar] + TAP_BAR_BACK_ROWS, TAP_BAR_W, TAP_BAR_H - TAP_BAR_BACK_ROWS, 6);
@@ -721,8 +753,8 @@ static void tap_draw_placeholder(float alpha, float bartender_x, TapBartState ba
                 continue;
             }
             {
-                float bx = beer->x_prev + (beer->x - beer->x_prev) * alpha;
-                v_fill_rect((int)bx, y_surface, TAP_BEER_W, TAP_BEER_H, 11);
+                int bx = PHYS_INT(PHYS_LERP(beer->x_prev, beer->x, t));
+                v_fill_rect(bx, y_surface, TAP_BEER_W, TAP_BEER_H, 11);
             }
         }
         for (i = 0; i < TAP_MAX_MUGS_PER_BAR; ++i) {
@@ -731,8 +763,8 @@ static void tap_draw_placeholder(float alpha, float bartender_x, TapBartState ba
                 continue;
             }
             {
-                float mx = mug->x_prev + (mug->x - mug->x_prev) * alpha;
-                v_fill_rect((int)mx, y_surface, TAP_MUG_W, TAP_MUG_H, 7);
+                int mx = PHYS_INT(PHYS_LERP(mug->x_prev, mug->x, t));
+                v_fill_rect(mx, y_surface, TAP_MUG_W, TAP_MUG_H, 7);
             }
         }
     }
@@ -745,10 +777,10 @@ static int tap_spawn_customer(int bar)
     for (i = 0; i < TAP_MAX_CUSTOMERS_PER_BAR; ++i) {
         TapCustomer *cust = &g_customers[bar][i];
         if (cust->state == TAP_CUSTOMER_NONE) {
-            cust->x = (float)(TAP_X_RIGHT - TAP_CUST_W);
+            cust->x = PHYS_I(TAP_X_RIGHT - TAP_CUST_W);
             cust->x_prev = cust->x;
             cust->state = TAP_CUSTOMER_ADVANCE;
-            cust->skin = (unsigned char)(rand() % 3);
+            cust->skin = (unsigned char)rng_below(&g_rng, 3);
             return 1;
         }
     }
@@ -756,7 +788,7 @@ static int tap_spawn_customer(int bar)
     return 0;
 }
 
-static int tap_lane_has_space(int bar, float spawn_x, int guard_dist)
+static int tap_lane_has_space(int bar, phys_t spawn_x, int guard_dist)
 {
     int i;
 
@@ -765,7 +797,7 @@ static int tap_lane_has_space(int bar, float spawn_x, int guard_dist)
         if (cust->state == TAP_CUSTOMER_NONE) {
             continue;
         }
-        if (absf(cust->x - spawn_x) < (float)guard_dist) {
+        if (abs_phys(cust->x - spawn_x) < PHYS_I(guard_dist)) {
             return 0;
         }
     }
@@ -777,10 +809,10 @@ static int tap_try_spawn_customer(int guard_dist, int retry_limit)
 {
     int attempts = retry_limit > 0 ? retry_limit : 1;
     int i;
-    float spawn_x = (float)(TAP_X_RIGHT - TAP_CUST_W);
+    phys_t spawn_x = PHYS_I(TAP_X_RIGHT - TAP_CUST_W);
 
     for (i = 0; i < attempts; ++i) {
-        int bar = rand() % TAP_BAR_COUNT;
+        int bar = rng_below(&g_rng, TAP_BAR_COUNT);
         if (!tap_lane_has_space(bar, spawn_x, guard_dist)) {
             continue;
         }
@@ -792,10 +824,10 @@ static int tap_try_spawn_customer(int guard_dist, int retry_limit)
     return 0;
 }
 
-static int tap_spawn_beer(int bar, float bartender_x)
+static int tap_spawn_beer(int bar, phys_t bartender_x)
 {
     int i;
-    float start_x = bartender_x + (TAP_BART_W * 0.5f) - (TAP_BEER_W * 0.5f);
+    phys_t start_x = bartender_x + PHYS_RATIO(TAP_BART_W, 2) - PHYS_RATIO(TAP_BEER_W, 2);
 
     for (i = 0; i < TAP_MAX_BEERS_PER_BAR; ++i) {
         TapProjectile *beer = &g_beers[bar][i];
@@ -810,7 +842,7 @@ static int tap_spawn_beer(int bar, float bartender_x)
     return 0;
 }
 
-static int tap_spawn_mug(int bar, float start_x)
+static int tap_spawn_mug(int bar, phys_t start_x)
 {
     int i;
 
@@ -827,17 +859,17 @@ static int tap_spawn_mug(int bar, float start_x)
     return 0;
 }
 
-static int tap_pickup_mug(int bar, float bartender_x)
+static int tap_pickup_mug(int bar, phys_t bartender_x)
 {
     int i;
 
     for (i = 0; i < TAP_MAX_MUGS_PER_BAR; ++i) {
         TapProjectile *mug = &g_mugs[bar][i];
         if (mug->active) {
-            float bart_left = bartender_x - TAP_MUG_PICKUP_DISTANCE;
-            float bart_right = bartender_x + TAP_BART_W + TAP_MUG_PICKUP_DISTANCE;
-            float mug_left = mug->x;
-            float mug_right = mug->x + TAP_MUG_W;
+            phys_t bart_left = bartender_x - PHYS_C(TAP_MUG_PICKUP_DISTANCE);
+            phys_t bart_right = bartender_x + PHYS_I(TAP_BART_W) + PHYS_C(TAP_MUG_PICKUP_DISTANCE);
+            phys_t mug_left = mug->x;
+            phys_t mug_right = mug->x + PHYS_I(TAP_MUG_W);
             if (mug_left <= bart_right && mug_right >= bart_left) {
                 mug->active = 0;
                 return 1;
@@ -867,12 +899,17 @@ void Tapp_Init(const GameSettings *settings)
     } else {
         memset(&g_settings, 0, sizeof(g_settings));
     }
+    rng_seed(&g_rng, g_settings.seed);
 
     tap_select_params(g_settings.difficulty, &g_params);
-    g_params.customer_speed *= g_settings.speed_multiplier;
-    g_params.beer_speed *= g_settings.speed_multiplier;
-    g_params.mug_speed *= g_settings.speed_multiplier;
-    g_params.bartender_speed *= g_settings.speed_multiplier;
+    {
+        phys_t mul = PHYS_F(g_settings.speed_multiplier);
+
+        g_params.customer_speed = PHYS_MUL(g_params.customer_speed, mul);
+    g_params.beer_speed = PHYS_MUL(g_params.beer_speed, mul);
+    g_params.mug_speed = PHYS_MUL(g_params.mug_speed, mul);
+        g_params.bartender_speed = PHYS_MUL(g_params.bartender_speed, mul);
+    }
 
     tap_load_sprites();
     if (!g_sprites_loaded) {
@@ -889,7 +926,7 @@ void Tapp_Init(const GameSettings *settings)
         }
     }
 
-    g_bartender_x = (float)TAP_BART_X_MIN;
+    g_bartender_x = PHYS_I(TAP_BART_X_MIN);
     g_bartender_x_prev = g_bartender_x;
     g_bart_move_dir = 0;
     g_active_bar = 0;
@@ -908,19 +945,19 @@ void Tapp_Init(const GameSettings *settings)
     for (bar = 0; bar < TAP_BAR_COUNT; ++bar) {
         for (i = 0; i < TAP_MAX_CUSTOMERS_PER_BAR; ++i) {
             g_customers[bar][i].state = TAP_CUSTOMER_NONE;
-            g_customers[bar][i].x = 0.0f;
-            g_customers[bar][i].x_prev = 0.0f;
+            g_customers[bar][i].x = PHYS_C(0.0f);
+            g_customers[bar][i].x_prev = PHYS_C(0.0f);
             g_customers[bar][i].skin = 0;
         }
         for (i = 0; i < TAP_MAX_BEERS_PER_BAR; ++i) {
             g_beers[bar][i].active = 0;
-            g_beers[bar][i].x = 0.0f;
-            g_beers[bar][i].x_prev = 0.0f;
+            g_beers[bar][i].x = PHYS_C(0.0f);
+            g_beers[bar][i].x_prev = PHYS_C(0.0f);
         }
         for (i = 0; i < TAP_MAX_MUGS_PER_BAR; ++i) {
             g_mugs[bar][i].active = 0;
-            g_mugs[bar][i].x = 0.0f;
-            g_mugs[bar][i].x_prev = 0.0f;
+            g_mugs[bar][i].x = PHYS_C(0.0f);
+            g_mugs[bar][i].x_prev = PHYS_C(0.0f);
         }
     }
 
@@ -1015,8 +1052,8 @@ void Tapp_Update(void)
         g_bar_switch_held = 0;
     }
 
-    g_bartender_x += (float)move_dir * g_params.bartender_speed;
-    g_bartender_x = clampf(g_bartender_x, (float)TAP_BART_X_MIN, (float)TAP_BART_X_MAX);
+    g_bartender_x += PHYS_MUL(PHYS_I(move_dir), g_params.bartender_speed);
+    g_bartender_x = clamp_phys(g_bartender_x, PHYS_I(TAP_BART_X_MIN), PHYS_I(TAP_BART_X_MAX));
     g_bart_move_dir = move_dir;
 
     if (g_bart_anim_ticks > 0) {
@@ -1037,7 +1074,7 @@ void Tapp_Update(void)
             }
         }
         if (action_pressed && !picked) {
-            if (g_bartender_x <= (float)TAP_BART_X_MIN + TAP_SERVE_X_TOLERANCE) {
+            if (g_bartender_x <= PHYS_I(TAP_BART_X_MIN) + PHYS_C(TAP_SERVE_X_TOLERANCE)) {
                 if (tap_spawn_beer(g_active_bar, g_bartender_x)) {
                     g_bart_state = TAP_BART_SERVE;
                     g_bart_anim_ticks = g_params.serve_anim_ticks;
@@ -1058,7 +1095,7 @@ void Tapp_Update(void)
     }
 
     {
-        float ramp_progress = 1.0f;
+        phys_t ramp_progress = PHYS_C(1.0f);
         int current_max_clients;
         int current_spawn_delay;
         int max_min = g_spawn_params.max_clients_initial;
@@ -1067,7 +1104,8 @@ void Tapp_Update(void)
         int delay_max = g_spawn_params.spawn_initial_delay_ticks;
 
         if (g_spawn_params.spawn_ramp_duration_ticks > 0) {
-            ramp_progress = clampf((float)g_survived_ticks / (float)g_spawn_params.spawn_ramp_duration_ticks, 0.0f, 1.0f);
+            ramp_progress = clamp_phys(PHYS_RATIO(g_survived_ticks, g_spawn_params.spawn_ramp_duration_ticks),
+                                       PHYS_C(0.0f), PHYS_C(1.0f));
         }
 
         current_max_clients = lerp_int(g_spawn_params.max_clients_initial, g_spawn_params.max_clients_final, ramp_progress);
@@ -1107,13 +1145,13 @@ void Tapp_Update(void)
             TapCustomer *cust = &g_customers[bar][i];
             if (cust->state == TAP_CUSTOMER_ADVANCE) {
                 cust->x -= g_params.customer_speed;
-                if (cust->x <= (float)TAP_FAIL_LINE) {
+                if (cust->x <= PHYS_I(TAP_FAIL_LINE)) {
                     tap_fail("CLIENTE");
                     return;
                 }
             } else if (cust->state == TAP_CUSTOMER_RETURN) {
                 cust->x += g_params.customer_speed;
-                if (cust->x >= (float)(TAP_X_RIGHT - TAP_CUST_W)) {
+                if (cust->x >= PHYS_I(TAP_X_RIGHT - TAP_CUST_W)) {
                     cust->state = TAP_CUSTOMER_NONE;
                 }
             }
@@ -1125,7 +1163,7 @@ void Tapp_Update(void)
                 continue;
             }
             beer->x += g_params.beer_speed;
-            if (beer->x > (float)TAP_X_RIGHT) {
+            if (beer->x > PHYS_I(TAP_X_RIGHT)) {
                 beer->active = 0;
                 tap_fail("JARRA");
                 return;
@@ -1138,9 +1176,9 @@ void Tapp_Update(void)
                     if (cust->state != TAP_CUSTOMER_ADVANCE) {
                         continue;
                     }
-                    if ((beer->x + TAP_BEER_W) >= cust->x && beer->x <= (cust->x + TAP_CUST_W)) {
+                    if ((beer->x + PHYS_I(TAP_BEER_W)) >= cust->x && beer->x <= (cust->x + PHYS_I(TAP_CUST_W))) {
                         cust->state = TAP_CUSTOMER_RETURN;
-                        tap_spawn_mug(bar, cust->x + (TAP_CUST_W * 0.5f) - (TAP_MUG_W * 0.5f));
+                        tap_spawn_mug(bar, cust->x + PHYS_RATIO(TAP_CUST_W, 2) - PHYS_RATIO(TAP_MUG_W, 2));
                         beer->active = 0;
                         g_score += TAP_SCORE_SERVE;
                         if (g_sound_enabled) {
@@ -1158,7 +1196,7 @@ void Tapp_Update(void)
                 continue;
             }
             mug->x -= g_params.mug_speed;
-            if (mug->x < (float)(TAP_X_LEFT - TAP_MUG_W)) {
+            if (mug->x < PHYS_I(TAP_X_LEFT - TAP_MUG_W)) {
                 tap_fail("VASO");
                 return;
             }
@@ -1182,13 +1220,14 @@ void Tapp_DrawInterpolated(float alpha)
     char score_text[24];
     int bar;
     int i;
-    float bartender_x = g_bartender_x_prev + (g_bartender_x - g_bartender_x_prev) * alpha;
+    phys_t t = PHYS_F(alpha);
+    int bartender_x = PHYS_INT(PHYS_LERP(g_bartender_x_prev, g_bartender_x, t));
     TapBartState bart_state = g_bart_state;
 
-    tapper_draw_background();
+    tapper_draw_background_layer();
 
     if (!g_sprites_loaded) {
-        tap_draw_placeholder(alpha, bartender_x, bart_state);
+        tap_draw_placeholder(t, bartender_x, bart_state);
         if (g_sprite_load_failed) {
             v_puts(4, 4, "TAPPER: sprites NOT loaded", 15);
             if (g_sprite_fail_name[0] != '\0') {
@@ -1210,12 +1249,12 @@ void Tapp_DrawInterpolated(float alpha)
                     continue;
                 }
                 {
-                    float cx = cust->x_prev + (cust->x - cust->x_prev) * alpha;
+                    int cx = PHYS_INT(PHYS_LERP(cust->x_prev, cust->x, t));
                     const TapSprite *sprite = tap_customer_sprite(cust->skin);
                     if (cust->state == TAP_CUSTOMER_RETURN) {
-                        tap_blit_sprite_flipped((int)cx, y_customer, sprite);
+                        tap_blit_sprite_flipped(cx, y_customer, sprite);
                     } else {
-                        tap_blit_sprite((int)cx, y_customer, sprite);
+                        tap_blit_sprite(cx, y_customer, sprite);
                     }
                 }
             }
@@ -1233,9 +1272,9 @@ void Tapp_DrawInterpolated(float alpha)
                     }
                 }
                 if (flip) {
-                    tap_blit_sprite_flipped((int)bartender_x, y_bart, sprite);
+                    tap_blit_sprite_flipped(bartender_x, y_bart, sprite);
                 } else {
-                    tap_blit_sprite((int)bartender_x, y_bart, sprite);
+                    tap_blit_sprite(bartender_x, y_bart, sprite);
                 }
             }
 
@@ -1251,8 +1290,8 @@ void Tapp_DrawInterpolated(float alpha)
                     continue;
                 }
                 {
-                    float bx = beer->x_prev + (beer->x - beer->x_prev) * alpha;
-                    tap_blit_sprite((int)bx, y_surface, &g_beer1);
+                    int bx = PHYS_INT(PHYS_LERP(beer->x_prev, beer->x, t));
+                    tap_blit_sprite(bx, y_surface, &g_beer1);
                 }
             }
             for (i = 0; i < TAP_MAX_MUGS_PER_BAR; ++i) {
@@ -1261,8 +1300,8 @@ void Tapp_DrawInterpolated(float alpha)
                     continue;
                 }
                 {
-                    float mx = mug->x_prev + (mug->x - mug->x_prev) * alpha;
-                    tap_blit_sprite((int)mx, y_surface, &g_mug1);
+                    int mx = PHYS_INT(PHYS_LERP(mug->x_prev, mug->x, t));
+                    tap_blit_sprite(mx, y_surface, &g_mug1);
                 }
             }
         }
@@ -1301,6 +1340,8 @@ void Tapp_End(void)
     }
 
     tap_free_sprites();
+    v_surface_free(&g_bg_layer);
+    g_bg_ready = 0;
 }
 
 int Tapp_IsFinished(void)
@@ -1,7 +1,9 @@
 #include "tron.h"
 
+#include "../../CORE/fixed.h"
 #include "../../CORE/input.h"
 #include "../../CORE/options.h"
+#include "../../CORE/rng.h"
 #include "../../CORE/sound.h"
 #include "../../CORE/video.h"
 #include "../../CORE/keyboard.h"
@@ -15,6 +17,7 @@
 #include <malloc.h>
 
 #define TRON_FAST_RENDER 1
+#define TRON_EXPLOSION_SAMPLE "SOUNDS\\explode.wav"
 
 #define TRON_CELL_SIZE 8
 #define TRON_GRID_COLS 40
@@ -36,6 +39,8 @@
 #define TRON_EXPLOSION_PARTICLES 16
 #define TRON_EXPLOSION_LIFE 18
 #define TRON_FINISH_DELAY_TICKS 24
+// Puntuación de "sin candidato" en la IA: cabe en 16.16 y ninguna jugada real baja tanto
+#define TRON_AI_SCORE_NONE PHYS_C(-30000.0f)
 
 typedef enum {
     TRON_CELL_EMPTY = 0,
@@ -52,7 +57,7 @@ typedef enum {
 } TronDir;
 
 typedef struct {
-    float move_speed;
+    phys_t move_speed;
     int allow_reverse;
     int ai_mistake_chance;
     int ai_aggression;
@@ -63,18 +68,22 @@ typedef struct {
     unsigned short w;
     unsigned short h;
     unsigned char far *pixels;
+    SpanSprite spans;
 } TronSprite;
 
 typedef struct {
     int active;
-    float x;
-    float y;
-    float vx;
-    float vy;
+    phys_t x;
+    phys_t y;
+    phys_t vx;
+    phys_t vy;
     int life;
 } TronParticle;
 
 static GameSettings g_settings;
+static Rng g_rng;
+// La IA de la demo tira de su propia serie: la entrada no toca la de la partida
+static Rng g_demo_rng;
 static TronParams g_params;
 static TronSprite g_bike_player;
 static TronSprite g_bike_enemy;
@@ -88,20 +97,21 @@ static TronCell g_grid[TRON_GRID_ROWS][TRON_GRID_COLS];
 static int far g_open_area_queue_x[TRON_GRID_COLS * TRON_GRID_ROWS];
 static int far g_open_area_queue_y[TRON_GRID_COLS * TRON_GRID_ROWS];
 static unsigned char far g_open_area_visited[TRON_GRID_ROWS][TRON_GRID_COLS];
-static unsigned char far *g_arena_layer = NULL;
+static Surface g_arena;
 static int g_arena_ready = 0;
 
-static float g_player_x = 0.0f;
-static float g_player_y = 0.0f;
-static float g_player_prev_x = 0.0f;
-static float g_player_prev_y = 0.0f;
-static float g_enemy_x = 0.0f;
-static float g_enemy_y = 0.0f;
-static float g_enemy_prev_x = 0.0f;
-static float g_enemy_prev_y = 0.0f;
+static phys_t g_player_x = PHYS_C(0.0f);
+static phys_t g_player_y = PHYS_C(0.0f);
+static phys_t g_player_prev_x = PHYS_C(0.0f);
+static phys_t g_player_prev_y = PHYS_C(0.0f);
+static phys_t g_enemy_x = PHYS_C(0.0f);
+static phys_t g_enemy_y = PHYS_C(0.0f);
+static phys_t g_enemy_prev_x = PHYS_C(0.0f);
+static phys_t g_enemy_prev_y = PHYS_C(0.0f);
 static TronDir g_player_dir = TRON_DIR_RIGHT;
 static TronDir g_player_next_dir = TRON_DIR_RIGHT;
 static TronDir g_enemy_dir = TRON_DIR_LEFT;
+static TronDir g_demo_dir = TRON_DIR_RIGHT;
 
 static int g_move_timer = 0;
 static int g_move_interval = 0;
@@ -110,6 +120,7 @@ static int g_finished = 0;
 static int g_did_win = 0;
 static int g_use_keyboard = 1;
 static int g_finish_delay = 0;
+static int g_explosion_sample = 0;
 static uint64_t g_final_score = 0;
 static char g_end_detail[32] = "";
 
@@ -147,14 +158,14 @@ static void tron_select_params(unsigned char difficulty, TronParams *params)
 
     switch (difficulty) {
     case DIFFICULTY_EASY:
-        params->move_speed = 4.0f;
+        params->move_speed = PHYS_C(4.0f);
         params->allow_reverse = 1;
         params->ai_mistake_chance = 30;
         params->ai_aggression = 20;
         params->ai_lookahead = 8;
         break;
     case DIFFICULTY_HARD:
-        params->move_speed = 8.0f;
+        params->move_speed = PHYS_C(8.0f);
         params->allow_reverse = 0;
         params->ai_mistake_chance = 4;
         params->ai_aggression = 95;
@@ -162,7 +173,7 @@ static void tron_select_params(unsigned char difficulty, TronParams *params)
         break;
     case DIFFICULTY_NORMAL:
     default:
-        params->move_speed = 6.0f;
+        params->move_speed = PHYS_C(6.0f);
         params->allow_reverse = 0;
         params->ai_mistake_chance = 12;
         params->ai_aggression = 55;
@@ -359,15 +370,15 @@ static int tron_edge_dist(int x, int y)
 static TronDir tron_ai_pick_dir(void)
 {
     TronDir candidates[4];
-    float scores[4];
+    phys_t scores[4];
     int count = 0;
     int best = -1;
-    float best_score = -100000.0f;
+    phys_t best_score = TRON_AI_SCORE_NONE;
     int dir;
-    int ex = (int)g_enemy_x;
-    int ey = (int)g_enemy_y;
-    int px = (int)g_player_x;
-    int py = (int)g_player_y;
+    int ex = PHYS_INT(g_enemy_x);
+    int ey = PHYS_INT(g_enemy_y);
+    int px = PHYS_INT(g_player_x);
+    int py = PHYS_INT(g_player_y);
     int reverse_block = tron_dir_opposite(g_enemy_dir);
 
     for (dir = 0; dir < 4; ++dir) {
@@ -386,7 +397,7 @@ static TronDir tron_ai_pick_dir(void)
             continue;
         }
         candidates[count] = d;
-        scores[count] = 0.0f;
+        scores[count] = PHYS_C(0.0f);
         count++;
     }
 
@@ -394,8 +405,8 @@ static TronDir tron_ai_pick_dir(void)
         return g_enemy_dir;
     }
 
-    if ((rand() % 100) < g_params.ai_mistake_chance) {
-        return candidates[rand() % count];
+    if (rng_below(&g_rng, 100) < g_params.ai_mistake_chance) {
+        return candidates[rng_below(&g_rng, count)];
     }
 
     for (dir = 0; dir < count; ++dir) {
@@ -408,7 +419,7 @@ static TronDir tron_ai_pick_dir(void)
         int area;
         int dist;
         int edge_dist;
-        float score;
+        phys_t score;
 
         tron_dir_to_delta(d, &dx, &dy);
         nx = ex + dx;
@@ -428,14 +439,14 @@ static TronDir tron_ai_pick_dir(void)
             edge_dist = TRON_GRID_ROWS - 1 - ny;
         }
 
-        score = 0.0f;
-        score += run * 2.0f;
-        score -= dist * (0.4f + (g_params.ai_aggression / 100.0f));
-        score += area * 0.15f;
-        score -= edge_dist * (g_params.ai_aggression / 120.0f);
+        score = PHYS_C(0.0f);
+        score += PHYS_MUL(PHYS_I(run), PHYS_C(2.0f));
+        score -= PHYS_MUL(PHYS_I(dist), PHYS_C(0.4f) + PHYS_RATIO(g_params.ai_aggression, 100));
+        score += PHYS_MUL(PHYS_I(area), PHYS_C(0.15f));
+        score -= PHYS_MUL(PHYS_I(edge_dist), PHYS_RATIO(g_params.ai_aggression, 120));
 
         if (tron_clear_line(nx, ny, px, py)) {
-            score += (float)g_params.ai_aggression;
+            score += PHYS_I(g_params.ai_aggression);
         }
 
         scores[dir] = score;
@@ -455,10 +466,10 @@ static TronDir tron_ai_pick_dir(void)
     return candidates[best];
 }
 
-static float tron_ai_eval_pos(int nx, int ny, int px, int py)
+static phys_t tron_ai_eval_pos(int nx, int ny, int px, int py)
 {
     int run, area, dist, exits, edge;
-    float score;
+    phys_t score;
 
     run = 0;
     area = tron_count_open_area(nx, ny, g_params.ai_lookahead * g_params.ai_lookahead);
@@ -466,42 +477,38 @@ static float tron_ai_eval_pos(int nx, int ny, int px, int py)
     exits = tron_count_exits(nx, ny);
     edge = tron_edge_dist(nx, ny);
 
-    score = 0.0f;
+    score = PHYS_C(0.0f);
 
-    score += area * 0.20f;
+    score += PHYS_MUL(PHYS_I(area), PHYS_C(0.20f));
 
     if (exits <= 1) {
-        score -= 80.0f;
+        score -= PHYS_C(80.0f);
     } else if (exits == 2) {
-        score -= 18.0f;
+        score -= PHYS_C(18.0f);
     } else {
-        score += 10.0f;
+        score += PHYS_C(10.0f);
     }
 
-    score += edge * 0.8f;
+    score += PHYS_MUL(PHYS_I(edge), PHYS_C(0.8f));
 
-    score -= dist * (0.18f + (g_params.ai_aggression / 220.0f));
+    score -= PHYS_MUL(PHYS_I(dist), PHYS_C(0.18f) + PHYS_RATIO(g_params.ai_aggression, 220));
 
     if (tron_clear_line(nx, ny, px, py)) {
-        score += (float)g_params.ai_aggression * 0.55f;
+        score += PHYS_MUL(PHYS_I(g_params.ai_aggression), PHYS_C(0.55f));
     }
 
     return score;
 }
 
-static TronDir tron_ai_pick_dir_smart(void)
+// Moto en (ex, ey) yendo hacia dir, rival en (px, py): la CPU y, en la demo, el jugador
+static TronDir tron_ai_pick_dir_smart(Rng *rng, int ex, int ey, TronDir dir_now, int px, int py)
 {
-    TronDir best_dir = g_enemy_dir;
-    float best_score = -1000000.0f;
+    TronDir best_dir = dir_now;
+    phys_t best_score = TRON_AI_SCORE_NONE;
 
-    int ex = (int)g_enemy_x;
-    int ey = (int)g_enemy_y;
-    int px = (int)g_player_x;
-    int py = (int)g_player_y;
+    TronDir reverse_block = tron_dir_opposite(dir_now);
 
-    TronDir reverse_block = tron_dir_opposite(g_enemy_dir);
-
-    if ((rand() % 100) < g_params.ai_mistake_chance) {
+    if (rng_below(rng, 100) < g_params.ai_mistake_chance) {
         TronDir opts[3];
         int n = 0, dir;
         for (dir = 0; dir < 4; ++dir) {
@@ -518,9 +525,9 @@ static TronDir tron_ai_pick_dir_smart(void)
             }
         }
         if (n > 0) {
-            return opts[rand() % n];
+            return opts[rng_below(rng, n)];
         }
-        return g_enemy_dir;
+        return dir_now;
     }
 
     {
@@ -530,7 +537,7 @@ static TronDir tron_ai_pick_dir_smart(void)
             int dx = 0, dy = 0;
             int nx, ny;
             int run;
-            float s1, s2_best, score;
+            phys_t s1, s2_best, score;
 
             if (d == reverse_block) {
                 continue;
@@ -545,16 +552,16 @@ static TronDir tron_ai_pick_dir_smart(void)
             run = tron_free_run(ex, ey, dx, dy);
 
             s1 = tron_ai_eval_pos(nx, ny, px, py);
-            s1 += run * 2.2f;
+            s1 += PHYS_MUL(PHYS_I(run), PHYS_C(2.2f));
 
-            s2_best = -1000000.0f;
+            s2_best = TRON_AI_SCORE_NONE;
             {
                 int dir2;
                 TronDir reverse2 = tron_dir_opposite(d);
                 for (dir2 = 0; dir2 < 4; ++dir2) {
                     TronDir d2 = (TronDir)dir2;
                     int dx2 = 0, dy2 = 0, nx2, ny2;
-                    float s2;
+                    phys_t s2;
 
                     if (d2 == reverse2) {
                         continue;
@@ -573,20 +580,20 @@ static TronDir tron_ai_pick_dir_smart(void)
                 }
             }
 
-            if (s2_best < -999999.0f) {
-                s2_best = -120.0f;
+            if (s2_best <= TRON_AI_SCORE_NONE) {
+                s2_best = PHYS_C(-120.0f);
             }
 
             {
-                float future_blend = 0.65f;
+                phys_t future_blend = PHYS_C(0.65f);
                 if (g_settings.difficulty == DIFFICULTY_EASY) {
-                    future_blend = 0.45f;
+                    future_blend = PHYS_C(0.45f);
                 }
                 if (g_settings.difficulty == DIFFICULTY_HARD) {
-                    future_blend = 0.80f;
+                    future_blend = PHYS_C(0.80f);
                 }
 
-                score = s1 + future_blend * s2_best;
+                score = s1 + PHYS_MUL(future_blend, s2_best);
             }
 
             if (score > best_score) {
@@ -630,31 +637,36 @@ static void tron_reset_particles(void)
     }
 }
 
-static void tron_spawn_explosion(float x, float y)
+static void tron_spawn_explosion(int x, int y)
 {
     int i;
     int slot = 0;
-    const float speed = 1.1f;
-    const float dirs[8][2] = {
-        { -1.0f, -1.0f },
-        { 1.0f, -1.0f },
-        { -1.0f, 1.0f },
-        { 1.0f, 1.0f },
-        { 0.0f, -1.0f },
-        { 0.0f, 1.0f },
-        { -1.0f, 0.0f },
-        { 1.0f, 0.0f }
+    const phys_t speed = PHYS_C(1.1f);
+    const phys_t dirs[8][2] = {
+        { PHYS_C(-1.0f), PHYS_C(-1.0f) },
+        { PHYS_C(1.0f), PHYS_C(-1.0f) },
+        { PHYS_C(-1.0f), PHYS_C(1.0f) },
+        { PHYS_C(1.0f), PHYS_C(1.0f) },
+        { PHYS_C(0.0f), PHYS_C(-1.0f) },
+        { PHYS_C(0.0f), PHYS_C(1.0f) },
+        { PHYS_C(-1.0f), PHYS_C(0.0f) },
+        { PHYS_C(1.0f), PHYS_C(0.0f) }
     };
 
+    // Sin la muestra en disco, un pitido
+    if (g_settings.sound_enabled && !(g_explosion_sample && sound_play_sample())) {
+        sound_play_tone(180, 120);
+    }
+
     for (i = 0; i < TRON_EXPLOSION_PARTICLES; ++i) {
         int index = i % 8;
         for (; slot < TRON_EXPLOSION_PARTICLES; ++slot) {
             if (!g_particles[slot].active) {
                 g_particles[slot].active = 1;
-                g_particles[slot].x = x;
-                g_particles[slot].y = y;
-                g_particles[slot].vx = dirs[index][0] * speed;
-                g_particles[slot].vy = dirs[index][1] * speed;
+                g_particles[slot].x = PHYS_I(x);
+                g_particles[slot].y = PHYS_I(y);
+                g_particles[slot].vx = PHYS_MUL(dirs[index][0], speed);
+                g_particles[slot].vy = PHYS_MUL(dirs[index][1], speed);
                 g_particles[slot].life = TRON_EXPLOSION_LIFE;
                 slot++;
                 break;
@@ -798,6 +810,8 @@ static void tron_sprite_rotate_into(const TronSprite *src, TronSprite *dst, Tron
             dst->pixels[sy * dst->w + sx] = p;
         }
     }
+
+    v_sprite_spans_build(&dst->spans, dst->w, dst->h, dst->pixels, 0);
 }
 
 static void tron_build_rotated_sprites_once(void)
@@ -811,158 +825,27 @@ static void tron_build_rotated_sprites_once(void)
 }
 #endif
 
-static void buf_putpixel(unsigned char far *buf, int x, int y, unsigned char c)
-{
-    if (!buf) {
-        return;
-    }
-    if (x < 0 || x >= VIDEO_WIDTH || y < 0 || y >= VIDEO_HEIGHT) {
-        return;
-    }
-    buf[(unsigned long)y * VIDEO_WIDTH + x] = c;
-}
-
-static void buf_fill_rect(unsigned char far *buf, int x, int y, int w, int h, unsigned char c)
-{
-    int iy;
-    int x0 = x;
-    int y0 = y;
-    int x1 = x + w;
-    int y1 = y + h;
-
-    if (!buf || w <= 0 || h <= 0) {
-        return;
-    }
-
-    if (x0 < 0) {
-        x0 = 0;
-    }
-    if (y0 < 0) {
-        y0 = 0;
-    }
-    if (x1 > VIDEO_WIDTH) {
-        x1 = VIDEO_WIDTH;
-    }
-    if (y1 > VIDEO_HEIGHT) {
-        y1 = VIDEO_HEIGHT;
-    }
-    if (x0 >= x1 || y0 >= y1) {
-        return;
-    }
-
-    for (iy = y0; iy < y1; ++iy) {
-        memset((void far *)(buf + ((unsigned long)iy * VIDEO_WIDTH) + x0), c, (size_t)(x1 - x0));
-    }
-}
-
-static void buf_draw_dotted_rect(unsigned char far *buf, int x, int y, int w, int h,
-                                 unsigned char base_color, unsigned char dot_color, int horizontal)
-{
-    int ix;
-    int iy;
-    const int dot_step = 6;
-    const int dot_size = 2;
-    const int phase = -2;
-
-    for (iy = 0; iy < h; ++iy) {
-        for (ix = 0; ix < w; ++ix) {
-            buf_putpixel(buf, x + ix, y + iy, base_color);
-        }
-    }
-
-    if (!horizontal) {
-        for (iy = y; iy < y + h; ++iy) {
-            int row = iy / dot_step;
-            int x_offset = (row % 2) * (dot_step / 2);
-
-            if ((iy % dot_step) != 0) {
-                continue;
-            }
-
-            for (ix = x; ix < x + w; ++ix) {
-                int xa = ix + x_offset + phase;
-                if ((xa % dot_step) != 0) {
-                    continue;
-                }
-
-                {
-                    int remaining_w = (x + w) - ix;
-                    int remaining_h = (y + h) - iy;
-                    int dot_w = remaining_w >= dot_size ? dot_size : remaining_w;
-                    int dot_h = remaining_h >= dot_size ? dot_size : remaining_h;
-                    int dx;
-                    int dy;
-
-                    for (dy = 0; dy < dot_h; ++dy) {
-                        for (dx = 0; dx < dot_w; ++dx) {
-                            buf_putpixel(buf, ix + dx, iy + dy, dot_color);
-                        }
-                    }
-                }
-            }
-        }
-    } else {
-        for (ix = x; ix < x + w; ++ix) {
-            int col = ix / dot_step;
-            int y_offset = (col % 2) * (dot_step / 2);
-
-            if ((ix % dot_step) != 0) {
-                continue;
-            }
-
-            for (iy = y; iy < y + h; ++iy) {
-                int ya = iy + y_offset + phase;
-                if ((ya % dot_step) != 0) {
-                    continue;
-                }
-
-                {
-                    int remaining_w = (x + w) - ix;
-                    int remaining_h = (y + h) - iy;
-                    int dot_w = remaining_w >= dot_size ? dot_size : remaining_w;
-                    int dot_h = remaining_h >= dot_size ? dot_size : remaining_h;
-                    int dx;
-                    int dy;
-
-                    for (dy = 0; dy < dot_h; ++dy) {
-                        for (dx = 0; dx < dot_w; ++dx) {
-                            buf_putpixel(buf, ix + dx, iy + dy, dot_color);
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
-
 static void tron_build_arena_layer(void)
 {
     int x;
     int y;
 
-    if (!g_arena_layer) {
-        g_arena_layer = (unsigned char far *)_fmalloc((size_t)VIDEO_WIDTH * VIDEO_HEIGHT);
-    }
-    if (!g_arena_layer) {
+    if (!g_arena.pixels && !v_surface_alloc(&g_arena, VIDEO_WIDTH, VIDEO_HEIGHT)) {
         return;
     }
 
-    buf_fill_rect(g_arena_layer, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT, TRON_COLOR_BG);
-
-    buf_fill_rect(g_arena_layer, TRON_GRID_ORIGIN_X, TRON_GRID_ORIGIN_Y,
-                  TRON_GRID_COLS * TRON_CELL_SIZE, TRON_GRID_ROWS * TRON_CELL_SIZE,
-                  TRON_COLOR_BG);
+    v_surf_clear(&g_arena, TRON_COLOR_BG);
 
-    buf_draw_dotted_rect(g_arena_layer,
-                     TRON_GRID_ORIGIN_X, TRON_GRID_ORIGIN_Y,
-                     TRON_GRID_COLS * TRON_CELL_SIZE, TRON_GRID_ROWS * TRON_CELL_SIZE,
-                     TRON_COLOR_BG, TRON_COLOR_GRID, 1);
+    v_surf_draw_dotted_rect(&g_arena,
+                            TRON_GRID_ORIGIN_X, TRON_GRID_ORIGIN_Y,
+                            TRON_GRID_COLS * TRON_CELL_SIZE, TRON_GRID_ROWS * TRON_CELL_SIZE,
+                            TRON_COLOR_BG, TRON_COLOR_GRID, 1);
 
     for (y = 0; y < TRON_GRID_ROWS; ++y) {
         for (x = 0; x < TRON_GRID_COLS; ++x) {
             if (g_grid[y][x] == TRON_CELL_WALL) {
-                buf_fill_rect(
-                    g_arena_layer,
+                v_surf_fill_rect(
+                    &g_arena,
                     TRON_GRID_ORIGIN_X + x * TRON_CELL_SIZE,
                     TRON_GRID_ORIGIN_Y + y * TRON_CELL_SIZE,
                     TRON_CELL_SIZE,
@@ -1022,33 +905,34 @@ static void tron_set_start_positions(void)
 {
     switch (g_settings.difficulty) {
     case DIFFICULTY_EASY:
-        g_player_x = 6.0f;
-        g_player_y = 12.0f;
-        g_enemy_x = 33.0f;
-        g_enemy_y = 12.0f;
+        g_player_x = PHYS_C(6.0f);
+        g_player_y = PHYS_C(12.0f);
+        g_enemy_x = PHYS_C(33.0f);
+        g_enemy_y = PHYS_C(12.0f);
         g_player_dir = TRON_DIR_RIGHT;
         g_enemy_dir = TRON_DIR_LEFT;
         break;
     case DIFFICULTY_HARD:
-        g_player_x = 8.0f;
-        g_player_y = 12.0f;
-        g_enemy_x = 30.0f;
-        g_enemy_y = 12.0f;
+        g_player_x = PHYS_C(8.0f);
+        g_player_y = PHYS_C(12.0f);
+        g_enemy_x = PHYS_C(30.0f);
+        g_enemy_y = PHYS_C(12.0f);
         g_player_dir = TRON_DIR_RIGHT;
         g_enemy_dir = TRON_DIR_LEFT;
         break;
     case DIFFICULTY_NORMAL:
     default:
-        g_player_x = 7.0f;
-        g_player_y = 12.0f;
-        g_enemy_x = 31.0f;
-        g_enemy_y = 12.0f;
+        g_player_x = PHYS_C(7.0f);
+        g_player_y = PHYS_C(12.0f);
+        g_enemy_x = PHYS_C(31.0f);
+        g_enemy_y = PHYS_C(12.0f);
         g_player_dir = TRON_DIR_RIGHT;
         g_enemy_dir = TRON_DIR_LEFT;
         break;
     }
 
     g_player_next_dir = g_player_dir;
+    g_demo_dir = g_player_dir;
 }
 
 static void tron_load_sprite(const char *path, TronSprite *sprite)
@@ -1069,7 +953,11 @@ static void tron_load_sprite(const char *path, TronSprite *sprite)
 
 static void tron_free_sprite(TronSprite *sprite)
 {
-    if (!sprite || !sprite->pixels) {
+    if (!sprite) {
+        return;
+    }
+    v_sprite_spans_free(&sprite->spans);
+    if (!sprite->pixels) {
         return;
     }
 
@@ -1108,15 +996,17 @@ void Tron_Init(const GameSettings *settings)
     } else {
         memset(&g_settings, 0, sizeof(g_settings));
     }
+    rng_seed(&g_rng, g_settings.seed);
+    rng_seed(&g_demo_rng, ~g_settings.seed);
 
     tron_select_params(g_settings.difficulty, &g_params);
-    g_params.move_speed *= g_settings.speed_multiplier;
+    g_params.move_speed = PHYS_MUL(g_params.move_speed, PHYS_F(g_settings.speed_multiplier));
 
-    if (g_params.move_speed < 2.0f) {
-        g_params.move_speed = 2.0f;
+    if (g_params.move_speed < PHYS_C(2.0f)) {
+        g_params.move_speed = PHYS_C(2.0f);
     }
 
-    g_move_interval = (int)((float)TRON_TICKS_PER_SECOND / g_params.move_speed);
+    g_move_interval = PHYS_INT(PHYS_DIV(PHYS_I(TRON_TICKS_PER_SECOND), g_params.move_speed));
     if (g_move_interval < 1) {
         g_move_interval = 1;
     }
@@ -1130,6 +1020,9 @@ void Tron_Init(const GameSettings *settings)
 #endif
     }
 
+    // Se abre aquí: en el tick sólo se arranca
+    g_explosion_sample = g_settings.sound_enabled && sound_load_sample(TRON_EXPLOSION_SAMPLE);
+
     tron_reset_grid();
     tron_reset_particles();
     tron_build_arena_layer();
@@ -1194,15 +1087,16 @@ void Tron_Update(void)
 
     {
         TronDir next_player_dir = tron_apply_player_dir();
-        TronDir next_enemy_dir = tron_ai_pick_dir_smart();
+        TronDir next_enemy_dir = tron_ai_pick_dir_smart(&g_rng, PHYS_INT(g_enemy_x), PHYS_INT(g_enemy_y), g_enemy_dir,
+                                                        PHYS_INT(g_player_x), PHYS_INT(g_player_y));
         int pdx = 0;
         int pdy = 0;
         int edx = 0;
         int edy = 0;
-        int px = (int)g_player_x;
-        int py = (int)g_player_y;
-        int ex = (int)g_enemy_x;
-        int ey = (int)g_enemy_y;
+        int px = PHYS_INT(g_player_x);
+        int py = PHYS_INT(g_player_y);
+        int ex = PHYS_INT(g_enemy_x);
+        int ey = PHYS_INT(g_enemy_y);
         int pnx;
         int pny;
         int enx;
@@ -1254,23 +1148,23 @@ void Tron_Update(void)
         g_grid[ey][ex] = TRON_CELL_ENEMY_TRAIL;
 
         if (g_arena_ready) {
-            buf_fill_rect(g_arena_layer,
-                          TRON_GRID_ORIGIN_X + (px * TRON_CELL_SIZE),
-                          TRON_GRID_ORIGIN_Y + (py * TRON_CELL_SIZE),
-                          TRON_CELL_SIZE, TRON_CELL_SIZE, TRON_COLOR_PLAYER_TRAIL);
-
-            buf_fill_rect(g_arena_layer,
-                          TRON_GRID_ORIGIN_X + (ex * TRON_CELL_SIZE),
-                          TRON_GRID_ORIGIN_Y + (ey * TRON_CELL_SIZE),
-                          TRON_CELL_SIZE, TRON_CELL_SIZE, TRON_COLOR_ENEMY_TRAIL);
+            v_surf_fill_rect(&g_arena,
+                             TRON_GRID_ORIGIN_X + (px * TRON_CELL_SIZE),
+                             TRON_GRID_ORIGIN_Y + (py * TRON_CELL_SIZE),
+                             TRON_CELL_SIZE, TRON_CELL_SIZE, TRON_COLOR_PLAYER_TRAIL);
+
+            v_surf_fill_rect(&g_arena,
+                             TRON_GRID_ORIGIN_X + (ex * TRON_CELL_SIZE),
+                             TRON_GRID_ORIGIN_Y + (ey * TRON_CELL_SIZE),
+                             TRON_CELL_SIZE, TRON_CELL_SIZE, TRON_COLOR_ENEMY_TRAIL);
         }
 
         g_player_dir = next_player_dir;
         g_enemy_dir = next_enemy_dir;
-        g_player_x = (float)pnx;
-        g_player_y = (float)pny;
-        g_enemy_x = (float)enx;
-        g_enemy_y = (float)eny;
+        g_player_x = PHYS_I(pnx);
+        g_player_y = PHYS_I(pny);
+        g_enemy_x = PHYS_I(enx);
+        g_enemy_y = PHYS_I(eny);
 
     }
 
@@ -1280,19 +1174,20 @@ void Tron_Update(void)
 void Tron_DrawInterpolated(float alpha)
 {
     int i;
-    float px = g_player_prev_x + (g_player_x - g_player_prev_x) * alpha;
-    float py = g_player_prev_y + (g_player_y - g_player_prev_y) * alpha;
-    float ex = g_enemy_prev_x + (g_enemy_x - g_enemy_prev_x) * alpha;
-    float ey = g_enemy_prev_y + (g_enemy_y - g_enemy_prev_y) * alpha;
-    int player_px = TRON_GRID_ORIGIN_X + (int)(px * TRON_CELL_SIZE);
-    int player_py = TRON_GRID_ORIGIN_Y + (int)(py * TRON_CELL_SIZE);
-    int enemy_px = TRON_GRID_ORIGIN_X + (int)(ex * TRON_CELL_SIZE);
-    int enemy_py = TRON_GRID_ORIGIN_Y + (int)(ey * TRON_CELL_SIZE);
+    phys_t t = PHYS_F(alpha);
+    phys_t px = PHYS_LERP(g_player_prev_x, g_player_x, t);
+    phys_t py = PHYS_LERP(g_player_prev_y, g_player_y, t);
+    phys_t ex = PHYS_LERP(g_enemy_prev_x, g_enemy_x, t);
+    phys_t ey = PHYS_LERP(g_enemy_prev_y, g_enemy_y, t);
+    int player_px = TRON_GRID_ORIGIN_X + PHYS_INT(PHYS_MUL(px, PHYS_I(TRON_CELL_SIZE)));
+    int player_py = TRON_GRID_ORIGIN_Y + PHYS_INT(PHYS_MUL(py, PHYS_I(TRON_CELL_SIZE)));
+    int enemy_px = TRON_GRID_ORIGIN_X + PHYS_INT(PHYS_MUL(ex, PHYS_I(TRON_CELL_SIZE)));
+    int enemy_py = TRON_GRID_ORIGIN_Y + PHYS_INT(PHYS_MUL(ey, PHYS_I(TRON_CELL_SIZE)));
     char hud[32];
 
 #if TRON_FAST_RENDER
-    if (g_arena_ready && g_arena_layer) {
-        v_blit_fullscreen_fast((const unsigned char far *)g_arena_layer);
+    if (g_arena_ready && g_arena.pixels) {
+        v_surf_blit(v_surface_screen(), 0, 0, &g_arena, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
     } else {
         v_clear(TRON_COLOR_BG);
     }
@@ -1300,12 +1195,20 @@ void Tron_DrawInterpolated(float alpha)
     {
         TronSprite *sp = &g_bike_player_rot[(int)g_player_dir];
         TronSprite *se = &g_bike_enemy_rot[(int)g_enemy_dir];
-        v_blit_sprite(player_px, player_py, sp->w, sp->h, (const unsigned char far *)sp->pixels, 0);
-        v_blit_sprite(enemy_px, enemy_py, se->w, se->h, (const unsigned char far *)se->pixels, 0);
+        if (sp->spans.data) {
+            v_blit_sprite_spans(player_px, player_py, &sp->spans);
+        } else {
+            v_blit_sprite(player_px, player_py, sp->w, sp->h, (const unsigned char far *)sp->pixels, 0);
+        }
+        if (se->spans.data) {
+            v_blit_sprite_spans(enemy_px, enemy_py, &se->spans);
+        } else {
+            v_blit_sprite(enemy_px, enemy_py, se->w, se->h, (const unsigned char far *)se->pixels, 0);
+        }
     }
 #else
-    if (g_arena_ready && g_arena_layer) {
-        v_blit_sprite(0, 0, VIDEO_WIDTH, VIDEO_HEIGHT, (const unsigned char far *)g_arena_layer, 255);
+    if (g_arena_ready && g_arena.pixels) {
+        v_surf_blit_keyed(v_surface_screen(), 0, 0, &g_arena, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT, 255);
     } else {
         v_clear(TRON_COLOR_BG);
     }
@@ -1342,7 +1245,7 @@ void Tron_DrawInterpolated(float alpha)
             if (g_particles[i].life < (TRON_EXPLOSION_LIFE / 2)) {
                 color = TRON_COLOR_EXPLOSION_1;
             }
-            v_fill_rect((int)g_particles[i].x, (int)g_particles[i].y, 2, 2, color);
+            v_fill_rect(PHYS_INT(g_particles[i].x), PHYS_INT(g_particles[i].y), 2, 2, color);
         }
     }
 
@@ -1356,11 +1259,12 @@ void Tron_End(void)
 {
     char score_text[16];
 
-    if (g_arena_layer) {
-        _ffree(g_arena_layer);
-        g_arena_layer = NULL;
-    }
+    v_surface_free(&g_arena);
     g_arena_ready = 0;
+    if (g_explosion_sample) {
+        sound_unload_sample();
+        g_explosion_sample = 0;
+    }
     high_scores_format_score(score_text, sizeof(score_text), g_final_score);
     snprintf(g_end_detail, sizeof(g_end_detail), "PUNTOS %s", score_text);
     tron_free_sprites();
@@ -1385,3 +1289,15 @@ uint64_t Tron_GetScore(void)
 {
     return g_final_score;
 }
+
+void Tron_DemoInput(unsigned char *keys)
+{
+    static const unsigned char dir_keys[4] = {SC_UP, SC_RIGHT, SC_DOWN, SC_LEFT};
+
+    // La IA es cara: sólo se piensa en el tick en que la moto avanza; entre medias se mantiene
+    if (!g_finished && g_finish_delay <= 0 && g_move_timer + 1 >= g_move_interval) {
+        g_demo_dir = tron_ai_pick_dir_smart(&g_demo_rng, PHYS_INT(g_player_x), PHYS_INT(g_player_y), g_player_dir,
+                                            PHYS_INT(g_enemy_x), PHYS_INT(g_enemy_y));
+    }
+    kb_snapshot_press(keys, dir_keys[g_demo_dir]);
+}
@@ -13,5 +13,7 @@ int Tron_IsFinished(void);
 int Tron_DidWin(void);
 const char *Tron_GetEndDetail(void);
 uint64_t Tron_GetScore(void);
+// Demo: teclas del jugador que pondría la IA
+void Tron_DemoInput(unsigned char *keys);
 
 #endif
@@ -1,12 +1,16 @@
 #ifndef GAME_SETTINGS_H
 #define GAME_SETTINGS_H
 
+#include <stdint.h>
+
 typedef struct {
     unsigned char difficulty;
     unsigned char sound_enabled;
     unsigned char input_mode;
     unsigned char game_speed;
     float speed_multiplier;
+    // Semilla del Rng del juego; el lanzador pone una nueva en cada partida
+    uint32_t seed;
 } GameSettings;
 
 #endif
@@ -1,11 +1,16 @@
 #include "main.h"
 
 #include "CORE/video.h"
+#include "CORE/palfx.h"
+#include "CORE/capture.h"
 #include "CORE/input.h"
 #include "CORE/keyboard.h"
+#include "CORE/opl.h"
 #include "CORE/timer.h"
 #include "CORE/options.h"
+#include "CORE/profiler.h"
 #include "CORE/records.h"
+#include "CORE/replay.h"
 #include "CORE/sound.h"
 #include "CORE/text.h"
 #include "GAME/menu.h"
@@ -15,6 +20,8 @@
 #include "GAME/story_high_scores.h"
 #include "GAME/year_launcher.h"
 
+#include <stdlib.h>
+
 
 static void draw_center_text(const char *text, int y, unsigned char color)
 {
@@ -32,28 +39,63 @@ static void draw_center_text(const char *text, int y, unsigned char color)
 int main(void)
 {
     unsigned long start;
+    const char *modex;
 
+    // El sonido cuelga un hook de la ISR del timer: va detrás de timer_init
+    timer_init();
     sound_init();
+    // Con AdLib suena por la OPL2; SET TBSPEAKER=1 deja el altavoz
+    if (!getenv("TBSPEAKER") && opl_detect()) {
+        sound_set_backend(SOUND_BACKEND_OPL2);
+    }
     options_init();
     records_init();
     kb_init();
 
-    v_init_mode13();
+    // SET TBMODEX=240 (o 200) para el backend con flip de páginas
+    modex = getenv("TBMODEX");
+    if (modex) {
+        v_init_modex(atoi(modex));
+    } else {
+        v_init_mode13();
+    }
+    // Captura para QA: SET TBCAPTURE=PARTIDA.FLI
+    cap_open(getenv("TBCAPTURE"));
+    // Entrada por tick: SET TBRECORD=PARTIDA.REC graba, SET TBREPLAY=PARTIDA.REC reproduce
+    if (!rec_replay(getenv("TBREPLAY"))) {
+        rec_record(getenv("TBRECORD"));
+    }
+    // Misma semilla en todas las partidas: SET TBSEED=1234
+    launch_set_seed(getenv("TBSEED"));
     v_lock_palette("palette.dat");
+    pal_fx_fade_from_black(400);
     v_clear(0);
     draw_center_text(text_get(TEXT_PROGRAMMED_BY), 96, 15);
     v_present();
 
+    // v_present aplica el fundido en cada retrace; sin daño no copia nada
     start = t_now_ms();
     while ((t_now_ms() - start) < 2000UL) {
         if (in_keyhit()) {
             break;
         }
+        v_present();
     }
     while (in_keyhit()) {
         in_poll();
     }
 
+    pal_fx_fade_to_black(300);
+    // OJO: con tope, como la espera de arriba; si el fundido no avanza no se cuelga
+    start = t_now_ms();
+    while (pal_fx_busy() && (t_now_ms() - start) < 1000UL) {
+        v_present();
+    }
+    v_clear(0);
+    v_present();
+    // El menú vuelve a subir la paleta mientras se dibuja
+    pal_fx_fade_from_black(300);
+
     while (1) {
         MenuOption choice = menu_run();
         int selected_year;
@@ -74,9 +116,16 @@ int main(void)
             StoryHighScores_Run(options ? options->difficulty : DIFFICULTY_NORMAL);
         } else if (choice == MENU_OPCIONES) {
             options_menu_run();
+        } else if (choice == MENU_DEMO) {
+            launch_attract();
         }
     }
 
+    // Perfil por fases de cada minijuego jugado: SET TBPROFILE=PERFIL.TXT
+    prof_write_summary(getenv("TBPROFILE"));
+    rec_close();
+    cap_close();
+    timer_shutdown();
     kb_shutdown();
     sound_shutdown();
     v_text_mode();
@@ -0,0 +1,151 @@
+# captura_a_ppm.py
+#
+# Expande una captura FLI hecha con TBCAPTURE (CORE/capture.c) a un PPM por frame.
+# Uso: python captura_a_ppm.py PARTIDA.FLI [carpeta_salida] [cada_n_frames]
+
+import os
+import struct
+import sys
+
+FLI_MAGIC = 0xAF11
+FLC_MAGIC = 0xAF12
+FRAME_MAGIC = 0xF1FA
+
+COLOR_256 = 4
+COLOR_64 = 11
+LC = 12
+BLACK = 13
+BRUN = 15
+COPY = 16
+
+
+def _signed(b: int) -> int:
+    return b - 256 if b > 127 else b
+
+
+def _color(data: bytes, palette: bytearray, six_bits: bool) -> None:
+    (packets,) = struct.unpack_from("<H", data, 0)
+    pos = 2
+    index = 0
+    for _ in range(packets):
+        index += data[pos]
+        count = data[pos + 1] or 256
+        pos += 2
+        for i in range(count):
+            for c in range(3):
+                v = data[pos + c]
+                if six_bits:
+                    # DAC de 6 bits a 8 bits, igual que v_dump_ppm
+                    v = ((v << 2) | (v >> 4)) & 0xFF
+                palette[(index + i) * 3 + c] = v
+            pos += 3
+        index += count
+
+
+def _brun(data: bytes, pixels: bytearray, width: int, height: int) -> None:
+    pos = 0
+    for y in range(height):
+        pos += 1  # Contador de paquetes, no se usa
+        x = 0
+        row = y * width
+        while x < width:
+            size = _signed(data[pos])
+            pos += 1
+            if size > 0:
+                pixels[row + x : row + x + size] = bytes([data[pos]]) * size
+                pos += 1
+                x += size
+            else:
+                size = -size
+                pixels[row + x : row + x + size] = data[pos : pos + size]
+                pos += size
+                x += size
+
+
+def _lc(data: bytes, pixels: bytearray, width: int) -> None:
+    first, lines = struct.unpack_from("<HH", data, 0)
+    pos = 4
+    for y in range(first, first + lines):
+        packets = data[pos]
+        pos += 1
+        x = 0
+        row = y * width
+        for _ in range(packets):
+            x += data[pos]
+            size = _signed(data[pos + 1])
+            pos += 2
+            if size >= 0:
+                pixels[row + x : row + x + size] = data[pos : pos + size]
+                pos += size
+                x += size
+            else:
+                size = -size
+                pixels[row + x : row + x + size] = bytes([data[pos]]) * size
+                pos += 1
+                x += size
+
+
+def _write_ppm(path: str, pixels: bytearray, palette: bytearray, width: int, height: int) -> None:
+    rgb = bytearray(width * height * 3)
+    for i, p in enumerate(pixels):
+        rgb[i * 3 : i * 3 + 3] = palette[p * 3 : p * 3 + 3]
+    with open(path, "wb") as f:
+        f.write(b"P6\n%d %d\n255\n" % (width, height))
+        f.write(rgb)
+
+
+def decode(in_path: str, out_dir: str, every: int = 1) -> int:
+    with open(in_path, "rb") as f:
+        data = f.read()
+
+    _, magic, frames, width, height = struct.unpack_from("<IHHHH", data, 0)
+    if magic not in (FLI_MAGIC, FLC_MAGIC):
+        raise ValueError(f"'{in_path}' no es un FLI/FLC (magic {magic:#06x})")
+
+    os.makedirs(out_dir, exist_ok=True)
+    pixels = bytearray(width * height)
+    palette = bytearray(768)
+    pos = 128
+    written = 0
+
+    for n in range(frames):
+        size, fmagic, chunks = struct.unpack_from("<IHH", data, pos)
+        if fmagic != FRAME_MAGIC:
+            raise ValueError(f"frame {n}: cabecera incorrecta en {pos}")
+
+        cpos = pos + 16
+        for _ in range(chunks):
+            csize, ctype = struct.unpack_from("<IH", data, cpos)
+            body = data[cpos + 6 : cpos + csize]
+            if ctype == COLOR_64:
+                _color(body, palette, True)
+            elif ctype == COLOR_256:
+                _color(body, palette, False)
+            elif ctype == LC:
+                _lc(body, pixels, width)
+            elif ctype == BRUN:
+                _brun(body, pixels, width, height)
+            elif ctype == BLACK:
+                pixels[:] = bytes(width * height)
+            elif ctype == COPY:
+                pixels[:] = body[: width * height]
+            cpos += csize
+
+        if n % every == 0:
+            _write_ppm(os.path.join(out_dir, f"frame_{n + 1:05d}.ppm"), pixels, palette, width, height)
+            written += 1
+        pos += size
+
+    return written
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("Uso: python captura_a_ppm.py PARTIDA.FLI [carpeta_salida] [cada_n_frames]")
+        sys.exit(1)
+
+    src = sys.argv[1]
+    dst = sys.argv[2] if len(sys.argv) > 2 else os.path.splitext(src)[0] + "_ppm"
+    step = int(sys.argv[3]) if len(sys.argv) > 3 else 1
+    count = decode(src, dst, max(1, step))
+    print(f"{count} frames escritos en {dst}")
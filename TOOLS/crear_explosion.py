@@ -0,0 +1,40 @@
+# crear_explosion.py
+#
+# Genera SOUNDS/explode.wav: ruido filtrado que se apaga, PCM mono de 8 bits a
+# 8000 Hz (el tope del PWM del altavoz). Misma semilla, mismo fichero.
+
+import os
+import random
+import struct
+
+OUTPUT = os.path.join("SOUNDS", "explode.wav")
+RATE = 8000
+SECONDS = 0.6
+
+random.seed(1983)
+
+count = int(RATE * SECONDS)
+samples = bytearray()
+low = 0.0
+
+for i in range(count):
+    t = i / count
+    # Cada vez más grave y más flojo
+    cut = 0.5 - 0.42 * t
+    low += cut * (random.uniform(-1.0, 1.0) - low)
+    level = low * (1.0 - t) ** 2 * 2.2
+    level = max(-1.0, min(1.0, level))
+    samples.append(int(128 + level * 127))
+
+os.makedirs("SOUNDS", exist_ok=True)
+
+with open(OUTPUT, "wb") as f:
+    f.write(b"RIFF")
+    f.write(struct.pack("<I", 36 + len(samples)))
+    f.write(b"WAVEfmt ")
+    f.write(struct.pack("<IHHIIHH", 16, 1, 1, RATE, RATE, 1, 8))
+    f.write(b"data")
+    f.write(struct.pack("<I", len(samples)))
+    f.write(samples)
+
+print("%s generado (%d muestras)" % (OUTPUT, len(samples)))
@@ -39,6 +39,11 @@ if exist "Sprites" (
     xcopy "Sprites" "exe\Sprites\" /E /I /Y >nul
 )
 
+REM Muestras digitalizadas (TOOLS\crear_explosion.py)
+if exist "SOUNDS" (
+    xcopy "SOUNDS" "exe\SOUNDS\" /E /I /Y >nul
+)
+
 echo [STAGE] Copiados .exe y .dat a .\exe\
 echo.
 
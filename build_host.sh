@@ -0,0 +1,83 @@
+#!/bin/sh
+# Build de host (Linux) del runner sin hardware: ./tbrun -g all -r 0
+# Usa el backend headless de video y el reloj virtual; no hace falta DOSBox.
+# tbsnd vuelca las melodías a WAV y comprueba sus tiempos: ./tbsnd -o .
+# y con -b opl las escrituras de la OPL2 contra los registros buenos de SOUNDS/OPL:
+#   ./tbsnd -b opl -c SOUNDS/OPL -o /tmp
+# (si cambia una melodía a propósito se regeneran con ./tbsnd -b opl -o SOUNDS/OPL)
+# -s pasa un WAV por el PWM del altavoz: ./tbsnd -s muestra.wav -o .
+#
+# ./build_host.sh fisica compila además tbrun_float (USE_FIXED_PHYSICS=0) y compara
+# las dos físicas con las mismas partidas (semillas 1-5, teclas al azar y demo):
+#   - frog, tron y pang: el hash del último frame tiene que ser el mismo
+#   - el resto: partidas a menos del 10% y porcentaje de victorias a menos de 5 puntos
+#   - breakout sólo compara partidas: el rebote sale del punto exacto del golpe en
+#     la pala y con tan pocas victorias un redondeo distinto las cambia (15 contra 7)
+
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2}"
+OUT="tbrun"
+OUT_SND="tbsnd"
+
+SRC="Source/HOST/runner.c Source/GAME/year_registry.c Source/GAME/melodies.c Source/CORE/*.c Source/MINI/*/*.c"
+SRC_SND="Source/HOST/sound_dump.c Source/GAME/melodies.c Source/CORE/*.c"
+
+echo "[BUILD] $OUT"
+$CC -std=gnu99 $CFLAGS -o "$OUT" $SRC -lm || exit 1
+echo "[OK] $OUT"
+
+echo "[BUILD] $OUT_SND"
+$CC -std=gnu99 $CFLAGS -o "$OUT_SND" $SRC_SND -lm || exit 1
+echo "[OK] $OUT_SND"
+
+[ "$1" = "fisica" ] || exit 0
+
+OUT_FLOAT="tbrun_float"
+echo "[BUILD] $OUT_FLOAT"
+$CC -std=gnu99 $CFLAGS -DUSE_FIXED_PHYSICS=0 -o "$OUT_FLOAT" $SRC -lm || exit 1
+echo "[OK] $OUT_FLOAT"
+
+echo "[FISICA] coma fija contra float"
+for RUN in "./$OUT" "./$OUT_FLOAT"; do
+    for MODE in -k -a; do
+        for SEED in 1 2 3 4 5; do
+            $RUN -g all -t 20000 -r 100 $MODE -s $SEED | sed "s|^|$RUN |"
+        done
+    done
+done | awk -v fixed="./$OUT" '
+    {
+        side = ($1 == fixed) ? 0 : 1
+        game = $2
+        games[game] = 1
+        sessions[game, side] += $6
+        wins[game, side] += $8 + 0
+        for (i = 1; i < NF; ++i) {
+            if ($i == "hash") {
+                n = ++runs[game, side]
+                hash[game, n, side] = $(i + 1)
+            }
+        }
+    }
+    END {
+        exact["frog"] = exact["tron"] = exact["pang"] = 1
+        failed = 0
+        for (game in games) {
+            p0 = sessions[game, 0]; p1 = sessions[game, 1]
+            w0 = wins[game, 0]; w1 = wins[game, 1]
+            r0 = p0 ? 100 * w0 / p0 : 0; r1 = p1 ? 100 * w1 / p1 : 0
+            ok = 1
+            if (game in exact) {
+                for (i = 1; i <= runs[game, 0]; ++i) {
+                    if (hash[game, i, 0] != hash[game, i, 1]) ok = 0
+                }
+            } else {
+                if ((p0 > p1 ? p0 - p1 : p1 - p0) * 10 > (p0 > p1 ? p0 : p1)) ok = 0
+                if (game != "breakout" && (r0 > r1 ? r0 - r1 : r1 - r0) > 5) ok = 0
+            }
+            printf "%-9s partidas %4d/%4d  victorias %5.1f%%/%5.1f%%  %s%s\n", game, p0, p1, r0, r1,
+                   (game in exact) ? "hash " : "", ok ? "OK" : "MAL"
+            if (!ok) failed = 1
+        }
+        exit failed
+    }' || exit 1
+echo "[OK] fisica"